@@ -0,0 +1,154 @@
+#!/usr/bin/env bash
+# End-to-end performance regression check.
+# Runs the whole IVPSNR pipeline on in-memory synthetic sequences (-syn 1, no disk I/O) and on the same sequences
+# written to files (-syn 2, default file reading path - fused preparation, interleaved only IV-PSNR, batched reader)
+# for a set of configurations, measures frames per second and peak RSS, and compares them with values stored in
+# the baseline file. Configurations without baseline entry fail unless -u is given.
+# Exit code: 0 = no regression, 1 = regression detected, 2 = usage or runtime error.
+
+Binary="./buildL/IV_PSNR"
+BaselineFile="./perf_baseline.txt"
+Width=1920
+Height=1080
+Frames=16
+Repeats=3
+FpsTolerance=0.10 #allowed relative FPS drop
+RssTolerance=0.10 #allowed relative peak RSS growth
+Update=0
+Filter=""
+
+print_usage()
+{
+  cat <<EOF
+usage: perf_regression.sh [options]
+  -b   path      IVPSNR binary (default ${Binary})
+  -f   path      Baseline file (default ${BaselineFile})
+  -w   width     Picture width  (default ${Width})
+  -h   height    Picture height (default ${Height})
+  -l   frames    Number of frames per run (default ${Frames})
+  -r   repeats   Runs per configuration, best FPS and max RSS are taken (default ${Repeats})
+  -ft  tol       Allowed relative FPS drop (default ${FpsTolerance})
+  -mt  tol       Allowed relative peak RSS growth (default ${RssTolerance})
+  -k   filter    Run only configurations containing filter string
+  -u             Update (rewrite) baseline entries with measured values (required for new configurations)
+EOF
+}
+
+while [ $# -gt 0 ]; do
+  case "$1" in
+    -b ) Binary="$2";       shift 2;;
+    -f ) BaselineFile="$2"; shift 2;;
+    -w ) Width="$2";        shift 2;;
+    -h ) Height="$2";       shift 2;;
+    -l ) Frames="$2";       shift 2;;
+    -r ) Repeats="$2";      shift 2;;
+    -ft) FpsTolerance="$2"; shift 2;;
+    -mt) RssTolerance="$2"; shift 2;;
+    -k ) Filter="$2";       shift 2;;
+    -u ) Update=1;          shift 1;;
+    * ) print_usage; exit 2;;
+  esac
+done
+
+if [ ! -x "${Binary}" ]; then echo "ERROR --> IVPSNR binary not found (${Binary})"; exit 2; fi
+
+#file inputs - synthetic sequences written once by -syn 2, IV-PSNR only runs use config file (metrics are not selectable from commandline)
+WorkDir=$(mktemp -d) || { echo "ERROR --> cannot create temporary directory"; exit 2; }
+trap 'rm -rf "${WorkDir}"' EXIT
+SynArgs="-w ${Width} -h ${Height} -l ${Frames} -sn 8 -sx 1 -sy 1 -v 1"
+printf "Calc__PSNR = 0\nCalcWSPSNR = 0\nCalcCheckFlow = 0\nCalcPSNRFlow = 0\nCalcIVPSNRFlow = 0\nCalcIVPSNRFlowOnly = 0\n" > "${WorkDir}/ivpsnr_only.cfg"
+
+#configurations: name, input source (syn = in memory, file = files written by -syn 2) and IVPSNR arguments
+#optical flow metrics are computed in all configurations except ivpsnr_only ones
+Configs=(
+  "planar_t1                syn  -ilp 0 -t 1"
+  "planar_t4                syn  -ilp 0 -t 4"
+  "interleaved_t0           syn  -ilp 1 -t 0"
+  "interleaved_t1           syn  -ilp 1 -t 1"
+  "interleaved_t4           syn  -ilp 1 -t 4"
+  "interleaved_tall         syn  -ilp 1 -t -1"
+  "interleaved_t1_hp        syn  -ilp 1 -t 1 -hp 1"
+  "interleaved_t4_hp        syn  -ilp 1 -t 4 -hp 1"
+  "masked_t4                syn  -ilp 1 -t 4 -sm"
+  "erp_t4                   syn  -ilp 1 -t 4 -erp"
+  "bd10cf444_t4             syn  -ilp 1 -t 4 -bd 10 -cf 444"
+  "file_t4                  file -t 4"
+  "file_ivpsnr_only_t1      file -t 1 -c ${WorkDir}/ivpsnr_only.cfg"
+  "file_ivpsnr_only_t4      file -t 4 -c ${WorkDir}/ivpsnr_only.cfg"
+  "file_ivpsnr_only_rdm2_t4 file -t 4 -c ${WorkDir}/ivpsnr_only.cfg -rdm 2"
+)
+FileArgs="-i0 ${WorkDir}/ref.yuv -i1 ${WorkDir}/tst.yuv -w ${Width} -h ${Height} -l ${Frames} -v 1"
+FilesWritten=0
+
+#baseline lookup: "Key FramesPerSecond PeakRSS"
+declare -A BaseFps BaseRss
+if [ -f "${BaselineFile}" ]; then
+  while read -r Key Fps Rss; do
+    case "${Key}" in ""|\#*) continue;; esac
+    BaseFps["${Key}"]="${Fps}"; BaseRss["${Key}"]="${Rss}"
+  done < "${BaselineFile}"
+fi
+
+Failed=0
+Results=()
+printf "%-34s %10s %10s %8s %10s %10s %8s  %s\n" "Config" "FPS" "BaseFPS" "dFPS" "RSS[MiB]" "BaseRSS" "dRSS" "Status"
+for Config in "${Configs[@]}"; do
+  read -r Name Source Args <<< "${Config}"
+  Key="${Name}@${Width}x${Height}"
+  if [ -n "${Filter}" ] && [[ "${Key}" != *"${Filter}"* ]]; then continue; fi
+
+  if [ "${Source}" == "file" ]; then
+    CommonArgs="${FileArgs}"
+    if [ ${FilesWritten} -eq 0 ]; then
+      Log=$("${Binary}" -syn 2 ${SynArgs} -i0 "${WorkDir}/ref.yuv" -i1 "${WorkDir}/tst.yuv" 2>&1)
+      if [ $? -ne 0 ] || ! grep -q "END-OF-LOG" <<< "${Log}"; then echo "ERROR --> input files generation failed (-syn 2 ${SynArgs})"; echo "${Log}" | tail -n 20; exit 2; fi
+      FilesWritten=1
+    fi
+  else
+    CommonArgs="-syn 1 ${SynArgs}"
+  fi
+
+  BestFps=0
+  MaxRss=0
+  for (( R=0; R<Repeats; R++ )); do
+    Log=$("${Binary}" ${CommonArgs} ${Args} 2>&1)
+    if [ $? -ne 0 ] || ! grep -q "END-OF-LOG" <<< "${Log}"; then echo "ERROR --> run failed (${Name}: ${CommonArgs} ${Args})"; echo "${Log}" | tail -n 20; exit 2; fi
+    Fps=$(awk '/^FramesPerSecond/ { print $2 }' <<< "${Log}")
+    Rss=$(awk '/^PeakRSS/         { print $2 }' <<< "${Log}")
+    BestFps=$(awk -v A="${BestFps}" -v B="${Fps}" 'BEGIN { print (B > A ? B : A) }')
+    MaxRss=$( awk -v A="${MaxRss}"  -v B="${Rss:-0}" 'BEGIN { print (B > A ? B : A) }')
+  done
+  Results+=("${Key} ${BestFps} ${MaxRss}")
+
+  if [ -z "${BaseFps[${Key}]}" ]; then
+    if [ ${Update} -eq 1 ]; then Status="NEW"; else Status="NO-BASELINE"; Failed=1; fi
+    printf "%-34s %10.2f %10s %8s %10.1f %10s %8s  %s\n" "${Key}" "${BestFps}" "-" "-" "${MaxRss}" "-" "-" "${Status}"
+    continue
+  fi
+  read -r DFps DRss Status <<< "$(awk -v F="${BestFps}" -v BF="${BaseFps[${Key}]}" -v M="${MaxRss}" -v BM="${BaseRss[${Key}]}" -v TF="${FpsTolerance}" -v TM="${RssTolerance}" 'BEGIN {
+    DF = BF > 0 ? F / BF - 1 : 0; DM = BM > 0 ? M / BM - 1 : 0; S = "OK";
+    if(DF < -TF) { S = "FPS-REGRESSION"; }
+    if(DM >  TM) { S = (S == "OK" ? "RSS-REGRESSION" : S "+RSS"); }
+    printf("%+.1f%% %+.1f%% %s\n", 100 * DF, 100 * DM, S) }')"
+  printf "%-34s %10.2f %10.2f %8s %10.1f %10.1f %8s  %s\n" "${Key}" "${BestFps}" "${BaseFps[${Key}]}" "${DFps}" "${MaxRss}" "${BaseRss[${Key}]}" "${DRss}" "${Status}"
+  if [ "${Status}" != "OK" ]; then Failed=1; fi
+done
+
+if [ ${Update} -eq 1 ]; then
+  #keep entries of configurations (or resolutions) not measured in this run
+  for Result in "${Results[@]}"; do
+    read -r Key Fps Rss <<< "${Result}"
+    BaseFps["${Key}"]="${Fps}"; BaseRss["${Key}"]="${Rss}"
+  done
+  {
+    echo "# IVPSNR end-to-end performance baseline - generated by perf_regression.sh -u"
+    echo "# Config@Resolution  FramesPerSecond  PeakRSS[MiB]"
+    for Key in $(printf "%s\n" "${!BaseFps[@]}" | sort); do echo "${Key} ${BaseFps[${Key}]} ${BaseRss[${Key}]}"; done
+  } > "${BaselineFile}"
+  echo "Baseline updated (${BaselineFile})"
+  exit 0
+fi
+
+if [ ${Failed} -ne 0 ]; then echo "PERFORMANCE REGRESSION DETECTED (or missing baseline entries - create them with -u)"; exit 1; fi
+echo "No performance regression"
+exit 0
@@ -39,14 +39,21 @@
 
 #include "xFile.h"
 #include "xSeq.h"
+#include "xSeqGen.h"
+#include "xSeqBatchReader.h"
 #include "xIVPSNR.h"
 #include "xCfgINI.h"
+#include "xResources.h"
+#include "xStageTimer.h"
+#include "xPerfCounters.h"
+#include "xMemory.h"
 #include "xUtilsOCV.h"
 #include <math.h>
 #include <fstream>
 #include <time.h>
 #include <limits>
 #include <numeric>
+#include <algorithm>
 #include <cassert>
 #include <thread>
 #include <iostream>
@@ -84,14 +91,20 @@ Usage:
  Cmd | ParamName        | Description
  -i0   InputFile0         File path - sequence 0
  -i1   InputFile1         File path - sequence 1
- -w    PictureWidth       Width of sequence
- -h    PictureHeight      Height of sequence
+                          ("-"=stdin, pipes and FIFOs are read until EOF)
+                          (Y4M is detected, picture params taken from header)
+ -w    PictureWidth       Width of sequence  (optional for Y4M)
+ -h    PictureHeight      Height of sequence (optional for Y4M)
  -bd   BitDepth           Bit depth     (optional, default 8, up to 14) 
  -cf   ChromaFormat       Chroma format (optional, default 420) [420, 444]
+ -fl0  FileLayout0        Sample layout of sequence 0 file (optional, default 0)
+                          [0=planar, 1=semi-planar 420 (NV12 for 8 bit, MSB aligned
+                          P010/P016 otherwise), 2=v210 (10 bit 422, BitDepth=10)]
+ -fl1  FileLayout1        Sample layout of sequence 1 file (optional, default 0)
  -s0   StartFrame0        Start frame   (optional, default 0) 
  -s1   StartFrame1        Start frame   (optional, default 0) 
  -l    NumberOfFrames     Number of frames to be processed 
-                          (optional, default -1=all)
+                          (optional, default -1=all, for streams until end of shortest one)
  -o    OutputFile         Output file path (optional)
 
  -im   InputFileM         File path - mask (optional)
@@ -117,11 +130,52 @@ Usage:
                           optional, default=1)
 
  -t    NumberOfThreads    Number of worker threads
-                          (optional, default -1=all, suggested 4-8)
+                          (optional, default -1=all available, suggested 4-8)
+                          (available CPUs respect affinity mask and cgroup CPU quota/cpuset)
+ -aff  ThreadAffinity     Worker threads affinity and NUMA placement
+                          (optional, default 0) [0=none, 1=NUMA node groups, 2=pin to cores]
  -ilp  InterleavedPic     Use additional image buffer with interleaved layout for IVPSNR 
                           (improves performance at a cost of increased memory usage
                           optional, default=1)
+ -rdm  ReadMode           Input file reading method (optional, default 0)
+                          [0=stdio - read into intermediate buffer,
+                           1=mmap - unpack directly from memory mapped file,
+                           2=io_uring - all inputs read with single batched submission,
+                             next frame is read during processing (Linux, falls back to pread)
+                           3=io_uring + O_DIRECT - as 2, bypasses page cache]
+ -rah  ReadAhead          Number of frames loaded ahead by dedicated I/O thread per input
+                          (optional, default 0=disabled, -1=auto - limited by available memory)
+ -fpp  FusedPrep          Unpack, check, extend and interleave input frames in single pass
+                          (optional, default=1)
+ -n8b  Native8bit         Keep interleaved pictures of 8-bit content in 8-bit samples
+                          (halves IVPSNR memory traffic, not used with mask,
+                          optional, default=1)
+ -hp   HugePages          Back picture buffers with 2MB huge pages (reduces dTLB misses)
+                          [0=disabled, 1=transparent (madvise),
+                           2=explicit (MAP_HUGETLB, requires vm.nr_hugepages, falls back to 1)]
+                          (Linux, optional, default=0)
  -v    VerboseLevel       Verbose level (optional, default=2)
+ -tf   TimingFile         Stage timing output file - per stage min/median/p99 and
+                          per-frame histograms in JSON format (optional, default=empty)
+ -hpc  PerfCounters       Collect performance counters (Linux perf_event_open) for frame level
+                          stages - IPC, backend stalls, LLC bytes per pixel, dTLB misses, CPU time
+                          reported next to AvgTime lines (optional, default=0, requires -v 3)
+ -trf  TraceFile          Timeline trace output file - frames, stages and thread pool
+                          tasks in Chrome trace-event JSON format (chrome://tracing,
+                          ui.perfetto.dev) (optional, default=empty)
+
+ -syn  Synthetic          Synthetic input sequences (optional, default 0)
+                          [0=read InputFile0/1/M,
+                           1=generate in memory - no disk I/O, InputFile0/1/M are not used,
+                           2=write generated sequences to InputFile0/1/M and exit]
+                          Synthetic modes require NumberOfFrames
+ -sm   SynMask            Generate mask sequence (flag, default disabled)
+ -sn   SynNoise           Test sequence noise amplitude (optional, default -1=auto)
+ -sx   SynShiftX          Test sequence horizontal displacement (optional, default 0)
+ -sy   SynShiftY          Test sequence vertical displacement (optional, default 0)
+ -so   SynColorOffset     Test sequence per component offset
+                          ("Lm:Cb:Cr:0" - nonnegative integers, default "0:0:0:0")
+ -ss   SynSeed            Synthetic content seed (optional, default 99184151)
 
  -c    "config.cfg"       External config file - in INI format (optional)
 
@@ -129,13 +183,20 @@ VerboseLevel:
   0 = final PSNR, WSPSNR, IVPSNR values only
   1 = 0 + configuration + detected frame numbers
   2 = 1 + argc/argv + frame level PSNR, WSPSNR, IVPSNR
-  3 = 2 + computing time (LOAD, PSNR, WSPSNR, IVPSNR)
+  3 = 2 + computing time (LOAD, PSNR, WSPSNR, IVPSNR, flow) + stage min/median/p99
+          + thread pool statistics (utilization, queue wait, task time)
+          + flow plane pool statistics (borrows, reuse, created units)
+          + huge page allocation statistics (for HugePages != 0)
           (uses high_resolution_clock, could slightly slow down computations)
   4 = 3 + IVPSNR specific debug data (GlobalColorShift, R2T+T2R)
+          + frame level thread pool utilization
 
 Example - commandline parameters:
   IVPSNR -i0 "A.yuv" -i1 "B.yuv" -w 2048 -h 1088 -bd 10 -cf 420 -v 3 -o "o.txt"
 
+Example - in memory synthetic 8K ERP run (throughput without disk I/O):
+  IVPSNR -syn 1 -w 8192 -h 4096 -bd 10 -erp -l 16 -sn 8 -sx 2 -v 3
+
 Example - config file:
   InputFile0      = "A.yuv"
   InputFile1      = "B.yuv"
@@ -179,6 +240,8 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-h"  , "", "PictureHeight"       ));
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-bd" , "", "BitDepth"            ));
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-cf" , "", "ChromaFormat"        ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-fl0", "", "FileLayout0"         ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-fl1", "", "FileLayout1"         ));
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-s0" , "", "StartFrame0"         ));
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-s1" , "", "StartFrame1"         ));
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-l"  , "", "NumberOfFrames"      ));
@@ -194,33 +257,43 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-unc", "", "UnnoticeableCoef"    )); 
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-ws8", "", "Legacy8bitWSPSNR"    ));  
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-t"  , "", "NumberOfThreads"     ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-aff", "", "ThreadAffinity"      ));
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-ilp", "", "InterleavedPic"      ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-rdm", "", "ReadMode"            ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-rah", "", "ReadAhead"           ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-fpp", "", "FusedPrep"           ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-n8b", "", "Native8bit"          ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-hp" , "", "HugePages"           ));
   CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-v"  , "", "VerboseLevel"        ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-tf" , "", "TimingFile"          ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-trf", "", "TraceFile"           ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-hpc", "", "PerfCounters"        ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-syn", "", "Synthetic"           ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-sm" , "", "SynMask"        , "1"));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-sn" , "", "SynNoise"            ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-sx" , "", "SynShiftX"           ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-sy" , "", "SynShiftY"           ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-so" , "", "SynColorOffset"      ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-ss" , "", "SynSeed"             ));
   
 
   bool CommandlineResult = CfgParser.loadFromCommandline(argc, argv);
   if(!CommandlineResult) { xCfgINI::printErrorMessage("! invalid commandline\n", HelpString); return EXIT_FAILURE; }
    
-  //TODO: temp variables, to be changed later
-   
-  bool CalcCheckFlow = true;
-  bool CalcPSNRFlow = true;
-  bool CalcIVPSNRFlow = true;
-  bool CalcIVPSNRFlowOnly = true;
-
-  //TODO: temp variables, to be changed later
-
   //readed from commandline/config 
   constexpr int32 NumInputsMax = 3;
 
   std::string InputFile [NumInputsMax];
   int32       StartFrame[2];
+  int32       FileLayout[2];
               InputFile[0]       = CfgParser.getParam1stArg("InputFile0"      , std::string(""));
               InputFile[1]       = CfgParser.getParam1stArg("InputFile1"      , std::string(""));  
   int32       PictureWidth       = CfgParser.getParam1stArg("PictureWidth"    , NOT_VALID      );
   int32       PictureHeight      = CfgParser.getParam1stArg("PictureHeight"   , NOT_VALID      );
   int32       BitDepth           = CfgParser.getParam1stArg("BitDepth"        , 8              );  
   int32       ChromaFormat       = CfgParser.getParam1stArg("ChromaFormat"    , 420            );
+              FileLayout[0]      = CfgParser.getParam1stArg("FileLayout0"     , 0              );
+              FileLayout[1]      = CfgParser.getParam1stArg("FileLayout1"     , 0              );
               StartFrame[0]      = CfgParser.getParam1stArg("StartFrame0"     , 0              );
               StartFrame[1]      = CfgParser.getParam1stArg("StartFrame1"     , 0              );
   int32       NumberOfFrames     = CfgParser.getParam1stArg("NumberOfFrames"  , -1             );  
@@ -231,6 +304,10 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
   bool        Calc__PSNR         = CfgParser.getParam1stArg("Calc__PSNR"      , true);
   bool        CalcWSPSNR         = CfgParser.getParam1stArg("CalcWSPSNR"      , true);
   bool        CalcIVPSNR         = CfgParser.getParam1stArg("CalcIVPSNR"      , true);
+  bool        CalcCheckFlow      = CfgParser.getParam1stArg("CalcCheckFlow"   , true);
+  bool        CalcPSNRFlow       = CfgParser.getParam1stArg("CalcPSNRFlow"    , true);
+  bool        CalcIVPSNRFlow     = CfgParser.getParam1stArg("CalcIVPSNRFlow"  , true);
+  bool        CalcIVPSNRFlowOnly = CfgParser.getParam1stArg("CalcIVPSNRFlowOnly", true);
   bool        IsEquirectangular  = CfgParser.getParam1stArg("Equirectangular" , false          );
   int32       LonRangeDeg        = CfgParser.getParam1stArg("LonRangeDeg"     , 360            );
   int32       LatRangeDeg        = CfgParser.getParam1stArg("LatRangeDeg"     , 180            );
@@ -241,17 +318,89 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
   flt32V4     UnnoticeableCoef   = xString::scanFltWeights(UnnoticeableCoefS);
   bool        Legacy8bitWSPSNR   = CfgParser.getParam1stArg("Legacy8bitWSPSNR", true           );
   int32       NumberOfThreads    = CfgParser.getParam1stArg("NumberOfThreads" , NOT_VALID      );
+  int32       ThreadAffinity     = CfgParser.getParam1stArg("ThreadAffinity"  , 0              );
   bool        InterleavedPic     = CfgParser.getParam1stArg("InterleavedPic"  , true           );
+  int32       ReadMode           = CfgParser.getParam1stArg("ReadMode"        , 0              );
+  int32       ReadAhead          = CfgParser.getParam1stArg("ReadAhead"       , 0              );
+  bool        FusedPrep          = CfgParser.getParam1stArg("FusedPrep"       , true           );
+  bool        Native8bit         = CfgParser.getParam1stArg("Native8bit"      , true           );
+  int32       HugePages          = CfgParser.getParam1stArg("HugePages"       , 0              );
   int32       VerboseLevel       = CfgParser.getParam1stArg("VerboseLevel"    , 1              );
+  std::string TimingFile         = CfgParser.getParam1stArg("TimingFile"      , std::string(""));
+  std::string TraceFile          = CfgParser.getParam1stArg("TraceFile"       , std::string(""));
+  bool        PerfCounters       = CfgParser.getParam1stArg("PerfCounters"    , false          );
+  int32       Synthetic          = CfgParser.getParam1stArg("Synthetic"       , 0              );
+  bool        SynMask            = CfgParser.getParam1stArg("SynMask"         , false          );
+  int32       SynNoise           = CfgParser.getParam1stArg("SynNoise"        , NOT_VALID      );
+  int32       SynShiftX          = CfgParser.getParam1stArg("SynShiftX"       , 0              );
+  int32       SynShiftY          = CfgParser.getParam1stArg("SynShiftY"       , 0              );
+  std::string SynColorOffsetS    = CfgParser.getParam1stArg("SynColorOffset"  , std::string("0:0:0:0"));
+  int32V4     SynColorOffset     = xString::scanIntWeights(SynColorOffsetS);
+  int32       SynSeed            = CfgParser.getParam1stArg("SynSeed"         , (int32)xSeqGen::c_DefSeed);
 
   if(VerboseLevel >= 2) { fmt::printf("Commandline args:\n");  xCfgINI::printCommandlineArgs(argc, argv); }
 
+  //Y4M inputs - picture parameters are taken from stream header, explicitly given ones (or header of InputFile0) have to match it
+  std::vector<xSeq> Sequence(NumInputsMax);
+  bool              IsY4M  [NumInputsMax] = { false };
+  xSeq::xY4MInfo    Y4MInfo[NumInputsMax];
+  std::string       Y4MMsg;
+  for(int32 i = 0; i < NumInputsMax && Synthetic == 0; i++)
+  {
+    if(InputFile[i].empty()) { continue; }
+    if(InputFile[i] == xFile::c_StdStreamName && std::find(InputFile, InputFile + i, InputFile[i]) != InputFile + i) { continue; } //stdin used twice is reported by config check
+    xSeq::xY4MInfo& Y4M = Y4MInfo[i];
+    if(xFile::isStream(InputFile[i]))
+    {
+      //stream header can be read only once - stream is opened here and kept open
+      if(Sequence[i].openFile(InputFile[i], xSeq::eMode::Read).getResult() != xSeq::eRetv::Success) { xPrintError(fmt::sprintf("ERROR --> InputFile opening failure (%s)", InputFile[i])); return EXIT_FAILURE; }
+      IsY4M[i] = Sequence[i].getFormat() == xSeq::eFormat::Y4M;
+      Y4M      = Sequence[i].getY4MInfo();
+    }
+    else
+    {
+      IsY4M[i] = xSeq::probeFormat(InputFile[i], Y4M) == xSeq::eFormat::Y4M;
+      if(IsY4M[i] && !Y4M.isValid()) { xPrintError(fmt::sprintf("ERROR --> InputFile has invalid or unsupported Y4M header (%s)", InputFile[i])); return EXIT_FAILURE; }
+    }
+    if(!IsY4M[i]) { continue; }
+
+    const bool HeaderOf0 = i == 1 && IsY4M[0];
+    auto ApplyY4M = [&](const std::string& ParamName, int32& Value, int32 Y4MValue, bool Fixed)
+    {
+      if((Fixed || CfgParser.findParam(ParamName)) && Value != Y4MValue) { Y4MMsg += fmt::sprintf("CONFIGURATION ERROR: %s=%d does not match Y4M header of %s (%d)\n", ParamName, Value, InputFile[i], Y4MValue); }
+      Value = Y4MValue;
+    };
+    if(i < 2)
+    {
+      ApplyY4M("PictureWidth" , PictureWidth , Y4M.Size.getX()  , HeaderOf0);
+      ApplyY4M("PictureHeight", PictureHeight, Y4M.Size.getY()  , HeaderOf0);
+      ApplyY4M("BitDepth"     , BitDepth     , Y4M.BitDepth     , HeaderOf0);
+      ApplyY4M("ChromaFormat" , ChromaFormat , Y4M.ChromaFormat , HeaderOf0);
+    }
+    else
+    {
+      if(Y4M.Size != int32V2(PictureWidth, PictureHeight)) { Y4MMsg += fmt::sprintf("CONFIGURATION ERROR: Picture size of Y4M mask %s does not match PictureWidth and PictureHeight\n", InputFile[i]); }
+      ApplyY4M("BitDepthM"    , BitDepthM    , Y4M.BitDepth     , false);
+      ApplyY4M("ChromaFormatM", ChromaFormatM, Y4M.ChromaFormat , false);
+    }
+    //mask parameters default to (header provided) picture parameters
+    if(i == 1 || (i == 0 && !IsY4M[1]))
+    {
+      if(!CfgParser.findParam("BitDepthM"    )) { BitDepthM     = BitDepth    ; }
+      if(!CfgParser.findParam("ChromaFormatM")) { ChromaFormatM = ChromaFormat; }
+    }
+  }
+
   //derrived
   const int32V2 PictureSize   = { PictureWidth, PictureHeight };
-  const int32   PictureMargin = xRoundUpToNearestMultiple(SearchRange, 2);
   const int32   WindowSize    = 2 * SearchRange + 1;
+  //margins are read only by search window (IV-PSNR and flow based IV-PSNR variants) - exactly SearchRange samples are reachable, no margin when no metric searches
+  const bool    SearchPic     = CalcIVPSNR || CalcCheckFlow || CalcIVPSNRFlow;
+  const bool    SearchFlow    = CalcCheckFlow || CalcIVPSNRFlow || CalcIVPSNRFlowOnly;
+  const int32   PictureMargin = SearchPic  ? SearchRange : 0;
+  const int32   FlowMargin    = SearchFlow ? SearchRange : 0;
 
-  const bool    UseMask       = !InputFile[2].empty();
+  const bool    UseMask       = Synthetic != 0 ? SynMask : !InputFile[2].empty();
   const int32   NumInputsCur  = !UseMask ? 2 : 3;
   const std::string Suffix    = !UseMask ? "" : "-M";
 
@@ -271,22 +420,25 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
   if(VerboseLevel >= 1)
   {
     fmt::printf("Run-time configuration:\n");
-    fmt::printf("InputFile0       = %s\n"  , InputFile[0]     );
-    fmt::printf("InputFile1       = %s\n"  , InputFile[1]     );    
+    fmt::printf("InputFile0       = %s%s\n", InputFile[0], IsY4M[0] ? "  (Y4M)" : "");
+    fmt::printf("InputFile1       = %s%s\n", InputFile[1], IsY4M[1] ? "  (Y4M)" : "");
     fmt::printf("PictureWidth     = %d\n"  , PictureWidth     );
     fmt::printf("PictureHeight    = %d\n"  , PictureHeight    );
     fmt::printf("BitDepth         = %d\n"  , BitDepth         );
     fmt::printf("ChromaFormat     = %d\n"  , ChromaFormat     );
+    fmt::printf("FileLayout0      = %d  (%s)\n", FileLayout[0], xSeq::LayoutToString((xSeq::eLayout)FileLayout[0]));
+    fmt::printf("FileLayout1      = %d  (%s)\n", FileLayout[1], xSeq::LayoutToString((xSeq::eLayout)FileLayout[1]));
     fmt::printf("StartFrame0      = %d\n"  , StartFrame[0]    );
     fmt::printf("StartFrame1      = %d\n"  , StartFrame[1]    );
     fmt::printf("NumberOfFrames   = %d%s\n", NumberOfFrames, NumberOfFrames==NOT_VALID ? "  (all)" : "");
     fmt::printf("OutputFile       = %s\n"  , OutputFile.empty() ? "(unused)" : OutputFile);
-    fmt::printf("InputFileM       = %s\n"  , InputFile[2].empty() ? "(unused)" : InputFile[2]);
+    fmt::printf("InputFileM       = %s%s\n", InputFile[2].empty() ? "(unused)" : InputFile[2], IsY4M[2] ? "  (Y4M)" : "");
     fmt::printf("BitDepthM        = %d\n"  , BitDepthM        );
     fmt::printf("ChromaFormatM    = %d\n"  , ChromaFormatM    );
     fmt::printf("Calc__PSNR       = %d\n"  , Calc__PSNR       );
     fmt::printf("CalcWSPSNR       = %d\n"  , CalcWSPSNR       );
     fmt::printf("CalcIVPSNR       = %d\n"  , CalcIVPSNR       );
+    fmt::printf("CalcFlow         = %d %d %d %d  (Check PSNR IVPSNR IVPSNROnly)\n", CalcCheckFlow, CalcPSNRFlow, CalcIVPSNRFlow, CalcIVPSNRFlowOnly);
     fmt::printf("Equirectangular  = %d\n"  , IsEquirectangular);
     fmt::printf("LonRangeDeg      = %d\n"  , LonRangeDeg      );
     fmt::printf("LatRangeDeg      = %d\n"  , LatRangeDeg      );
@@ -295,37 +447,107 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
     fmt::printf("UnnoticeableCoef = %s%s\n", xString::formatFltWeights(UnnoticeableCoef), UnnoticeableCoef == xIVPSNR::c_DefaultUnntcbCoef ? "  (default)" : "  (custom)");
     fmt::printf("Legacy8bitWSPSNR = %d\n"  , Legacy8bitWSPSNR );
     fmt::printf("NumberOfThreads  = %d%s\n", NumberOfThreads, NumberOfThreads == NOT_VALID ? "  (all)" : "");
+    fmt::printf("ThreadAffinity   = %d  (%s)\n", ThreadAffinity, xTopology::AffinityToString((xTopology::eAffinity)ThreadAffinity));
     fmt::printf("InterleavedPic   = %d\n"  , InterleavedPic   );
+    fmt::printf("ReadMode         = %d  (%s)\n", ReadMode, ReadMode == 1 ? "mmap" : ReadMode == 2 ? "io_uring" : ReadMode == 3 ? "io_uring+O_DIRECT" : "stdio");
+    fmt::printf("ReadAhead        = %d%s\n", ReadAhead, ReadAhead < 0 ? "  (auto)" : ReadAhead == 0 ? "  (disabled)" : "");
+    fmt::printf("FusedPrep        = %d\n"  , FusedPrep        );
+    fmt::printf("Native8bit       = %d\n"  , Native8bit       );
+    fmt::printf("HugePages        = %d  (%s)\n", HugePages, xMemory::HugePagesToString((xMemory::eHugePages)HugePages));
     fmt::printf("VerboseLevel     = %d\n"  , VerboseLevel     );    
+    fmt::printf("TimingFile       = %s\n"  , TimingFile.empty() ? "(unused)" : TimingFile);
+    fmt::printf("PerfCounters     = %d\n"  , PerfCounters     );
+    fmt::printf("TraceFile        = %s%s\n", TraceFile.empty() ? "(unused)" : TraceFile, !TraceFile.empty() && !USE_TRACE ? "  (ignored - build with USE_TRACE=0)" : "");
+    fmt::printf("Synthetic        = %d%s\n", Synthetic, Synthetic == 1 ? "  (in memory)" : Synthetic == 2 ? "  (write files)" : "");
+    if(Synthetic != 0)
+    {
+      fmt::printf("SynMask          = %d\n"  , SynMask          );
+      fmt::printf("SynNoise         = %d%s\n", SynNoise, SynNoise == NOT_VALID ? "  (auto)" : "");
+      fmt::printf("SynShift         = %d:%d\n", SynShiftX, SynShiftY);
+      fmt::printf("SynColorOffset   = %s\n"  , xString::formatIntWeights(SynColorOffset));
+      fmt::printf("SynSeed          = %d\n"  , SynSeed          );
+    }
     fmt::printf("\n");
     fmt::printf("Run-time derrived parameters:\n");
     fmt::printf("WindowSize       = %dx%d\n", WindowSize, WindowSize);
     fmt::printf("PictureMargin    = %d\n"   , PictureMargin);
+    fmt::printf("FlowMargin       = %d\n"   , FlowMargin);
     fmt::printf("UseMask          = %d\n"   , UseMask);
     fmt::printf("\n");
   }
 
-  //check hardware concurrency
+  //check hardware concurrency and resource limits (affinity mask, cgroup cpu quota/cpuset/memory limit)
+  xResources Resources;
+  Resources.detect();
   int32 HardwareConcurency  = std::thread::hardware_concurrency();
-  int32 NumberOfThreadsUsed = NumberOfThreads < 0 ? HardwareConcurency : std::min(NumberOfThreads, HardwareConcurency);
+  int32 AvailableCpus       = Resources.getAvailableCpus();
+  int32 NumberOfThreadsUsed = NumberOfThreads < 0 ? AvailableCpus : std::min(NumberOfThreads, HardwareConcurency);
+
+  //max number of frames buffered ahead by pipeline - limited by available memory (planar pictures of all inputs per frame)
+  constexpr int32 MaxBufferingDepthLimit = 8;
+  const int64 BytesPerFrame     = (int64)NumInputsCur * xPicCommon::c_DefNumCmps * (xMax(PictureWidth, 1) + 2 * PictureMargin) * (xMax(PictureHeight, 1) + 2 * PictureMargin) * (int64)sizeof(uint16);
+  const int32 MaxBufferingDepth = Resources.calcMaxBufferingDepth(BytesPerFrame, 0, MaxBufferingDepthLimit);
+
   if (VerboseLevel >= 1)
   {
     fmt::printf("Multithreading:\n");
     fmt::printf("HardwareConcurency  = %d\n", HardwareConcurency );
-    fmt::printf("NumberOfThreadsUsed = %d\n", NumberOfThreadsUsed);
+    fmt::printf("AffinityCpus        = %d\n", Resources.getAffinityCpus());
+    fmt::printf("CGroupVersion       = %d%s\n", Resources.getCGroupVersion(), Resources.getCGroupVersion() == 0 ? "  (not detected)" : "");
+    fmt::printf("CGroupCpusetCpus    = %d%s\n", Resources.getCpusetCpus(), Resources.getCpusetCpus() == NOT_VALID ? "  (unlimited)" : "");
+    fmt::printf(Resources.getCpuQuota() > 0 ? "CGroupCpuQuota      = %.2f\n" : "CGroupCpuQuota      = %.0f  (unlimited)\n", Resources.getCpuQuota());
+    fmt::printf("AvailableCpus       = %d\n", AvailableCpus);
+    fmt::printf("NumberOfThreadsUsed = %d%s\n", NumberOfThreadsUsed, NumberOfThreads < 0 ? "  (auto = AvailableCpus)" : "");
+    fmt::printf("NumaNodes           = %d\n", xTopology::getNumNodes());
+    for(int32 n = 0; n < xTopology::getNumNodes(); n++) { fmt::printf("NumaNode%dCpus       = %s\n", n, xTopology::formatCpuList(xTopology::getNodeCpus(n))); }
+    fmt::printf("\n");
+    fmt::printf("Memory:\n");
+    fmt::printf("PhysicalMemory      = %dMB\n", Resources.getPhysicalMemory() / (1 << 20));
+    if(Resources.getCGroupMemoryLimit() != xResources::c_Unlimited) { fmt::printf("CGroupMemoryLimit   = %dMB\n", Resources.getCGroupMemoryLimit() / (1 << 20)); }
+    else                                                           { fmt::printf("CGroupMemoryLimit   = (unlimited)\n"); }
+    fmt::printf("MaxBufferingDepth   = %d\n", MaxBufferingDepth);
+    if(ReadAhead < 0) { fmt::printf("ReadAheadDepth      = %d\n", MaxBufferingDepth); }
     fmt::printf("\n");
   }
 
   //check config
-  std::string CfgMsg;
-  if (InputFile[0].empty()              ) { CfgMsg += "CONFIGURATION ERROR: InputFile0 is empty                 \n"; }
-  if (InputFile[1].empty()              ) { CfgMsg += "CONFIGURATION ERROR: InputFile1 is empty                 \n"; }
+  std::string CfgMsg = Y4MMsg;
+  if (InputFile[0].empty() && Synthetic != 1) { CfgMsg += "CONFIGURATION ERROR: InputFile0 is empty                 \n"; }
+  if (InputFile[1].empty() && Synthetic != 1) { CfgMsg += "CONFIGURATION ERROR: InputFile1 is empty                 \n"; }
   if (PictureWidth <= 0                 ) { CfgMsg += "CONFIGURATION ERROR: Invalid PictureWidth value          \n"; }
   if (PictureHeight <= 0                ) { CfgMsg += "CONFIGURATION ERROR: Invalid PictureHeight value         \n"; }
   if (BitDepth < 8 || BitDepth > 14     ) { CfgMsg += "CONFIGURATION ERROR: Invalid or unsuported BitDepth value\n"; }
   if (StartFrame[0]<0 || StartFrame[1]<0) { CfgMsg += "CONFIGURATION ERROR: StartFrame value cannot be negative \n"; }
+  if (ThreadAffinity<0 || ThreadAffinity>2) { CfgMsg += "CONFIGURATION ERROR: Invalid ThreadAffinity value        \n"; }
+  if (ReadMode<0 || ReadMode>3          ) { CfgMsg += "CONFIGURATION ERROR: Invalid ReadMode value              \n"; }
+  if (ReadMode>=2 && ReadAhead!=0       ) { CfgMsg += "CONFIGURATION ERROR: ReadAhead cannot be used with ReadMode 2/3 (io_uring reads ahead by itself)\n"; }
+  if (ReadAhead<-1                      ) { CfgMsg += "CONFIGURATION ERROR: Invalid ReadAhead value             \n"; }
+  if (HugePages<0 || HugePages>2        ) { CfgMsg += "CONFIGURATION ERROR: Invalid HugePages value             \n"; }
+  if (Synthetic<0 || Synthetic>2        ) { CfgMsg += "CONFIGURATION ERROR: Invalid Synthetic value             \n"; }
+  if (Synthetic == 0 && std::count(InputFile, InputFile + NumInputsCur, std::string(xFile::c_StdStreamName)) > 1) { CfgMsg += "CONFIGURATION ERROR: Only one input can be read from stdin\n"; }
+  for(int32 i = 0; i < 2; i++)
+  {
+    if (FileLayout[i]<0 || FileLayout[i]>2) { CfgMsg += fmt::sprintf("CONFIGURATION ERROR: Invalid FileLayout%d value\n", i); continue; }
+    if (FileLayout[i] == 0) { continue; }
+    if (FileLayout[i] == 1 && ChromaFormat != 420) { CfgMsg += fmt::sprintf("CONFIGURATION ERROR: Semi-planar FileLayout%d requires ChromaFormat=420\n", i); }
+    if (FileLayout[i] == 2 && BitDepth != 10     ) { CfgMsg += fmt::sprintf("CONFIGURATION ERROR: v210 FileLayout%d requires BitDepth=10\n", i); }
+    if (IsY4M[i]                                 ) { CfgMsg += fmt::sprintf("CONFIGURATION ERROR: FileLayout%d cannot be used with Y4M input (always planar)\n", i); }
+    if (Synthetic == 2                           ) { CfgMsg += fmt::sprintf("CONFIGURATION ERROR: FileLayout%d is read only and cannot be used with Synthetic=2\n", i); }
+  }
+  if (Synthetic != 0)
+  {
+    if (NumberOfFrames <= 0                 ) { CfgMsg += "CONFIGURATION ERROR: NumberOfFrames is required in synthetic mode\n"; }
+    if (ChromaFormat != 420 && ChromaFormat != 444) { CfgMsg += "CONFIGURATION ERROR: Invalid ChromaFormat value           \n"; }
+    if (ChromaFormat == 420 && ((PictureWidth & 1) || (PictureHeight & 1))) { CfgMsg += "CONFIGURATION ERROR: PictureWidth and PictureHeight have to be even for 420\n"; }
+    if (SynMask && (BitDepthM < 8 || BitDepthM > 14 || (ChromaFormatM != 400 && ChromaFormatM != 420 && ChromaFormatM != 444))) { CfgMsg += "CONFIGURATION ERROR: Invalid BitDepthM or ChromaFormatM value\n"; }
+    if (Synthetic == 2 && SynMask && InputFile[2].empty()) { CfgMsg += "CONFIGURATION ERROR: InputFileM is empty                 \n"; }
+    if (SynColorOffset[0] < 0 || SynNoise < NOT_VALID) { CfgMsg += "CONFIGURATION ERROR: Invalid SynColorOffset or SynNoise value\n"; }
+  }
   if (!CfgMsg.empty()) { xCfgINI::printErrorMessage(std::string("! Invalid parameters\n") + CfgMsg, HelpString); return EXIT_FAILURE; }
 
+  //picture and plane buffers allocated from now on are backed by huge pages (if requested and available)
+  xMemory::setHugePages((xMemory::eHugePages)HugePages);
+
 
   //check weights
   if (!xc_USE_RUNTIME_CMPWEIGHTS && ComponentWeights != xIVPSNR::c_DefaultCmpWeights)
@@ -367,73 +589,239 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
   //preparation
   if(VerboseLevel >= 2) { fmt::printf("Initializing:\n"); }
 
-  //file size
-  int64 SizeOfInputFile[NumInputsMax] = { 0 };
-  for(int32 i = 0; i < 2; i++)
+  const int32 BDs[NumInputsMax] = { BitDepth    , BitDepth    , BitDepthM };
+  const int32 CFs[NumInputsMax] = { FileLayout[0] == 2 ? 422 : ChromaFormat, FileLayout[1] == 2 ? 422 : ChromaFormat, ChromaFormatM }; //v210 is always 4:2:2
+  const xSeq::eLayout Layouts[NumInputsMax] = { (xSeq::eLayout)FileLayout[0], (xSeq::eLayout)FileLayout[1], xSeq::eLayout::Planar };
+
+  //synthetic sequences - Ref, Tst and Msk are generated from one texture, so InputFile0/1/M are always consistent
+  constexpr xSeqGen::eSeq SynSeqs[NumInputsMax] = { xSeqGen::eSeq::Ref, xSeqGen::eSeq::Tst, xSeqGen::eSeq::Msk };
+  xSeqGen SeqGen;
+  if(Synthetic != 0)
   {
-    if(!xFile::exist(InputFile[i])) { xPrintError(fmt::sprintf("ERROR --> InputFile does not exist (%s)", InputFile[i])); return EXIT_FAILURE; }
-    SizeOfInputFile[i] = xFile::filesize(InputFile[i]);
-    if(VerboseLevel >= 1) { fmt::printf("SizeOfInputFile%d = %d\n", i, SizeOfInputFile[i]); }
+    xSeqGen::xParams GenParams;
+    GenParams.Size         = PictureSize;
+    GenParams.BitDepth     = BitDepth;
+    GenParams.ChromaFormat = ChromaFormat;
+    GenParams.Seed         = (uint32)SynSeed;
+    GenParams.NoiseAmp     = SynNoise;
+    GenParams.Shift        = { SynShiftX, SynShiftY };
+    GenParams.ColorOffset  = SynColorOffset;
+    tTimePoint GenBeg = tClock::now();
+    SeqGen.create(GenParams);
+    tTimePoint GenEnd = tClock::now();
+    if(VerboseLevel >= 1) { fmt::printf("SynTextureTime   = %.2f s\n", std::chrono::duration_cast<tDurationS>(GenEnd - GenBeg).count()); }
   }
-
-  if(UseMask)
+  if(Synthetic == 2)
   {
-    if(!xFile::exist(InputFile[2])) { xPrintError(fmt::sprintf("ERROR --> InputFile does not exist (%s)", InputFile[2])); return EXIT_FAILURE; }
-    SizeOfInputFile[2] = xFile::filesize(InputFile[2]);
-    if(VerboseLevel >= 1) { fmt::printf("SizeOfInputFileM = %d\n", SizeOfInputFile[2]); }
+    for(int32 i = 0; i < NumInputsCur; i++)
+    {
+      xSeq::tResult WriteResult = SeqGen.writeSequence(InputFile[i], SynSeqs[i], StartFrame[xMin(i, 1)], NumberOfFrames, BDs[i], CFs[i]);
+      if(WriteResult != xSeq::eRetv::Success) { xPrintError(fmt::sprintf("ERROR --> OutputFile write error (%s)", InputFile[i])); return EXIT_FAILURE; }
+      if(VerboseLevel >= 1) { fmt::printf("Written %s (%s, %d frames)\n", InputFile[i], xSeqGen::SeqToString(SynSeqs[i]), NumberOfFrames); }
+    }
+    fmt::printf("END-OF-LOG\n");
+    return EXIT_SUCCESS;
   }
 
-  //num of frames
-  int32 NumOfFrames[NumInputsMax] = { 0 };
-  for(int32 i = 0; i < 2; i++)
+  int64 SizeOfInputFile[NumInputsMax] = { 0 };
+  int32 NumOfFrames    [NumInputsMax] = { 0 };
+  int32 FirstFrame     [NumInputsMax] = { 0 };
+  bool  IsStream       [NumInputsMax] = { false };
+  bool  AnyStream                     = false;
+  int32 NumFrames                     = 0; //NOT_VALID - unknown, inputs are read until end of shortest stream
+  if(Synthetic == 0)
   {
-    NumOfFrames[i] = xSeq::calcNumFramesInFile(PictureSize, BitDepth, ChromaFormat, SizeOfInputFile[i]);
-    if(VerboseLevel >= 1) { fmt::printf("DetectedFrames%d  = %d\n", i, NumOfFrames[i]); }
-    if(StartFrame[i] >= NumOfFrames[i]) { xPrintError(fmt::sprintf("ERROR --> StartFrame%d >= DetectedFrames%d for (%s)", i, i, InputFile[i])); return EXIT_FAILURE; }
-  }
+    //streams (stdin, pipes, FIFOs) - not opened here (opening FIFO blocks until writer appears), size and number of frames are unknown
+    for(int32 i = 0; i < NumInputsCur; i++) { IsStream[i] = xFile::isStream(InputFile[i]); AnyStream = AnyStream || IsStream[i]; }
+
+    //file size
+    for(int32 i = 0; i < 2; i++)
+    {
+      if(IsStream[i]) { if(VerboseLevel >= 1) { fmt::printf("SizeOfInputFile%d = unknown (stream)\n", i); } continue; }
+      if(!xFile::exist(InputFile[i])) { xPrintError(fmt::sprintf("ERROR --> InputFile does not exist (%s)", InputFile[i])); return EXIT_FAILURE; }
+      SizeOfInputFile[i] = xFile::filesize(InputFile[i]);
+      if(VerboseLevel >= 1) { fmt::printf("SizeOfInputFile%d = %d\n", i, SizeOfInputFile[i]); }
+    }
 
-  if(UseMask)
+    if(UseMask && IsStream[2])
+    {
+      if(VerboseLevel >= 1) { fmt::printf("SizeOfInputFileM = unknown (stream)\n"); }
+    }
+    else if(UseMask)
+    {
+      if(!xFile::exist(InputFile[2])) { xPrintError(fmt::sprintf("ERROR --> InputFile does not exist (%s)", InputFile[2])); return EXIT_FAILURE; }
+      SizeOfInputFile[2] = xFile::filesize(InputFile[2]);
+      if(VerboseLevel >= 1) { fmt::printf("SizeOfInputFileM = %d\n", SizeOfInputFile[2]); }
+    }
+
+    //num of frames
+    for(int32 i = 0; i < 2; i++)
+    {
+      if(IsStream[i]) { NumOfFrames[i] = NOT_VALID; if(VerboseLevel >= 1) { fmt::printf("DetectedFrames%d  = unknown (stream)\n", i); } continue; }
+      NumOfFrames[i] = IsY4M[i] ? Y4MInfo[i].NumFrames : xSeq::calcNumFramesInFile(PictureSize, BDs[i], CFs[i], SizeOfInputFile[i], Layouts[i]);
+      if(VerboseLevel >= 1) { fmt::printf("DetectedFrames%d  = %d\n", i, NumOfFrames[i]); }
+      if(StartFrame[i] >= NumOfFrames[i]) { xPrintError(fmt::sprintf("ERROR --> StartFrame%d >= DetectedFrames%d for (%s)", i, i, InputFile[i])); return EXIT_FAILURE; }
+    }
+
+    if(UseMask)
+    {
+      NumOfFrames[2] = IsStream[2] ? NOT_VALID : IsY4M[2] ? Y4MInfo[2].NumFrames : xSeq::calcNumFramesInFile(PictureSize, BitDepthM, ChromaFormatM, SizeOfInputFile[2]);
+      if(VerboseLevel >= 1) { if(IsStream[2]) { fmt::printf("DetectedFramesM  = unknown (stream)\n"); } else { fmt::printf("DetectedFramesM  = %d\n", NumOfFrames[2]); } }
+      for(int32 i = 0; i < 2; i++) { if(StartFrame[i] != 0) { xPrintError(fmt::sprintf("ERROR --> StartFrame%d != 0 in not supported in masked mode", i)); return EXIT_FAILURE; } }
+    }
+
+    if(!AnyStream)
+    {
+      int32 MinSeqNumFrames = xMin(NumOfFrames[0], NumOfFrames[1]);
+      int32 MinSeqRemFrames = xMin(NumOfFrames[0] - StartFrame[0], NumOfFrames[1] - StartFrame[1]);
+      NumFrames             = xMin(NumberOfFrames > 0 ? NumberOfFrames : MinSeqNumFrames, MinSeqRemFrames);
+      for(int32 i = 0; i < 2; i++) { FirstFrame[i] = xMin(StartFrame[i], NumOfFrames[i] - 1); }
+    }
+    else
+    {
+      //limited by NumberOfFrames and regular files only - streams are read until EOF (leading frames are skipped by reading)
+      NumFrames = NumberOfFrames > 0 ? NumberOfFrames : NOT_VALID;
+      for(int32 i = 0; i < 2; i++)
+      {
+        if(IsStream[i]) { FirstFrame[i] = StartFrame[i]; continue; }
+        const int32 RemFrames = NumOfFrames[i] - StartFrame[i];
+        NumFrames     = NumFrames == NOT_VALID ? RemFrames : xMin(NumFrames, RemFrames);
+        FirstFrame[i] = xMin(StartFrame[i], NumOfFrames[i] - 1);
+      }
+    }
+    if(VerboseLevel >= 1) { if(NumFrames != NOT_VALID) { fmt::printf("FramesToProcess  = %d\n", NumFrames); } else { fmt::printf("FramesToProcess  = unknown (until end of stream)\n"); } }
+    fmt::printf("\n");
+
+    if(UseMask && !IsStream[2] && NumFrames != NOT_VALID && (NumFrames > NumOfFrames[2])) { xPrintError(fmt::sprintf("ERROR --> FramesToProcess > NumOfFramesM")); return EXIT_FAILURE; }
+  }
+  else
   {
-    NumOfFrames[2] = xSeq::calcNumFramesInFile(PictureSize, BitDepthM, ChromaFormatM, SizeOfInputFile[2]);
-    if(VerboseLevel >= 1) { fmt::printf("DetectedFramesM  = %d\n", NumOfFrames[2]); }
-    for(int32 i = 0; i < 2; i++) { if(StartFrame[i] != 0) { xPrintError(fmt::sprintf("ERROR --> StartFrame%d != 0 in not supported in masked mode", i)); return EXIT_FAILURE; } }
+    NumFrames = NumberOfFrames;
+    for(int32 i = 0; i < 2; i++) { FirstFrame[i] = StartFrame[i]; }
+    if(VerboseLevel >= 1) { fmt::printf("FramesToProcess  = %d  (synthetic)\n", NumFrames); }
+    fmt::printf("\n");
   }
 
-  int32 MinSeqNumFrames = xMin(NumOfFrames[0], NumOfFrames[1]);
-  int32 MinSeqRemFrames = xMin(NumOfFrames[0] - StartFrame[0], NumOfFrames[1] - StartFrame[1]);
-  int32 NumFrames       = xMin(NumberOfFrames > 0 ? NumberOfFrames : MinSeqNumFrames, MinSeqRemFrames);
-  int32 FirstFrame[3] = { 0 };
-  for(int32 i = 0; i < 2; i++) { FirstFrame[i] = xMin(StartFrame[i], NumOfFrames[i] - 1); }
-  if(VerboseLevel >= 1) { fmt::printf("FramesToProcess  = %d\n", NumFrames); }
-  fmt::printf("\n");
+  if(Synthetic == 0) { for(int32 i = 0; i < NumInputsCur; i++) { Sequence[i].create(PictureSize, BDs[i], CFs[i], Layouts[i]); } }
+  //IV-PSNR only - file frames are unpacked directly into interleaved pictures, planar reference and test pictures are not allocated at all (mask stays planar)
+  const bool CalcFlow        = CalcCheckFlow || CalcPSNRFlow || CalcIVPSNRFlow || CalcIVPSNRFlowOnly;
+  const bool InterleavedOnly = CalcIVPSNR && InterleavedPic && FusedPrep && Synthetic == 0 && !Calc__PSNR && !CalcWSPSNR && !CalcFlow;
+  if(InterleavedOnly && VerboseLevel >= 1) { fmt::printf("InterleavedOnly  = 1  (planar Ref/Tst pictures skipped)\n\n"); }
+  //8-bit content - interleaved pictures (IVPSNR search) keep 8-bit samples, masked IVPSNR stays on 16-bit interleaved pictures
+  const bool UseNative8bit   = Native8bit && InterleavedPic && CalcIVPSNR && BitDepth <= 8 && !UseMask;
+  if(UseNative8bit && VerboseLevel >= 1) { fmt::printf("UseNative8bit    = 1  (8-bit interleaved Ref/Tst pictures)\n\n"); }
 
-  if(!InputFile[2].empty() && (NumFrames > NumOfFrames[2])) { xPrintError(fmt::sprintf("ERROR --> FramesToProcess > NumOfFramesM")); return EXIT_FAILURE; }
-  
-  const int32 BDs[NumInputsMax] = { BitDepth    , BitDepth    , BitDepthM };
-  const int32 CFs[NumInputsMax] = { ChromaFormat, ChromaFormat, ChromaFormatM };
-  std::vector<xSeq> Sequence(NumInputsCur);
-  for(int32 i = 0; i < NumInputsCur; i++) { Sequence[i].create(PictureSize, BDs[i], CFs[i]); }
   std::vector<xPicP> PictureP(NumInputsCur);
-  for(int32 i = 0; i < NumInputsCur; i++) { PictureP[i].create(PictureSize, BDs[i], PictureMargin); }
+  for(int32 i = 0; i < NumInputsCur; i++) { if(!InterleavedOnly || i >= 2) { PictureP[i].create(PictureSize, BDs[i], PictureMargin); } }
   std::vector<xPicI> PictureI(2);
-  if (InterleavedPic && CalcIVPSNR) { for (int32 i = 0; i < 2; i++) { PictureI[i].create(PictureSize, BitDepth, PictureMargin); } }
+  if (InterleavedPic && CalcIVPSNR && !UseNative8bit) { for (int32 i = 0; i < 2; i++) { PictureI[i].create(PictureSize, BitDepth, PictureMargin); } }
+  std::vector<xPicI8> PictureI8(2);
+  if (UseNative8bit) { for (int32 i = 0; i < 2; i++) { PictureI8[i].create(PictureSize, BitDepth, PictureMargin); } }
 
-  for(int32 i = 0; i < NumInputsCur; i++)
+  for(int32 i = 0; i < NumInputsCur && Synthetic == 0; i++)
   {
-    bool OpenSucces = (bool)(Sequence[i].openFile(InputFile[i], xSeq::eMode::Read));
+    const xSeq::eRead SeqReadMode = ReadMode == 1 ? xSeq::eRead::MemMap : xSeq::eRead::Stdio;
+    bool OpenSucces = Sequence[i].getFileMode() == xSeq::eMode::Read || (bool)(Sequence[i].openFile(InputFile[i], xSeq::eMode::Read, SeqReadMode)); //streams are already opened by Y4M detection
     if(!OpenSucces) { xPrintError(fmt::sprintf("ERROR --> InputFile opening failure (%s)", InputFile[i])); return EXIT_FAILURE; }
+    if(Sequence[i].getReadMode() != SeqReadMode && VerboseLevel >= 1) { fmt::printf("ReadMode fallback to %s for %s\n", xSeq::ReadModeToString(Sequence[i].getReadMode()), InputFile[i]); }
     if(FirstFrame[i] != 0) { Sequence[i].seekFrame(FirstFrame[i]); }
+    if(ReadAhead != 0) { Sequence[i].startReadAhead(ReadAhead < 0 ? MaxBufferingDepth : ReadAhead); }
+  }
+
+  //batched reader - frames of all inputs are loaded by single submission, xSeq only unpacks them
+  xSeqBatchReader BatchReader;
+  bool            UseBatchReader = false;
+  if(Synthetic == 0 && ReadMode >= 2)
+  {
+    std::vector<xSeq*> Seqs;
+    for(int32 i = 0; i < NumInputsCur; i++) { Seqs.push_back(&Sequence[i]); }
+    UseBatchReader = BatchReader.create(Seqs, ReadMode == 3);
+    if(VerboseLevel >= 1)
+    {
+      if(UseBatchReader) { fmt::printf("BatchReader %s%s%s\n", xSeqBatchReader::BackendToString(BatchReader.getBackend()), BatchReader.hasRegisteredBuffers() ? " (registered buffers)" : "", BatchReader.isDirectIO() ? " (O_DIRECT)" : ""); }
+      else               { fmt::printf("ReadMode fallback to %s\n", xSeq::ReadModeToString(xSeq::eRead::Stdio)); }
+    }
+  }
+
+  //fused frame preparation - file frames are unpacked, checked, extended and interleaved in single pass by LOAD stage (synthetic frames are generated directly into planar picture)
+  const bool          UseInterleaved = InterleavedPic && CalcIVPSNR;
+  const bool          UseFusedPrep   = FusedPrep && Synthetic == 0;
+  std::vector<boolV4> FusedCorrect(NumInputsCur, xMakeVec4(true));
+
+  //input picture source - file reader or synthetic generator
+  auto LoadPicture = [&Sequence, &PictureP, &PictureI, &PictureI8, &FusedCorrect, &SeqGen, &SynSeqs, &FirstFrame, &BatchReader, UseBatchReader, UseFusedPrep, UseInterleaved, UseNative8bit, InterleavedOnly, Synthetic](int32 i, int32 f) -> xSeq::eRetv
+  {
+    if(Synthetic != 0) { SeqGen.genFrame(&(PictureP[i]), SynSeqs[i], FirstFrame[i] + f); return xSeq::eRetv::Success; }
+    if(UseFusedPrep)
+    {
+      xPicP* PicP = InterleavedOnly && i < 2 ? nullptr : &(PictureP[i]);
+      auto ReadFused = [&](auto* PicI) -> xSeq::eRetv
+      {
+        if(UseBatchReader) { return Sequence[i].unpackFrame(PicP, PicI, BatchReader.getFrameData(i), FusedCorrect[i]).getResult(); }
+        return Sequence[i].readFrame(PicP, PicI, FusedCorrect[i]).getResult();
+      };
+      if(UseNative8bit && i < 2) { return ReadFused(&(PictureI8[i])); }
+      return ReadFused(UseInterleaved && i < 2 ? &(PictureI[i]) : nullptr);
+    }
+    if(UseBatchReader) { return Sequence[i].unpackFrame(&(PictureP[i]), BatchReader.getFrameData(i)).getResult(); }
+    return Sequence[i].readFrame(&(PictureP[i])).getResult();
+  };
+
+  //picture preparation - range check, margin extension and interleave (fused preparation only reports broken pictures)
+  auto PrepPicture = [&PictureP, &PictureI, &PictureI8, &FusedCorrect, &InputFile, UseFusedPrep, UseInterleaved, UseNative8bit, InterleavedOnly](int32 i) -> bool
+  {
+    if(UseFusedPrep)
+    {
+      if(FusedCorrect[i] == xMakeVec4(true)) { return true; }
+      if(!InterleavedOnly || i >= 2) { return PictureP[i].check(InputFile[i]); } //slow path - finds and prints broken samples
+      for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { if(!FusedCorrect[i][CmpIdx]) { fmt::printf("FILE BROKEN " + InputFile[i] + " (CMP=%d)\n", CmpIdx); break; } }
+      return false;
+    }
+    bool Correct = PictureP[i].check(InputFile[i]);
+    PictureP[i].extend();
+    if(UseInterleaved && i < 2)
+    {
+      if(UseNative8bit) { PictureI8[i].rearrangeFromPlanar(&PictureP[i]); }
+      else              { PictureI [i].rearrangeFromPlanar(&PictureP[i]); }
+    }
+    return Correct;
+  };
+
+  //performance counters - has to be enabled before worker threads are created (each worker opens own counters)
+  if(PerfCounters)
+  {
+    bool PerfCountersOK = xPerfCounters::enable();
+    if(VerboseLevel >= 1)
+    {
+      fmt::printf("PerfCounters:");
+      if(PerfCountersOK) { for(int32 c = 0; c < xPerfCounters::c_NumCounters; c++) { fmt::printf(" %s=%d", xPerfCounters::CounterToString((xPerfCounters::eCounter)c), xPerfCounters::isAvailable((xPerfCounters::eCounter)c)); } }
+      else               { fmt::printf(" unavailable (unsupported platform, missing PMU or restricted by perf_event_paranoid)"); }
+      fmt::printf("\n");
+    }
   }
 
+  //timeline trace - has to be started before worker threads are created
+  if(!TraceFile.empty()) { xTrace::start(); xTrace::setThreadName("Main"); }
+
   xThreadPool*         ThreadPool = nullptr;
   xThreadPoolInterface ThreadPoolIf;
   if(NumberOfThreadsUsed > 0)
   { 
     ThreadPool = new xThreadPool;
-    ThreadPool->create(NumberOfThreadsUsed, PictureHeight+1);
+    ThreadPool->setStatsEnabled(VerboseLevel >= 3);
+    ThreadPool->create(NumberOfThreadsUsed, PictureHeight+1, (xTopology::eAffinity)ThreadAffinity);
+    if(VerboseLevel >= 1 && ThreadPool->getNumPinFailed() > 0) { fmt::printf("AFFINITY WARNING: Failed to pin %d of %d worker threads to requested cpus.\n\n", ThreadPool->getNumPinFailed(), NumberOfThreadsUsed); }
     ThreadPoolIf.init(ThreadPool, 2);
   }  
 
+  //first touch of picture buffers by worker groups - places buffer pages on the NUMA node which processes given picture lines
+  if(ThreadPoolIf.isActive() && ThreadPool->getNumNodes() > 1)
+  {
+    for(xPicP& Pic : PictureP) { if(Pic.getNumCmps() > 0) { ThreadPoolIf.parallelFor(Pic.getBuffNumLines(), 0, [&Pic](int32 Line) { Pic.clearLines(Line, 1); }); } }
+    if(InterleavedPic && CalcIVPSNR && !UseNative8bit) { for(xPicI&  Pic : PictureI ) { ThreadPoolIf.parallelFor(Pic.getBuffNumLines(), 0, [&Pic](int32 Line) { Pic.clearLines(Line, 1); }); } }
+    if(UseNative8bit                                 ) { for(xPicI8& Pic : PictureI8) { ThreadPoolIf.parallelFor(Pic.getBuffNumLines(), 0, [&Pic](int32 Line) { Pic.clearLines(Line, 1); }); } }
+  }
+
   xTIVPSNR Processor;
   Processor.setLegacyWS8bit(Legacy8bitWSPSNR);
   Processor.setSearchRange (SearchRange     );
@@ -460,89 +848,118 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
   if(VerboseLevel >= 2) { fmt::printf("Running:\n"); }
   tTimePoint ProcessingBeg = tClock::now();
 
-  tDuration Duration__Load = tDuration(0);
-  tDuration Duration__Prep = tDuration(0);
-  tDuration Duration__PSNR = tDuration(0);
-  tDuration DurationWSPSNR = tDuration(0);
-  tDuration DurationIVPSNR = tDuration(0);
-  tDuration DurationFlowCalc = tDuration(0);
-  tDuration DurationCalcFlow = tDuration(0);
-  tDuration DurationIVPSNRFlowCheck = tDuration(0);
-  tDuration DurationPSNRFlow = tDuration(0);
-  tDuration DurationIVPSNRFlow = tDuration(0);
-  tDuration DurationIVPSNROnlyFlow = tDuration(0);
+  //stage timing - frame level stages (wall time) + stages registered by library code (xSeq, xPic, xIVPSNR)
+  xStageTimer::setEnabled(VerboseLevel >= 3 || !TimingFile.empty());
+  xStageTimer::reserveFrames(xMax(NumFrames, 0));
+  const xStageTimer::tStageId Stage__Load           = xStageTimer::registerStage("LOAD"          );
+  const xStageTimer::tStageId Stage__Prep           = xStageTimer::registerStage("PREP"          );
+  const xStageTimer::tStageId Stage__PSNR           = xStageTimer::registerStage("PSNR"          );
+  const xStageTimer::tStageId StageWSPSNR           = xStageTimer::registerStage("WSPSNR"        );
+  const xStageTimer::tStageId StageIVPSNR           = xStageTimer::registerStage("IVPSNR"        );
+  const xStageTimer::tStageId StageCalcFlow         = xStageTimer::registerStage("CalcFlow"      );
+  const xStageTimer::tStageId StageFarneback        = xStageTimer::registerStage("Flow::Farneback");
+  const xStageTimer::tStageId StageIVPSNRFlowCheck  = xStageTimer::registerStage("IVPSNRFlowCheck");
+  const xStageTimer::tStageId StagePSNRFlow         = xStageTimer::registerStage("PSNRFlow"      );
+  const xStageTimer::tStageId StageIVPSNRFlow       = xStageTimer::registerStage("IVPSNRFlow"    );
+  const xStageTimer::tStageId StageIVPSNROnlyFlow   = xStageTimer::registerStage("IVPSNRFlowOnly");
+  const int64                 PicArea               = (int64)PictureWidth * PictureHeight;
 
   std::vector<flt64> Frame__PSNR[4];
   std::vector<flt64> FrameWSPSNR[4];
-  for(int32 CmpIdx = 0; CmpIdx < 4; CmpIdx++)
-  {
-    Frame__PSNR[CmpIdx].resize(NumFrames);
-    FrameWSPSNR[CmpIdx].resize(NumFrames);
-  }
-  std::vector<flt64> FrameIVPSNR(NumFrames);
-  std::vector<flt64> FrameR2T(VerboseLevel >= 4 ? NumFrames : 0);
-  std::vector<flt64> FrameT2R(VerboseLevel >= 4 ? NumFrames : 0);
+  std::vector<flt64> FrameIVPSNR;
+  std::vector<flt64> FrameR2T;
+  std::vector<flt64> FrameT2R;
 
-  std::vector<flt64> FrameIVPSNRFlowCheck(NumFrames);
-  std::vector<flt64> FramePSNRFlow(NumFrames);
-  std::vector<flt64> FrameIVPSNRFlow(NumFrames);
-  std::vector<flt64> FrameIVPSNROnlyFlow(NumFrames);
+  std::vector<flt64> FrameIVPSNRFlowCheck;
+  std::vector<flt64> FramePSNRFlow;
+  std::vector<flt64> FrameIVPSNRFlow;
+  std::vector<flt64> FrameIVPSNROnlyFlow;
+
+  //per frame results - sized up front, or grown frame by frame when number of frames is unknown (streams)
+  auto ResizeFrameResults = [&](int32 NumFrameResults)
+  {
+    for(int32 CmpIdx = 0; CmpIdx < 4; CmpIdx++)
+    {
+      Frame__PSNR[CmpIdx].resize(NumFrameResults);
+      FrameWSPSNR[CmpIdx].resize(NumFrameResults);
+    }
+    FrameIVPSNR.resize(NumFrameResults);
+    FrameR2T   .resize(VerboseLevel >= 4 ? NumFrameResults : 0);
+    FrameT2R   .resize(VerboseLevel >= 4 ? NumFrameResults : 0);
+
+    FrameIVPSNRFlowCheck.resize(NumFrameResults);
+    FramePSNRFlow       .resize(NumFrameResults);
+    FrameIVPSNRFlow     .resize(NumFrameResults);
+    FrameIVPSNROnlyFlow .resize(NumFrameResults);
+  };
+  const bool UnknownNumFrames = NumFrames == NOT_VALID;
+  ResizeFrameResults(xMax(NumFrames, 0));
 
   bool AllExact = true;
   bool AnyFake  = false;
 
+  //thread pool statistics - Client0 = frame level tasks (load, prep, flow), Client1 = metric processor
+  xThreadPoolStats::xSnapshot ThreadPoolStatsPrev = ThreadPool ? ThreadPool->getStatistics() : xThreadPoolStats::xSnapshot();
+  xThreadPoolStats::xSnapshot ThreadPoolStatsLast = ThreadPoolStatsPrev;
+
   cv::Mat prev[2];
   cv::Mat next[2];
+  cv::Mat flow[2]; //kept across frames - calcOpticalFlowFarneback reuses already allocated output
+  xPlaneRental<flt32V2> FlowRental; //per-frame flow planes are borrowed from pool (preallocated, no allocation in frame loop)
+  if(CalcFlow) { FlowRental.create(PictureSize, BitDepth, FlowMargin, 2, 2); }
 
-  for(int32 f = 0; f < NumFrames; f++)
+  int32 NumFramesProcessed = 0;
+  for(int32 f = 0; UnknownNumFrames || f < NumFrames; f++)
   {
-    tTimePoint T0 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
+    xTrace::xScope FrameScope("Frame", "frame", f);
+    if(UnknownNumFrames) { ResizeFrameResults(f + 1); }
 
-    std::vector<bool> ReadOK(NumInputsCur, true);
-    if(ThreadPoolIf.isActive())
+    bool EndOfStream = false;
     {
-      for(int32 i = 0; i < NumInputsCur; i++) { ThreadPoolIf.addWaitingTask([&Sequence, &PictureP, &ReadOK, i](int32 /*ThreadIdx*/) { ReadOK[i] = (bool)Sequence[i].readFrame(&(PictureP[i])); }); }
-      ThreadPoolIf.waitUntilTasksFinished(NumInputsCur);
+      xStageTimer::xScope Scope(Stage__Load, NumInputsCur * PicArea);
+      xPerfCounters::xScope Perf(Stage__Load);
+      std::vector<xSeq::eRetv> ReadResult(NumInputsCur, xSeq::eRetv::Success);
+      if(UseBatchReader && !BatchReader.loadFrames()) { xPrintError("ERROR --> InputFile batched read error"); return EXIT_FAILURE; }
+      if(ThreadPoolIf.isActive())
+      {
+        for(int32 i = 0; i < NumInputsCur; i++) { ThreadPoolIf.addWaitingTask([&LoadPicture, &ReadResult, i, f](int32 /*ThreadIdx*/) { ReadResult[i] = LoadPicture(i, f); }); }
+        ThreadPoolIf.waitUntilTasksFinished(NumInputsCur);
+      }
+      else
+      {
+        for(int32 i = 0; i < NumInputsCur; i++) { ReadResult[i] = LoadPicture(i, f); }
+      }
+      for(int32 i = 0; i < NumInputsCur; i++)
+      {
+        if(ReadResult[i] == xSeq::eRetv::EndOfFile && AnyStream) { EndOfStream = true; continue; } //shortest stream ended
+        if(ReadResult[i] != xSeq::eRetv::Success) { xPrintError(fmt::sprintf("ERROR --> InputFile read error (%s)", InputFile[i])); return EXIT_FAILURE; }
+      }
     }
-    else
+    if(EndOfStream)
     {
-      for(int32 i = 0; i < NumInputsCur; i++) { ReadOK[i] = (bool)(Sequence[i].readFrame(&(PictureP[i]))); }
+      if(!UnknownNumFrames && VerboseLevel >= 1) { fmt::printf("Input stream ended after %d frames (NumberOfFrames=%d)\n", f, NumFrames); }
+      break;
     }
-    for(int32 i = 0; i < NumInputsCur; i++) { if(!ReadOK[i]) { xPrintError(fmt::sprintf("ERROR --> InputFile read error (%s)", InputFile[i])); return EXIT_FAILURE; } }
 
-    tTimePoint T1 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
-
-    std::vector<bool> CheckOK(NumInputsCur, true);
-    if(ThreadPoolIf.isActive())
     {
-      for(int32 i = 0; i < NumInputsCur; i++)
+      xStageTimer::xScope Scope(Stage__Prep, NumInputsCur * PicArea);
+      xPerfCounters::xScope Perf(Stage__Prep);
+      std::vector<int32> CheckOK(NumInputsCur, 1);
+      if(ThreadPoolIf.isActive())
       {
-        ThreadPoolIf.addWaitingTask(
-          [&PictureP, &PictureI, &CheckOK, &InputFile, InterleavedPic, i](int32 /*ThreadIdx*/)
-          {
-            CheckOK[i] = PictureP[i].check(InputFile[i]);
-            PictureP[i].extend();
-            if(InterleavedPic && i<2) { PictureI[i].rearrangeFromPlanar(&PictureP[i]); }
-          }
-        );
+        for(int32 i = 0; i < NumInputsCur; i++) { ThreadPoolIf.addWaitingTask([&PrepPicture, &CheckOK, i](int32 /*ThreadIdx*/) { CheckOK[i] = PrepPicture(i); }); }
+        ThreadPoolIf.waitUntilTasksFinished(NumInputsCur);
       }
-      ThreadPoolIf.waitUntilTasksFinished(NumInputsCur);
-    }
-    else
-    {
-      for(int32 i = 0; i < NumInputsCur; i++)
+      else
       {
-        CheckOK[i] = PictureP[i].check(InputFile[i]);
-        PictureP[i].extend();
-        if(InterleavedPic && i < 2) { PictureI[i].rearrangeFromPlanar(&PictureP[i]); }
+        for(int32 i = 0; i < NumInputsCur; i++) { CheckOK[i] = PrepPicture(i); }
       }
     }
-    
-
-    tTimePoint T2 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
 
     if(Calc__PSNR)
     {
+      xStageTimer::xScope Scope(Stage__PSNR, PicArea);
+      xPerfCounters::xScope Perf(Stage__PSNR);
       flt64V4 PSNR  = xMakeVec4(0.0  );
       boolV4  Exact = xMakeVec4(false);
       if(UseMask) { std::tie(PSNR, Exact) = Processor.calcPicPSNRM(&PictureP[0], &PictureP[1], &PictureP[2]); }
@@ -566,10 +983,10 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
       }
     }
 
-    tTimePoint T3 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
-
     if(CalcWSPSNR)
     {
+      xStageTimer::xScope Scope(StageWSPSNR, PicArea);
+      xPerfCounters::xScope Perf(StageWSPSNR);
       flt64V4 WSPSNR = xMakeVec4(0.0  );
       boolV4  Exact  = xMakeVec4(false);
 
@@ -592,19 +1009,26 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
       }
     }
 
-    tTimePoint T4 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
-
     if(CalcIVPSNR)
     {
+      xStageTimer::xScope Scope(StageIVPSNR, PicArea);
+      xPerfCounters::xScope Perf(StageIVPSNR);
       flt64 IVPSNR = 0.0;
-      if(!InputFile[2].empty())
+      if(InterleavedOnly)
+      {
+        if     (UseMask      ) { IVPSNR = Processor.calcPicIVPSNRM(&PictureI [0], &PictureI [1], &PictureP[2]); }
+        else if(UseNative8bit) { IVPSNR = Processor.calcPicIVPSNR (&PictureI8[0], &PictureI8[1]              ); }
+        else                   { IVPSNR = Processor.calcPicIVPSNR (&PictureI [0], &PictureI [1]              ); }
+      }
+      else if(UseMask)
       {
         IVPSNR = Processor.calcPicIVPSNRM(&PictureP[0], &PictureP[1], &PictureP[2], &PictureI[0], &PictureI[1]);
       }
       else
       {
-        if  (InterleavedPic) { IVPSNR = Processor.calcPicIVPSNR(&PictureP[0], &PictureP[1], &PictureI[0], &PictureI[1]); }
-        else                 { IVPSNR = Processor.calcPicIVPSNR(&PictureP[0], &PictureP[1]                            ); }
+        if     (UseNative8bit ) { IVPSNR = Processor.calcPicIVPSNR(&PictureP[0], &PictureP[1], &PictureI8[0], &PictureI8[1]); }
+        else if(InterleavedPic) { IVPSNR = Processor.calcPicIVPSNR(&PictureP[0], &PictureP[1], &PictureI [0], &PictureI [1]); }
+        else                    { IVPSNR = Processor.calcPicIVPSNR(&PictureP[0], &PictureP[1]                              ); }
       }
       FrameIVPSNR[f] = IVPSNR;
 
@@ -622,25 +1046,15 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
       }
     }
 
-    tTimePoint T5 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
-
     /*=============*/
     /*OPTICAL FLOW*/
     /*=============*/
 
-    tTimePoint T6 = tTimePoint::min();
-    tTimePoint T7 = tTimePoint::min();
-    tTimePoint T8 = tTimePoint::min();
-    tTimePoint T9 = tTimePoint::min();
-    tTimePoint T10 = tTimePoint::min();
-
     if (CalcCheckFlow || CalcPSNRFlow || CalcIVPSNRFlow || CalcIVPSNRFlowOnly) {
         flt64 IVPSNRFlowCheck = 0.0;
         flt64 PSNRFlow = 0.0;
         flt64 IVPSNRFlow = 0.0;
         flt64 IVPSNROnlyFlow = 0.0;
-        std::vector<xPlane<flt32V2>>flowPlane(2);
-        for (int32 i = 0; i < NumInputsCur; i++) { flowPlane[i].create(PictureSize, BitDepth, PictureMargin); }
 
         double pyr_scale = 0.5;
         int levels = 2;
@@ -650,6 +1064,8 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
         double poly_sigma = 1.2;
 
         if (f == 0) {
+            xStageTimer::xScope Scope(StageCalcFlow, 2 * PicArea);
+            xPerfCounters::xScope Perf(StageCalcFlow);
 
             prev[0] = cv::Mat(PictureHeight, PictureWidth, CV_16UC1);
             prev[1] = cv::Mat(PictureHeight, PictureWidth, CV_16UC1);
@@ -665,36 +1081,39 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
             FrameIVPSNROnlyFlow[f] = 0.0;
         }
         else {
-            
-            cv::Mat flow[2];
-            if (ThreadPoolIf.isActive())
+            xPlane<flt32V2>* flowPlane[2] = { FlowRental.borrow(), FlowRental.borrow() };
             {
-                for (int32 i = 0; i < 2; i++) {
-                    ThreadPoolIf.addWaitingTask([&prev, &next, &flow, &PictureP, &flowPlane, &pyr_scale, &levels, &winsize, &iterations, &poly_n, &poly_sigma, i](int32 /*ThreadIdx*/) {
-                        xUtilsOCV::xPic2Mat(PictureP[i], next[i], 1);
-                        flow[i] = (prev[i].size(), CV_32FC2);
-                        cv::calcOpticalFlowFarneback(prev[i], next[i], flow[i], pyr_scale, levels, winsize, iterations, poly_n, poly_sigma, 0);
-                        xUtilsOCV::Mat2xPlane(flow[i], flowPlane[i]);
-                        flowPlane[i].extend();
-                        });
+                xStageTimer::xScope Scope(StageCalcFlow, 2 * PicArea);
+                xPerfCounters::xScope Perf(StageCalcFlow);
+                if (ThreadPoolIf.isActive())
+                {
+                    for (int32 i = 0; i < 2; i++) {
+                        ThreadPoolIf.addWaitingTask([&prev, &next, &flow, &PictureP, &flowPlane, &pyr_scale, &levels, &winsize, &iterations, &poly_n, &poly_sigma, StageFarneback, PicArea, i](int32 /*ThreadIdx*/) {
+                            xUtilsOCV::xPic2Mat(PictureP[i], next[i], 1);
+                            flow[i].create(prev[i].size(), CV_32FC2);
+                            { xStageTimer::xScope Scope(StageFarneback, PicArea); cv::calcOpticalFlowFarneback(prev[i], next[i], flow[i], pyr_scale, levels, winsize, iterations, poly_n, poly_sigma, 0); }
+                            xUtilsOCV::Mat2xPlane(flow[i], *flowPlane[i]);
+                            flowPlane[i]->extend();
+                            });
+                    }
+                    ThreadPoolIf.waitUntilTasksFinished(2);
                 }
-                ThreadPoolIf.waitUntilTasksFinished(2);
-            }
-            else
-            {
-                for (int32 i = 0; i < 2; i++) {
-                    xUtilsOCV::xPic2Mat(PictureP[i], next[i], 1);
-                    flow[i] = (prev[i].size(), CV_32FC2);
-                    cv::calcOpticalFlowFarneback(prev[i], next[i], flow[i], pyr_scale, levels, winsize, iterations, poly_n, poly_sigma, 0);
-                    xUtilsOCV::Mat2xPlane(flow[i], flowPlane[i]);
-                    flowPlane[i].extend();
+                else
+                {
+                    for (int32 i = 0; i < 2; i++) {
+                        xUtilsOCV::xPic2Mat(PictureP[i], next[i], 1);
+                        flow[i].create(prev[i].size(), CV_32FC2);
+                        { xStageTimer::xScope Scope(StageFarneback, PicArea); cv::calcOpticalFlowFarneback(prev[i], next[i], flow[i], pyr_scale, levels, winsize, iterations, poly_n, poly_sigma, 0); }
+                        xUtilsOCV::Mat2xPlane(flow[i], *flowPlane[i]);
+                        flowPlane[i]->extend();
+                    }
                 }
             }
 
-            T6 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
-
             if (CalcCheckFlow) {
-                IVPSNRFlowCheck = Processor.calcPicIVPSNRFlowCheck(&PictureP[0], &PictureP[1], &flowPlane[0], &flowPlane[1]);
+                xStageTimer::xScope Scope(StageIVPSNRFlowCheck, PicArea);
+                xPerfCounters::xScope Perf(StageIVPSNRFlowCheck);
+                IVPSNRFlowCheck = Processor.calcPicIVPSNRFlowCheck(&PictureP[0], &PictureP[1], flowPlane[0], flowPlane[1]);
                 FrameIVPSNRFlowCheck[f] = IVPSNRFlowCheck;
                 if (VerboseLevel >= 2) {
                     fmt::printf("Frame %08d IV-PSNR-Flow-Check %8.4f", f, IVPSNRFlowCheck);
@@ -702,10 +1121,10 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
                 }
             }
 
-            T7 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
-
             if (CalcPSNRFlow) {
-                PSNRFlow = Processor.calcPicPSNRFlow(&flowPlane[0], &flowPlane[1]);
+                xStageTimer::xScope Scope(StagePSNRFlow, PicArea);
+                xPerfCounters::xScope Perf(StagePSNRFlow);
+                PSNRFlow = Processor.calcPicPSNRFlow(flowPlane[0], flowPlane[1]);
                 FramePSNRFlow[f] = PSNRFlow;
                 if (VerboseLevel >= 2) {
                     fmt::printf("Frame %08d PSNR-Flow %8.4f", f, PSNRFlow);
@@ -713,10 +1132,10 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
                 }
             }
 
-            T8 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
-
             if (CalcIVPSNRFlow) {
-                IVPSNRFlow = Processor.calcPicIVPSNRFlowUse(&PictureP[0], &PictureP[1], &flowPlane[0], &flowPlane[1]);
+                xStageTimer::xScope Scope(StageIVPSNRFlow, PicArea);
+                xPerfCounters::xScope Perf(StageIVPSNRFlow);
+                IVPSNRFlow = Processor.calcPicIVPSNRFlowUse(&PictureP[0], &PictureP[1], flowPlane[0], flowPlane[1]);
                 FrameIVPSNRFlow[f] = IVPSNRFlow;
                 if (VerboseLevel >= 2) {
                     fmt::printf("Frame %08d IV-PSNR-Flow %8.4f", f, IVPSNRFlow);
@@ -724,35 +1143,37 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
                 }
             }
 
-            T9 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
-
             if (CalcIVPSNRFlowOnly) {
-                IVPSNROnlyFlow = Processor.calcPicIVPSNROnlyFlow(&flowPlane[0], &flowPlane[1]);
+                xStageTimer::xScope Scope(StageIVPSNROnlyFlow, PicArea);
+                xPerfCounters::xScope Perf(StageIVPSNROnlyFlow);
+                IVPSNROnlyFlow = Processor.calcPicIVPSNROnlyFlow(flowPlane[0], flowPlane[1]);
                 FrameIVPSNROnlyFlow[f] = IVPSNROnlyFlow;
                 if (VerboseLevel >= 2) {
                     fmt::printf("Frame %08d IV-PSNR-Only-Flow %8.4f", f, IVPSNROnlyFlow);
                     fmt::printf("\n");
                 }
             }
-
-            T10 = (VerboseLevel >= 3) ? tClock::now() : tTimePoint::min();
+            for (int32 i = 0; i < 2; i++) { FlowRental.giveback(flowPlane[i]); }
         }
     }
 
-    Duration__Load += (T1 - T0);
-    Duration__Prep += (T2 - T1);
-    Duration__PSNR += (T3 - T2);
-    DurationWSPSNR += (T4 - T3);
-    DurationIVPSNR += (T5 - T4);
-    DurationCalcFlow += (T6 - T5);
-    DurationIVPSNRFlowCheck += (T7 - T6);
-    DurationPSNRFlow += (T8 - T7);
-    DurationIVPSNRFlow += (T9 - T8);
-    DurationIVPSNROnlyFlow += (T10 - T9);
+    xStageTimer::finishFrame();
+    NumFramesProcessed = f + 1;
+
+    if(VerboseLevel >= 4 && ThreadPool)
+    {
+      ThreadPoolStatsLast = ThreadPool->getStatistics();
+      xThreadPoolStats::xSnapshot Delta = ThreadPoolStatsLast - ThreadPoolStatsPrev;
+      xThreadPoolStats::xCounters Total = Delta.getTotal();
+      fmt::printf("Frame %08d ThreadPool Utilization %5.1f%%   Tasks %d   QueueWait p99 <%.1f us   Task p99 <%.1f us\n", f, 100.0 * Delta.getUtilization(), Total.NumTasks, Total.QueueHist.getPercentile(0.99) / 1e3, Total.TaskHist.getPercentile(0.99) / 1e3);
+      ThreadPoolStatsPrev = ThreadPoolStatsLast;
+    }
   }
   
   //==============================================================================
   //finalizing
+  if(NumFramesProcessed == 0) { xPrintError("ERROR --> No frames were read from input streams"); return EXIT_FAILURE; }
+  if(NumFramesProcessed != NumFrames) { NumFrames = NumFramesProcessed; ResizeFrameResults(NumFrames); }
   
   //summary
   flt64V4 Sum__PSNR = xMakeVec4(0.0);
@@ -778,12 +1199,19 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
   flt64   AvgIVPSNROnlyFlow = SumIVPSNROnlyFlow / (NumFrames - 1);
 
   tTimePoint  ProcessingEnd  = tClock::now();
+  if(ThreadPool) { ThreadPoolStatsLast = ThreadPool->getStatistics(); }
 
   //cleanup
+  const int64 AnonHugePages = HugePages != 0 && VerboseLevel >= 3 ? xMemory::getAnonHugePagesBytes() : NOT_VALID; //while pictures are still allocated
+  std::vector<xSeq::xReadAheadStats> ReadAheadStats(NumInputsCur);
+  for(int32 i = 0; i < NumInputsCur; i++) { ReadAheadStats[i] = Sequence[i].getReadAheadStats(); }
   for(int32 i = 0; i < 2; i++) { Sequence[i].closeFile(); }
   for(int32 i = 0; i < 2; i++) { Sequence[i].destroy(); }
   for(int32 i = 0; i < 2; i++) { PictureP[i].destroy(); }
   if (InterleavedPic) { for(int32 i = 0; i < 2; i++) { PictureI[i].destroy(); } }
+  if (UseNative8bit ) { for(int32 i = 0; i < 2; i++) { PictureI8[i].destroy(); } }
+  const xRentalCommon::xStats FlowRentalStats = FlowRental.getStats();
+  FlowRental.destroy();
   if(ThreadPool) { ThreadPool->destroy(); }
 
   //output file
@@ -834,20 +1262,90 @@ int32 IVPSNR_MAIN(int argc, char *argv[], char* /*envp*/[])
   }
   if(VerboseLevel >= 3)
   {
-    if(true      )                  { fmt::printf("AvgTime           LOAD %9.2f ms\n", std::chrono::duration_cast<tDurationMS>(Duration__Load).count() / NumFrames); }
-    if(true      )                  { fmt::printf("AvgTime           PREP %9.2f ms\n", std::chrono::duration_cast<tDurationMS>(Duration__Prep).count() / NumFrames); }
-    if(Calc__PSNR)                  { fmt::printf("AvgTime           PSNR %9.2f ms\n", std::chrono::duration_cast<tDurationMS>(Duration__PSNR).count() / NumFrames); }
-    if(CalcWSPSNR)                  { fmt::printf("AvgTime         WSPSNR %9.2f ms\n", std::chrono::duration_cast<tDurationMS>(DurationWSPSNR).count() / NumFrames); }
-    if(CalcIVPSNR)                  { fmt::printf("AvgTime         IVPSNR %9.2f ms\n", std::chrono::duration_cast<tDurationMS>(DurationIVPSNR).count() / NumFrames); }
-    if(CalcCheckFlow || CalcPSNRFlow || CalcIVPSNRFlow || CalcIVPSNRFlowOnly)             
-								    { fmt::printf("AvgTime       CalcFlow %9.2f ms\n", std::chrono::duration_cast<tDurationMS>(DurationFlowCalc).count() / NumFrames); }
-    if(CalcPSNRFlow)              	{ fmt::printf("AvgTime       PSNRFlow %9.2f ms\n", std::chrono::duration_cast<tDurationMS>(DurationFlowCalc).count() / NumFrames); }
-    if(CalcIVPSNRFlow)            	{ fmt::printf("AvgTime     IVPSNRFlow %9.2f ms\n", std::chrono::duration_cast<tDurationMS>(DurationFlowCalc).count() / NumFrames); }
-    if(CalcIVPSNRFlowOnly)        	{ fmt::printf("AvgTime IVPSNRFlowOnly %9.2f ms\n", std::chrono::duration_cast<tDurationMS>(DurationFlowCalc).count() / NumFrames); }
+    auto AvgMs = [](xStageTimer::tStageId StageId) { return xStageTimer::getSummary(StageId).AvgMs; };
+    auto Hpc   = [](xStageTimer::tStageId StageId)
+    {
+      if(!xPerfCounters::isEnabled()) { return std::string(); }
+      using eCounter = xPerfCounters::eCounter;
+      const xPerfCounters::xValues V = xPerfCounters::getStageValues(StageId);
+      const xStageTimer::xSummary  S = xStageTimer::getSummary(StageId);
+      std::string Result;
+      if(V.isValid(eCounter::Cycles) && V.isValid(eCounter::Instructions)) { Result += fmt::sprintf("   IPC %5.2f", V.getIPC()); }
+      if(V.isValid(eCounter::Cycles) && V.isValid(eCounter::StalledCyclesBackend) && V.get(eCounter::Cycles) > 0) { Result += fmt::sprintf("   BackendStall %5.1f%%", 100.0 * V.get(eCounter::StalledCyclesBackend) / V.get(eCounter::Cycles)); }
+      if(V.isValid(eCounter::LLCMisses) && S.NumPixels > 0) { Result += fmt::sprintf("   LLC %7.2f B/pix", V.get(eCounter::LLCMisses) * xc_MemSizeCacheLine / (flt64)S.NumPixels); }
+      if(V.isValid(eCounter::DTLBLoadMisses) && S.NumPixels > 0) { Result += fmt::sprintf("   dTLB %7.2f miss/kpix", V.get(eCounter::DTLBLoadMisses) * 1000.0 / (flt64)S.NumPixels); }
+      if(V.isValid(eCounter::TaskClock) && S.NumFrames > 0) { Result += fmt::sprintf("   CpuTime %9.2f ms", V.get(eCounter::TaskClock) / 1e6 / S.NumFrames); }
+      return Result;
+    };
+    if(true      )                  { fmt::printf("AvgTime           LOAD %9.2f ms%s\n", AvgMs(Stage__Load), Hpc(Stage__Load)); }
+    if(true      )                  { fmt::printf("AvgTime           PREP %9.2f ms%s\n", AvgMs(Stage__Prep), Hpc(Stage__Prep)); }
+    if(Calc__PSNR)                  { fmt::printf("AvgTime           PSNR %9.2f ms%s\n", AvgMs(Stage__PSNR), Hpc(Stage__PSNR)); }
+    if(CalcWSPSNR)                  { fmt::printf("AvgTime         WSPSNR %9.2f ms%s\n", AvgMs(StageWSPSNR), Hpc(StageWSPSNR)); }
+    if(CalcIVPSNR)                  { fmt::printf("AvgTime         IVPSNR %9.2f ms%s\n", AvgMs(StageIVPSNR), Hpc(StageIVPSNR)); }
+    if(CalcCheckFlow || CalcPSNRFlow || CalcIVPSNRFlow || CalcIVPSNRFlowOnly)
+                                    { fmt::printf("AvgTime       CalcFlow %9.2f ms%s\n", AvgMs(StageCalcFlow), Hpc(StageCalcFlow)); }
+    if(CalcCheckFlow)               { fmt::printf("AvgTime IVPSNRFlowCheck %8.2f ms%s\n", AvgMs(StageIVPSNRFlowCheck), Hpc(StageIVPSNRFlowCheck)); }
+    if(CalcPSNRFlow)                { fmt::printf("AvgTime       PSNRFlow %9.2f ms%s\n", AvgMs(StagePSNRFlow), Hpc(StagePSNRFlow)); }
+    if(CalcIVPSNRFlow)              { fmt::printf("AvgTime     IVPSNRFlow %9.2f ms%s\n", AvgMs(StageIVPSNRFlow), Hpc(StageIVPSNRFlow)); }
+    if(CalcIVPSNRFlowOnly)          { fmt::printf("AvgTime IVPSNRFlowOnly %9.2f ms%s\n", AvgMs(StageIVPSNROnlyFlow), Hpc(StageIVPSNROnlyFlow)); }
+    fmt::printf("\n");
+    fmt::printf("StageTime %-18s %7s %8s %9s %9s %9s %9s %9s %9s\n", "Stage", "Frames", "Calls", "Avg[ms]", "Min[ms]", "Med[ms]", "P99[ms]", "Max[ms]", "Mpix/s");
+    for(const xStageTimer::xSummary& S : xStageTimer::getSummary())
+    {
+      if(S.NumFrames == 0) { continue; }
+      fmt::printf("StageTime %-18s %7d %8d %9.3f %9.3f %9.3f %9.3f %9.3f %9.1f\n", S.Name, S.NumFrames, S.NumCalls, S.AvgMs, S.MinMs, S.MedianMs, S.P99Ms, S.MaxMs, S.MPixPerS);
+    }
+  }
+  if(VerboseLevel >= 3 && ThreadPool)
+  {
+    fmt::printf("\n");
+    fmt::printf("%s", ThreadPoolStatsLast.format("ThreadPool "));
+  }
+  if(VerboseLevel >= 3 && ReadAhead != 0 && Synthetic == 0)
+  {
+    fmt::printf("\n");
+    for(int32 i = 0; i < NumInputsCur; i++)
+    {
+      const xSeq::xReadAheadStats& S = ReadAheadStats[i];
+      fmt::printf("ReadAhead%c Hits %d  Misses %d  HitRate %5.1f%%  Wait %.2f ms\n", i < 2 ? '0' + i : 'M', S.NumHits, S.NumMisses, 100.0 * S.getHitRate(), 1000.0 * S.WaitTime);
+    }
+  }
+  if(VerboseLevel >= 3 && CalcFlow)
+  {
+    const xRentalCommon::xStats& S = FlowRentalStats;
+    fmt::printf("\n");
+    fmt::printf("FlowRental Borrows %d  Reused %d  Created %d  Destroyed %d  Rejected %d  PeakInUse %d  ReuseRate %5.1f%%\n", S.NumBorrows, S.NumReused, S.NumCreated, S.NumDestroyed, S.NumRejected, S.PeakInUse, 100.0 * S.getReuseRate());
+  }
+  if(VerboseLevel >= 3 && HugePages != 0)
+  {
+    const xMemory::xStats S = xMemory::getStats();
+    fmt::printf("\n");
+    fmt::printf("HugePages Allocs %d  Explicit %d  Advised %d  Fallbacks %d  Huge %.1f MiB", S.NumAllocs, S.NumExplicit, S.NumAdvised, S.NumFallbacks, (flt64)S.BytesHuge / (1 << 20));
+    if(AnonHugePages != NOT_VALID) { fmt::printf("  AnonHugePages %.1f MiB", (flt64)AnonHugePages / (1 << 20)); }
+    fmt::printf("\n");
+  }
+  if(!TimingFile.empty())
+  {
+    bool WriteOK = xStageTimer::writeJSON(TimingFile);
+    if(!WriteOK) { xPrintError(fmt::sprintf("ERROR --> TimingFile write error (%s)", TimingFile)); }
+  }
+  if(!TraceFile.empty() && USE_TRACE)
+  {
+    xTrace::stop();
+    bool WriteOK = xTrace::writeJSON(TraceFile);
+    if(!WriteOK) { xPrintError(fmt::sprintf("ERROR --> TraceFile write error (%s)", TraceFile)); }
+    if(VerboseLevel >= 1) { fmt::printf("TraceEvents %d (dropped %d)\n", xTrace::getNumEvents(), xTrace::getNumDropped()); }
   }
   fmt::printf("\n");
   fmt::printf("TotalTime %.2f s\n", std::chrono::duration_cast<tDurationS>(ProcessingEnd - ProcessingBeg).count());
   fmt::printf("NumFrames %d\n", NumFrames);
+  if(VerboseLevel >= 1)
+  {
+    const flt64 TotalSeconds = std::chrono::duration_cast<tDurationS>(ProcessingEnd - ProcessingBeg).count();
+    const int64 PeakRSS      = xResources::getPeakResidentMemory();
+    fmt::printf("FramesPerSecond %.3f\n", TotalSeconds > 0 ? NumFrames / TotalSeconds : 0.0);
+    if(PeakRSS != NOT_VALID) { fmt::printf("PeakRSS %.1f MiB\n", (flt64)PeakRSS / (1 << 20)); }
+  }
   fmt::printf("END-OF-LOG\n");
   fflush(stdout);
   
@@ -38,12 +38,18 @@
 #include "xIVPSNR.h"
 #include "xPlane.h"
 #include "xDistortion.h"
+#include "xStageTimer.h"
 #include <iostream>
 #include <cassert>
 #include <numeric>
 
 namespace PMBB_NAMESPACE {
 
+//===============================================================================================================================================================================================================
+
+static const xStageTimer::tStageId xc_StageGCS      = xStageTimer::registerStage("xIVPSNR::GCS"     );
+static const xStageTimer::tStageId xc_StageQualAsym = xStageTimer::registerStage("xIVPSNR::QualAsym");
+
 //===============================================================================================================================================================================================================
 // xIVPSNR
 //===============================================================================================================================================================================================================
@@ -75,6 +81,60 @@ flt64 xIVPSNR::calcPicIVPSNR(const xPicP* Ref, const xPicP* Tst, const xPicI* Re
 
   return IVPSNR;
 }
+flt64 xIVPSNR::calcPicIVPSNR(const xPicI* Ref, const xPicI* Tst)
+{
+  assert(Ref != nullptr && Tst != nullptr);
+  assert(Ref->isCompatible(Tst));
+
+  int32V4 GlobalColorShiftRef2Tst = xCalcGlobalColorShift(Ref, Tst, m_CmpUnntcbCoef, &m_ThreadPoolIf);
+  int32V4 GlobalColorShiftTst2Ref = -GlobalColorShiftRef2Tst;
+
+  flt64 R2T = xCalcQualAsymmetricPic(Ref, Tst, GlobalColorShiftRef2Tst);
+  flt64 T2R = xCalcQualAsymmetricPic(Tst, Ref, GlobalColorShiftTst2Ref);
+
+  flt64 IVPSNR = xMin(R2T, T2R);
+
+  if(m_DebugCallbackGCS) { m_DebugCallbackGCS(GlobalColorShiftRef2Tst); }
+  if(m_DebugCallbackQAP) { m_DebugCallbackQAP(R2T, T2R               ); }
+
+  return IVPSNR;
+}
+flt64 xIVPSNR::calcPicIVPSNR(const xPicP* Ref, const xPicP* Tst, const xPicI8* RefI, const xPicI8* TstI)
+{
+  assert(Ref != nullptr && Tst != nullptr && RefI != nullptr && TstI != nullptr);
+  assert(Ref->isCompatible(Tst) && RefI->isCompatible(TstI));
+
+  int32V4 GlobalColorShiftRef2Tst = xCalcGlobalColorShift(Ref, Tst, m_CmpUnntcbCoef, &m_ThreadPoolIf);
+  int32V4 GlobalColorShiftTst2Ref = -GlobalColorShiftRef2Tst;
+
+  flt64 R2T = xCalcQualAsymmetricPic(RefI, TstI, GlobalColorShiftRef2Tst);
+  flt64 T2R = xCalcQualAsymmetricPic(TstI, RefI, GlobalColorShiftTst2Ref);
+
+  flt64 IVPSNR = xMin(R2T, T2R);
+
+  if(m_DebugCallbackGCS) { m_DebugCallbackGCS(GlobalColorShiftRef2Tst); }
+  if(m_DebugCallbackQAP) { m_DebugCallbackQAP(R2T, T2R               ); }
+
+  return IVPSNR;
+}
+flt64 xIVPSNR::calcPicIVPSNR(const xPicI8* Ref, const xPicI8* Tst)
+{
+  assert(Ref != nullptr && Tst != nullptr);
+  assert(Ref->isCompatible(Tst));
+
+  int32V4 GlobalColorShiftRef2Tst = xCalcGlobalColorShift(Ref, Tst, m_CmpUnntcbCoef, &m_ThreadPoolIf);
+  int32V4 GlobalColorShiftTst2Ref = -GlobalColorShiftRef2Tst;
+
+  flt64 R2T = xCalcQualAsymmetricPic(Ref, Tst, GlobalColorShiftRef2Tst);
+  flt64 T2R = xCalcQualAsymmetricPic(Tst, Ref, GlobalColorShiftTst2Ref);
+
+  flt64 IVPSNR = xMin(R2T, T2R);
+
+  if(m_DebugCallbackGCS) { m_DebugCallbackGCS(GlobalColorShiftRef2Tst); }
+  if(m_DebugCallbackQAP) { m_DebugCallbackQAP(R2T, T2R               ); }
+
+  return IVPSNR;
+}
 
 //===============================================================================================================================================================================================================
 // xTIVPSNR
@@ -147,29 +207,52 @@ flt64 xTIVPSNR::calcPicIVPSNROnlyFlow(const tFlowPlane* Ref, const tFlowPlane* T
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 int32V4 xIVPSNR::xCalcGlobalColorShift(const xPicP* Ref, const xPicP* Tst, const flt32V4& CmpUnntcbCoef, xThreadPoolInterface* ThreadPoolIf)
 {
+  xStageTimer::xScope Scope(xc_StageGCS, Ref->getArea());
   const int32   MaxValue = Ref->getMaxPelValue();
   const int32V4 MaxDiff  = xRoundFltToInt32(CmpUnntcbCoef * (flt32)MaxValue);
 
   flt64V4 AvgColorDiff = { 0, 0, 0, 0 };
 
-  if(ThreadPoolIf && ThreadPoolIf->isActive())
-  {
-    for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
-    {
-      ThreadPoolIf->addWaitingTask([&AvgColorDiff, &Tst, &Ref, CmpIdx](int32 /*ThreadIdx*/)
-        { AvgColorDiff[CmpIdx] = xIVPSNR::xCalcAvgColorDiff(Ref->getAddr((eCmp)CmpIdx), Tst->getAddr((eCmp)CmpIdx), Ref->getStride(), Tst->getStride(), Ref->getWidth(), Ref->getHeight()); }
-      );
-    }
-    ThreadPoolIf->waitUntilTasksFinished(3);
-  }
-  else
+  auto CalcCmp = [&AvgColorDiff, &Tst, &Ref](int32 CmpIdx) { AvgColorDiff[CmpIdx] = xIVPSNR::xCalcAvgColorDiff(Ref->getAddr((eCmp)CmpIdx), Tst->getAddr((eCmp)CmpIdx), Ref->getStride(), Tst->getStride(), Ref->getWidth(), Ref->getHeight()); };
+  if(ThreadPoolIf) { ThreadPoolIf->parallelFor(3, 1, CalcCmp); }
+  else             { for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { CalcCmp(CmpIdx); } }
+
+  int32V4 GlobalColorShift = xRoundFltToInt32(AvgColorDiff);
+  GlobalColorShift.modClip(-MaxDiff, MaxDiff);
+
+  return GlobalColorShift;
+}
+int32V4 xIVPSNR::xCalcGlobalColorShift(const xPicI* Ref, const xPicI* Tst, const flt32V4& CmpUnntcbCoef, xThreadPoolInterface* ThreadPoolIf)
+{
+  return xCalcGlobalColorShiftI(Ref, Tst, CmpUnntcbCoef, ThreadPoolIf);
+}
+int32V4 xIVPSNR::xCalcGlobalColorShift(const xPicI8* Ref, const xPicI8* Tst, const flt32V4& CmpUnntcbCoef, xThreadPoolInterface* ThreadPoolIf)
+{
+  return xCalcGlobalColorShiftI(Ref, Tst, CmpUnntcbCoef, ThreadPoolIf);
+}
+template <class tPicI> int32V4 xIVPSNR::xCalcGlobalColorShiftI(const tPicI* Ref, const tPicI* Tst, const flt32V4& CmpUnntcbCoef, xThreadPoolInterface* ThreadPoolIf)
+{
+  xStageTimer::xScope Scope(xc_StageGCS, Ref->getArea());
+  const int32   MaxValue = Ref->getMaxPelValue();
+  const int32V4 MaxDiff  = xRoundFltToInt32(CmpUnntcbCoef * (flt32)MaxValue);
+  const int32   Width    = Ref->getWidth ();
+  const int32   Height   = Ref->getHeight();
+
+  //all components in single pass over interleaved data
+  int32V4 BandColorDiff[c_NumBandsGCS];
+  auto CalcBand = [&BandColorDiff, &Tst, &Ref, Width, Height](int32 BandIdx)
   {
-    for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
-    {
-      AvgColorDiff[CmpIdx] = xIVPSNR::xCalcAvgColorDiff(Ref->getAddr((eCmp)CmpIdx), Tst->getAddr((eCmp)CmpIdx), Ref->getStride(), Tst->getStride(), Ref->getWidth(), Ref->getHeight());
-    }
-  }
+    const int32 BegY = Height *  BandIdx      / c_NumBandsGCS;
+    const int32 EndY = Height * (BandIdx + 1) / c_NumBandsGCS;
+    BandColorDiff[BandIdx] = xDistortion::CalcSD(Ref->getAddr() + BegY * Ref->getStride(), Tst->getAddr() + BegY * Tst->getStride(), Ref->getStride(), Tst->getStride(), Width, EndY - BegY);
+  };
+  if(ThreadPoolIf) { ThreadPoolIf->parallelFor(c_NumBandsGCS, 1, CalcBand); }
+  else             { for(int32 BandIdx = 0; BandIdx < c_NumBandsGCS; BandIdx++) { CalcBand(BandIdx); } }
 
+  int32V4 SumColorDiff = xMakeVec4<int32>(0);
+  for(int32 BandIdx = 0; BandIdx < c_NumBandsGCS; BandIdx++) { SumColorDiff += BandColorDiff[BandIdx]; }
+
+  flt64V4 AvgColorDiff     = (flt64V4)SumColorDiff / (flt64)Ref->getArea();
   int32V4 GlobalColorShift = xRoundFltToInt32(AvgColorDiff);
   GlobalColorShift.modClip(-MaxDiff, MaxDiff);
 
@@ -188,30 +271,16 @@ flt64 xIVPSNR::xCalcAvgColorDiff(const uint16* RefPtr, const uint16* TstPtr, con
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 flt64 xIVPSNR::xCalcQualAsymmetricPic(const xPicP* Ref, const xPicP* Tst, const int32V4& GlobalColorShift)
 {
+  xStageTimer::xScope Scope(xc_StageQualAsym, Ref->getArea());
   const int32 Height = Ref->getHeight();
   const int32 Area   = Ref->getArea  ();
 
-  if(m_ThreadPoolIf.isActive())
-  {
-    for(int32 y = 0; y < Height; y++)
-    {
-      m_ThreadPoolIf.addWaitingTask(
-        [this, &Tst, &Ref, &GlobalColorShift, y](int32 /*ThreadIdx*/)
-        {
-          const int32V4 RowDist = xCalcDistAsymmetricRow(Ref, Tst, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch);
-          for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-        });
-    }
-    m_ThreadPoolIf.waitUntilTasksFinished(Height);
-  }
-  else
-  {
-    for(int32 y = 0; y < Height; y++)
+  m_ThreadPoolIf.parallelFor(Height, 1,
+    [this, &Tst, &Ref, &GlobalColorShift](int32 y)
     {
       const int32V4 RowDist = xCalcDistAsymmetricRow(Ref, Tst, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch);
       for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-    }
-  }
+    });
 
   flt64V4 FrameError = { 0, 0, 0, 0 };
   if(m_UseWS)
@@ -317,27 +386,12 @@ flt64 xTIVPSNR::xCalcQualAsymmetricPicFlowCheck(const xPicP* Ref, const xPicP* T
     const int32 Height = Ref->getHeight();
     const int32 Area = Ref->getArea();
 
-    if (m_ThreadPoolIf.isActive())
-    {
-        for (int32 y = 0; y < Height; y++)
-        {
-            m_ThreadPoolIf.addWaitingTask(
-                [this, &Tst, &Ref, &GlobalColorShift, y, &RefPlane, &TstPlane](int32 /*ThreadIdx*/)
-                {
-                    const int32V4 RowDist = xCalcDistAsymmetricRow(Ref, Tst, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch, RefPlane, TstPlane);
-                    for (int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-                });
-        }
-        m_ThreadPoolIf.waitUntilTasksFinished(Height);
-    }
-    else
-    {
-        for (int32 y = 0; y < Height; y++)
+    m_ThreadPoolIf.parallelFor(Height, 1,
+        [this, &Tst, &Ref, &GlobalColorShift, &RefPlane, &TstPlane](int32 y)
         {
             const int32V4 RowDist = xCalcDistAsymmetricRow(Ref, Tst, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch, RefPlane, TstPlane);
             for (int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-        }
-    }
+        });
 
     flt64V4 FrameError = { 0, 0, 0, 0 };
     if (m_UseWS)
@@ -369,27 +423,12 @@ flt64 xTIVPSNR::xCalcQualAsymmetricPicFlow(const xPicP* Ref, const xPicP* Tst, c
     const int32 Height = Ref->getHeight();
     const int32 Area = Ref->getArea();
 
-    if (m_ThreadPoolIf.isActive())
-    {
-        for (int32 y = 0; y < Height; y++)
-        {
-            m_ThreadPoolIf.addWaitingTask(
-                [this, &Tst, &Ref, &GlobalColorShift, y, &RefPlane, &TstPlane](int32 /*ThreadIdx*/)
-                {
-                    const int32V4 RowDist = xCalcDistAsymmetricRow(Ref, Tst, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch, RefPlane, TstPlane);
-                    for (int32 CmpIdx = 0; CmpIdx < 4; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-                });
-        }
-        m_ThreadPoolIf.waitUntilTasksFinished(Height);
-    }
-    else
-    {
-        for (int32 y = 0; y < Height; y++)
+    m_ThreadPoolIf.parallelFor(Height, 1,
+        [this, &Tst, &Ref, &GlobalColorShift, &RefPlane, &TstPlane](int32 y)
         {
             const int32V4 RowDist = xCalcDistAsymmetricRow(Ref, Tst, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch, RefPlane, TstPlane);
             for (int32 CmpIdx = 0; CmpIdx < 4; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-        }
-    }
+        });
 
     flt64V4 FrameError = { 0, 0, 0, 0 };
     if (m_UseWS)
@@ -427,27 +466,12 @@ flt64 xTIVPSNR::xCalcQualAsymmetricPicOnlyFlow(const tFlowPlane* Ref, const tFlo
 
     std::vector<flt64> RowDistortions(Height);
 
-    if (m_ThreadPoolIf.isActive())
-    {
-        for (int32 y = 0; y < Height; y++)
+    m_ThreadPoolIf.parallelFor(Height, 1,
+        [this, &Tst, &Ref, &RowDistortions](int32 y)
         {
-            m_ThreadPoolIf.addWaitingTask(
-                [this, &Tst, &Ref, y, &RowDistortions](int32 /*ThreadIdx*/)
-                {
-                    const flt64 RowDist = xCalcDistAsymmetricRowOnlyFlow(Ref, Tst, y, m_SearchRange, m_CmpWeightsSearch);
-                    RowDistortions[y] = RowDist;
-                });
-        }
-        m_ThreadPoolIf.waitUntilTasksFinished(Height);
-    }
-    else
-    {
-        for (int32 y = 0; y < Height; y++)
-        {
-            const flt64 RowDist = (flt64)xCalcDistAsymmetricRowOnlyFlow(Ref, Tst, y, m_SearchRange, m_CmpWeightsSearch);
+            const flt64 RowDist = xCalcDistAsymmetricRowOnlyFlow(Ref, Tst, y, m_SearchRange, m_CmpWeightsSearch);
             RowDistortions[y] = RowDist;
-        }
-    }
+        });
 
     flt64 FrameError = 0;
     if (m_UseWS)
@@ -606,30 +630,24 @@ int32 xTIVPSNR::xFindBestPixelWithinBlock(const xPicP* Ref, const int32V4& TstPe
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 flt64 xIVPSNR::xCalcQualAsymmetricPic(const xPicI* Ref, const xPicI* Tst, const int32V4& GlobalColorShift)
 {
+  return xCalcQualAsymmetricPicI(Ref, Tst, GlobalColorShift);
+}
+flt64 xIVPSNR::xCalcQualAsymmetricPic(const xPicI8* Ref, const xPicI8* Tst, const int32V4& GlobalColorShift)
+{
+  return xCalcQualAsymmetricPicI(Ref, Tst, GlobalColorShift);
+}
+template <class tPicI> flt64 xIVPSNR::xCalcQualAsymmetricPicI(const tPicI* Ref, const tPicI* Tst, const int32V4& GlobalColorShift)
+{
+  xStageTimer::xScope Scope(xc_StageQualAsym, Ref->getArea());
   const int32 Height = Ref->getHeight();
   const int32 Area   = Ref->getArea  ();
 
-  if(m_ThreadPoolIf.isActive())
-  {
-    for(int32 y = 0; y < Height; y++)
-    {
-      m_ThreadPoolIf.addWaitingTask(
-        [this, &Tst, &Ref, &GlobalColorShift, y](int32 /*ThreadIdx*/)
-        {
-          const int32V4 RowDist = xCalcDistAsymmetricRow(Ref, Tst, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch);
-          for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-        });
-    }
-    m_ThreadPoolIf.waitUntilTasksFinished(Height);
-  }
-  else
-  {
-    for(int32 y = 0; y < Height; y++)
+  m_ThreadPoolIf.parallelFor(Height, 1,
+    [this, &Tst, &Ref, &GlobalColorShift](int32 y)
     {
       const int32V4 RowDist = xCalcDistAsymmetricRow(Ref, Tst, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch);
       for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-    }
-  }
+    });
 
   flt64V4 FrameError = { 0, 0, 0, 0 };
   if(m_UseWS)
@@ -717,6 +735,63 @@ int32 xIVPSNR::xFindBestPixelWithinBlock_STD(const xPicI* Ref, const int32V4& Ts
   return BestOffset;
 }
 
+int32V4 xIVPSNR::xCalcDistAsymmetricRow_STD(const xPicI8* Ref, const xPicI8* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  const int32  Width     = Tst->getWidth ();
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+
+  int32V4 RowDist = { 0, 0, 0, 0 };
+
+  const uint8V4* TstPtr  = Tst->getAddr() + TstOffset;
+
+  for(int32 x = 0; x < Width; x++)
+  {
+    const int32V4 CurrTstValue  = (int32V4)(TstPtr[x]) + GlobalColorShift;
+    const int32   BestRefOffset = xFindBestPixelWithinBlock_STD(Ref, CurrTstValue, x, y, SearchRange, CmpWeights);
+    const int32V4 Diff = CurrTstValue - (int32V4)(Ref->getAddr()[BestRefOffset]);
+    const int32V4 Dist = Diff.getVecPow2();
+    RowDist += Dist;
+  }//x
+
+  return RowDist;
+}
+int32 xIVPSNR::xFindBestPixelWithinBlock_STD(const xPicI8* Ref, const int32V4& TstPel, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  const int32 BegY = CenterY - SearchRange;
+  const int32 EndY = CenterY + SearchRange;
+  const int32 BegX = CenterX - SearchRange;
+  const int32 EndX = CenterX + SearchRange;
+
+  const uint8V4* RefPtr = Ref->getAddr  ();
+  const int32    Stride = Ref->getStride();
+
+  int32 BestError  = std::numeric_limits<int32>::max();
+  int32 BestOffset = NOT_VALID;
+
+  for(int32 y = BegY; y <= EndY; y++)
+  {
+    for(int32 x = BegX; x <= EndX; x++)
+    {
+      const int32   Offset = y * Stride + x;
+      const int32V4 RefPel = (int32V4)(RefPtr[Offset]);
+      const int32V4 Dist   = (TstPel - RefPel).getVecPow2();
+      if constexpr (c_UseRuntimeCmpWeights)
+      {
+        const int32 Error = (Dist * CmpWeights).getSum();
+        if (Error < BestError) { BestError = Error; BestOffset = Offset; }
+      }
+      else
+      {
+        const int32 Error = (Dist[0] << 2) + Dist[1] + Dist[2];
+        if (Error < BestError) { BestError = Error; BestOffset = Offset; }
+      }
+    } //x
+  } //y
+
+  return BestOffset;
+}
+
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // asymetric Q interleaved - SSE
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -775,6 +850,79 @@ __m128i xIVPSNR::xCalcDistWithinBlock_SSE(const xPicI* Ref, const __m128i& TstPe
 
   return BestDistV;
 }
+int32V4 xIVPSNR::xCalcDistAsymmetricRow_SSE(const xPicI8* Ref, const xPicI8* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights)
+{
+  //16-bit error calculation would overflow - fallback to STD
+  if(CmpWeights.getMaxAbs() > c_MaxCmpWeight8bitSSE || GlobalColorShift.getMaxAbs() > (int32)std::numeric_limits<uint8>::max()) { return xCalcDistAsymmetricRow_STD(Ref, Tst, y, GlobalColorShift, SearchRange, CmpWeights); }
+
+  const int32  Width     = Tst->getWidth();
+  const int32  TstStride = Tst->getStride();
+  const int32  TstOffset = y * TstStride;
+  const __m128i CmpWeightsV       = _mm_loadu_si128((__m128i*) &CmpWeights);
+  const __m128i CmpWeightsV16     = _mm_packs_epi32(CmpWeightsV, CmpWeightsV);
+  const __m128i GlobalColorShiftV = _mm_loadu_si128((__m128i*) &GlobalColorShift);
+
+  const uint8V4* TstPtr = Tst->getAddr() + TstOffset;
+  __m128i RowDistV = _mm_setzero_si128();
+  for (int32 x = 0; x < Width; x++)
+  {
+    __m128i TstU8V   = _mm_cvtsi32_si128(*((int32*)(TstPtr + x)));
+    __m128i TstV     = _mm_add_epi32(_mm_cvtepu8_epi32(TstU8V), GlobalColorShiftV);
+    __m128i BestDist = xCalcDistWithinBlock_SSE(Ref, TstV, x, y, SearchRange, CmpWeightsV16);
+    RowDistV = _mm_add_epi32(RowDistV, BestDist);
+  }//x
+
+  int32V4 RowDist;
+  _mm_storeu_si128((__m128i*)&RowDist, RowDistV);
+  return RowDist;
+}
+__m128i xIVPSNR::xCalcDistWithinBlock_SSE(const xPicI8* Ref, const __m128i& TstPelV, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m128i& CmpWeightsV16)
+{
+  const int32 WindowSize  = 2 * SearchRange + 1;
+  const int32 WindowSize2 = (int32)((uint32)WindowSize & (uint32)0xFFFFFFFE);
+  const int32 BegY = CenterY - SearchRange;
+  const int32 BegX = CenterX - SearchRange;
+
+  const int32    Stride = Ref->getStride();
+  const uint8V4* RefPtr = Ref->getAddr() + BegY * Stride + BegX;
+
+  //TstPel replicated for 2 candidates (as int16)
+  const __m128i TstPelV16 = _mm_packs_epi32(TstPelV, TstPelV);
+
+  int32          BestError  = std::numeric_limits<int32>::max();
+  const uint8V4* BestRefPtr = RefPtr;
+
+  for (int32 y = 0; y < WindowSize; y++)
+  {
+    const uint8V4* RefPtrY = RefPtr + y * Stride;
+    for (int32 x = 0; x < WindowSize2; x+=2)
+    {
+      __m128i RefU8V  = _mm_loadl_epi64   ((__m128i*)(RefPtrY + x));
+      __m128i RefV    = _mm_cvtepu8_epi16 (RefU8V);
+      __m128i DiffV   = _mm_sub_epi16     (TstPelV16, RefV);
+      __m128i ErrorV  = _mm_madd_epi16    (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV16));
+      __m128i SumV    = _mm_add_epi32     (ErrorV, _mm_srli_epi64(ErrorV, 32));
+      int32   Error0  = _mm_extract_epi32 (SumV, 0);
+      int32   Error1  = _mm_extract_epi32 (SumV, 2);
+      if (Error0 < BestError) { BestError = Error0; BestRefPtr = RefPtrY + x    ; }
+      if (Error1 < BestError) { BestError = Error1; BestRefPtr = RefPtrY + x + 1; }
+    } //x
+    //WindowSize is always odd - last candidate in row
+    {
+      __m128i RefU8V  = _mm_cvtsi32_si128 (*((int32*)(RefPtrY + WindowSize2)));
+      __m128i RefV    = _mm_cvtepu8_epi16 (RefU8V);
+      __m128i DiffV   = _mm_sub_epi16     (TstPelV16, RefV);
+      __m128i ErrorV  = _mm_madd_epi16    (DiffV, _mm_mullo_epi16(DiffV, CmpWeightsV16));
+      __m128i SumV    = _mm_add_epi32     (ErrorV, _mm_srli_epi64(ErrorV, 32));
+      int32   Error0  = _mm_extract_epi32 (SumV, 0);
+      if (Error0 < BestError) { BestError = Error0; BestRefPtr = RefPtrY + WindowSize2; }
+    }
+  } //y
+
+  __m128i RefV  = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*((int32*)BestRefPtr)));
+  __m128i DiffV = _mm_sub_epi32    (TstPelV, RefV);
+  return _mm_mullo_epi32(DiffV, DiffV);
+}
 #endif //X_CAN_USE_SSE
 
 //===============================================================================================================================================================================================================
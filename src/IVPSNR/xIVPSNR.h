@@ -81,11 +81,18 @@ public:
   void  setDebugCallbackQAP(tDCfQAP DebugCallbackQAP) { m_DebugCallbackQAP = DebugCallbackQAP; }
 
   flt64 calcPicIVPSNR  (const xPicP* Ref, const xPicP* Tst, const xPicI* RefI = nullptr, const xPicI* TstI = nullptr);
+  flt64 calcPicIVPSNR  (const xPicI* Ref, const xPicI* Tst); //interleaved only - planar pictures are not needed
+  flt64 calcPicIVPSNR  (const xPicP* Ref, const xPicP* Tst, const xPicI8* RefI, const xPicI8* TstI);
+  flt64 calcPicIVPSNR  (const xPicI8* Ref, const xPicI8* Tst); //interleaved 8-bit only - planar pictures are not needed
 
 protected:
   //global color shift
   static int32V4 xCalcGlobalColorShift(const xPicP* Ref, const xPicP* Tst, const flt32V4& CmpUnntcbCoef, xThreadPoolInterface* ThreadPoolIf = nullptr);
   static flt64   xCalcAvgColorDiff    (const uint16* RefPtr, const uint16* TstPtr, const int32 RefStride, const int32 TstStride, const int32 Width, const int32 Height);
+  static int32V4 xCalcGlobalColorShift(const xPicI* Ref, const xPicI* Tst, const flt32V4& CmpUnntcbCoef, xThreadPoolInterface* ThreadPoolIf = nullptr);
+  static int32V4 xCalcGlobalColorShift(const xPicI8* Ref, const xPicI8* Tst, const flt32V4& CmpUnntcbCoef, xThreadPoolInterface* ThreadPoolIf = nullptr);
+  template <class tPicI> static int32V4 xCalcGlobalColorShiftI(const tPicI* Ref, const tPicI* Tst, const flt32V4& CmpUnntcbCoef, xThreadPoolInterface* ThreadPoolIf); //common for xPicI and xPicI8
+  static constexpr int32 c_NumBandsGCS = 8; //interleaved picture is split into horizontal bands processed in parallel
 
   //asymetric Q planar
   flt64          xCalcQualAsymmetricPic					(const xPicP* Ref, const xPicP* Tst, const int32V4& GlobalColorShift);
@@ -94,20 +101,30 @@ protected:
   
   //asymetric Q interleaved
   flt64          xCalcQualAsymmetricPic   (const xPicI* Ref, const xPicI* Tst, const int32V4& GlobalColorShift);
+  flt64          xCalcQualAsymmetricPic   (const xPicI8* Ref, const xPicI8* Tst, const int32V4& GlobalColorShift);
+  template <class tPicI> flt64 xCalcQualAsymmetricPicI(const tPicI* Ref, const tPicI* Tst, const int32V4& GlobalColorShift); //common for xPicI and xPicI8
 #if X_CAN_USE_SSE
   static inline int32V4 xCalcDistAsymmetricRow   (const xPicI* Ref, const xPicI* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCalcDistAsymmetricRow_SSE(Ref, Tst, y, GlobalColorShift, SearchRange, CmpWeights); }
+  static inline int32V4 xCalcDistAsymmetricRow   (const xPicI8* Ref, const xPicI8* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCalcDistAsymmetricRow_SSE(Ref, Tst, y, GlobalColorShift, SearchRange, CmpWeights); }
 #else //X_CAN_USE_SSE
   static inline int32V4 xCalcDistAsymmetricRow   (const xPicI* Ref, const xPicI* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCalcDistAsymmetricRow_STD(Ref, Tst, y, GlobalColorShift, SearchRange, CmpWeights); }
+  static inline int32V4 xCalcDistAsymmetricRow   (const xPicI8* Ref, const xPicI8* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights) { return xCalcDistAsymmetricRow_STD(Ref, Tst, y, GlobalColorShift, SearchRange, CmpWeights); }
 #endif //X_CAN_USE_SSE
 
   //asymetric Q interleaved - STD
   static int32V4 xCalcDistAsymmetricRow_STD   (const xPicI* Ref, const xPicI* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
   static int32   xFindBestPixelWithinBlock_STD(const xPicI* Ref, const int32V4& TstPel, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights);
+  static int32V4 xCalcDistAsymmetricRow_STD   (const xPicI8* Ref, const xPicI8* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+  static int32   xFindBestPixelWithinBlock_STD(const xPicI8* Ref, const int32V4& TstPel, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const int32V4& CmpWeights);
 
   //asymetric Q interleaved - SSE
 #if X_CAN_USE_SSE
   static int32V4 xCalcDistAsymmetricRow_SSE(const xPicI* Ref, const xPicI* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
   static __m128i xCalcDistWithinBlock_SSE  (const xPicI* Ref, const __m128i& TstPel, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m128i& CmpWeights);
+  //8-bit: 2 candidates per step, errors computed in 16-bit lanes by multiply-add (exact for |Diff|<=510 and CmpWeights<=c_MaxCmpWeight8bitSSE)
+  static int32V4 xCalcDistAsymmetricRow_SSE(const xPicI8* Ref, const xPicI8* Tst, const int32 y, const int32V4& GlobalColorShift, const int32 SearchRange, const int32V4& CmpWeights);
+  static __m128i xCalcDistWithinBlock_SSE  (const xPicI8* Ref, const __m128i& TstPel, const int32 CenterX, const int32 CenterY, const int32 SearchRange, const __m128i& CmpWeights);
+  static constexpr int32 c_MaxCmpWeight8bitSSE = 64;
 #endif //X_CAN_USE_SSE
 
 };
@@ -118,11 +135,13 @@ class xIVPSNRM : public xIVPSNR
 {
 public:
   flt64 calcPicIVPSNRM (const xPicP* Ref, const xPicP* Tst, const xPicP* Mask, const xPicI* RefI, const xPicI* TstI);
+  flt64 calcPicIVPSNRM (const xPicI* Ref, const xPicI* Tst, const xPicP* Mask); //interleaved only - planar pictures are not needed
 
 protected:
   //global color shift
   static int32V4 xCalcGlobalColorShiftM(const xPicP* Ref, const xPicP* Tst, const xPicP* Msk, const flt32V4& CmpUnntcbCoef, const int32 NumNonMasked, xThreadPoolInterface* ThreadPoolIf = nullptr);
   static int64   xCalcSumColorDiffM    (const uint16* RefPtr, const uint16* TstPtr, const uint16* MskPtr, const int32 RefStride, const int32 TstStride, const int32 MskStride, const int32 Width, const int32 Height);
+  static int32V4 xCalcGlobalColorShiftM(const xPicI* Ref, const xPicI* Tst, const xPicP* Msk, const flt32V4& CmpUnntcbCoef, const int32 NumNonMasked, xThreadPoolInterface* ThreadPoolIf = nullptr);
 
   //asymetric Q interleaved
   flt64                  xCalcQualAsymmetricPicM(const xPicI* Ref, const xPicI* Tst, const xPicP* Msk, const int32V4& GlobalColorShift, const int32 NumNonMasked);
@@ -69,6 +69,28 @@ flt64 xIVPSNRM::calcPicIVPSNRM(const xPicP* Ref, const xPicP* Tst, const xPicP*
 
   return IVPSNR;
 }
+flt64 xIVPSNRM::calcPicIVPSNRM(const xPicI* Ref, const xPicI* Tst, const xPicP* Msk)
+{
+  assert(Ref != nullptr && Tst != nullptr && Msk != nullptr);
+  assert(Ref->isCompatible    (Tst));
+  assert(Ref->isSameSizeMargin(Msk));
+
+  const int32 NumNonMasked = xPixelOps::CountNonZero(Msk->getAddr(eCmp::LM), Msk->getStride(), Msk->getWidth(), Msk->getHeight());
+
+  const int32V4 GlobalColorShiftRef2Tst = xCalcGlobalColorShiftM(Ref, Tst, Msk, m_CmpUnntcbCoef, NumNonMasked, &m_ThreadPoolIf);
+  const int32V4 GlobalColorShiftTst2Ref = -GlobalColorShiftRef2Tst;
+
+  flt64 R2T = xCalcQualAsymmetricPicM(Ref, Tst, Msk, GlobalColorShiftRef2Tst, NumNonMasked);
+  flt64 T2R = xCalcQualAsymmetricPicM(Tst, Ref, Msk, GlobalColorShiftTst2Ref, NumNonMasked);
+
+  flt64 IVPSNR = xMin(R2T, T2R);
+
+  if(m_DebugCallbackGCS) { m_DebugCallbackGCS(GlobalColorShiftRef2Tst); }
+  if(m_DebugCallbackQAP) { m_DebugCallbackQAP(R2T, T2R               ); }
+  if(m_DebugCallbackMSK) { m_DebugCallbackMSK(NumNonMasked           ); }
+
+  return IVPSNR;
+}
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // global color shift
@@ -80,23 +102,36 @@ int32V4 xIVPSNRM::xCalcGlobalColorShiftM(const xPicP* Ref, const xPicP* Tst, con
 
   int64V4 SumColorDiff = xMakeVec4<int64>(0);
 
-  if(ThreadPoolIf && ThreadPoolIf->isActive())
-  {
-    for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
-    {
-      ThreadPoolIf->addWaitingTask([&SumColorDiff, &Tst, &Ref, &Msk, CmpIdx](int32 /*ThreadIdx*/)
-        { SumColorDiff[CmpIdx] = xIVPSNRM::xCalcSumColorDiffM(Ref->getAddr((eCmp)CmpIdx), Tst->getAddr((eCmp)CmpIdx), Msk->getAddr(eCmp::LM), Ref->getStride(), Tst->getStride(), Msk->getStride(), Ref->getWidth(), Ref->getHeight()); }
-      );
-    }
-    ThreadPoolIf->waitUntilTasksFinished(3);
-  }
-  else
+  auto CalcCmp = [&SumColorDiff, &Tst, &Ref, &Msk](int32 CmpIdx) { SumColorDiff[CmpIdx] = xIVPSNRM::xCalcSumColorDiffM(Ref->getAddr((eCmp)CmpIdx), Tst->getAddr((eCmp)CmpIdx), Msk->getAddr(eCmp::LM), Ref->getStride(), Tst->getStride(), Msk->getStride(), Ref->getWidth(), Ref->getHeight()); };
+  if(ThreadPoolIf) { ThreadPoolIf->parallelFor(3, 1, CalcCmp); }
+  else             { for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { CalcCmp(CmpIdx); } }
+
+  flt64V4 AvgColorDiff     = (flt64V4)SumColorDiff / (flt64)((int64)NumNonMasked * (int64)(Msk->getMaxPelValue()));
+  int32V4 GlobalColorShift = xRoundFltToInt32(AvgColorDiff);
+  GlobalColorShift.modClip(-MaxDiff, MaxDiff);
+
+  return GlobalColorShift;
+}
+int32V4 xIVPSNRM::xCalcGlobalColorShiftM(const xPicI* Ref, const xPicI* Tst, const xPicP* Msk, const flt32V4& CmpUnntcbCoef, const int32 NumNonMasked, xThreadPoolInterface* ThreadPoolIf)
+{
+  const int32   MaxValue = Ref->getMaxPelValue();
+  const int32V4 MaxDiff  = xRoundFltToInt32(CmpUnntcbCoef * (flt32)MaxValue);
+  const int32   Width    = Ref->getWidth ();
+  const int32   Height   = Ref->getHeight();
+
+  //all components in single pass over interleaved data
+  int64V4 BandColorDiff[c_NumBandsGCS];
+  auto CalcBand = [&BandColorDiff, &Tst, &Ref, &Msk, Width, Height](int32 BandIdx)
   {
-    for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
-    {
-      SumColorDiff[CmpIdx] = xIVPSNRM::xCalcSumColorDiffM(Ref->getAddr((eCmp)CmpIdx), Tst->getAddr((eCmp)CmpIdx), Msk->getAddr(eCmp::LM), Ref->getStride(), Tst->getStride(), Msk->getStride(), Ref->getWidth(), Ref->getHeight());
-    }
-  }
+    const int32 BegY = Height *  BandIdx      / c_NumBandsGCS;
+    const int32 EndY = Height * (BandIdx + 1) / c_NumBandsGCS;
+    BandColorDiff[BandIdx] = xDistortion::CalcWeightedSD(Ref->getAddr() + BegY * Ref->getStride(), Tst->getAddr() + BegY * Tst->getStride(), Msk->getAddr(eCmp::LM) + BegY * Msk->getStride(), Ref->getStride(), Tst->getStride(), Msk->getStride(), Width, EndY - BegY);
+  };
+  if(ThreadPoolIf) { ThreadPoolIf->parallelFor(c_NumBandsGCS, 1, CalcBand); }
+  else             { for(int32 BandIdx = 0; BandIdx < c_NumBandsGCS; BandIdx++) { CalcBand(BandIdx); } }
+
+  int64V4 SumColorDiff = xMakeVec4<int64>(0);
+  for(int32 BandIdx = 0; BandIdx < c_NumBandsGCS; BandIdx++) { SumColorDiff += BandColorDiff[BandIdx]; }
 
   flt64V4 AvgColorDiff     = (flt64V4)SumColorDiff / (flt64)((int64)NumNonMasked * (int64)(Msk->getMaxPelValue()));
   int32V4 GlobalColorShift = xRoundFltToInt32(AvgColorDiff);
@@ -117,27 +152,12 @@ flt64 xIVPSNRM::xCalcQualAsymmetricPicM(const xPicI* Ref, const xPicI* Tst, cons
 {
   const int32 Height = Ref->getHeight();
 
-  if(m_ThreadPoolIf.isActive())
-  {
-    for(int32 y = 0; y < Height; y++)
-    {
-      m_ThreadPoolIf.addWaitingTask(
-        [this, &Tst, &Ref, &Msk, &GlobalColorShift, y](int32 /*ThreadIdx*/)
-        {
-          const uint64V4 RowDist = xCalcDistAsymmetricRowM(Ref, Tst, Msk, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch);
-          for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-        });
-    }
-    m_ThreadPoolIf.waitUntilTasksFinished(Height);
-  }
-  else
-  {
-    for(int32 y = 0; y < Height; y++)
+  m_ThreadPoolIf.parallelFor(Height, 1,
+    [this, &Tst, &Ref, &Msk, &GlobalColorShift](int32 y)
     {
       const uint64V4 RowDist = xCalcDistAsymmetricRowM(Ref, Tst, Msk, y, GlobalColorShift, m_SearchRange, m_CmpWeightsSearch);
       for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++) { m_RowDistortions[CmpIdx][y] = RowDist[CmpIdx]; }
-    }
-  }
+    });
 
   flt64V4 FrameError = { 0, 0, 0, 0 };
   if(m_UseWS)
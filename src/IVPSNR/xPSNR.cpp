@@ -55,21 +55,7 @@ xPSNR::tRes4 xPSNR::calcPicPSNR(const xPicP* Tst, const xPicP* Ref)
   flt64V4  PSNR  = xMakeVec4(flt64_max );
   boolV4   Exact = xMakeVec4(false     );
 
-  if(m_ThreadPoolIf.isActive())
-  {
-    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-    {
-      m_ThreadPoolIf.addWaitingTask([this, &PSNR, &Exact, &Tst, &Ref, CmpIdx](int32 /*ThreadIdx*/) { std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = xCalcCmpPSNR(Tst, Ref, (eCmp)CmpIdx); });
-    }
-    m_ThreadPoolIf.waitUntilTasksFinished(m_NumComponents);
-  }
-  else
-  {
-    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-    {
-      std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = xCalcCmpPSNR(Tst, Ref, (eCmp)CmpIdx);
-    }
-  }
+  m_ThreadPoolIf.parallelFor(m_NumComponents, 1, [this, &PSNR, &Exact, &Tst, &Ref](int32 CmpIdx) { std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = xCalcCmpPSNR(Tst, Ref, (eCmp)CmpIdx); });
 
   return std::make_tuple(PSNR, Exact);
 }
@@ -78,18 +64,8 @@ flt64 xPSNR::calcPicPSNRFlow(const tFlowPlane* Tst, const tFlowPlane* Ref)
     assert(Ref != nullptr && Tst != nullptr);
     assert(Ref->isCompatible(Tst));
 
-    flt64 PSNR = 0.0;
-    std::vector<bool>   Exact = std::vector<bool>(false);
-
-    if (m_ThreadPoolIf.isActive())
-    {
-        m_ThreadPoolIf.addWaitingTask([this, &PSNR, &Exact, &Tst, &Ref](int32 /*ThreadIdx*/) { PSNR = xCalcCmpPSNRFlow(Tst, Ref); });
-        m_ThreadPoolIf.waitUntilTasksFinished(1);
-    }
-    else
-    {
-        PSNR = xCalcCmpPSNRFlow(Tst, Ref);
-    }
+    //single plane - dispatching one task to the pool only adds latency
+    flt64 PSNR = xCalcCmpPSNRFlow(Tst, Ref);
 
     return PSNR;
 }
@@ -104,21 +80,7 @@ xPSNR::tRes4 xPSNR::calcPicPSNRM(const xPicP* Tst, const xPicP* Ref, const xPicP
   flt64V4 PSNR  = xMakeVec4(flt64_max);
   boolV4  Exact = xMakeVec4(false    );
 
-  if(m_ThreadPoolIf.isActive())
-  {
-    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-    {
-      m_ThreadPoolIf.addWaitingTask([this, &PSNR, &Exact, &Tst, &Ref, &Msk, &NumNonMasked, CmpIdx](int32 /*ThreadIdx*/) { std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = xCalcCmpPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx); });
-    }
-    m_ThreadPoolIf.waitUntilTasksFinished(m_NumComponents);
-  }
-  else
-  {
-    for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-    {
-      std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = xCalcCmpPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx);
-    }
-  }
+  m_ThreadPoolIf.parallelFor(m_NumComponents, 1, [this, &PSNR, &Exact, &Tst, &Ref, &Msk, &NumNonMasked](int32 CmpIdx) { std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = xCalcCmpPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx); });
 
   if(m_DebugCallbackMSK) { m_DebugCallbackMSK(NumNonMasked); }
 
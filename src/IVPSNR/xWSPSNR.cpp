@@ -89,21 +89,7 @@ xPSNR::tRes4 xWSPSNR::calcPicWSPSNR(const xPicP* Tst, const xPicP* Ref)
   }
   else
   {
-    if(m_ThreadPoolIf.isActive())
-    {
-      for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
-      {
-        m_ThreadPoolIf.addWaitingTask([this, &PSNR, &Exact, &Tst, &Ref, CmpIdx](int32 /*ThreadIdx*/) { std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = calcCmpWSPSNR(Tst, Ref, (eCmp)CmpIdx); });
-      }
-      m_ThreadPoolIf.waitUntilTasksFinished(3);
-    }
-    else
-    {
-      for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
-      {
-        std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = calcCmpWSPSNR(Tst, Ref, (eCmp)CmpIdx);
-      }
-    }
+    m_ThreadPoolIf.parallelFor(3, 1, [this, &PSNR, &Exact, &Tst, &Ref](int32 CmpIdx) { std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = calcCmpWSPSNR(Tst, Ref, (eCmp)CmpIdx); });
   }
 
   if(m_LegacyPeakValue8bitEmulation) //emulates behavior of original WS-PSNR software for 10bit content converted from 8 bit source
@@ -137,21 +123,7 @@ xPSNR::tRes4 xWSPSNR::calcPicWSPSNRM(const xPicP* Tst, const xPicP* Ref, const x
   }
   else
   {
-    if(m_ThreadPoolIf.isActive())
-    {
-      for(int32 CmpIdx = 0; CmpIdx < m_NumComponents; CmpIdx++)
-      {
-        m_ThreadPoolIf.addWaitingTask([this, &PSNR, &Exact, &Tst, &Ref, &Msk, &NumNonMasked, CmpIdx](int32 /*ThreadIdx*/) { std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = calcCmpWSPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx); });
-      }
-      m_ThreadPoolIf.waitUntilTasksFinished(m_NumComponents);
-    }
-    else
-    {
-      for(int32 CmpIdx = 0; CmpIdx < 3; CmpIdx++)
-      {
-        std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = calcCmpWSPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx);
-      }
-    }
+    m_ThreadPoolIf.parallelFor(m_NumComponents, 1, [this, &PSNR, &Exact, &Tst, &Ref, &Msk, &NumNonMasked](int32 CmpIdx) { std::tie(PSNR[CmpIdx], Exact[CmpIdx]) = calcCmpWSPSNRM(Tst, Ref, Msk, NumNonMasked, (eCmp)CmpIdx); });
   }
 
   if(m_DebugCallbackMSK) { m_DebugCallbackMSK(NumNonMasked); }
@@ -0,0 +1,260 @@
+﻿/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2021, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ // Original authors: Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+ //                   Adrian Dziembowski, adrian.dziembowski@put.poznan.pl,
+ //                   Poznan University of Technology, Poznań, Poland
+
+//===============================================================================================================================================================================================================
+
+#include "xBench.h"
+#include "xKernelCheck.h"
+#include "xCfgINI.h"
+#include "xString.h"
+#include "xPerfCounters.h"
+#include <sstream>
+
+using namespace PMBB_NAMESPACE;
+
+//===============================================================================================================================================================================================================
+
+static const char BannerString[] =
+R"IVPSNRRAWSTRING(
+=============================================================================
+
+IV-PSNR kernel benchmark v4.0-dev
+
+Copyright (c) 2010-2021, ISO/IEC, All rights reserved.
+
+Developed at Poznan University of Technology, Poznan, Poland
+Authors: Jakub Stankowski, Adrian Dziembowski
+
+=============================================================================
+
+)IVPSNRRAWSTRING";
+
+static const char HelpString[] =
+R"AVLIBRAWSTRING(
+=============================================================================
+IV-PSNR kernel benchmark v4.0-dev
+
+Single threaded micro-benchmark of xDistortion, xPixelOps and IV-PSNR kernels
+(all compiled ISA variants) on synthetic pictures.
+Optionally (-chk) randomized check of SIMD kernels against STD reference.
+
+Usage:
+
+ Cmd | ParamName        | Description
+ -r    Resolutions        Comma separated list of resolutions
+                          (optional, default "1920x1080,3840x2160,7680x4320,15360x8640")
+ -bd   BitDepths          Comma separated list of bit depths
+                          (optional, default "8,10,12,14")
+ -sr   SearchRanges       Comma separated list of IV-PSNR search ranges
+                          (optional, default "1,2,3,4")
+ -hp   HugePages          Comma separated list of picture buffer huge page modes
+                          [0=disabled, 1=transparent, 2=explicit], effect of each mode
+                          on time and dTLB misses is summarized at the end
+                          (Linux, optional, default "0")
+ -k    Kernels            Comma separated list of kernel name filters, matched as
+                          substring of "Group::Kernel" (optional, default empty=all)
+ -isa  ISAs               Comma separated list of ISA variants [STD, SSE, AVX]
+                          (optional, default empty=all compiled)
+ -mi   MinIters           Minimum number of timed calls per kernel (optional, default 5)
+ -mt   MinTime            Minimum time per kernel in seconds (optional, default 0.1)
+ -bh   BandHeight         Number of rows processed by IV-PSNR row kernels
+                          (optional, default 128)
+ -csv  CsvFile            Results output file - CSV format (optional, default=empty)
+ -json JsonFile           Results output file - JSON format (optional, default=empty)
+ -chk  CheckCases         Number of randomized kernel equivalence cases
+                          (optional, default 0=benchmark mode)
+ -seed Seed               Random seed used in check mode, decimal
+                          (optional, default 1592598101)
+ -v    VerboseLevel       Verbose level (optional, default=1)
+
+ -c    "config.cfg"       External config file - in INI format (optional)
+
+Reported values:
+  ns/pel = median time per call / number of processed elements
+  GB/s   = compulsory memory traffic (reads + writes) / median time per call
+  xN.NN  = speedup relative to STD variant of the same kernel
+  dTLB/kpel = data TLB load misses per 1000 elements (if perf_event_open is available)
+
+Example - commandline parameters:
+  IV_PSNR_bench -r "3840x2160" -bd 10 -k "CalcSSD,Interleave" -json "bench.json"
+  IV_PSNR_bench -r "7680x4320" -bd 10 -k "Copy,DistAsymmetricRow" -hp "0,1,2"
+  IV_PSNR_bench -chk 10000
+
+Check mode returns EXIT_FAILURE if any SIMD variant differs from STD.
+
+=============================================================================
+)AVLIBRAWSTRING";
+
+//===============================================================================================================================================================================================================
+
+static std::vector<std::string> xSplitList(const std::string& List)
+{
+  std::vector<std::string> Items;
+  std::istringstream Stream(List);
+  std::string Item;
+  while(std::getline(Stream, Item, ','))
+  {
+    xString::trimL(Item);
+    xString::trimR(Item);
+    if(!Item.empty()) { Items.push_back(Item); }
+  }
+  return Items;
+}
+static std::vector<int32> xSplitIntList(const std::string& List)
+{
+  std::vector<int32> Values;
+  for(const std::string& Item : xSplitList(List)) { Values.push_back(std::stoi(Item)); }
+  return Values;
+}
+
+//===============================================================================================================================================================================================================
+// Main
+//===============================================================================================================================================================================================================
+int32 main(int argc, char *argv[], char* /*envp*/[])
+{
+  fmt::printf(BannerString);
+
+  //==============================================================================
+  // parsing configuration
+  xCfgINI::xParser CfgParser;
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-r"   , "", "Resolutions"  ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-bd"  , "", "BitDepths"    ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-sr"  , "", "SearchRanges" ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-hp"  , "", "HugePages"    ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-k"   , "", "Kernels"      ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-isa" , "", "ISAs"         ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-mi"  , "", "MinIters"     ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-mt"  , "", "MinTime"      ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-bh"  , "", "BandHeight"   ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-csv" , "", "CsvFile"      ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-json", "", "JsonFile"     ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-chk" , "", "CheckCases"   ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-seed", "", "Seed"         ));
+  CfgParser.addCommandlineParam(xCfgINI::xCmdParam("-v"   , "", "VerboseLevel" ));
+
+  //no arguments = run with defaults
+  if(argc > 1)
+  {
+    bool CommandlineResult = CfgParser.loadFromCommandline(argc, argv);
+    if(!CommandlineResult) { xCfgINI::printErrorMessage("! invalid commandline\n", HelpString); return EXIT_FAILURE; }
+  }
+
+  xBench::xParams Params;
+  std::string ResolutionsS  = CfgParser.getParam1stArg("Resolutions" , std::string(""));
+  std::string BitDepthsS    = CfgParser.getParam1stArg("BitDepths"   , std::string(""));
+  std::string SearchRangesS = CfgParser.getParam1stArg("SearchRanges", std::string(""));
+  std::string HugePagesS    = CfgParser.getParam1stArg("HugePages"   , std::string(""));
+  std::string KernelsS      = CfgParser.getParam1stArg("Kernels"     , std::string(""));
+  std::string ISAsS         = CfgParser.getParam1stArg("ISAs"        , std::string(""));
+  Params.MinIters           = CfgParser.getParam1stArg("MinIters"    , xBench::c_DefMinIters  );
+  Params.MinTimeS           = CfgParser.getParam1stArg("MinTime"     , xBench::c_DefMinTimeS  );
+  Params.BandHeight         = CfgParser.getParam1stArg("BandHeight"  , xBench::c_DefBandHeight);
+  std::string CsvFile       = CfgParser.getParam1stArg("CsvFile"     , std::string(""));
+  std::string JsonFile      = CfgParser.getParam1stArg("JsonFile"    , std::string(""));
+  int32       CheckCases    = CfgParser.getParam1stArg("CheckCases"  , 0);
+  uint32      CheckSeed     = (uint32)CfgParser.getParam1stArg("Seed", (int64)xKernelCheck::c_DefSeed);
+  Params.VerboseLevel       = CfgParser.getParam1stArg("VerboseLevel", 1);
+
+  try
+  {
+    if(!ResolutionsS .empty()) { Params.Resolutions.clear(); for(const std::string& R : xSplitList(ResolutionsS)) { Params.Resolutions.push_back(xString::scanResolution(R)); } }
+    if(!BitDepthsS   .empty()) { Params.BitDepths    = xSplitIntList(BitDepthsS   ); }
+    if(!SearchRangesS.empty()) { Params.SearchRanges = xSplitIntList(SearchRangesS); }
+    if(!HugePagesS   .empty()) { Params.HugePages    = xSplitIntList(HugePagesS   ); }
+  }
+  catch(const std::exception&) { xCfgINI::printErrorMessage("! invalid list of values\n", HelpString); return EXIT_FAILURE; }
+  Params.Kernels = xSplitList(KernelsS);
+  Params.ISAs    = xSplitList(ISAsS   );
+
+  //validation
+  for(const int32V2& R  : Params.Resolutions ) { if(R.getX() <= 0 || R.getY() <= 0 || (R.getX() & 1) || (R.getY() & 1)) { xCfgINI::printErrorMessage("! invalid resolution (positive and even values required)\n", HelpString); return EXIT_FAILURE; } }
+  for(const int32   BD : Params.BitDepths   ) { if(BD < 8 || BD > 14                                                  ) { xCfgINI::printErrorMessage("! invalid bit depth (8-14 allowed)\n"                     , HelpString); return EXIT_FAILURE; } }
+  for(const int32   SR : Params.SearchRanges) { if(SR < 1 || SR > 16                                                  ) { xCfgINI::printErrorMessage("! invalid search range (1-16 allowed)\n"                 , HelpString); return EXIT_FAILURE; } }
+  for(const int32   HP : Params.HugePages   ) { if(HP < 0 || HP > 2                                                   ) { xCfgINI::printErrorMessage("! invalid huge pages mode (0-2 allowed)\n"               , HelpString); return EXIT_FAILURE; } }
+  if(Params.MinIters <= 0 || Params.MinTimeS < 0 || Params.BandHeight <= 0) { xCfgINI::printErrorMessage("! invalid timing parameters\n", HelpString); return EXIT_FAILURE; }
+  if(CheckCases < 0) { xCfgINI::printErrorMessage("! invalid number of check cases\n", HelpString); return EXIT_FAILURE; }
+
+  //==============================================================================
+  // check mode
+  if(CheckCases > 0)
+  {
+    xKernelCheck::xParams CheckParams;
+    CheckParams.NumCases     = CheckCases;
+    CheckParams.Seed         = CheckSeed;
+    CheckParams.Kernels      = Params.Kernels;
+    CheckParams.VerboseLevel = Params.VerboseLevel;
+    if(Params.VerboseLevel >= 1)
+    {
+      fmt::printf("CheckCases       = %d\n", CheckParams.NumCases);
+      fmt::printf("Seed             = 0x%08X\n", CheckParams.Seed);
+    }
+
+    xKernelCheck Check(CheckParams);
+    const bool Passed = Check.run();
+    fmt::printf("\nNumberOfMismatches = %d\n", Check.getNumMismatches());
+    return Passed ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  if(Params.VerboseLevel >= 1)
+  {
+    std::string ISAs;
+    for(const std::string_view ISA : xBench::getAvailableISAs()) { ISAs += fmt::format(ISAs.empty() ? "{}" : ",{}", ISA); }
+    fmt::printf("Compiled ISAs    = %s\n", ISAs);
+    fmt::printf("MinIters         = %d\n", Params.MinIters);
+    fmt::printf("MinTime          = %.3fs\n", Params.MinTimeS);
+    fmt::printf("BandHeight       = %d\n", Params.BandHeight);
+  }
+
+  //dTLB misses are reported if counter is available (optional - benchmark runs without it)
+  const bool PerfCountersOK = xPerfCounters::enable() && xPerfCounters::isAvailable(xPerfCounters::eCounter::DTLBLoadMisses);
+  if(Params.VerboseLevel >= 1) { fmt::printf("DTLBCounter      = %d\n", PerfCountersOK); }
+
+  //==============================================================================
+  // running
+  xBench Bench(Params);
+  Bench.run();
+
+  //==============================================================================
+  // output
+  if(!CsvFile .empty() && !xBench::writeFile(CsvFile , Bench.formatCSV ())) { fmt::printf("ERROR --> cannot write results file %s\n", CsvFile ); return EXIT_FAILURE; }
+  if(!JsonFile.empty() && !xBench::writeFile(JsonFile, Bench.formatJSON())) { fmt::printf("ERROR --> cannot write results file %s\n", JsonFile); return EXIT_FAILURE; }
+
+  fmt::printf("\nNumberOfResults  = %d\n", (int32)Bench.getResults().size());
+  return EXIT_SUCCESS;
+}
+
+//===============================================================================================================================================================================================================
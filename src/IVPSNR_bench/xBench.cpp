@@ -0,0 +1,437 @@
+﻿/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2021, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ // Original authors: Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+ //                   Adrian Dziembowski, adrian.dziembowski@put.poznan.pl,
+ //                   Poznan University of Technology, Poznań, Poland
+
+#include "xBench.h"
+#include "xBenchCommon.h"
+#include "xPlane.h"
+#include "xMemory.h"
+#include "xPerfCounters.h"
+#include "fmt/chrono.h"
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <ctime>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xBench
+//===============================================================================================================================================================================================================
+void xBench::run()
+{
+  const int32 MaxSearchRange = m_Params.SearchRanges.empty() ? xIVPSNR::c_DefaultSearchRange : *std::max_element(m_Params.SearchRanges.begin(), m_Params.SearchRanges.end());
+  const int32 Margin         = MaxSearchRange; //same as IV-PSNR app - margin covers search window only
+
+  for(const int32 HugePages : m_Params.HugePages)
+  {
+    m_HugePages = HugePages;
+    xMemory::setHugePages((xMemory::eHugePages)HugePages); //pictures are allocated inside kernel groups
+    for(const int32V2& Size : m_Params.Resolutions)
+    {
+      for(const int32 BitDepth : m_Params.BitDepths)
+      {
+        m_Size     = Size;
+        m_BitDepth = BitDepth;
+        if(m_Params.VerboseLevel >= 1) { fmt::printf("\n--- %dx%d %dbps (margin %d, huge pages %s) ---\n", Size.getX(), Size.getY(), BitDepth, Margin, xMemory::HugePagesToString((xMemory::eHugePages)HugePages)); }
+        xRunDistortion(Margin);
+        xRunPixelOps  (Margin);
+        xRunIVPSNR    (Margin);
+      }
+    }
+  }
+  xMemory::setHugePages(xMemory::eHugePages::Disabled);
+
+  if(m_Params.VerboseLevel >= 1 && m_Params.HugePages.size() > 1) { xPrintHugePagesEffect(); }
+}
+std::vector<std::string_view> xBench::getAvailableISAs()
+{
+  std::vector<std::string_view> ISAs = { "STD" };
+#if X_CAN_USE_SSE
+  ISAs.push_back("SSE");
+#endif //X_CAN_USE_SSE
+#if X_CAN_USE_AVX
+  ISAs.push_back("AVX");
+#endif //X_CAN_USE_AVX
+  return ISAs;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// xBench - kernel groups
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xBench::xRunDistortion(int32 Margin)
+{
+  m_SearchRange = 0;
+  xPlane<uint16> Org(m_Size, m_BitDepth, Margin);
+  xPlane<uint16> Tst(m_Size, m_BitDepth, Margin);
+  xPlane<uint16> Msk(m_Size, m_BitDepth, Margin);
+  xBenchData::genPicture  (Org.getBuffer(), Org.getStride(), m_Size.getY() + 2 * Margin, m_BitDepth, c_Seed);
+  xBenchData::genDistorted(Tst.getBuffer(), Org.getBuffer(), Org.getBuffNumPels(), m_BitDepth, xBenchData::getDefNoiseAmp(m_BitDepth), c_Seed + 1);
+  xBenchData::genMask     (Msk.getBuffer(), Msk.getBuffNumPels(), m_BitDepth, c_Seed + 2);
+
+  const uint16* O = Org.getAddr(); const uint16* OB = Org.getBuffer();
+  const uint16* T = Tst.getAddr(); const uint16* TB = Tst.getBuffer();
+  const uint16* M = Msk.getAddr(); const uint16* MB = Msk.getBuffer();
+  const int32   S = Org.getStride();
+  const int32   W = m_Size.getX();
+  const int32   H = m_Size.getY();
+  const int32   A = Org.getBuffNumPels();
+  const int64   P = (int64)W * H;
+
+  xMeasure("xDistortion", "CalcSD/Area"          , A, 4 * (int64)A, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcSD         (OB, TB,              A      ); }));
+  xMeasure("xDistortion", "CalcSD/Stride"        , P, 4 *        P, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcSD         (O , T ,     S, S,    W, H); }));
+  xMeasure("xDistortion", "CalcSSD/Area"         , A, 4 * (int64)A, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcSSD        (OB, TB,              A      ); }));
+  xMeasure("xDistortion", "CalcSSD/Stride"       , P, 4 *        P, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcSSD        (O , T ,     S, S,    W, H); }));
+  xMeasure("xDistortion", "CalcWeightedSD/Area"  , A, 6 * (int64)A, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcWeightedSD (OB, TB, MB,           A      ); }, xKernelVariants::c_IncludeUntested));
+  xMeasure("xDistortion", "CalcWeightedSD/Stride", P, 6 *        P, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcWeightedSD (O , T , M , S, S, S, W, H); }, xKernelVariants::c_IncludeUntested));
+  xMeasure("xDistortion", "CalcWeightedSSD/Area" , A, 6 * (int64)A, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcWeightedSSD(OB, TB, MB,           A      ); }, xKernelVariants::c_IncludeUntested));
+  xMeasure("xDistortion", "CalcWeightedSSD/Stride",P, 6 *        P, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcWeightedSSD(O , T , M , S, S, S, W, H); }, xKernelVariants::c_IncludeUntested));
+
+  if(xIsSelected("xDistortion", "CalcSSD/Flow"))
+  {
+    xPlane<flt32V2> FlowO(m_Size, 0, Margin);
+    xPlane<flt32V2> FlowT(m_Size, 0, Margin);
+    xBenchData::genFlow(FlowO.getBuffer(), FlowO.getBuffNumPels(), c_Seed + 3);
+    xBenchData::genFlow(FlowT.getBuffer(), FlowT.getBuffNumPels(), c_Seed + 4);
+    const flt32V2* FO = FlowO.getBuffer();
+    const flt32V2* FT = FlowT.getBuffer();
+    xMeasure("xDistortion", "CalcSSD/Flow", A, 16 * (int64)A, { { "STD", [=]() { return xDistortionSTD::CalcSSD(FO, FT, A); } } });
+  }
+}
+void xBench::xRunPixelOps(int32 Margin)
+{
+  m_SearchRange = 0;
+  const int32   W     = m_Size.getX();
+  const int32   H     = m_Size.getY();
+  const int64   P     = (int64)W * H;
+  const int32V2 SizeH = { W >> 1, H >> 1 };
+  const int64   PH    = (int64)SizeH.getX() * SizeH.getY();
+
+  xPlane<uint16> Org (m_Size, m_BitDepth, Margin);
+  xPlane<uint16> Dst (m_Size, m_BitDepth, Margin);
+  xPlane<uint16> Msk (m_Size, m_BitDepth, Margin);
+  xPlane<uint8 > Org8(m_Size, 8         , Margin);
+  xPlane<uint8 > Dst8(m_Size, 8         , Margin);
+  xBenchData::genPicture(Org .getBuffer(), Org .getStride(), H + 2 * Margin, m_BitDepth, c_Seed    );
+  xBenchData::genPicture(Org8.getBuffer(), Org8.getStride(), H + 2 * Margin, 8         , c_Seed + 5);
+  xBenchData::genMask   (Msk .getBuffer(), Msk .getBuffNumPels(), m_BitDepth, c_Seed + 2);
+  Dst .clear();
+  Dst8.clear();
+
+  uint16* D  = Dst .getAddr(); const uint16* O  = Org .getAddr(); const int32 S  = Org .getStride();
+  uint8*  D8 = Dst8.getAddr(); const uint8*  O8 = Org8.getAddr(); const int32 S8 = Org8.getStride();
+  const uint16* M = Msk.getAddr();
+  const int32   B = m_BitDepth;
+
+  xMeasure("xPixelOps", "Copy"         , P, 4 * P, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::Copy(D, O, S, S, W, H); return 0; }));
+  xMeasure("xPixelOps", "Cvt/U8toU16"  , P, 3 * P, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::Cvt(D , O8, S , S8, W, H); return 0; }));
+  xMeasure("xPixelOps", "Cvt/U16toU8"  , P, 3 * P, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::Cvt(D8, O , S8, S , W, H); return 0; }));
+
+  //2:1 resampling - source/destination in half resolution
+  {
+    xPlane<uint16> OrgH (SizeH, m_BitDepth, Margin);
+    xPlane<uint16> DstH (SizeH, m_BitDepth, Margin);
+    xPlane<uint8 > Org8H(SizeH, 8         , Margin);
+    xPlane<uint8 > Dst8H(SizeH, 8         , Margin);
+    xBenchData::genPicture(OrgH .getBuffer(), OrgH .getStride(), SizeH.getY() + 2 * Margin, m_BitDepth, c_Seed + 6);
+    xBenchData::genPicture(Org8H.getBuffer(), Org8H.getStride(), SizeH.getY() + 2 * Margin, 8         , c_Seed + 7);
+    const uint16* OH  = OrgH .getAddr(); uint16* DH  = DstH .getAddr(); const int32 SH  = OrgH .getStride();
+    const uint8*  O8H = Org8H.getAddr(); uint8*  D8H = Dst8H.getAddr(); const int32 S8H = Org8H.getStride();
+
+    xMeasure("xPixelOps", "Upsample"     , P, 2 * P + 2 * PH, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::Upsample   (D , OH , S , SH , W, H); return 0; }));
+    xMeasure("xPixelOps", "CvtUpsample"  , P, 2 * P +     PH, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::CvtUpsample(D , O8H, S , S8H, W, H); return 0; }));
+    xMeasure("xPixelOps", "Downsample"   , P, 2 * P + 2 * PH, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::Downsample   (DH , O, SH , S, SizeH.getX(), SizeH.getY()); return 0; }));
+    xMeasure("xPixelOps", "CvtDownsample", P, 2 * P +     PH, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::CvtDownsample(D8H, O, S8H, S, SizeH.getX(), SizeH.getY()); return 0; }));
+  }
+
+  //packed file layouts - P010/P016 luma, semi-planar CbCr pairs (Org/Org8 lines reused as pair lines) and v210, chroma is written in full resolution
+  xMeasure("xPixelOps", "CopyShr", P, 4 * P, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::CopyShr(D, O, S, S, W, H, 16 - B); return 0; }));
+  if(xIsSelected("xPixelOps", "UpsampleUV") || xIsSelected("xPixelOps", "CvtUpsampleUV") || xIsSelected("xPixelOps", "UnpackV210"))
+  {
+    xPlane<uint16> DstU(m_Size, m_BitDepth, Margin);
+    xPlane<uint16> DstV(m_Size, m_BitDepth, Margin);
+    uint16* DU = DstU.getAddr(); uint16* DV = DstV.getAddr();
+    xMeasure("xPixelOps", "UpsampleUV"   , 2 * P, 4 * P + P, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::UpsampleUV   (DU, DV, O , S, S , W, H, 16 - B); return 0; }));
+    xMeasure("xPixelOps", "CvtUpsampleUV", 2 * P, 4 * P + P / 2, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::CvtUpsampleUV(DU, DV, O8, S, S8, W, H); return 0; }));
+
+    const int32 SW = ((W + 47) / 48) * 32; //words - lines are padded to 48 pels (128 bytes)
+    std::vector<uint32> V210((size_t)SW * H);
+    for(int32 i = 0; i < (int32)V210.size(); i++) { V210[i] = (uint32)(i * 2654435761u) & 0x3FFFFFFF; }
+    const uint32* SV = V210.data();
+    xMeasure("xPixelOps", "UnpackV210", P, 6 * P + 4 * (int64)SW * H, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::UnpackV210(D, DU, DV, SV, S, SW, W, H); return 0; }));
+  }
+
+  xMeasure("xPixelOps", "CheckValues"  , P, 2 * P, xKernelVariants::PixelOps<uint64()>([=](auto I) { return decltype(I)::CheckValues (O, S, W, H, B); }));
+  xMeasure("xPixelOps", "FindBroken"   , P, 2 * P, xKernelVariants::PixelOps<uint64()>([=](auto I) { return decltype(I)::FindBroken  (O, S, W, H, B); }));
+  xMeasure("xPixelOps", "CountNonZero" , P, 2 * P, xKernelVariants::PixelOps<uint64()>([=](auto I) { return decltype(I)::CountNonZero(M, S, W, H   ); }));
+
+  if(xIsSelected("xPixelOps", "Interleave"))
+  {
+    xPicI Dst4(m_Size, m_BitDepth, Margin);
+    uint16*     D4  = (uint16*)Dst4.getAddr();
+    const int32 S4  = Dst4.getStride() * xPicCommon::c_MaxNumCmps;
+    const uint16* T = Dst.getAddr();
+    xMeasure("xPixelOps", "Interleave" , P, 14 * P, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::Interleave(D4, O, T, M, 0, S4, S, W, H); return 0; }));
+  }
+  if(xIsSelected("xPixelOps", "CvtInterleave"))
+  {
+    xPicI8 Dst4(m_Size, 8, Margin);
+    uint8*      D4  = (uint8*)Dst4.getAddr();
+    const int32 S4  = Dst4.getStride() * xPicCommon::c_MaxNumCmps;
+    const uint16* T = Dst.getAddr();
+    xMeasure("xPixelOps", "CvtInterleave" , P, 10 * P, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::CvtInterleave(D4, O, T, M, 0, S4, S, W, H); return 0; }));
+  }
+
+  //margin extension - elements = margin samples
+  const int64 MarginPels = (int64)(W + 2 * Margin) * (H + 2 * Margin) - P;
+  xMeasure("xPixelOps", "ExtendMargin", MarginPels, 2 * MarginPels, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::ExtendMargin(D, S, W, H, Margin); return 0; }));
+  if(xIsSelected("xPixelOps", "ExtendMargin/Flow"))
+  {
+    xPlane<flt32V2> Flow(m_Size, 0, Margin);
+    xBenchData::genFlow(Flow.getBuffer(), Flow.getBuffNumPels(), c_Seed + 3);
+    flt32V2*    F  = Flow.getAddr();
+    const int32 SF = Flow.getStride();
+    xMeasure("xPixelOps", "ExtendMargin/Flow", MarginPels, 8 * MarginPels, xKernelVariants::PixelOps<uint64()>([=](auto I) { decltype(I)::ExtendMargin(F, SF, W, H, Margin); return 0; }));
+  }
+}
+void xBench::xRunIVPSNR(int32 Margin)
+{
+  //IV-PSNR row kernels are compute bound (window search for every sample), cost does not depend on picture height
+  const int32   BandHeight = xMin(m_Size.getY(), m_Params.BandHeight);
+  const int32V2 BandSize   = { m_Size.getX(), BandHeight };
+  const int64   P          = (int64)BandSize.getX() * BandSize.getY();
+
+  xPicP RefP(BandSize, m_BitDepth, Margin), TstP(BandSize, m_BitDepth, Margin), MskP(BandSize, m_BitDepth, Margin);
+  xPicI RefI(BandSize, m_BitDepth, Margin), TstI(BandSize, m_BitDepth, Margin);
+  xBenchData::genPicture  (&RefP, c_Seed);
+  xBenchData::genDistorted(&TstP, &RefP, xBenchData::getDefNoiseAmp(m_BitDepth), c_Seed + 1);
+  MskP.clear();
+  xBenchData::genMask(MskP.getBuffer(eCmp::LM), MskP.getBuffNumPels(), m_BitDepth, c_Seed + 2);
+  RefI.rearrangeFromPlanar(&RefP);
+  TstI.rearrangeFromPlanar(&TstP);
+
+  const xPicP* RP = &RefP; const xPicP* TP = &TstP; const xPicP* MP = &MskP;
+  const xPicI* RI = &RefI; const xPicI* TI = &TstI;
+  const int32  W  = BandSize.getX();
+  const int32  H  = BandSize.getY();
+  const int32  S  = RefP.getStride();
+  const int32V4 GCS = { 0, 0, 0, 0 };
+  const int32V4 CW  = xIVPSNR::c_DefaultCmpWeights;
+
+  m_SearchRange = 0;
+  xMeasure("xIVPSNR", "AvgColorDiff" , P, 4 * P, { { "STD", [=]() { return (uint64)(xIVPSNRKernels::xCalcAvgColorDiff (RP->getAddr(eCmp::LM), TP->getAddr(eCmp::LM), S, S, W, H) * 1024.0); } } });
+  xMeasure("xIVPSNR", "SumColorDiffM", P, 6 * P, { { "STD", [=]() { return (uint64)xIVPSNRKernels::xCalcSumColorDiffM(RP->getAddr(eCmp::LM), TP->getAddr(eCmp::LM), MP->getAddr(eCmp::LM), S, S, S, W, H); } } });
+
+  for(const int32 SearchRange : m_Params.SearchRanges)
+  {
+    m_SearchRange = SearchRange;
+    const int32 SR = SearchRange;
+    auto RowsP = [=]() { int32V4  D = { 0, 0, 0, 0 }; for(int32 y = 0; y < H; y++) { D += xIVPSNRKernels::xCalcDistAsymmetricRow     (RP, TP,     y, GCS, SR, CW); } return (uint64)D.getSum(); };
+    auto RowsI = [=]() { int32V4  D = { 0, 0, 0, 0 }; for(int32 y = 0; y < H; y++) { D += xIVPSNRKernels::xCalcDistAsymmetricRow_STD (RI, TI,     y, GCS, SR, CW); } return (uint64)D.getSum(); };
+    auto RowsM = [=]() { uint64V4 D = { 0, 0, 0, 0 }; for(int32 y = 0; y < H; y++) { D += xIVPSNRKernels::xCalcDistAsymmetricRowM_STD(RI, TI, MP, y, GCS, SR, CW); } return (uint64)D.getSum(); };
+#if X_CAN_USE_SSE
+    auto RowsISSE = [=]() { int32V4 D = { 0, 0, 0, 0 }; for(int32 y = 0; y < H; y++) { D += xIVPSNRKernels::xCalcDistAsymmetricRow_SSE(RI, TI, y, GCS, SR, CW); } return (uint64)D.getSum(); };
+#endif //X_CAN_USE_SSE
+
+    xMeasure("xIVPSNR", "DistAsymmetricRow/Planar", P, 12 * P, { { "STD", RowsP } });
+    xMeasure("xIVPSNR", "DistAsymmetricRow/Interleaved", P, 16 * P, {
+      { "STD", RowsI },
+#if X_CAN_USE_SSE
+      { "SSE", RowsISSE },
+#endif //X_CAN_USE_SSE
+    });
+    xMeasure("xIVPSNR", "DistAsymmetricRowM/Interleaved", P, 18 * P, { { "STD", RowsM } });
+  }
+
+  //native 8-bit interleaved pictures (8-bit content only)
+  if(!xIsSelected("xIVPSNR", "DistAsymmetricRow/Interleaved8")) { return; }
+  xPicP RefP8(BandSize, 8, Margin), TstP8(BandSize, 8, Margin);
+  xPicI8 RefI8(BandSize, 8, Margin), TstI8(BandSize, 8, Margin);
+  xBenchData::genPicture  (&RefP8, c_Seed);
+  xBenchData::genDistorted(&TstP8, &RefP8, xBenchData::getDefNoiseAmp(8), c_Seed + 1);
+  RefI8.rearrangeFromPlanar(&RefP8);
+  TstI8.rearrangeFromPlanar(&TstP8);
+  const xPicI8* RI8 = &RefI8; const xPicI8* TI8 = &TstI8;
+
+  for(const int32 SearchRange : m_Params.SearchRanges)
+  {
+    m_SearchRange = SearchRange;
+    const int32 SR = SearchRange;
+    auto RowsI8 = [=]() { int32V4 D = { 0, 0, 0, 0 }; for(int32 y = 0; y < H; y++) { D += xIVPSNRKernels::xCalcDistAsymmetricRow_STD(RI8, TI8, y, GCS, SR, CW); } return (uint64)D.getSum(); };
+#if X_CAN_USE_SSE
+    auto RowsI8SSE = [=]() { int32V4 D = { 0, 0, 0, 0 }; for(int32 y = 0; y < H; y++) { D += xIVPSNRKernels::xCalcDistAsymmetricRow_SSE(RI8, TI8, y, GCS, SR, CW); } return (uint64)D.getSum(); };
+#endif //X_CAN_USE_SSE
+
+    xMeasure("xIVPSNR", "DistAsymmetricRow/Interleaved8", P, 8 * P, {
+      { "STD", RowsI8 },
+#if X_CAN_USE_SSE
+      { "SSE", RowsI8SSE },
+#endif //X_CAN_USE_SSE
+    });
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// xBench - measurement
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool xBench::xIsSelected(std::string_view Group, std::string_view Kernel) const
+{
+  if(m_Params.Kernels.empty()) { return true; }
+  const std::string FullName = std::string(Group) + "::" + std::string(Kernel);
+  for(const std::string& Filter : m_Params.Kernels) { if(FullName.find(Filter) != std::string::npos) { return true; } }
+  return false;
+}
+bool xBench::xIsSelected(std::string_view Group, std::string_view Kernel, std::string_view ISA) const
+{
+  if(!xIsSelected(Group, Kernel)) { return false; }
+  if(m_Params.ISAs.empty()) { return true; }
+  return std::find(m_Params.ISAs.begin(), m_Params.ISAs.end(), ISA) != m_Params.ISAs.end();
+}
+void xBench::xMeasure(std::string_view Group, std::string_view Kernel, int64 NumPels, int64 NumBytes, const tVariants& Variants)
+{
+  static volatile uint64 Sink = 0; //prevents elimination of kernels with unused result
+
+  flt64 ReferenceNs = 0;
+  for(const auto& [ISA, Func] : Variants)
+  {
+    if(!xIsSelected(Group, Kernel, ISA)) { continue; }
+
+    const uint64 Result = Func(); //warm-up (page faults, caches, branch predictors)
+
+    std::vector<flt64> Samples;
+    Samples.reserve(m_Params.MaxIters);
+    const bool                   CountTLB = xPerfCounters::isEnabled() && xPerfCounters::isAvailable(xPerfCounters::eCounter::DTLBLoadMisses);
+    const xPerfCounters::xValues PerfBeg  = CountTLB ? xPerfCounters::readAll() : xPerfCounters::xValues();
+    const tTimePoint BegAll = tClock::now();
+    while((int32)Samples.size() < m_Params.MaxIters)
+    {
+      const tTimePoint Beg = tClock::now();
+      Sink = Sink + Func();
+      const tTimePoint End = tClock::now();
+      Samples.push_back(std::chrono::duration<flt64, std::nano>(End - Beg).count());
+      if((int32)Samples.size() >= m_Params.MinIters && tDurationS(End - BegAll).count() >= m_Params.MinTimeS) { break; }
+    }
+    const xPerfCounters::xValues PerfEnd = CountTLB ? xPerfCounters::readAll() : xPerfCounters::xValues();
+    std::sort(Samples.begin(), Samples.end());
+
+    xResult R;
+    R.Group       = Group;
+    R.Kernel      = Kernel;
+    R.ISA         = ISA;
+    R.Size        = m_Size;
+    R.BitDepth    = m_BitDepth;
+    R.SearchRange = m_SearchRange;
+    R.HugePages   = m_HugePages;
+    R.NumPels     = NumPels;
+    R.NumBytes    = NumBytes;
+    R.NumIters    = (int32)Samples.size();
+    R.MinNs       = Samples.front();
+    R.MedianNs    = Samples[Samples.size() >> 1];
+    R.Result      = Result;
+    if(ISA == "STD") { ReferenceNs = R.MedianNs; }
+    R.Speedup     = ReferenceNs > 0 ? ReferenceNs / R.MedianNs : 0;
+    R.DTLBMisses  = CountTLB ? (PerfEnd - PerfBeg).get(xPerfCounters::eCounter::DTLBLoadMisses) / (flt64)R.NumIters : -1.0;
+
+    if(m_Params.VerboseLevel >= 1) { xPrintResult(R); }
+    m_Results.push_back(std::move(R));
+  }
+}
+void xBench::xPrintResult(const xResult& R) const
+{
+  const std::string TLB = R.DTLBMisses >= 0 ? fmt::sprintf("  %8.3f dTLB/kpel", R.getDTLBPerKiloPel()) : std::string();
+  fmt::printf("%-11s %-30s %-3s SR%d  %8.4f ns/pel  %7.2f GB/s  x%5.2f%s  (%d iters, min %.4f ns/pel)\n",
+    R.Group, R.Kernel, R.ISA, R.SearchRange, R.getNsPerPel(), R.getGBps(), R.Speedup, TLB, R.NumIters, R.MinNs / (flt64)R.NumPels);
+}
+void xBench::xPrintHugePagesEffect() const
+{
+  fmt::printf("\n--- huge pages effect (relative to regular pages) ---\n");
+  for(const xResult& R : m_Results)
+  {
+    if(R.HugePages == (int32)xMemory::eHugePages::Disabled) { continue; }
+    auto IsBase = [&R](const xResult& B) { return B.HugePages == (int32)xMemory::eHugePages::Disabled && B.Group == R.Group && B.Kernel == R.Kernel && B.ISA == R.ISA && B.Size == R.Size && B.BitDepth == R.BitDepth && B.SearchRange == R.SearchRange; };
+    auto Base = std::find_if(m_Results.begin(), m_Results.end(), IsBase);
+    if(Base == m_Results.end()) { continue; }
+    const std::string TLB = R.DTLBMisses >= 0 && Base->DTLBMisses >= 0 ? fmt::sprintf("  dTLB/kpel %8.3f -> %8.3f", Base->getDTLBPerKiloPel(), R.getDTLBPerKiloPel()) : std::string();
+    fmt::printf("%-11s %-30s %-3s SR%d  %dx%d %2dbps  %-11s  time x%5.3f%s\n",
+      R.Group, R.Kernel, R.ISA, R.SearchRange, R.Size.getX(), R.Size.getY(), R.BitDepth, xMemory::HugePagesToString((xMemory::eHugePages)R.HugePages), R.MedianNs / Base->MedianNs, TLB);
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// xBench - output
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::string xBench::formatCSV() const
+{
+  std::string Result = "Group,Kernel,ISA,Width,Height,BitDepth,SearchRange,HugePages,NumPels,NumBytes,Iters,MinNs,MedianNs,NsPerPel,GBps,Speedup,DTLBPerKPel,Result\n";
+  for(const xResult& R : m_Results)
+  {
+    Result += fmt::sprintf("%s,%s,%s,%d,%d,%d,%d,%d,%d,%d,%d,%.1f,%.1f,%.6f,%.4f,%.4f,%.4f,%d\n",
+      R.Group, R.Kernel, R.ISA, R.Size.getX(), R.Size.getY(), R.BitDepth, R.SearchRange, R.HugePages, R.NumPels, R.NumBytes, R.NumIters, R.MinNs, R.MedianNs, R.getNsPerPel(), R.getGBps(), R.Speedup, R.getDTLBPerKiloPel(), R.Result);
+  }
+  return Result;
+}
+std::string xBench::formatJSON() const
+{
+  std::string ISAs;
+  for(const std::string_view ISA : getAvailableISAs()) { ISAs += fmt::format(ISAs.empty() ? "\"{}\"" : ", \"{}\"", ISA); }
+
+  std::string Result = "{\n";
+  Result += fmt::sprintf("  \"Timestamp\": \"%s\",\n", fmt::format("{:%Y-%m-%dT%H:%M:%S}", fmt::localtime(std::time(nullptr))));
+  Result += fmt::sprintf("  \"Compiler\": \"%s\",\n", X_COMPILER_NAME);
+  Result += fmt::sprintf("  \"ISAs\": [%s],\n", ISAs);
+  Result += fmt::sprintf("  \"HardwareThreads\": %d,\n", std::thread::hardware_concurrency());
+  Result += fmt::sprintf("  \"MinIters\": %d, \"MaxIters\": %d, \"MinTimeS\": %.3f, \"BandHeight\": %d,\n", m_Params.MinIters, m_Params.MaxIters, m_Params.MinTimeS, m_Params.BandHeight);
+  Result += "  \"Results\": [\n";
+  for(int32 i = 0; i < (int32)m_Results.size(); i++)
+  {
+    const xResult& R = m_Results[i];
+    Result += fmt::sprintf("    {\"Group\": \"%s\", \"Kernel\": \"%s\", \"ISA\": \"%s\", \"Width\": %d, \"Height\": %d, \"BitDepth\": %d, \"SearchRange\": %d, \"HugePages\": %d, \"NumPels\": %d, \"NumBytes\": %d, \"Iters\": %d, \"MinNs\": %.1f, \"MedianNs\": %.1f, \"NsPerPel\": %.6f, \"GBps\": %.4f, \"Speedup\": %.4f, \"DTLBPerKPel\": %.4f, \"Result\": %d}%s\n",
+      R.Group, R.Kernel, R.ISA, R.Size.getX(), R.Size.getY(), R.BitDepth, R.SearchRange, R.HugePages, R.NumPels, R.NumBytes, R.NumIters, R.MinNs, R.MedianNs, R.getNsPerPel(), R.getGBps(), R.Speedup, R.getDTLBPerKiloPel(), R.Result, i + 1 < (int32)m_Results.size() ? "," : "");
+  }
+  Result += "  ]\n}\n";
+  return Result;
+}
+bool xBench::writeFile(const std::string& FileName, const std::string& Content)
+{
+  std::ofstream File(FileName, std::ios::out | std::ios::trunc);
+  if(!File.is_open()) { return false; }
+  File << Content;
+  return File.good();
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
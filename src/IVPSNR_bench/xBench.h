@@ -0,0 +1,138 @@
+﻿#pragma once
+
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2021, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ // Original authors: Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+ //                   Adrian Dziembowski, adrian.dziembowski@put.poznan.pl,
+ //                   Poznan University of Technology, Poznań, Poland
+
+#include "xCommonDefIVPSNR.h"
+#include "xVec.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xBench - single threaded kernel micro-benchmark on synthetic pictures
+//===============================================================================================================================================================================================================
+class xBench
+{
+public:
+  static constexpr int32  c_DefMinIters   = 5;
+  static constexpr int32  c_DefMaxIters   = 1000;
+  static constexpr flt64  c_DefMinTimeS   = 0.1;
+  static constexpr int32  c_DefBandHeight = 128;
+  static constexpr uint32 c_Seed          = 0x1F0C5EED;
+
+  struct xParams
+  {
+    std::vector<int32V2    > Resolutions  = { {1920, 1080}, {3840, 2160}, {7680, 4320}, {15360, 8640} };
+    std::vector<int32      > BitDepths    = { 8, 10, 12, 14 };
+    std::vector<int32      > SearchRanges = { 1, 2, 3, 4 };
+    std::vector<int32      > HugePages    = { 0 }; //xMemory::eHugePages modes of picture buffers
+    std::vector<std::string> Kernels;      //substring filter applied to "Group::Kernel", empty = all
+    std::vector<std::string> ISAs;         //exact match filter, empty = all
+    int32                    MinIters     = c_DefMinIters;
+    int32                    MaxIters     = c_DefMaxIters;
+    flt64                    MinTimeS     = c_DefMinTimeS;
+    int32                    BandHeight   = c_DefBandHeight; //number of rows processed by IV-PSNR row kernels
+    int32                    VerboseLevel = 1;
+  };
+
+  struct xResult
+  {
+    std::string Group;
+    std::string Kernel;
+    std::string ISA;
+    int32V2     Size;
+    int32       BitDepth;
+    int32       SearchRange; //0 for kernels without search window
+    int32       HugePages;   //xMemory::eHugePages mode of picture buffers
+    int64       NumPels;     //elements processed per call
+    int64       NumBytes;    //compulsory memory traffic per call (reads + writes)
+    int32       NumIters;
+    flt64       MinNs;       //per call
+    flt64       MedianNs;    //per call
+    uint64      Result;      //value returned by first call (0 for kernels without return value)
+    flt64       Speedup;     //relative to STD variant of the same kernel (0 if STD was not measured)
+    flt64       DTLBMisses;  //dTLB load misses per call (negative if counter is not available)
+
+    flt64 getNsPerPel      () const { return MedianNs / (flt64)NumPels; }
+    flt64 getDTLBPerKiloPel() const { return DTLBMisses >= 0 ? DTLBMisses * 1000.0 / (flt64)NumPels : -1.0; }
+    flt64 getGBps    () const { return (flt64)NumBytes / MedianNs; } //bytes/ns == GB/s
+  };
+
+protected:
+  xParams              m_Params;
+  std::vector<xResult> m_Results;
+
+  //current configuration
+  int32V2 m_Size        = { 0, 0 };
+  int32   m_BitDepth    = 0;
+  int32   m_SearchRange = 0;
+  int32   m_HugePages   = 0;
+
+public:
+  xBench(const xParams& Params) : m_Params(Params) {}
+
+  void run();
+
+  const std::vector<xResult>& getResults() const { return m_Results; }
+  static std::vector<std::string_view> getAvailableISAs();
+
+  std::string formatCSV () const;
+  std::string formatJSON() const;
+  static bool writeFile (const std::string& FileName, const std::string& Content);
+
+protected:
+  using tVariant  = std::pair<std::string_view, std::function<uint64()>>;
+  using tVariants = std::vector<tVariant>;
+
+  void xRunDistortion(int32 Margin);
+  void xRunPixelOps  (int32 Margin);
+  void xRunIVPSNR    (int32 Margin);
+
+  bool xIsSelected (std::string_view Group, std::string_view Kernel                      ) const;
+  bool xIsSelected (std::string_view Group, std::string_view Kernel, std::string_view ISA) const;
+  void xMeasure    (std::string_view Group, std::string_view Kernel, int64 NumPels, int64 NumBytes, const tVariants& Variants);
+  void xPrintResult(const xResult& Result) const;
+  void xPrintHugePagesEffect() const; //compares results of each HugePages mode against regular pages
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,79 @@
+﻿/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2021, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ // Original authors: Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+ //                   Adrian Dziembowski, adrian.dziembowski@put.poznan.pl,
+ //                   Poznan University of Technology, Poznań, Poland
+
+#include "xBenchCommon.h"
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xBenchData
+//===============================================================================================================================================================================================================
+void xBenchData::genDistorted(uint16* Dst, const uint16* Src, int32 NumPels, int32 BitDepth, int32 NoiseAmp, uint32 Seed)
+{
+  xRandom     Random(Seed);
+  const int32 MaxValue = xBitDepth2MaxValue(BitDepth);
+  for(int32 i = 0; i < NumPels; i++) { Dst[i] = (uint16)xClipU((int32)Src[i] + Random.next(-NoiseAmp, NoiseAmp), MaxValue); }
+}
+void xBenchData::genMask(uint16* Dst, int32 NumPels, int32 BitDepth, uint32 Seed)
+{
+  xRandom      Random(Seed);
+  const uint16 MaxValue = (uint16)xBitDepth2MaxValue(BitDepth);
+  for(int32 i = 0; i < NumPels; i++) { Dst[i] = Random.nextBool() ? MaxValue : 0; }
+}
+void xBenchData::genFlow(flt32V2* Dst, int32 NumPels, uint32 Seed)
+{
+  xRandom Random(Seed);
+  for(int32 i = 0; i < NumPels; i++) { Dst[i] = flt32V2((flt32)Random.next(-4096, 4096) / 512.0f, (flt32)Random.next(-4096, 4096) / 512.0f); }
+}
+void xBenchData::genPicture(xPicP* Pic, uint32 Seed)
+{
+  for(int32 CmpIdx = 0; CmpIdx < xPicCommon::c_DefNumCmps; CmpIdx++)
+  {
+    genPicture(Pic->getBuffer((eCmp)CmpIdx), Pic->getStride(), Pic->getHeight() + 2 * Pic->getMargin(), Pic->getBitDepth(), Seed + CmpIdx);
+  }
+}
+void xBenchData::genDistorted(xPicP* Dst, const xPicP* Src, int32 NoiseAmp, uint32 Seed)
+{
+  for(int32 CmpIdx = 0; CmpIdx < xPicCommon::c_DefNumCmps; CmpIdx++)
+  {
+    genDistorted(Dst->getBuffer((eCmp)CmpIdx), Src->getBuffer((eCmp)CmpIdx), Src->getBuffNumPels(), Src->getBitDepth(), NoiseAmp, Seed + CmpIdx);
+  }
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
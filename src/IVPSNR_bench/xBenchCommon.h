@@ -0,0 +1,165 @@
+﻿#pragma once
+
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2021, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ // Original authors: Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+ //                   Adrian Dziembowski, adrian.dziembowski@put.poznan.pl,
+ //                   Poznan University of Technology, Poznań, Poland
+
+#include "xCommonDefIVPSNR.h"
+#include "xVec.h"
+#include "xPic.h"
+#include "xDistortion.h"
+#include "xPixelOps.h"
+#include "xIVPSNR.h"
+#include <vector>
+#include <string_view>
+#include <functional>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xIVPSNRKernels - exposes protected IV-PSNR kernels
+//===============================================================================================================================================================================================================
+class xIVPSNRKernels : public xIVPSNRM
+{
+public:
+  using xIVPSNR ::xCalcAvgColorDiff;
+  using xIVPSNR ::xCalcDistAsymmetricRow;
+  using xIVPSNR ::xCalcDistAsymmetricRow_STD;
+#if X_CAN_USE_SSE
+  using xIVPSNR ::xCalcDistAsymmetricRow_SSE;
+#endif //X_CAN_USE_SSE
+  using xIVPSNRM::xCalcSumColorDiffM;
+  using xIVPSNRM::xCalcDistAsymmetricRowM_STD;
+};
+
+//===============================================================================================================================================================================================================
+// xKernelVariants - STD reference first, followed by SIMD variants compiled in
+//===============================================================================================================================================================================================================
+class xKernelVariants
+{
+public:
+  template <typename tSignature> using tVariants = std::vector<std::pair<std::string_view, std::function<tSignature>>>;
+
+  //SIMD weighted distortion kernels are not used by xDistortion yet (guarded by assert(0) - not tested), only release builds can call them
+#ifdef NDEBUG
+  static constexpr bool c_IncludeUntested = true;
+#else
+  static constexpr bool c_IncludeUntested = false;
+#endif
+
+  //xDistortionSTD/SSE/AVX - identical interfaces, Func is called with instance of implementation class followed by Args
+  template <typename tSignature, class xFunc> static tVariants<tSignature> Distortion(xFunc Func, bool IncludeSIMD = true)
+  {
+    tVariants<tSignature> Variants;
+    Variants.emplace_back("STD", [Func](auto... Args) { return Func(xDistortionSTD(), Args...); });
+    if(!IncludeSIMD) { return Variants; }
+#if X_CAN_USE_SSE
+    Variants.emplace_back("SSE", [Func](auto... Args) { return Func(xDistortionSSE(), Args...); });
+#endif //X_CAN_USE_SSE
+#if X_CAN_USE_AVX
+    Variants.emplace_back("AVX", [Func](auto... Args) { return Func(xDistortionAVX(), Args...); });
+#endif //X_CAN_USE_AVX
+    return Variants;
+  }
+  //xPixelOpsSTD/SSE/AVX - SIMD classes implement subset of STD interface
+  template <typename tSignature, class xFunc> static tVariants<tSignature> PixelOps(xFunc Func)
+  {
+    tVariants<tSignature> Variants;
+    Variants.emplace_back("STD", [Func](auto... Args) { return Func(xPixelOpsSTD(), Args...); });
+#if X_CAN_USE_SSE
+    Variants.emplace_back("SSE", [Func](auto... Args) { return Func(xPixelOpsSSE(), Args...); });
+#endif //X_CAN_USE_SSE
+#if X_CAN_USE_AVX
+    Variants.emplace_back("AVX", [Func](auto... Args) { return Func(xPixelOpsAVX(), Args...); });
+#endif //X_CAN_USE_AVX
+    return Variants;
+  }
+};
+
+//===============================================================================================================================================================================================================
+// xRandom - xorshift32, fast and deterministic, quality is irrelevant here
+//===============================================================================================================================================================================================================
+class xRandom
+{
+protected:
+  uint32 m_State;
+
+public:
+  xRandom(uint32 Seed) : m_State(Seed ? Seed : 1) {}
+  uint32 next(                  ) { m_State ^= m_State << 13; m_State ^= m_State >> 17; m_State ^= m_State << 5; return m_State; }
+  int32  next(int32 Min, int32 Max) { return Min + (int32)(next() % (uint32)(Max - Min + 1)); }
+  bool   nextBool(              ) { return (next() & 0x100) != 0; }
+};
+
+//===============================================================================================================================================================================================================
+// xBenchData - synthetic data generators
+//===============================================================================================================================================================================================================
+class xBenchData
+{
+public:
+  //diagonal gradient + noise, covers NumRows x Stride samples (including margin)
+  template <typename PelType> static void genPicture(PelType* Buffer, int32 Stride, int32 NumRows, int32 BitDepth, uint32 Seed);
+
+  static void genDistorted(uint16*  Dst, const uint16* Src, int32 NumPels, int32 BitDepth, int32 NoiseAmp, uint32 Seed); //source + noise in range [-NoiseAmp, NoiseAmp]
+  static void genMask     (uint16*  Dst, int32 NumPels, int32 BitDepth, uint32 Seed); //active (max value) or inactive (zero) samples, same convention as IV-PSNR mask input
+  static void genFlow     (flt32V2* Dst, int32 NumPels, uint32 Seed);
+
+  static void genPicture  (xPicP* Pic, uint32 Seed);
+  static void genDistorted(xPicP* Dst, const xPicP* Src, int32 NoiseAmp, uint32 Seed);
+
+  static int32 getDefNoiseAmp(int32 BitDepth) { return xMax(1, xBitDepth2MaxValue(BitDepth) >> 7); }
+};
+
+template <typename PelType> void xBenchData::genPicture(PelType* Buffer, int32 Stride, int32 NumRows, int32 BitDepth, uint32 Seed)
+{
+  xRandom     Random(Seed);
+  const int32 MaxValue = xBitDepth2MaxValue(BitDepth);
+  const int32 NoiseAmp = xMax(1, MaxValue >> 5);
+  const int64 Denom    = (int64)Stride + 2 * (int64)NumRows;
+  for(int32 y = 0; y < NumRows; y++)
+  {
+    for(int32 x = 0; x < Stride; x++)
+    {
+      const int32 Base = (int32)(((int64)x + 2 * (int64)y) * MaxValue / Denom);
+      Buffer[x] = (PelType)xClipU(Base + Random.next(-NoiseAmp, NoiseAmp), MaxValue);
+    }
+    Buffer += Stride;
+  }
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
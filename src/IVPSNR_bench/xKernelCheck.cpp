@@ -0,0 +1,422 @@
+﻿/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2021, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ // Original authors: Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+ //                   Adrian Dziembowski, adrian.dziembowski@put.poznan.pl,
+ //                   Poznan University of Technology, Poznań, Poland
+
+#include "xKernelCheck.h"
+#include "xBenchCommon.h"
+#include "xString.h"
+#include <algorithm>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// helpers
+//===============================================================================================================================================================================================================
+static constexpr int32 xc_Guard = 64; //extra samples after each destination buffer, detects writes past the last row
+
+template <typename PelType> static std::vector<PelType> xRandBuffer(xRandom& Random, int32 Size, int32 MaxValue)
+{
+  std::vector<PelType> Buffer(Size);
+  for(PelType& V : Buffer) { V = (PelType)Random.next(0, MaxValue); }
+  return Buffer;
+}
+//all inactive, all active, binary, arbitrary values
+static std::vector<uint16> xRandMask(xRandom& Random, int32 Size, int32 BitDepth)
+{
+  const int32 MaxValue = xBitDepth2MaxValue(BitDepth);
+  const int32 Mode     = Random.next(0, 3);
+  std::vector<uint16> Buffer(Size);
+  for(uint16& V : Buffer)
+  {
+    switch(Mode)
+    {
+      case 0:  V = 0; break;
+      case 1:  V = (uint16)MaxValue; break;
+      case 2:  V = Random.nextBool() ? (uint16)MaxValue : 0; break;
+      default: V = (uint16)Random.next(0, MaxValue); break;
+    }
+  }
+  return Buffer;
+}
+static void xRandPicture(xRandom& Random, xPicP* Pic)
+{
+  const int32 MaxValue = xBitDepth2MaxValue(Pic->getBitDepth());
+  for(int32 CmpIdx = 0; CmpIdx < xPicCommon::c_DefNumCmps; CmpIdx++)
+  {
+    uint16* Buffer = Pic->getBuffer((eCmp)CmpIdx);
+    for(int32 i = 0; i < Pic->getBuffNumPels(); i++) { Buffer[i] = (uint16)Random.next(0, MaxValue); }
+  }
+}
+
+template <typename tValue> static std::string xToString(const tValue& Value)
+{
+  if constexpr(std::is_same_v<tValue, int32V4>) { return xString::formatIntWeights(Value); }
+  else                                           { return std::to_string(Value);           }
+}
+
+//===============================================================================================================================================================================================================
+// xKernelCheck
+//===============================================================================================================================================================================================================
+bool xKernelCheck::run()
+{
+  xRandom Random(m_Params.Seed);
+  for(int32 CaseIdx = 0; CaseIdx < m_Params.NumCases; CaseIdx++)
+  {
+    const uint32 CaseSeed = Random.next();
+    xCheckDistortion(CaseSeed    );
+    xCheckPixelOps  (CaseSeed + 1);
+    xCheckIVPSNR    (CaseSeed + 2);
+  }
+
+  if(m_Params.VerboseLevel >= 1)
+  {
+    fmt::printf("\n");
+    for(const xStats& S : m_Stats)
+    {
+      fmt::printf("%-45s %-10s cases=%-7d mismatches=%-5d %s\n", S.Kernel, S.ISA, S.NumCases, S.NumMismatches, S.NumMismatches ? "FAILED" : "OK");
+    }
+  }
+  return getNumMismatches() == 0;
+}
+int32 xKernelCheck::getNumMismatches() const
+{
+  int32 NumMismatches = 0;
+  for(const xStats& S : m_Stats) { NumMismatches += S.NumMismatches; }
+  return NumMismatches;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// xKernelCheck - kernel groups
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void xKernelCheck::xCheckDistortion(uint32 Seed)
+{
+  xRandom Random(Seed);
+  const int32 BitDepth = Random.next(8, 14);
+  const int32 MaxValue = xBitDepth2MaxValue(BitDepth);
+  const int32 W        = Random.next(1, c_MaxWidth );
+  const int32 H        = Random.next(1, c_MaxHeight);
+  const int32 SO       = W + Random.next(0, c_MaxPadding); const int32 OO = Random.next(0, c_MaxOffset);
+  const int32 SD       = W + Random.next(0, c_MaxPadding); const int32 OD = Random.next(0, c_MaxOffset);
+  const int32 SM       = W + Random.next(0, c_MaxPadding); const int32 OM = Random.next(0, c_MaxOffset);
+  const int32 A        = Random.next(1, W * H);
+
+  const std::vector<uint16> Org = xRandBuffer<uint16>(Random, OO + SO * H, MaxValue);
+  const std::vector<uint16> Dis = xRandBuffer<uint16>(Random, OD + SD * H, MaxValue);
+  const std::vector<uint16> Msk = xRandMask          (Random, OM + SM * H, BitDepth);
+  const uint16* O = Org.data() + OO;
+  const uint16* D = Dis.data() + OD;
+  const uint16* M = Msk.data() + OM;
+
+  const std::string Case = fmt::sprintf("seed=%08X W=%d H=%d OS=%d DS=%d MS=%d BD=%d Area=%d", Seed, W, H, SO, SD, SM, BitDepth, A);
+
+  xCheckValue<uint64>("xDistortion::CalcSD/Area"           , Case, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcSD         (O, D,                A      ); }));
+  xCheckValue<uint64>("xDistortion::CalcSD/Stride"         , Case, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcSD         (O, D,    SO, SD,     W, H); }));
+  xCheckValue<uint64>("xDistortion::CalcSSD/Area"          , Case, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcSSD        (O, D,                A      ); }));
+  xCheckValue<uint64>("xDistortion::CalcSSD/Stride"        , Case, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcSSD        (O, D,    SO, SD,     W, H); }));
+  //SIMD weighted kernels are guarded by assert(0) (not tested, not used by metrics) and are known to differ from STD - only STD is exercised until they are fixed
+  xCheckValue<uint64>("xDistortion::CalcWeightedSD/Area"   , Case, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcWeightedSD (O, D, M,            A      ); }, false));
+  xCheckValue<uint64>("xDistortion::CalcWeightedSD/Stride" , Case, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcWeightedSD (O, D, M, SO, SD, SM, W, H); }, false));
+  xCheckValue<uint64>("xDistortion::CalcWeightedSSD/Area"  , Case, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcWeightedSSD(O, D, M,            A      ); }, false));
+  xCheckValue<uint64>("xDistortion::CalcWeightedSSD/Stride", Case, xKernelVariants::Distortion<uint64()>([=](auto I) { return decltype(I)::CalcWeightedSSD(O, D, M, SO, SD, SM, W, H); }, false));
+
+  //interleaved (4 components per pel) - used by global color shift of direct-to-interleaved path
+  const std::vector<uint16> OrgI = xRandBuffer<uint16>(Random, 4 * (OO + SO * H), MaxValue);
+  const std::vector<uint16> DisI = xRandBuffer<uint16>(Random, 4 * (OD + SD * H), MaxValue);
+  const uint16V4* OI = (const uint16V4*)OrgI.data() + OO;
+  const uint16V4* DI = (const uint16V4*)DisI.data() + OD;
+  xCheckValue<int32V4>("xDistortion::CalcSD/Interleaved"   , Case, xKernelVariants::Distortion<int32V4()>([=](auto I) { return decltype(I)::CalcSD        (OI, DI,   SO, SD,     W, H); }));
+
+  //interleaved 8-bit - native 8-bit IV-PSNR pictures
+  const std::vector<uint8> OrgI8 = xRandBuffer<uint8>(Random, 4 * (OO + SO * H), 255);
+  const std::vector<uint8> DisI8 = xRandBuffer<uint8>(Random, 4 * (OD + SD * H), 255);
+  const uint8V4* OI8 = (const uint8V4*)OrgI8.data() + OO;
+  const uint8V4* DI8 = (const uint8V4*)DisI8.data() + OD;
+  xCheckValue<int32V4>("xDistortion::CalcSD/Interleaved8"  , Case, xKernelVariants::Distortion<int32V4()>([=](auto I) { return decltype(I)::CalcSD        (OI8, DI8, SO, SD,     W, H); }));
+}
+void xKernelCheck::xCheckPixelOps(uint32 Seed)
+{
+  xRandom Random(Seed);
+  const int32 BitDepth = Random.next(8, 14);
+  const int32 MaxValue = xBitDepth2MaxValue(BitDepth);
+  const int32 W        = Random.next(1, c_MaxWidth );
+  const int32 H        = Random.next(1, c_MaxHeight);
+  const int32 SS       = W + Random.next(0, c_MaxPadding); const int32 OS = Random.next(0, c_MaxOffset);
+  const int32 SD       = W + Random.next(0, c_MaxPadding); const int32 OD = Random.next(0, c_MaxOffset);
+
+  const std::vector<uint8 > Src8  = xRandBuffer<uint8 >(Random, OS + SS * H, 255     );
+  const std::vector<uint16> Src16 = xRandBuffer<uint16>(Random, OS + SS * H, MaxValue);
+  const std::vector<uint16> SrcB  = xRandBuffer<uint16>(Random, OS + SS * H, MaxValue);
+  const std::vector<uint16> SrcC  = xRandBuffer<uint16>(Random, OS + SS * H, MaxValue);
+  const std::vector<uint16> Msk   = xRandMask          (Random, OS + SS * H, BitDepth);
+  const uint8 * S8  = Src8 .data() + OS;
+  const uint16* S16 = Src16.data() + OS;
+  const uint16* SB  = SrcB .data() + OS;
+  const uint16* SC  = SrcC .data() + OS;
+  const uint16* SM  = Msk  .data() + OS;
+
+  //destinations are prefilled with garbage, whole buffers are compared
+  const std::vector<uint8 > Init8  = xRandBuffer<uint8 >(Random, OD + SD * H + xc_Guard, 255  );
+  const std::vector<uint16> Init16 = xRandBuffer<uint16>(Random, OD + SD * H + xc_Guard, 65535);
+
+  const std::string Case = fmt::sprintf("seed=%08X W=%d H=%d SS=%d DS=%d BD=%d", Seed, W, H, SS, SD, BitDepth);
+
+  xCheckBuffer("xPixelOps::Copy"      , Case, Init16, OD, SD, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::Copy(Dst, S16, SD, SS, W, H); }));
+  xCheckBuffer("xPixelOps::Cvt/U8toU16", Case, Init16, OD, SD, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::Cvt(Dst, S8 , SD, SS, W, H); }));
+  xCheckBuffer("xPixelOps::Cvt/U16toU8", Case, Init8 , OD, SD, xKernelVariants::PixelOps<void(uint8* )>([=](auto I, uint8*  Dst) { decltype(I)::Cvt(Dst, S16, SD, SS, W, H); }));
+
+  //2:1 resampling - even destination size
+  {
+    const int32 WH  = Random.next(1, c_MaxWidth  >> 1);
+    const int32 HH  = Random.next(1, c_MaxHeight >> 1);
+    const int32 SSH = WH     + Random.next(0, c_MaxPadding);
+    const int32 SDU = 2 * WH + Random.next(0, c_MaxPadding);
+    const std::vector<uint8 > SrcH8  = xRandBuffer<uint8 >(Random, OS + SSH * HH, 255     );
+    const std::vector<uint16> SrcH16 = xRandBuffer<uint16>(Random, OS + SSH * HH, MaxValue);
+    const std::vector<uint16> InitU  = xRandBuffer<uint16>(Random, OD + SDU * 2 * HH + xc_Guard, 65535);
+    const uint8 * SH8  = SrcH8 .data() + OS;
+    const uint16* SH16 = SrcH16.data() + OS;
+    const std::string CaseU = fmt::sprintf("seed=%08X W=%d H=%d SS=%d DS=%d BD=%d", Seed, 2 * WH, 2 * HH, SSH, SDU, BitDepth);
+    xCheckBuffer("xPixelOps::Upsample"   , CaseU, InitU, OD, SDU, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::Upsample   (Dst, SH16, SDU, SSH, 2 * WH, 2 * HH); }));
+    xCheckBuffer("xPixelOps::CvtUpsample", CaseU, InitU, OD, SDU, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::CvtUpsample(Dst, SH8 , SDU, SSH, 2 * WH, 2 * HH); }));
+
+    //full range source samples - 2x2 sums have to be calculated without 16 bit overflow
+    const int32 SSU = 2 * WH + Random.next(0, c_MaxPadding);
+    const int32 SDH = WH     + Random.next(0, c_MaxPadding);
+    const std::vector<uint16> SrcU16 = xRandBuffer<uint16>(Random, OS + SSU * 2 * HH, Random.nextBool() ? MaxValue : 65535);
+    const std::vector<uint16> InitH  = xRandBuffer<uint16>(Random, OD + SDH * HH + xc_Guard, 65535);
+    const std::vector<uint8 > InitH8 = xRandBuffer<uint8 >(Random, OD + SDH * HH + xc_Guard, 255  );
+    const uint16* SU16 = SrcU16.data() + OS;
+    const std::string CaseD = fmt::sprintf("seed=%08X W=%d H=%d SS=%d DS=%d BD=%d", Seed, WH, HH, SSU, SDH, BitDepth);
+    xCheckBuffer("xPixelOps::Downsample"   , CaseD, InitH , OD, SDH, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::Downsample   (Dst, SU16, SDH, SSU, WH, HH); }));
+    xCheckBuffer("xPixelOps::CvtDownsample", CaseD, InitH8, OD, SDH, xKernelVariants::PixelOps<void(uint8* )>([=](auto I, uint8*  Dst) { decltype(I)::CvtDownsample(Dst, SU16, SDH, SSU, WH, HH); }));
+
+    //semi-planar CbCr lines (pairs) - Cb and Cr destinations are stacked in one buffer, MSB aligned samples are shifted down
+    const int32 SSUV  = 2 * WH + Random.next(0, c_MaxPadding);
+    const int32 Shift = 16 - BitDepth;
+    const std::vector<uint8 > SrcUV8  = xRandBuffer<uint8 >(Random, OS + SSUV * HH, 255  );
+    const std::vector<uint16> SrcUV16 = xRandBuffer<uint16>(Random, OS + SSUV * HH, 65535);
+    const std::vector<uint16> InitUV  = xRandBuffer<uint16>(Random, OD + 2 * SDU * 2 * HH + xc_Guard, 65535);
+    const uint8 * SUV8  = SrcUV8 .data() + OS;
+    const uint16* SUV16 = SrcUV16.data() + OS;
+    const int32   OV    = SDU * 2 * HH;
+    xCheckBuffer("xPixelOps::UpsampleUV"   , CaseU, InitUV, OD, SDU, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::UpsampleUV   (Dst, Dst + OV, SUV16, SDU, SSUV, 2 * WH, 2 * HH, Shift); }));
+    xCheckBuffer("xPixelOps::CvtUpsampleUV", CaseU, InitUV, OD, SDU, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::CvtUpsampleUV(Dst, Dst + OV, SUV8 , SDU, SSUV, 2 * WH, 2 * HH       ); }));
+  }
+
+  //MSB aligned 16 bit samples (P010/P016 luma)
+  {
+    const std::vector<uint16> SrcM = xRandBuffer<uint16>(Random, OS + SS * H, 65535);
+    const uint16* SSM = SrcM.data() + OS;
+    xCheckBuffer("xPixelOps::CopyShr", Case, Init16, OD, SD, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::CopyShr(Dst, SSM, SD, SS, W, H, 16 - BitDepth); }));
+  }
+
+  //v210 - random words (including 2 unused MSBs), Y/Cb/Cr destinations are stacked in one buffer
+  {
+    const int32 SSW = ((W + 5) / 6) * 4 + Random.next(0, c_MaxPadding); //words
+    std::vector<uint32> SrcW(OS + SSW * H);
+    for(uint32& V : SrcW) { V = Random.next(); }
+    const std::vector<uint16> InitV = xRandBuffer<uint16>(Random, OD + 3 * SD * H + xc_Guard, 65535);
+    const uint32* SW = SrcW.data() + OS;
+    const int32   OP = SD * H;
+    xCheckBuffer("xPixelOps::UnpackV210", Case, InitV, OD, SD, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::UnpackV210(Dst, Dst + OP, Dst + 2 * OP, SW, SD, SSW, W, H); }));
+  }
+
+  //sometimes single out of range value - inside picture or in padding area (has to be ignored)
+  {
+    std::vector<uint16> SrcV = Src16;
+    std::string         CaseV = Case;
+    bool                BrokenInside = false;
+    if(Random.nextBool())
+    {
+      const int32 Y = Random.next(0, H - 1);
+      const int32 X = (SS > W && Random.nextBool()) ? Random.next(W, SS - 1) : Random.next(0, W - 1);
+      SrcV[OS + Y * SS + X] = (uint16)Random.next(MaxValue + 1, 65535);
+      CaseV += fmt::sprintf(" Broken=(%d,%d)", Y, X);
+      BrokenInside = X < W;
+    }
+    const uint16* SV = SrcV.data() + OS;
+    xCheckValue<uint64>("xPixelOps::CheckValues", CaseV, xKernelVariants::PixelOps<uint64()>([=](auto I) { return decltype(I)::CheckValues(SV, SS, W, H, BitDepth); }));
+    //FindBroken prints every broken sample - exercised only when nothing is expected to be printed
+    if(!BrokenInside) { xCheckValue<uint64>("xPixelOps::FindBroken", CaseV, xKernelVariants::PixelOps<uint64()>([=](auto I) { return decltype(I)::FindBroken(SV, SS, W, H, BitDepth); })); }
+  }
+
+  xCheckValue<uint64>("xPixelOps::CountNonZero", Case, xKernelVariants::PixelOps<uint64()>([=](auto I) { return decltype(I)::CountNonZero(SM, SS, W, H); }));
+
+  {
+    const int32  SD4    = 4 * W + Random.next(0, c_MaxPadding);
+    const uint16 ValueD = (uint16)Random.next(0, MaxValue);
+    const std::vector<uint16> Init4 = xRandBuffer<uint16>(Random, OD + SD4 * H + xc_Guard, 65535);
+    xCheckBuffer("xPixelOps::Interleave", Case, Init4, OD, SD4, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::Interleave(Dst, S16, SB, SC, ValueD, SD4, SS, W, H); }));
+    //samples above 255 are saturated
+    const uint8 ValueD8 = (uint8)Random.next(0, 255);
+    const std::vector<uint8> Init48 = xRandBuffer<uint8>(Random, OD + SD4 * H + xc_Guard, 255);
+    xCheckBuffer("xPixelOps::CvtInterleave", Case, Init48, OD, SD4, xKernelVariants::PixelOps<void(uint8*)>([=](auto I, uint8* Dst) { decltype(I)::CvtInterleave(Dst, S16, SB, SC, ValueD8, SD4, SS, W, H); }));
+  }
+
+  //margin extension - whole buffer (picture, margins and padding) is compared, flt32V2 planes are compared as raw 16 bit words
+  {
+    const int32 M  = Random.next(0, c_MaxPadding);
+    const int32 SE = W + 2 * M + Random.next(0, c_MaxPadding);
+    const int32 OE = OD + M * SE + M;
+    const std::vector<uint16> InitE  = xRandBuffer<uint16>(Random,     (OD + SE * (H + 2 * M) + xc_Guard), 65535);
+    const std::vector<uint16> InitE2 = xRandBuffer<uint16>(Random, 4 * (OD + SE * (H + 2 * M) + xc_Guard), 65535);
+    const std::string CaseE = fmt::sprintf("seed=%08X W=%d H=%d S=%d M=%d", Seed, W, H, SE, M);
+    xCheckBuffer("xPixelOps::ExtendMargin/U16"    , CaseE, InitE , OE    , SE    , xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::ExtendMargin   (Dst           , SE, W, H, M); }));
+    xCheckBuffer("xPixelOps::ExtendMargin/F32V2"  , CaseE, InitE2, OE * 4, SE * 4, xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::ExtendMargin   ((flt32V2*)Dst, SE, W, H, M); }));
+    xCheckBuffer("xPixelOps::ExtendMarginHor"     , CaseE, InitE , OE    , SE    , xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::ExtendMarginHor(Dst           , SE, W, H, M); }));
+    xCheckBuffer("xPixelOps::ExtendMarginVer"     , CaseE, InitE , OE    , SE    , xKernelVariants::PixelOps<void(uint16*)>([=](auto I, uint16* Dst) { decltype(I)::ExtendMarginVer(Dst           , SE, W, H, M); }));
+  }
+}
+void xKernelCheck::xCheckIVPSNR(uint32 Seed)
+{
+  if(!xIsSelected("xIVPSNR::DistAsymmetricRow") && !xIsSelected("xIVPSNR::DistAsymmetricRow/Interleaved8")) { return; }
+
+  xRandom Random(Seed);
+  const int32   BitDepth    = Random.next(8, 14);
+  const int32   MaxValue    = xBitDepth2MaxValue(BitDepth);
+  const int32   SearchRange = Random.next(1, 4);
+  const int32   Margin      = SearchRange + Random.next(0, 3);
+  const int32V2 Size        = { Random.next(1, 96), Random.next(1, 8) };
+  const int32   NoiseAmp    = Random.next(0, MaxValue >> 4); //keeps row sums within int32 range
+
+  xPicP RefP(Size, BitDepth, Margin), TstP(Size, BitDepth, Margin);
+  xPicI RefI(Size, BitDepth, Margin), TstI(Size, BitDepth, Margin);
+  xRandPicture(Random, &RefP);
+  xBenchData::genDistorted(&TstP, &RefP, NoiseAmp, Random.next());
+  RefI.rearrangeFromPlanar(&RefP);
+  TstI.rearrangeFromPlanar(&TstP);
+
+  const int32V4 GCS = { Random.next(-16, 16), Random.next(-16, 16), Random.next(-16, 16), 0 };
+  const int32V4 CW  = xIVPSNR::c_UseRuntimeCmpWeights ? int32V4(Random.next(0, 4), Random.next(0, 1), Random.next(0, 1), 0) : xIVPSNR::c_DefaultCmpWeights;
+
+  const xPicP* RP = &RefP; const xPicP* TP = &TstP;
+  const xPicI* RI = &RefI; const xPicI* TI = &TstI;
+  for(int32 y = 0; y < Size.getY(); y++)
+  {
+    const std::string Case = fmt::sprintf("seed=%08X W=%d H=%d M=%d SR=%d BD=%d GCS=%s CW=%s y=%d", Seed, Size.getX(), Size.getY(), Margin, SearchRange, BitDepth, xString::formatIntWeights(GCS), xString::formatIntWeights(CW), y);
+    const xKernelVariants::tVariants<int32V4()> Variants =
+    {
+      { "STD"       , [=]() { return xIVPSNRKernels::xCalcDistAsymmetricRow_STD(RI, TI, y, GCS, SearchRange, CW); } }, //reference - interleaved
+      { "STD/Planar", [=]() { return xIVPSNRKernels::xCalcDistAsymmetricRow    (RP, TP, y, GCS, SearchRange, CW); } },
+#if X_CAN_USE_SSE
+      { "SSE"       , [=]() { return xIVPSNRKernels::xCalcDistAsymmetricRow_SSE(RI, TI, y, GCS, SearchRange, CW); } },
+#endif //X_CAN_USE_SSE
+    };
+    xCheckValue<int32V4>("xIVPSNR::DistAsymmetricRow", Case, Variants);
+  }
+
+  //native 8-bit interleaved pictures - 16-bit interleaved picture of the same content is the reference
+  xPicP RefP8(Size, 8, Margin), TstP8(Size, 8, Margin);
+  xPicI RefI16(Size, 8, Margin), TstI16(Size, 8, Margin);
+  xPicI8 RefI8(Size, 8, Margin), TstI8(Size, 8, Margin);
+  xRandPicture(Random, &RefP8);
+  xBenchData::genDistorted(&TstP8, &RefP8, Random.next(0, 15), Random.next());
+  RefI16.rearrangeFromPlanar(&RefP8); RefI8.rearrangeFromPlanar(&RefP8);
+  TstI16.rearrangeFromPlanar(&TstP8); TstI8.rearrangeFromPlanar(&TstP8);
+
+  const xPicI*  RI16 = &RefI16; const xPicI*  TI16 = &TstI16;
+  const xPicI8* RI8  = &RefI8 ; const xPicI8* TI8  = &TstI8 ;
+  for(int32 y = 0; y < Size.getY(); y++)
+  {
+    const std::string Case = fmt::sprintf("seed=%08X W=%d H=%d M=%d SR=%d BD=8 GCS=%s CW=%s y=%d", Seed, Size.getX(), Size.getY(), Margin, SearchRange, xString::formatIntWeights(GCS), xString::formatIntWeights(CW), y);
+    const xKernelVariants::tVariants<int32V4()> Variants =
+    {
+      { "STD"     , [=]() { return xIVPSNRKernels::xCalcDistAsymmetricRow_STD(RI16, TI16, y, GCS, SearchRange, CW); } }, //reference - interleaved 16-bit
+      { "STD/8bit", [=]() { return xIVPSNRKernels::xCalcDistAsymmetricRow_STD(RI8 , TI8 , y, GCS, SearchRange, CW); } },
+#if X_CAN_USE_SSE
+      { "SSE/8bit", [=]() { return xIVPSNRKernels::xCalcDistAsymmetricRow_SSE(RI8 , TI8 , y, GCS, SearchRange, CW); } },
+#endif //X_CAN_USE_SSE
+    };
+    xCheckValue<int32V4>("xIVPSNR::DistAsymmetricRow/Interleaved8", Case, Variants);
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// xKernelCheck - comparison
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool xKernelCheck::xIsSelected(std::string_view Kernel) const
+{
+  if(m_Params.Kernels.empty()) { return true; }
+  for(const std::string& Filter : m_Params.Kernels) { if(Kernel.find(Filter) != std::string_view::npos) { return true; } }
+  return false;
+}
+void xKernelCheck::xRecord(std::string_view Kernel, std::string_view ISA, bool Equal, const std::string& Details)
+{
+  auto Stats = std::find_if(m_Stats.begin(), m_Stats.end(), [&](const xStats& S) { return S.Kernel == Kernel && S.ISA == ISA; });
+  if(Stats == m_Stats.end()) { m_Stats.push_back({ std::string(Kernel), std::string(ISA) }); Stats = std::prev(m_Stats.end()); }
+
+  Stats->NumCases++;
+  if(Equal) { return; }
+  Stats->NumMismatches++;
+  if(m_Params.VerboseLevel >= 1 && Stats->NumMismatches <= c_MaxMismatchesReported) { fmt::printf("MISMATCH %s %s: %s\n", Kernel, ISA, Details); }
+}
+template <typename tValue, class xVariants> void xKernelCheck::xCheckValue(std::string_view Kernel, const std::string& Case, const xVariants& Variants)
+{
+  if(!xIsSelected(Kernel)) { return; }
+  const tValue Reference = (tValue)Variants[0].second();
+  for(int32 i = 1; i < (int32)Variants.size(); i++)
+  {
+    const tValue Value = (tValue)Variants[i].second();
+    const bool   Equal = Value == Reference;
+    xRecord(Kernel, Variants[i].first, Equal, Equal ? std::string() : fmt::sprintf("%s expected=%s got=%s", Case, xToString(Reference), xToString(Value)));
+  }
+}
+template <typename PelType, class xVariants> void xKernelCheck::xCheckBuffer(std::string_view Kernel, const std::string& Case, const std::vector<PelType>& Init, int32 Offset, int32 Stride, const xVariants& Variants)
+{
+  if(!xIsSelected(Kernel)) { return; }
+  std::vector<PelType> Reference = Init;
+  Variants[0].second(Reference.data() + Offset);
+  for(int32 i = 1; i < (int32)Variants.size(); i++)
+  {
+    std::vector<PelType> Buffer = Init;
+    Variants[i].second(Buffer.data() + Offset);
+    const auto  Mismatch = std::mismatch(Reference.begin(), Reference.end(), Buffer.begin());
+    const bool  Equal    = Mismatch.first == Reference.end();
+    std::string Details;
+    if(!Equal)
+    {
+      const int32 Pos = (int32)(Mismatch.first - Reference.begin()) - Offset;
+      const int32 Y   = Pos >= 0 ? Pos / Stride : -1;
+      const int32 X   = Pos - Y * Stride;
+      Details = fmt::sprintf("%s first difference at y=%d x=%d expected=%d got=%d", Case, Y, X, *Mismatch.first, *Mismatch.second);
+    }
+    xRecord(Kernel, Variants[i].first, Equal, Details);
+  }
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,103 @@
+﻿#pragma once
+
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2021, ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ // Original authors: Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+ //                   Adrian Dziembowski, adrian.dziembowski@put.poznan.pl,
+ //                   Poznan University of Technology, Poznań, Poland
+
+#include "xCommonDefIVPSNR.h"
+#include <vector>
+#include <string>
+#include <string_view>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xKernelCheck - randomized cross-ISA equivalence check, every SIMD variant has to be bit-exact with STD reference
+//===============================================================================================================================================================================================================
+class xKernelCheck
+{
+public:
+  static constexpr int32  c_DefNumCases  = 1000;
+  static constexpr uint32 c_DefSeed      = 0x5EED1E55;
+  static constexpr int32  c_MaxWidth     = 200; //covers all SIMD remainder paths (8/16/32 samples)
+  static constexpr int32  c_MaxHeight    = 24;
+  static constexpr int32  c_MaxPadding   = 40; //stride - width
+  static constexpr int32  c_MaxOffset    = 15; //buffer misalignment in samples
+  static constexpr int32  c_MaxMismatchesReported = 3; //per kernel and ISA
+
+  struct xParams
+  {
+    int32                    NumCases     = c_DefNumCases;
+    uint32                   Seed         = c_DefSeed;
+    std::vector<std::string> Kernels;      //substring filter applied to "Group::Kernel", empty = all
+    int32                    VerboseLevel = 1;
+  };
+
+  struct xStats
+  {
+    std::string Kernel;
+    std::string ISA;
+    int32       NumCases      = 0;
+    int32       NumMismatches = 0;
+  };
+
+protected:
+  xParams             m_Params;
+  std::vector<xStats> m_Stats;
+
+public:
+  xKernelCheck(const xParams& Params) : m_Params(Params) {}
+
+  bool run(); //returns true if all variants are bit-exact
+
+  const std::vector<xStats>& getStats        () const { return m_Stats; }
+  int32                      getNumMismatches() const;
+
+protected:
+  void xCheckDistortion(uint32 Seed);
+  void xCheckPixelOps  (uint32 Seed);
+  void xCheckIVPSNR    (uint32 Seed);
+
+  bool xIsSelected(std::string_view Kernel) const;
+  void xRecord    (std::string_view Kernel, std::string_view ISA, bool Equal, const std::string& Details);
+
+  template <typename tValue, class xVariants> void xCheckValue (std::string_view Kernel, const std::string& Case, const xVariants& Variants);
+  template <typename PelType, class xVariants> void xCheckBuffer(std::string_view Kernel, const std::string& Case, const std::vector<PelType>& Init, int32 Offset, int32 Stride, const xVariants& Variants);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
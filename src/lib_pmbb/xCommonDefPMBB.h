@@ -77,6 +77,9 @@ THE POSSIBILITY OF SUCH DAMAGE.
 // Compile time settings
 //=============================================================================================================================================================================
 #define USE_SIMD  1 // use SIMD (to be precise... use SSE 4.1 or AVX2) 
+#ifndef USE_TRACE
+#define USE_TRACE 1 // compile in timeline trace recorder (still has to be enabled at runtime, 0 removes all trace points)
+#endif
 
 //=============================================================================================================================================================================
 // Hard coded constrains
@@ -273,6 +276,8 @@ static constexpr uint8  uint8_min  = 0         ;
 //=============================================================================================================================================================================
 static constexpr int32 xc_Log2MemSizePage = 12; //Memmory page size = 4kB
 static constexpr int32 xc_MemSizePage     = (1<<xc_Log2MemSizePage);
+static constexpr int32 xc_Log2MemSizeCacheLine = 6; //Cache line size = 64B
+static constexpr int32 xc_MemSizeCacheLine     = (1<<xc_Log2MemSizeCacheLine);
 static constexpr int32 xc_AlignmentPel    = xc_MemSizePage; //pel alignment
 
 //Allocation with explicit alignment
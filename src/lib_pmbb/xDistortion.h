@@ -74,6 +74,8 @@ public:
   static inline  int32 CalcSD (const uint16* Org, const uint16* Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionAVX::CalcSD (Org, Dist, OStride, DStride, Width,  Height); }
   static inline uint64 CalcSSD(const uint16* Org, const uint16* Dist,                               int32 Area               ) { return xDistortionAVX::CalcSSD(Org, Dist,                   Area          ); }
   static inline uint64 CalcSSD(const uint16* Org, const uint16* Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionAVX::CalcSSD(Org, Dist, OStride, DStride, Width,  Height); }
+  static inline int32V4 CalcSD(const uint16V4* Org, const uint16V4* Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionAVX::CalcSD(Org, Dist, OStride, DStride, Width, Height); }
+  static inline int32V4 CalcSD(const uint8V4*  Org, const uint8V4*  Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionAVX::CalcSD(Org, Dist, OStride, DStride, Width, Height); }
 
 #elif X_CAN_USE_SSE
 
@@ -81,6 +83,8 @@ public:
   static inline  int32 CalcSD (const uint16* Org, const uint16* Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionSSE::CalcSD (Org, Dist, OStride, DStride, Width,  Height); }
   static inline uint64 CalcSSD(const uint16* Org, const uint16* Dist,                               int32 Area               ) { return xDistortionSSE::CalcSSD(Org, Dist,                   Area          ); }
   static inline uint64 CalcSSD(const uint16* Org, const uint16* Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionSSE::CalcSSD(Org, Dist, OStride, DStride, Width,  Height); }
+  static inline int32V4 CalcSD(const uint16V4* Org, const uint16V4* Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionSSE::CalcSD(Org, Dist, OStride, DStride, Width, Height); }
+  static inline int32V4 CalcSD(const uint8V4*  Org, const uint8V4*  Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionSSE::CalcSD(Org, Dist, OStride, DStride, Width, Height); }
 
 #else //X_CAN_USE_???
 
@@ -88,6 +92,8 @@ public:
   static inline  int32 CalcSD (const uint16* Org, const uint16* Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionSTD::CalcSD (Org, Dist, OStride, DStride, Width,  Height); }
   static inline uint64 CalcSSD(const uint16* Org, const uint16* Dist,                               int32 Area               ) { return xDistortionSTD::CalcSSD(Org, Dist,                   Area          ); }
   static inline uint64 CalcSSD(const uint16* Org, const uint16* Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionSTD::CalcSSD(Org, Dist, OStride, DStride, Width,  Height); }
+  static inline int32V4 CalcSD(const uint16V4* Org, const uint16V4* Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionSTD::CalcSD(Org, Dist, OStride, DStride, Width, Height); }
+  static inline int32V4 CalcSD(const uint8V4*  Org, const uint8V4*  Dist, int32 OStride, int32 DStride, int32 Width, int32 Height) { return xDistortionSTD::CalcSD(Org, Dist, OStride, DStride, Width, Height); }
 
 #endif //X_CAN_USE_???
 
@@ -95,6 +101,7 @@ public:
   static inline  int64 CalcWeightedSD (const uint16* Org, const uint16* Dist, const uint16* Mask, int32 OStride, int32 DStride, int32 MStride, int32 Width, int32 Height) { return xDistortionSTD::CalcWeightedSD (Org, Dist, Mask, OStride, DStride, MStride, Width,  Height); }
   static inline uint64 CalcWeightedSSD(const uint16* Org, const uint16* Dist, const uint16* Mask,                                              int32 Area               ) { return xDistortionSTD::CalcWeightedSSD(Org, Dist, Mask,                            Area          ); }
   static inline uint64 CalcWeightedSSD(const uint16* Org, const uint16* Dist, const uint16* Mask, int32 OStride, int32 DStride, int32 MStride, int32 Width, int32 Height) { return xDistortionSTD::CalcWeightedSSD(Org, Dist, Mask, OStride, DStride, MStride, Width,  Height); }
+  static inline int64V4 CalcWeightedSD(const uint16V4* Org, const uint16V4* Dist, const uint16* Mask, int32 OStride, int32 DStride, int32 MStride, int32 Width, int32 Height) { return xDistortionSTD::CalcWeightedSD(Org, Dist, Mask, OStride, DStride, MStride, Width, Height); }
 
 };
 
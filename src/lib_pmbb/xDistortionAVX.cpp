@@ -92,7 +92,7 @@ int32 xDistortionAVX::CalcSD(const uint16* restrict Org, const uint16* restrict
     } //y
     __m128i SD_V128A = _mm256_extractf128_si256(SD_V256, 1);
     __m128i SD_V128B = _mm256_castsi256_si128  (SD_V256);
-    __m128i SD_V128  = _mm_add_epi64(SD_V128A, SD_V128B);
+    __m128i SD_V128  = _mm_add_epi32(SD_V128A, SD_V128B);
     __m128i Tmp1V    = _mm_hadd_epi32(SD_V128, SD_V128);
     __m128i Tmp2V    = _mm_hadd_epi32(Tmp1V, Tmp1V);
     int32 SD = _mm_extract_epi32(Tmp2V, 0);
@@ -148,13 +148,70 @@ int32 xDistortionAVX::CalcSD(const uint16* restrict Org, const uint16* restrict
 
     __m128i SD_V128A = _mm256_extractf128_si256(SD_V256, 1);
     __m128i SD_V128B = _mm256_castsi256_si128  (SD_V256);
-    SD_V128 = _mm_add_epi64(SD_V128, _mm_add_epi64(SD_V128A, SD_V128B));
+    SD_V128 = _mm_add_epi32(SD_V128, _mm_add_epi32(SD_V128A, SD_V128B));
     __m128i Tmp1V = _mm_hadd_epi32(SD_V128, SD_V128);
     __m128i Tmp2V = _mm_hadd_epi32(Tmp1V, Tmp1V);
     SD += _mm_extract_epi32(Tmp2V, 0);
     return SD;
   } //any other
 }
+int32V4 xDistortionAVX::CalcSD(const uint16V4* restrict Org, const uint16V4* restrict Dist, int32 OStride, int32 DStride, int32 Width, int32 Height)
+{
+  //4 pixels per iteration, accumulator lanes hold components (twice)
+  const int32 Width4  = (int32)((uint32)Width & c_MultipleMask4);
+  __m256i     SD_V256 = _mm256_setzero_si256();
+  int32V4     SD      = xMakeVec4<int32>(0);
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width4; x+=4)
+    {
+      __m256i Org_V256   = _mm256_loadu_si256((__m256i*) & Org [x]);
+      __m256i Dist_V256  = _mm256_loadu_si256((__m256i*) & Dist[x]);
+      __m256i Diff_V256  = _mm256_sub_epi16     (Org_V256, Dist_V256);
+      __m256i Diff_V256A = _mm256_cvtepi16_epi32(_mm256_extractf128_si256(Diff_V256, 1));
+      __m256i Diff_V256B = _mm256_cvtepi16_epi32(_mm256_castsi256_si128  (Diff_V256   ));
+      __m256i Sum_V256   = _mm256_add_epi32     (Diff_V256A, Diff_V256B);
+      SD_V256 = _mm256_add_epi32(SD_V256, Sum_V256);
+    } //x
+    for(int32 x=Width4; x<Width; x++) { SD += (int32V4)Org[x] - (int32V4)Dist[x]; }
+    Org  += OStride;
+    Dist += DStride;
+  } //y
+  __m128i SD_V128A = _mm256_extractf128_si256(SD_V256, 1);
+  __m128i SD_V128B = _mm256_castsi256_si128  (SD_V256   );
+  __m128i SD_V128  = _mm_add_epi32(SD_V128A, SD_V128B);
+  int32V4 SD_V; _mm_storeu_si128((__m128i*)&SD_V, SD_V128);
+  return SD + SD_V;
+}
+int32V4 xDistortionAVX::CalcSD(const uint8V4* restrict Org, const uint8V4* restrict Dist, int32 OStride, int32 DStride, int32 Width, int32 Height)
+{
+  //8 pixels per iteration, Org-Dist obtained by multiply-add of interleaved bytes with {+1,-1}, accumulator lanes hold components (twice)
+  const int32   Width8  = (int32)((uint32)Width & c_MultipleMask8);
+  const __m256i PosNeg  = _mm256_set1_epi16((int16)0xFF01);
+  __m256i       SD_V256 = _mm256_setzero_si256();
+  int32V4       SD      = xMakeVec4<int32>(0);
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width8; x+=8)
+    {
+      __m256i Org_V256   = _mm256_loadu_si256((__m256i*) & Org [x]);
+      __m256i Dist_V256  = _mm256_loadu_si256((__m256i*) & Dist[x]);
+      __m256i Diff_V256A = _mm256_maddubs_epi16 (_mm256_unpacklo_epi8(Org_V256, Dist_V256), PosNeg);
+      __m256i Diff_V256B = _mm256_maddubs_epi16 (_mm256_unpackhi_epi8(Org_V256, Dist_V256), PosNeg);
+      __m256i Diff_V256  = _mm256_add_epi16     (Diff_V256A, Diff_V256B);
+      __m256i Sum_V256   = _mm256_add_epi32     (_mm256_cvtepi16_epi32(_mm256_castsi256_si128(Diff_V256)), _mm256_cvtepi16_epi32(_mm256_extracti128_si256(Diff_V256, 1)));
+      SD_V256 = _mm256_add_epi32(SD_V256, Sum_V256);
+    } //x
+    for(int32 x=Width8; x<Width; x++) { SD += (int32V4)Org[x] - (int32V4)Dist[x]; }
+    Org  += OStride;
+    Dist += DStride;
+  } //y
+  __m128i SD_V128A = _mm256_extractf128_si256(SD_V256, 1);
+  __m128i SD_V128B = _mm256_castsi256_si128  (SD_V256   );
+  __m128i SD_V128  = _mm_add_epi32(SD_V128A, SD_V128B);
+  int32V4 SD_V; _mm_storeu_si128((__m128i*)&SD_V, SD_V128);
+  return SD + SD_V;
+}
 uint64 xDistortionAVX::CalcSSD(const uint16* restrict Org, const uint16* restrict Dist, int32 Area)
 {  
   const int32 Area16   = (int32)((uint32)Area & c_MultipleMask16);
@@ -132,6 +132,57 @@ int32 xDistortionSSE::CalcSD(const uint16* restrict Org, const uint16* restrict
     return SD;
   }  
 }
+int32V4 xDistortionSSE::CalcSD(const uint16V4* restrict Org, const uint16V4* restrict Dist, int32 OStride, int32 DStride, int32 Width, int32 Height)
+{
+  //2 pixels per iteration, accumulator lanes hold components
+  const int32 Width2  = (int32)((uint32)Width & (uint32)0xFFFFFFFE);
+  __m128i     SD_V128 = _mm_setzero_si128();
+  int32V4     SD      = xMakeVec4<int32>(0);
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width2; x+=2)
+    {
+      __m128i Org_V128   = _mm_loadu_si128((__m128i*) & Org [x]);
+      __m128i Dist_V128  = _mm_loadu_si128((__m128i*) & Dist[x]);
+      __m128i Diff_V128  = _mm_sub_epi16     (Org_V128 , Dist_V128);
+      __m128i Diff_V128A = _mm_cvtepi16_epi32(Diff_V128);
+      __m128i Diff_V128B = _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8));
+      __m128i Sum_V128   = _mm_add_epi32     (Diff_V128A, Diff_V128B);
+      SD_V128 = _mm_add_epi32(SD_V128, Sum_V128);
+    } //x
+    for(int32 x=Width2; x<Width; x++) { SD += (int32V4)Org[x] - (int32V4)Dist[x]; }
+    Org  += OStride;
+    Dist += DStride;
+  } //y
+  int32V4 SD_V; _mm_storeu_si128((__m128i*)&SD_V, SD_V128);
+  return SD + SD_V;
+}
+int32V4 xDistortionSSE::CalcSD(const uint8V4* restrict Org, const uint8V4* restrict Dist, int32 OStride, int32 DStride, int32 Width, int32 Height)
+{
+  //4 pixels per iteration, Org-Dist obtained by multiply-add of interleaved bytes with {+1,-1}, accumulator lanes hold components
+  const int32   Width4  = (int32)((uint32)Width & c_MultipleMask4);
+  const __m128i PosNeg  = _mm_set1_epi16((int16)0xFF01);
+  __m128i       SD_V128 = _mm_setzero_si128();
+  int32V4       SD      = xMakeVec4<int32>(0);
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width4; x+=4)
+    {
+      __m128i Org_V128   = _mm_loadu_si128((__m128i*) & Org [x]);
+      __m128i Dist_V128  = _mm_loadu_si128((__m128i*) & Dist[x]);
+      __m128i Diff_V128A = _mm_maddubs_epi16 (_mm_unpacklo_epi8(Org_V128, Dist_V128), PosNeg);
+      __m128i Diff_V128B = _mm_maddubs_epi16 (_mm_unpackhi_epi8(Org_V128, Dist_V128), PosNeg);
+      __m128i Diff_V128  = _mm_add_epi16     (Diff_V128A, Diff_V128B);
+      __m128i Sum_V128   = _mm_add_epi32     (_mm_cvtepi16_epi32(Diff_V128), _mm_cvtepi16_epi32(_mm_srli_si128(Diff_V128, 8)));
+      SD_V128 = _mm_add_epi32(SD_V128, Sum_V128);
+    } //x
+    for(int32 x=Width4; x<Width; x++) { SD += (int32V4)Org[x] - (int32V4)Dist[x]; }
+    Org  += OStride;
+    Dist += DStride;
+  } //y
+  int32V4 SD_V; _mm_storeu_si128((__m128i*)&SD_V, SD_V128);
+  return SD + SD_V;
+}
 uint64 xDistortionSSE::CalcSSD(const uint16* restrict Org, const uint16* restrict Dist, int32 Area)
 {  
   const int32 Area8    = (int32)((uint32)Area & c_MultipleMask8);
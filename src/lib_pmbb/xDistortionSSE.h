@@ -39,6 +39,7 @@ THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "xCommonDefPMBB.h"
+#include "xVec.h"
 
 #if X_USE_SSE && X_SSE_ALL
 
@@ -55,6 +56,10 @@ public:
   static uint64 CalcSSD(const uint16* restrict Org, const uint16* restrict Dist,                               int32 Area               );
   static uint64 CalcSSD(const uint16* restrict Org, const uint16* restrict Dist, int32 OStride, int32 DStride, int32 Width, int32 Height);
 
+  //SD - interleaved (all components in single pass)
+  static int32V4 CalcSD(const uint16V4* restrict Org, const uint16V4* restrict Dist, int32 OStride, int32 DStride, int32 Width, int32 Height);
+  static int32V4 CalcSD(const uint8V4*  restrict Org, const uint8V4*  restrict Dist, int32 OStride, int32 DStride, int32 Width, int32 Height);
+
   static  int64 CalcWeightedSD (const uint16* restrict Org, const uint16* restrict Dist, const uint16* restrict Mask,                                              int32 Area               );
   static  int64 CalcWeightedSD (const uint16* restrict Org, const uint16* restrict Dist, const uint16* restrict Mask, int32 OStride, int32 DStride, int32 MStride, int32 Width, int32 Height);
   static uint64 CalcWeightedSSD(const uint16* restrict Org, const uint16* restrict Dist, const uint16* restrict Mask,                                              int32 Area               );
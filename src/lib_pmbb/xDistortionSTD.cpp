@@ -87,6 +87,40 @@ uint64 xDistortionSTD::CalcSSD(const uint16* restrict Org, const uint16* restric
   return SSD;
 }
 
+int32V4 xDistortionSTD::CalcSD(const uint16V4* restrict Org, const uint16V4* restrict Dist, int32 OStride, int32 DStride, int32 Width, int32 Height)
+{
+  int32V4 SD = xMakeVec4<int32>(0);
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width; x++) { SD += (int32V4)Org[x] - (int32V4)Dist[x]; }
+    Org  += OStride;
+    Dist += DStride;
+  }
+  return SD;
+}
+int32V4 xDistortionSTD::CalcSD(const uint8V4* restrict Org, const uint8V4* restrict Dist, int32 OStride, int32 DStride, int32 Width, int32 Height)
+{
+  int32V4 SD = xMakeVec4<int32>(0);
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width; x++) { SD += (int32V4)Org[x] - (int32V4)Dist[x]; }
+    Org  += OStride;
+    Dist += DStride;
+  }
+  return SD;
+}
+int64V4 xDistortionSTD::CalcWeightedSD(const uint16V4* restrict Org, const uint16V4* restrict Dist, const uint16* restrict Mask, int32 OStride, int32 DStride, int32 MStride, int32 Width, int32 Height)
+{
+  int64V4 SD = xMakeVec4<int64>(0);
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width; x++) { SD += (int64V4)(((int32V4)Org[x] - (int32V4)Dist[x]) * (int32)Mask[x]); }
+    Org  += OStride;
+    Dist += DStride;
+    Mask += MStride;
+  }
+  return SD;
+}
 int64 xDistortionSTD::CalcWeightedSD(const uint16* restrict Org, const uint16* restrict Dist, const uint16* restrict Mask, int32 Area)
 {
   int64 SD = 0;
@@ -43,6 +43,7 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 
 #ifdef max
 #undef max
@@ -95,6 +96,44 @@ void xEvent::wait()
   if(!m_ManualReset) { m_State = false; }
 }
 
+//===============================================================================================================================================================================================================
+// xLatch - thread safe countdown latch (reusable, count is set by reset)
+//===============================================================================================================================================================================================================
+class xLatch
+{
+protected:
+  std::atomic<int32>      m_Counter;
+  std::mutex              m_Mutex;
+  std::condition_variable m_ConditionVariable;
+
+public:
+  xLatch(int32 InitialCount = 0) : m_Counter(InitialCount) {}
+  xLatch(const xLatch&) = delete;
+  xLatch& operator=(const xLatch&) = delete;
+
+  inline void reset    (int32 Count);
+  inline void countDown();
+  inline void wait     ();
+};
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void xLatch::reset(int32 Count)
+{
+  m_Counter.store(Count, std::memory_order_release);
+}
+void xLatch::countDown()
+{
+  //decrement and notify under mutex - waiter cannot return (and destroy latch owner) while last countDown is still running
+  std::lock_guard<std::mutex> LockManager(m_Mutex);
+  if(m_Counter.fetch_sub(1, std::memory_order_acq_rel) == 1) { m_ConditionVariable.notify_all(); }
+}
+void xLatch::wait()
+{
+  std::unique_lock<std::mutex> LockManager(m_Mutex); //always taken - synchronizes with last countDown
+  m_ConditionVariable.wait(LockManager, [&]{ return m_Counter.load(std::memory_order_acquire) == 0; });
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
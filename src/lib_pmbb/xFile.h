@@ -47,6 +47,11 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstdio>
 #include <string>
 #include <cerrno>
+#include <sys/stat.h>
+#if X_SYSTEM_WINDOWS
+#include <io.h>
+#include <fcntl.h>
+#endif
 
 namespace PMBB_NAMESPACE {
 
@@ -67,8 +72,11 @@ public:
   #error Unrecognized platform
 #endif
 
+  static constexpr const char* c_StdStreamName = "-"; //FilePath denoting standard input
+
 protected:
   FILE*  m_FileHandle;
+  bool   m_StdStream = false; //handle is not owned (stdin)
 
 public:
   inline       xFile (                                                  ) { m_FileHandle = nullptr; }
@@ -76,6 +84,7 @@ public:
   inline       ~xFile(                                                  ) { close(); }
   inline void   open (const std::string FilePath, const std::string Attr); 
   inline void   open (const char*       FilePath, const char*       Attr) { open(std::string(FilePath), std::string(Attr)); };
+  inline void   openStdin();
   inline void   close();
 
   inline uint64 read (      void* Memmory, uint32 Length) { return fread (Memmory, 1, Length, m_FileHandle); }
@@ -100,6 +109,7 @@ protected:
 public:
   static inline bool  exist   (const std::string FilePath);
   static inline int64 filesize(const std::string FilePath);
+  static inline bool  isStream(const std::string FilePath); //stdin, pipe, FIFO, character device or socket - not seekable, size is unknown
 };
 
 //=============================================================================================================================================================================
@@ -113,12 +123,22 @@ void xFile::open(const std::string FilePath, const std::string Attr)
   m_FileHandle = fopen(FilePath.c_str(), Mode.c_str());
   if(m_FileHandle==nullptr) { xPrinterror(); fmt::printf("(%s)\n", FilePath); }
 }
+void xFile::openStdin()
+{
+  if(m_FileHandle != nullptr) { return; }
+#if X_SYSTEM_WINDOWS
+  _setmode(_fileno(stdin), _O_BINARY);
+#endif
+  m_FileHandle = stdin;
+  m_StdStream  = true;
+}
 void xFile::close()
 {
   if(m_FileHandle!=nullptr)
   {
-    fclose(m_FileHandle);
+    if(!m_StdStream) { fclose(m_FileHandle); }
     m_FileHandle = nullptr;
+    m_StdStream  = false;
   }
 }
 uint64 xFile::size()
@@ -163,6 +183,20 @@ int64 xFile::filesize(const std::string FilePath)
   fclose(FileHandle);
   return EndPosition;
 }
+bool xFile::isStream(const std::string FilePath)
+{
+  if(FilePath == c_StdStreamName) { return true; }
+#if X_SYSTEM_WINDOWS
+  if(FilePath.rfind("\\\\.\\pipe\\", 0) == 0) { return true; }
+  struct _stat64 Stat;
+  if(_stat64(FilePath.c_str(), &Stat) != 0) { return false; }
+  return (Stat.st_mode & _S_IFMT) == _S_IFIFO || (Stat.st_mode & _S_IFMT) == _S_IFCHR;
+#else
+  struct stat Stat;
+  if(stat(FilePath.c_str(), &Stat) != 0) { return false; } //does not open the file - opening FIFO would block until writer appears
+  return S_ISFIFO(Stat.st_mode) || S_ISCHR(Stat.st_mode) || S_ISSOCK(Stat.st_mode);
+#endif
+}
 
 //===============================================================================================================================================================================================================
 
@@ -0,0 +1,154 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xFileMap.h"
+
+#if X_SYSTEM_WINDOWS
+#define NOMINMAX
+#include <windows.h>
+#elif X_SYSTEM_LINUX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+bool xFileMap::open(const std::string& FilePath)
+{
+  if(isOpen()) { return false; }
+#if X_SYSTEM_WINDOWS
+  HANDLE FileHandle = CreateFileA(FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if(FileHandle == INVALID_HANDLE_VALUE) { return false; }
+  LARGE_INTEGER FileSize;
+  if(!GetFileSizeEx(FileHandle, &FileSize) || FileSize.QuadPart == 0) { CloseHandle(FileHandle); return false; }
+  HANDLE MapHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(MapHandle == nullptr) { CloseHandle(FileHandle); return false; }
+  void* Data = MapViewOfFile(MapHandle, FILE_MAP_READ, 0, 0, 0);
+  if(Data == nullptr) { CloseHandle(MapHandle); CloseHandle(FileHandle); return false; }
+  m_FileHandle = FileHandle;
+  m_MapHandle  = MapHandle;
+  m_Data       = (const uint8*)Data;
+  m_Size       = (int64)FileSize.QuadPart;
+#elif X_SYSTEM_LINUX
+  int FileDesc = ::open(FilePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if(FileDesc < 0) { return false; }
+  struct stat FileStat;
+  if(fstat(FileDesc, &FileStat) != 0 || FileStat.st_size <= 0) { ::close(FileDesc); return false; }
+  void* Data = mmap(nullptr, (size_t)FileStat.st_size, PROT_READ, MAP_SHARED, FileDesc, 0);
+  ::close(FileDesc); //mapping holds its own reference to file
+  if(Data == MAP_FAILED) { return false; }
+  m_Data = (const uint8*)Data;
+  m_Size = (int64)FileStat.st_size;
+#else
+  (void)FilePath;
+  return false;
+#endif
+  return true;
+}
+void xFileMap::close()
+{
+  if(!isOpen()) { return; }
+#if X_SYSTEM_WINDOWS
+  UnmapViewOfFile(m_Data);
+  CloseHandle((HANDLE)m_MapHandle );
+  CloseHandle((HANDLE)m_FileHandle);
+  m_MapHandle  = nullptr;
+  m_FileHandle = nullptr;
+#elif X_SYSTEM_LINUX
+  munmap((void*)m_Data, (size_t)m_Size);
+#endif
+  m_Data = nullptr;
+  m_Size = NOT_VALID;
+}
+void xFileMap::advise(int64 Offset, int64 Length, eAdvice Advice) const
+{
+  if(!isOpen() || Offset >= m_Size || Length <= 0) { return; }
+#if X_SYSTEM_LINUX
+  const int64 PageSize = getPageSize();
+  const int64 Beg      = xMax<int64>(Offset, 0) & ~(PageSize - 1);
+  const int64 End      = xMin<int64>(Offset + Length, m_Size);
+  int32 Flag = MADV_NORMAL;
+  switch(Advice)
+  {
+    case eAdvice::Normal    : Flag = MADV_NORMAL    ; break;
+    case eAdvice::Sequential: Flag = MADV_SEQUENTIAL; break;
+    case eAdvice::WillNeed  : Flag = MADV_WILLNEED  ; break;
+    case eAdvice::DontNeed  : Flag = MADV_DONTNEED  ; break; //drops pages from process mapping only, page cache is preserved
+    default: return;
+  }
+  madvise((void*)(m_Data + Beg), (size_t)(End - Beg), Flag);
+#elif X_SYSTEM_WINDOWS
+  if(Advice != eAdvice::WillNeed) { return; } //sequential access is requested at CreateFile time
+  WIN32_MEMORY_RANGE_ENTRY Range;
+  Range.VirtualAddress = (void*)(m_Data + Offset);
+  Range.NumberOfBytes  = (size_t)(xMin<int64>(Offset + Length, m_Size) - Offset);
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &Range, 0);
+#else
+  (void)Advice;
+#endif
+}
+void xFileMap::prefault(int64 Offset, int64 Length) const
+{
+  if(!isOpen() || Offset >= m_Size || Length <= 0) { return; }
+  const int64 PageSize = getPageSize();
+  const int64 End      = xMin<int64>(Offset + Length, m_Size);
+  uint8 Sum = 0;
+  for(int64 Pos = xMax<int64>(Offset, 0) & ~(PageSize - 1); Pos < End; Pos += PageSize) { Sum += *((const volatile uint8*)(m_Data + Pos)); }
+  (void)Sum;
+}
+int64 xFileMap::getPageSize()
+{
+#if X_SYSTEM_WINDOWS
+  SYSTEM_INFO SystemInfo;
+  GetSystemInfo(&SystemInfo);
+  return (int64)SystemInfo.dwPageSize;
+#elif X_SYSTEM_LINUX
+  return (int64)sysconf(_SC_PAGESIZE);
+#else
+  return 4096;
+#endif
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,85 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include <string>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xFileMap - read only memory mapping of whole file (zero-copy access through page cache)
+//===============================================================================================================================================================================================================
+class xFileMap
+{
+public:
+  enum class eAdvice : int32 { Normal, Sequential, WillNeed, DontNeed };
+
+protected:
+  const uint8* m_Data = nullptr;
+  int64        m_Size = NOT_VALID;
+#if X_SYSTEM_WINDOWS
+  void*        m_FileHandle = nullptr;
+  void*        m_MapHandle  = nullptr;
+#endif
+
+public:
+  xFileMap() {}
+  xFileMap(const xFileMap&) = delete;
+  xFileMap& operator=(const xFileMap&) = delete;
+  ~xFileMap() { close(); }
+
+  bool  open (const std::string& FilePath);
+  void  close();
+
+  //range is extended to page boundaries and clipped to mapping size, advices are hints (ignored if not supported)
+  void  advise(int64 Offset, int64 Length, eAdvice Advice) const;
+  //touches every page of range - page faults (and disk reads) are taken by calling thread
+  void  prefault(int64 Offset, int64 Length) const;
+
+  inline bool         isOpen () const { return m_Data != nullptr; }
+  inline const uint8* getData() const { return m_Data; }
+  inline int64        getSize() const { return m_Size; }
+
+  static int64 getPageSize();
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,197 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xIOUring.h"
+
+#if X_IOURING_AVAILABLE
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+#if X_IOURING_AVAILABLE
+
+namespace {
+inline int32 xSysIOUringSetup   (uint32 Entries, io_uring_params* Params) { return (int32)syscall(__NR_io_uring_setup, Entries, Params); }
+inline int32 xSysIOUringEnter   (int32 Fd, uint32 ToSubmit, uint32 MinComplete, uint32 Flags) { return (int32)syscall(__NR_io_uring_enter, Fd, ToSubmit, MinComplete, Flags, nullptr, 0); }
+inline int32 xSysIOUringRegister(int32 Fd, uint32 Opcode, const void* Arg, uint32 NumArgs) { return (int32)syscall(__NR_io_uring_register, Fd, Opcode, Arg, NumArgs); }
+
+inline uint32 xLoadAcquire (const uint32* Ptr            ) { return __atomic_load_n(Ptr, __ATOMIC_ACQUIRE); }
+inline void   xStoreRelease(      uint32* Ptr, uint32 Val) { __atomic_store_n(Ptr, Val, __ATOMIC_RELEASE); }
+} //end of anonymous namespace
+
+bool xIOUring::init(uint32 NumEntries)
+{
+  if(isInitialized()) { return false; }
+
+  io_uring_params Params;
+  memset(&Params, 0, sizeof(Params));
+  const int32 RingFd = xSysIOUringSetup(NumEntries, &Params);
+  if(RingFd < 0) { return false; }
+
+  m_RingFd     = RingFd;
+  m_NumEntries = Params.sq_entries;
+  m_SqRingSize = Params.sq_off.array + Params.sq_entries * sizeof(uint32);
+  m_CqRingSize = Params.cq_off.cqes  + Params.cq_entries * sizeof(io_uring_cqe);
+  const bool SingleMmap = (Params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if(SingleMmap) { m_SqRingSize = m_CqRingSize = xMax(m_SqRingSize, m_CqRingSize); }
+
+  m_SqRingPtr = mmap(nullptr, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_SQ_RING);
+  if(m_SqRingPtr == MAP_FAILED) { m_SqRingPtr = nullptr; uninit(); return false; }
+  if(SingleMmap) { m_CqRingPtr = m_SqRingPtr; }
+  else
+  {
+    m_CqRingPtr = mmap(nullptr, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_CQ_RING);
+    if(m_CqRingPtr == MAP_FAILED) { m_CqRingPtr = nullptr; uninit(); return false; }
+  }
+  m_SqesSize = Params.sq_entries * sizeof(io_uring_sqe);
+  m_Sqes     = mmap(nullptr, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_SQES);
+  if(m_Sqes == MAP_FAILED) { m_Sqes = nullptr; uninit(); return false; }
+
+  uint8* SqRing = (uint8*)m_SqRingPtr;
+  m_SqHead  = (uint32*)(SqRing + Params.sq_off.head        );
+  m_SqTail  = (uint32*)(SqRing + Params.sq_off.tail        );
+  m_SqMask  = (uint32*)(SqRing + Params.sq_off.ring_mask   );
+  m_SqArray = (uint32*)(SqRing + Params.sq_off.array       );
+  uint8* CqRing = (uint8*)m_CqRingPtr;
+  m_CqHead  = (uint32*)(CqRing + Params.cq_off.head        );
+  m_CqTail  = (uint32*)(CqRing + Params.cq_off.tail        );
+  m_CqMask  = (uint32*)(CqRing + Params.cq_off.ring_mask   );
+  m_Cqes    = (void*  )(CqRing + Params.cq_off.cqes        );
+
+  m_IoVecs.resize(m_NumEntries * sizeof(iovec));
+  m_NumPending = 0;
+  return true;
+}
+void xIOUring::uninit()
+{
+  if(m_Sqes     ) { munmap(m_Sqes, m_SqesSize); m_Sqes = nullptr; }
+  if(m_CqRingPtr && m_CqRingPtr != m_SqRingPtr) { munmap(m_CqRingPtr, m_CqRingSize); }
+  if(m_SqRingPtr) { munmap(m_SqRingPtr, m_SqRingSize); }
+  m_SqRingPtr = nullptr;
+  m_CqRingPtr = nullptr;
+  if(m_RingFd >= 0) { close(m_RingFd); m_RingFd = NOT_VALID; } //registered buffers are released with ring
+  m_NumEntries = 0;
+  m_RegBuffers = false;
+  m_NumPending = 0;
+  m_IoVecs.clear();
+}
+bool xIOUring::registerBuffers(const std::vector<xBuffer>& Buffers)
+{
+  if(!isInitialized() || m_RegBuffers || Buffers.empty()) { return false; }
+  std::vector<iovec> IoVecs(Buffers.size());
+  for(uintSize i = 0; i < Buffers.size(); i++) { IoVecs[i].iov_base = Buffers[i].Addr; IoVecs[i].iov_len = Buffers[i].Size; }
+  m_RegBuffers = xSysIOUringRegister(m_RingFd, IORING_REGISTER_BUFFERS, IoVecs.data(), (uint32)IoVecs.size()) == 0;
+  return m_RegBuffers;
+}
+bool xIOUring::queueRead(int32 FileDesc, void* Dst, uint32 Length, int64 Offset, int32 BufferIdx, uint64 UserData)
+{
+  const uint32 Tail = *m_SqTail;
+  if(Tail - xLoadAcquire(m_SqHead) >= m_NumEntries) { return false; } //submission queue full
+
+  const uint32  Idx = Tail & *m_SqMask;
+  io_uring_sqe* Sqe = (io_uring_sqe*)m_Sqes + Idx;
+  memset(Sqe, 0, sizeof(io_uring_sqe));
+  Sqe->fd        = FileDesc;
+  Sqe->off       = (uint64)Offset;
+  Sqe->user_data = UserData;
+  if(m_RegBuffers && BufferIdx != NOT_VALID)
+  {
+    Sqe->opcode    = IORING_OP_READ_FIXED;
+    Sqe->addr      = (uint64)(uintptr_t)Dst;
+    Sqe->len       = Length;
+    Sqe->buf_index = (uint16)BufferIdx;
+  }
+  else
+  {
+    iovec* IoVec    = (iovec*)m_IoVecs.data() + Idx;
+    IoVec->iov_base = Dst;
+    IoVec->iov_len  = Length;
+    Sqe->opcode     = IORING_OP_READV;
+    Sqe->addr       = (uint64)(uintptr_t)IoVec;
+    Sqe->len        = 1;
+  }
+  m_SqArray[Idx] = Idx;
+  xStoreRelease(m_SqTail, Tail + 1);
+  m_NumPending++;
+  return true;
+}
+int32 xIOUring::submit(int32 WaitNumCompletions)
+{
+  if(!isInitialized()) { return -EBADF; }
+  const uint32 Flags  = WaitNumCompletions > 0 ? IORING_ENTER_GETEVENTS : 0;
+  int32        Result = 0;
+  do { Result = xSysIOUringEnter(m_RingFd, (uint32)m_NumPending, (uint32)xMax(WaitNumCompletions, 0), Flags); } while(Result < 0 && errno == EINTR);
+  if(Result < 0) { return -errno; }
+  m_NumPending -= Result;
+  return Result;
+}
+bool xIOUring::peekCompletion(uint64& UserData, int32& Result)
+{
+  const uint32 Head = *m_CqHead;
+  if(Head == xLoadAcquire(m_CqTail)) { return false; }
+  const io_uring_cqe* Cqe = (const io_uring_cqe*)m_Cqes + (Head & *m_CqMask);
+  UserData = Cqe->user_data;
+  Result   = Cqe->res;
+  xStoreRelease(m_CqHead, Head + 1);
+  return true;
+}
+
+#else //X_IOURING_AVAILABLE
+
+bool  xIOUring::init           (uint32 /*NumEntries*/) { return false; }
+void  xIOUring::uninit         () {}
+bool  xIOUring::registerBuffers(const std::vector<xBuffer>& /*Buffers*/) { return false; }
+bool  xIOUring::queueRead      (int32 /*FileDesc*/, void* /*Dst*/, uint32 /*Length*/, int64 /*Offset*/, int32 /*BufferIdx*/, uint64 /*UserData*/) { return false; }
+int32 xIOUring::submit         (int32 /*WaitNumCompletions*/) { return NOT_VALID; }
+bool  xIOUring::peekCompletion (uint64& /*UserData*/, int32& /*Result*/) { return false; }
+
+#endif //X_IOURING_AVAILABLE
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,110 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include <vector>
+
+#if X_SYSTEM_LINUX && __has_include(<linux/io_uring.h>)
+#define X_IOURING_AVAILABLE 1
+#else
+#define X_IOURING_AVAILABLE 0
+#endif
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xIOUring - minimal io_uring submission/completion ring built directly on kernel ABI (no liburing dependency)
+// - single producer/consumer: all methods have to be called from one thread at a time
+// - reads only: plain (IORING_OP_READV) or into registered buffers (IORING_OP_READ_FIXED)
+//===============================================================================================================================================================================================================
+class xIOUring
+{
+public:
+  struct xBuffer { void* Addr; uintSize Size; };
+
+protected:
+  int32    m_RingFd      = NOT_VALID;
+  uint32   m_NumEntries  = 0;
+  bool     m_RegBuffers  = false;
+  int32    m_NumPending  = 0; //queued (not submitted) entries
+
+  //submission queue
+  void*    m_SqRingPtr   = nullptr;
+  uintSize m_SqRingSize  = 0;
+  uint32*  m_SqHead      = nullptr;
+  uint32*  m_SqTail      = nullptr;
+  uint32*  m_SqMask      = nullptr;
+  uint32*  m_SqArray     = nullptr;
+  void*    m_Sqes        = nullptr;
+  uintSize m_SqesSize    = 0;
+
+  //completion queue
+  void*    m_CqRingPtr   = nullptr;
+  uintSize m_CqRingSize  = 0;
+  uint32*  m_CqHead      = nullptr;
+  uint32*  m_CqTail      = nullptr;
+  uint32*  m_CqMask      = nullptr;
+  void*    m_Cqes        = nullptr;
+
+  std::vector<uint8> m_IoVecs; //storage for iovec structures of READV entries (one per ring entry)
+
+public:
+  xIOUring() {}
+  xIOUring(const xIOUring&) = delete;
+  xIOUring& operator=(const xIOUring&) = delete;
+  ~xIOUring() { uninit(); }
+
+  bool  init           (uint32 NumEntries); //false if io_uring is unavailable (old kernel, seccomp, non Linux)
+  void  uninit         ();
+  bool  registerBuffers(const std::vector<xBuffer>& Buffers); //false if registration failed (i.e. RLIMIT_MEMLOCK) - plain reads can still be used
+
+  //BufferIdx = index of registered buffer containing Dst or NOT_VALID
+  bool  queueRead      (int32 FileDesc, void* Dst, uint32 Length, int64 Offset, int32 BufferIdx, uint64 UserData);
+  int32 submit         (int32 WaitNumCompletions); //submits queued entries, returns number of submitted entries or negative errno
+  bool  peekCompletion (uint64& UserData, int32& Result); //nonblocking, Result = bytes read or negative errno
+
+  inline bool  isInitialized      () const { return m_RingFd >= 0; }
+  inline bool  hasRegisteredBuffers() const { return m_RegBuffers; }
+  inline int32 getNumPending      () const { return m_NumPending; }
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,165 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xMemory.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <fstream>
+#include <string>
+
+#if X_SYSTEM_LINUX
+#include <sys/mman.h>
+#endif
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+namespace {
+
+struct xState
+{
+  std::atomic<int32>                  HugePages   = { (int32)xMemory::eHugePages::Disabled };
+  std::atomic<int32>                  NumMappings = { 0 };
+  std::mutex                          Mutex;
+  std::unordered_map<void*, uintSize> Mappings; //explicit huge page mappings (address -> size), guarded by Mutex
+  xMemory::xStats                     Stats;    //guarded by Mutex
+};
+
+xState& xGetState() { static xState State; return State; }
+
+} //end of anonymous namespace
+
+//===============================================================================================================================================================================================================
+
+void xMemory::setHugePages(eHugePages HugePages)
+{
+  xGetState().HugePages.store((int32)HugePages, std::memory_order_relaxed);
+}
+xMemory::eHugePages xMemory::getHugePages()
+{
+  return (eHugePages)xGetState().HugePages.load(std::memory_order_relaxed);
+}
+void* xMemory::alignedMalloc(uintSize Size, uintSize Alignment)
+{
+  xState&          State     = xGetState();
+  const eHugePages HugePages = getHugePages();
+  { std::lock_guard<std::mutex> Lock(State.Mutex); State.Stats.NumAllocs++; }
+
+  if(HugePages == eHugePages::Disabled || Size < c_HugePageSize) { return xAlignedMalloc(Size, Alignment); }
+
+#if X_SYSTEM_LINUX
+  const uintSize HugeSize = xRoundUpToNearestMultiple(Size, (uintSize)c_Log2HugePageSize);
+
+  if(HugePages == eHugePages::Explicit)
+  {
+    int Flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#if defined(MAP_HUGE_2MB)
+    Flags |= MAP_HUGE_2MB;
+#endif
+    void* Memory = mmap(nullptr, HugeSize, PROT_READ | PROT_WRITE, Flags, -1, 0);
+    std::lock_guard<std::mutex> Lock(State.Mutex);
+    if(Memory != MAP_FAILED)
+    {
+      State.Mappings.emplace(Memory, HugeSize);
+      State.NumMappings.fetch_add(1, std::memory_order_relaxed);
+      State.Stats.NumExplicit++;
+      State.Stats.BytesHuge += HugeSize;
+      return Memory;
+    }
+    State.Stats.NumFallbacks++; //huge page pool not configured or exhausted - try transparent huge pages
+  }
+
+  void* Memory = xAlignedMalloc(HugeSize, c_HugePageSize);
+  if(Memory == nullptr) { return nullptr; }
+  const bool Advised = madvise(Memory, HugeSize, MADV_HUGEPAGE) == 0; //fails if kernel is built without THP support
+  std::lock_guard<std::mutex> Lock(State.Mutex);
+  if(Advised) { State.Stats.NumAdvised++; State.Stats.BytesHuge += HugeSize; }
+  else        { State.Stats.NumFallbacks++; }
+  return Memory;
+#else
+  { std::lock_guard<std::mutex> Lock(State.Mutex); State.Stats.NumFallbacks++; }
+  return xAlignedMalloc(Size, Alignment);
+#endif
+}
+void xMemory::alignedFree(void* Memory)
+{
+  if(Memory == nullptr) { return; }
+#if X_SYSTEM_LINUX
+  xState& State = xGetState();
+  if(State.NumMappings.load(std::memory_order_relaxed) > 0)
+  {
+    uintSize MappingSize = 0;
+    {
+      std::lock_guard<std::mutex> Lock(State.Mutex);
+      auto Iter = State.Mappings.find(Memory);
+      if(Iter != State.Mappings.end()) { MappingSize = Iter->second; State.Mappings.erase(Iter); State.NumMappings.fetch_sub(1, std::memory_order_relaxed); }
+    }
+    if(MappingSize != 0) { munmap(Memory, MappingSize); return; }
+  }
+#endif
+  xAlignedFree(Memory);
+}
+xMemory::xStats xMemory::getStats()
+{
+  xState& State = xGetState();
+  std::lock_guard<std::mutex> Lock(State.Mutex);
+  return State.Stats;
+}
+int64 xMemory::getAnonHugePagesBytes()
+{
+#if X_SYSTEM_LINUX
+  std::ifstream File("/proc/self/smaps_rollup");
+  if(!File.is_open()) { return NOT_VALID; }
+  std::string Line;
+  while(std::getline(File, Line))
+  {
+    if(Line.compare(0, 14, "AnonHugePages:") != 0) { continue; }
+    return (int64)std::stoll(Line.substr(14)) * 1024; //value is in kilobytes
+  }
+  return NOT_VALID;
+#else
+  return NOT_VALID;
+#endif
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
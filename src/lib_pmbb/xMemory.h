@@ -0,0 +1,96 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include <string_view>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xMemory - allocator of large picture buffers with optional 2MB huge page backing
+// - Transparent = buffer is 2MB aligned and advised for transparent huge pages (Linux madvise MADV_HUGEPAGE)
+// - Explicit    = buffer is mapped from reserved huge page pool (Linux mmap MAP_HUGETLB, see /proc/sys/vm/nr_hugepages),
+//                 falls back to Transparent if pool is exhausted
+// - buffers smaller than huge page and systems without huge page support use regular aligned allocation
+// - huge pages reduce dTLB misses of strided (column/window) access over large pictures
+//===============================================================================================================================================================================================================
+class xMemory
+{
+public:
+  enum class eHugePages : int32 { Disabled = 0, Transparent = 1, Explicit = 2 };
+
+  static constexpr int32    c_Log2HugePageSize = 21; //huge page size = 2MB
+  static constexpr uintSize c_HugePageSize     = (uintSize)1 << c_Log2HugePageSize;
+
+  static std::string_view HugePagesToString(eHugePages HugePages)
+  {
+    switch(HugePages)
+    {
+      case eHugePages::Disabled   : return "Disabled"   ; break;
+      case eHugePages::Transparent: return "Transparent"; break;
+      case eHugePages::Explicit   : return "Explicit"   ; break;
+      default: return "INVALID"; break;
+    }
+  }
+
+  struct xStats
+  {
+    int64 NumAllocs    = 0; //total number of buffer allocations
+    int64 NumExplicit  = 0; //buffers mapped from huge page pool
+    int64 NumAdvised   = 0; //buffers advised for transparent huge pages
+    int64 NumFallbacks = 0; //huge pages requested but not available (explicit pool exhausted, madvise failed, unsupported system)
+    int64 BytesHuge    = 0; //total size of buffers backed (or advised to be backed) by huge pages
+  };
+
+public:
+  static void       setHugePages(eHugePages HugePages); //affects buffers allocated afterwards
+  static eHugePages getHugePages();
+
+  static void*      alignedMalloc(uintSize Size, uintSize Alignment);
+  static void       alignedFree  (void* Memory);
+
+  static xStats     getStats();
+  //amount of process memory backed by transparent huge pages (in bytes), NOT_VALID if unavailable
+  static int64      getAnonHugePagesBytes();
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,246 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+#include "xPerfCounters.h"
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstring>
+
+#if X_SYSTEM_LINUX
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+namespace {
+
+using eCounter = xPerfCounters::eCounter;
+
+#if X_SYSTEM_LINUX
+struct xCounterDesc
+{
+  eCounter Counter;
+  uint32   Type;
+  uint64   Config;
+};
+
+//three groups - hardware (leader = cycles), TLB (separate group - does not reduce chance of scheduling hardware group) and software (leader = task clock)
+const xCounterDesc xc_HardwareGroup[] =
+{
+  { eCounter::Cycles              , PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES              },
+  { eCounter::Instructions        , PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS            },
+  { eCounter::LLCMisses           , PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES            },
+  { eCounter::StalledCyclesBackend, PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND  },
+};
+const xCounterDesc xc_TLBGroup[] =
+{
+  { eCounter::DTLBLoadMisses      , PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+};
+const xCounterDesc xc_SoftwareGroup[] =
+{
+  { eCounter::TaskClock           , PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK              },
+  { eCounter::PageFaults          , PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS             },
+  { eCounter::ContextSwitches     , PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES        },
+};
+
+struct xGroup
+{
+  int32                 LeaderFD = NOT_VALID;
+  std::vector<int32>    FDs;
+  std::vector<eCounter> Counters; //counter of each group member, in read order
+};
+
+int32 xOpenCounter(const xCounterDesc& Desc, int32 GroupFD)
+{
+  perf_event_attr Attr;
+  std::memset(&Attr, 0, sizeof(Attr));
+  Attr.size           = sizeof(Attr);
+  Attr.type           = Desc.Type;
+  Attr.config         = Desc.Config;
+  Attr.disabled       = GroupFD == NOT_VALID ? 1 : 0;
+  Attr.exclude_kernel = 1;
+  Attr.exclude_hv     = 1;
+  Attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return (int32)syscall(SYS_perf_event_open, &Attr, 0 /*calling thread*/, -1 /*any cpu*/, GroupFD, 0);
+}
+
+template<size_t N> xGroup xOpenGroup(const xCounterDesc (&Descs)[N])
+{
+  xGroup Group;
+  for(size_t i = 0; i < N; i++)
+  {
+    const int32 FD = xOpenCounter(Descs[i], Group.LeaderFD);
+    if(FD < 0) { if(i == 0) { return Group; } continue; } //no leader - no group, unsupported member - skipped
+    if(i == 0) { Group.LeaderFD = FD; }
+    Group.FDs     .push_back(FD       );
+    Group.Counters.push_back(Descs[i].Counter);
+  }
+  ioctl(Group.LeaderFD, PERF_EVENT_IOC_RESET , PERF_IOC_FLAG_GROUP);
+  ioctl(Group.LeaderFD, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return Group;
+}
+
+void xReadGroup(const xGroup& Group, xPerfCounters::xValues& Values)
+{
+  if(Group.LeaderFD == NOT_VALID) { return; }
+  uint64 Buffer[3 + xPerfCounters::c_NumCounters]; //nr, time_enabled, time_running, values
+  const ssize_t Read = read(Group.LeaderFD, Buffer, sizeof(Buffer));
+  if(Read < (ssize_t)(3 * sizeof(uint64))) { return; }
+  const uint64 Num     = xMin(Buffer[0], (uint64)Group.Counters.size());
+  const uint64 Enabled = Buffer[1];
+  const uint64 Running = Buffer[2];
+  const flt64  Scale   = Running > 0 ? (flt64)Enabled / (flt64)Running : 0;
+  for(uint64 i = 0; i < Num; i++)
+  {
+    const int32 c = (int32)Group.Counters[i];
+    Values.m_Values[c] += (flt64)Buffer[3 + i] * Scale;
+    Values.m_Valid [c]  = true;
+  }
+}
+#endif //X_SYSTEM_LINUX
+
+struct xThreadCounters
+{
+#if X_SYSTEM_LINUX
+  xGroup Hardware;
+  xGroup TLB;
+  xGroup Software;
+#endif
+};
+
+struct xRegistry
+{
+  std::mutex                   Mutex;
+  std::atomic<bool>            Enabled = false;
+  std::vector<xThreadCounters> Threads;
+  bool                         Available[xPerfCounters::c_NumCounters] = { false };
+  xPerfCounters::xValues       StageValues[xPerfCounters::c_MaxNumStages];
+};
+
+xRegistry& xGetRegistry() { static xRegistry Registry; return Registry; }
+
+thread_local bool t_Registered = false;
+
+bool xRegisterThread(xRegistry& Registry)
+{
+#if X_SYSTEM_LINUX
+  xThreadCounters Counters;
+  Counters.Hardware = xOpenGroup(xc_HardwareGroup);
+  Counters.TLB      = xOpenGroup(xc_TLBGroup     );
+  Counters.Software = xOpenGroup(xc_SoftwareGroup);
+  if(Counters.Hardware.LeaderFD == NOT_VALID && Counters.TLB.LeaderFD == NOT_VALID && Counters.Software.LeaderFD == NOT_VALID) { return false; }
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  for(eCounter Counter : Counters.Hardware.Counters) { Registry.Available[(int32)Counter] = true; }
+  for(eCounter Counter : Counters.TLB     .Counters) { Registry.Available[(int32)Counter] = true; }
+  for(eCounter Counter : Counters.Software.Counters) { Registry.Available[(int32)Counter] = true; }
+  Registry.Threads.push_back(Counters);
+  t_Registered = true;
+  return true;
+#else
+  (void)Registry;
+  return false;
+#endif
+}
+
+} //end of anonymous namespace
+
+//===============================================================================================================================================================================================================
+
+bool xPerfCounters::enable()
+{
+  xRegistry& Registry = xGetRegistry();
+  if(Registry.Enabled.load(std::memory_order_relaxed)) { return true; }
+  if(!xRegisterThread(Registry)) { return false; }
+  Registry.Enabled.store(true, std::memory_order_relaxed);
+  return true;
+}
+bool xPerfCounters::isEnabled()
+{
+  return xGetRegistry().Enabled.load(std::memory_order_relaxed);
+}
+bool xPerfCounters::registerThread()
+{
+  xRegistry& Registry = xGetRegistry();
+  if(!Registry.Enabled.load(std::memory_order_relaxed) || t_Registered) { return t_Registered; }
+  return xRegisterThread(Registry);
+}
+bool xPerfCounters::isAvailable(eCounter Counter)
+{
+  xRegistry& Registry = xGetRegistry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  return Registry.Available[(int32)Counter];
+}
+xPerfCounters::xValues xPerfCounters::readAll()
+{
+  xValues Values;
+#if X_SYSTEM_LINUX
+  xRegistry& Registry = xGetRegistry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  for(const xThreadCounters& Thread : Registry.Threads)
+  {
+    xReadGroup(Thread.Hardware, Values);
+    xReadGroup(Thread.TLB     , Values);
+    xReadGroup(Thread.Software, Values);
+  }
+#endif
+  return Values;
+}
+void xPerfCounters::addStageValues(int32 StageId, const xValues& Values)
+{
+  if(StageId < 0 || StageId >= c_MaxNumStages) { return; }
+  xRegistry& Registry = xGetRegistry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  Registry.StageValues[StageId] += Values;
+}
+xPerfCounters::xValues xPerfCounters::getStageValues(int32 StageId)
+{
+  if(StageId < 0 || StageId >= c_MaxNumStages) { return xValues(); }
+  xRegistry& Registry = xGetRegistry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  return Registry.StageValues[StageId];
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
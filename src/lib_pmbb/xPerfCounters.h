@@ -0,0 +1,131 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include <string_view>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xPerfCounters - hardware/software performance counters (Linux perf_event_open) accumulated per instrumented stage
+// - every participating thread opens own counters (registerThread), stage values are sums over all registered threads
+//   (therefore only non-overlapping stages driven from single thread should be measured - i.e. frame level stages)
+// - counters which are not supported by CPU/kernel/permissions (perf_event_paranoid) are reported as invalid
+// - multiplexed counters are scaled by time_enabled/time_running
+//===============================================================================================================================================================================================================
+class xPerfCounters
+{
+public:
+  static constexpr int32 c_MaxNumStages = 64;
+
+  enum class eCounter : int32
+  {
+    Cycles = 0,
+    Instructions,
+    LLCMisses,
+    StalledCyclesBackend,
+    DTLBLoadMisses,  //data TLB load misses (page walks) - sensitive to page size of large buffers
+    TaskClock,       //ns
+    PageFaults,
+    ContextSwitches,
+    NumCounters
+  };
+  static constexpr int32 c_NumCounters = (int32)eCounter::NumCounters;
+
+  static std::string_view CounterToString(eCounter Counter)
+  {
+    switch(Counter)
+    {
+      case eCounter::Cycles              : return "Cycles"              ; break;
+      case eCounter::Instructions        : return "Instructions"        ; break;
+      case eCounter::LLCMisses           : return "LLCMisses"           ; break;
+      case eCounter::StalledCyclesBackend: return "StalledCyclesBackend"; break;
+      case eCounter::DTLBLoadMisses      : return "DTLBLoadMisses"      ; break;
+      case eCounter::TaskClock           : return "TaskClock"           ; break;
+      case eCounter::PageFaults          : return "PageFaults"          ; break;
+      case eCounter::ContextSwitches     : return "ContextSwitches"     ; break;
+      default: return "INVALID"; break;
+    }
+  }
+
+  class xValues
+  {
+  public:
+    flt64 m_Values[c_NumCounters];
+    bool  m_Valid [c_NumCounters];
+
+  public:
+    xValues() { for(int32 c = 0; c < c_NumCounters; c++) { m_Values[c] = 0; m_Valid[c] = false; } }
+
+    flt64 get    (eCounter Counter) const { return m_Values[(int32)Counter]; }
+    bool  isValid(eCounter Counter) const { return m_Valid [(int32)Counter]; }
+    flt64 getIPC () const { return isValid(eCounter::Cycles) && isValid(eCounter::Instructions) && get(eCounter::Cycles) > 0 ? get(eCounter::Instructions) / get(eCounter::Cycles) : 0; }
+
+    xValues& operator+=(const xValues& Other) { for(int32 c = 0; c < c_NumCounters; c++) { m_Values[c] += Other.m_Values[c]; m_Valid[c] |= Other.m_Valid[c]; } return *this; }
+    xValues  operator- (const xValues& Other) const { xValues R = *this; for(int32 c = 0; c < c_NumCounters; c++) { R.m_Values[c] -= Other.m_Values[c]; } return R; }
+  };
+
+  class xScope
+  {
+  protected:
+    int32   m_StageId;
+    xValues m_Beg;
+
+  public:
+    xScope(int32 StageId) { m_StageId = isEnabled() ? StageId : NOT_VALID; if(m_StageId != NOT_VALID) { m_Beg = readAll(); } }
+    ~xScope() { if(m_StageId != NOT_VALID) { addStageValues(m_StageId, readAll() - m_Beg); } }
+
+    xScope(const xScope&) = delete;
+    xScope& operator=(const xScope&) = delete;
+  };
+
+public:
+  static bool    enable        (); //opens counters for calling thread, returns false if no counter is available
+  static bool    isEnabled     ();
+  static bool    registerThread(); //opens counters for calling thread (no-op if already registered or not enabled)
+  static bool    isAvailable   (eCounter Counter);
+  static xValues readAll       ();
+  static void    addStageValues(int32 StageId, const xValues& Values);
+  static xValues getStageValues(int32 StageId);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
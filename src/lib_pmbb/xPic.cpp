@@ -39,11 +39,19 @@ THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "xPic.h"
 #include "xPixelOps.h"
+#include "xMemory.h"
+#include "xStageTimer.h"
 #include <cassert>
 #include <cstring>
 
 namespace PMBB_NAMESPACE {
 
+//===============================================================================================================================================================================================================
+
+static const xStageTimer::tStageId xc_StagePicCheck      = xStageTimer::registerStage("xPicP::Check"     );
+static const xStageTimer::tStageId xc_StagePicExtend     = xStageTimer::registerStage("xPicP::Extend"    );
+static const xStageTimer::tStageId xc_StagePicInterleave = xStageTimer::registerStage("xPicI::Interleave");
+
 //===============================================================================================================================================================================================================
 // xPicCommon
 //===============================================================================================================================================================================================================
@@ -113,7 +121,7 @@ void xPicP::create(int32V2 Size, int32 BitDepth, int32 Margin)
 
   for(int32 c = 0; c < m_NumCmps; c++)
   {
-    m_Buffer[c] = (uint16*)xAlignedMalloc(m_BuffCmpNumBytes, xc_AlignmentPel);
+    m_Buffer[c] = (uint16*)xMemory::alignedMalloc(m_BuffCmpNumBytes, xc_AlignmentPel);
     m_Origin[c] = m_Buffer[c] + (m_Margin * m_Stride) + m_Margin;
   }  
 }
@@ -121,7 +129,7 @@ void xPicP::destroy()
 {
   for(int32 c = 0; c < m_NumCmps; c++)
   {
-    if(m_Buffer[c] != nullptr) { xAlignedFree(m_Buffer[c]); m_Buffer[c] = nullptr; }
+    if(m_Buffer[c] != nullptr) { xMemory::alignedFree(m_Buffer[c]); m_Buffer[c] = nullptr; }
     m_Origin[c] = nullptr;
   }
   xUnInit();
@@ -133,6 +141,11 @@ void xPicP::clear()
   m_Timestamp        = NOT_VALID;
   m_IsMarginExtended = false;
 }
+void xPicP::clearLines(int32 FirstLine, int32 NumLines)
+{
+  assert(FirstLine >= 0 && FirstLine + NumLines <= getBuffNumLines());
+  for(int32 c=0; c < m_NumCmps; c++) { memset(m_Buffer[c] + FirstLine * m_Stride, 0, NumLines * m_Stride * sizeof(uint16)); }
+}
 void xPicP::copy(const xPicP* Src)
 {
   assert(Src!=nullptr && isCompatible(Src));
@@ -146,6 +159,7 @@ void xPicP::set(uint16 Value)
 }
 bool xPicP::check(const std::string& Name)
 {
+  xStageTimer::xScope Scope(xc_StagePicCheck, (int64)m_Width * m_Height);
   boolV4 Correct = xMakeVec4(true);
   for(int32 CmpIdx = 0; CmpIdx < m_NumCmps; CmpIdx++)
   { 
@@ -166,6 +180,8 @@ bool xPicP::check(const std::string& Name)
 }
 void xPicP::extend()
 {
+  if(m_Margin == 0) { return; }
+  xStageTimer::xScope Scope(xc_StagePicExtend, (int64)m_Width * m_Height);
   for(int32 CmpIdx = 0; CmpIdx < m_NumCmps; CmpIdx++) { xPixelOps::ExtendMargin(m_Origin[CmpIdx], m_Stride, m_Width, m_Height, m_Margin); }
 }
 
@@ -220,24 +236,141 @@ void xPicI::create(int32V2 Size, int32 BitDepth, int32 Margin)
 {
   xInit(Size, BitDepth, Margin, c_DefNumCmps);
 
-  m_Buffer = (uint16*)xAlignedMalloc(m_BuffCmpNumBytes * c_MaxNumCmps, xc_AlignmentPel);
+  m_Buffer = (uint16*)xMemory::alignedMalloc(m_BuffCmpNumBytes * c_MaxNumCmps, xc_AlignmentPel);
   m_Origin = m_Buffer + (m_Margin * (m_Stride << 2)) + (m_Margin << 2);
 }
 void xPicI::destroy()
 {
-  xAlignedFree(m_Buffer); m_Buffer = nullptr;
+  xMemory::alignedFree(m_Buffer); m_Buffer = nullptr;
   m_Origin = nullptr;
 
   xUnInit();
 }
+void xPicI::clearLines(int32 FirstLine, int32 NumLines)
+{
+  assert(FirstLine >= 0 && FirstLine + NumLines <= getBuffNumLines());
+  memset(m_Buffer + FirstLine * (m_Stride << 2), 0, NumLines * (m_Stride << 2) * sizeof(uint16));
+}
 void xPicI::rearrangeFromPlanar(const xPicP* Planar)
 {
+  xStageTimer::xScope Scope(xc_StagePicInterleave, (int64)m_Width * m_Height);
   assert(isCompatible(Planar));
   const int32 ExtWidth  = m_Width  + (m_Margin << 1);
   const int32 ExtHeight = m_Height + (m_Margin << 1);
   xPixelOps::Interleave(m_Buffer, Planar->getBuffer(eCmp::C0), Planar->getBuffer(eCmp::C1), Planar->getBuffer(eCmp::C2), 0, m_Stride * c_MaxNumCmps, Planar->getStride(), ExtWidth, ExtHeight);
 }
 
+//===============================================================================================================================================================================================================
+// xPicI8
+//===============================================================================================================================================================================================================
+void xPicI8::create(int32V2 Size, int32 BitDepth, int32 Margin)
+{
+  assert(BitDepth <= 8);
+  xInit(Size, BitDepth, Margin, c_DefNumCmps, sizeof(uint8));
+
+  m_Buffer = (uint8*)xMemory::alignedMalloc(m_BuffCmpNumBytes * c_MaxNumCmps, xc_AlignmentPel);
+  m_Origin = m_Buffer + (m_Margin * (m_Stride << 2)) + (m_Margin << 2);
+}
+void xPicI8::destroy()
+{
+  xMemory::alignedFree(m_Buffer); m_Buffer = nullptr;
+  m_Origin = nullptr;
+
+  xUnInit();
+}
+void xPicI8::clearLines(int32 FirstLine, int32 NumLines)
+{
+  assert(FirstLine >= 0 && FirstLine + NumLines <= getBuffNumLines());
+  memset(m_Buffer + FirstLine * (m_Stride << 2), 0, NumLines * (m_Stride << 2) * sizeof(uint8));
+}
+void xPicI8::rearrangeFromPlanar(const xPicP* Planar)
+{
+  xStageTimer::xScope Scope(xc_StagePicInterleave, (int64)m_Width * m_Height);
+  assert(isSameSizeMargin(Planar) && isSameBitDepth(Planar));
+  const int32 ExtWidth  = m_Width  + (m_Margin << 1);
+  const int32 ExtHeight = m_Height + (m_Margin << 1);
+  xPixelOps::CvtInterleave(m_Buffer, Planar->getBuffer(eCmp::C0), Planar->getBuffer(eCmp::C1), Planar->getBuffer(eCmp::C2), 0, m_Stride * c_MaxNumCmps, Planar->getStride(), ExtWidth, ExtHeight);
+}
+
+//===============================================================================================================================================================================================================
+// xRentalCommon
+//===============================================================================================================================================================================================================
+void xRentalCommon::setSizeLimit(uintSize SizeLimit)
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+  m_SizeLimit = SizeLimit;
+  while(m_Buffer.size() > m_SizeLimit) { xDestroyUnit(m_Buffer.back()); m_Buffer.pop_back(); m_Stats.NumDestroyed++; }
+}
+uintSize xRentalCommon::getLoad() const
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+  return m_Buffer.size();
+}
+int64 xRentalCommon::getInUse() const
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+  return m_InUse;
+}
+xRentalCommon::xStats xRentalCommon::getStats() const
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+  return m_Stats;
+}
+void xRentalCommon::xCreate(int32V2 Size, int32 BitDepth, int32 Margin, uintSize InitSize, uintSize SizeLimit)
+{
+  xDestroy();
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+  m_Size      = Size;
+  m_BitDepth  = BitDepth;
+  m_Margin    = Margin;
+  m_SizeLimit = SizeLimit;
+  m_Stats     = xStats();
+  m_Stats.PeakInUse = m_InUse; //units borrowed before recreate will be rejected on giveback
+  const uintSize NumUnits = std::min(InitSize, SizeLimit);
+  m_Buffer.reserve(NumUnits);
+  for(uintSize i = 0; i < NumUnits; i++) { m_Buffer.push_back(xCreateNewUnit()); m_Stats.NumCreated++; }
+}
+void xRentalCommon::xDestroy()
+{
+  std::lock_guard<std::mutex> Lock(m_Mutex);
+  for(xPicCommon* Unit : m_Buffer) { xDestroyUnit(Unit); }
+  m_Buffer.clear();
+}
+xPicCommon* xRentalCommon::xBorrow()
+{
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    m_Stats.NumBorrows++;
+    m_InUse++;
+    m_Stats.PeakInUse = std::max(m_Stats.PeakInUse, m_InUse);
+    if(!m_Buffer.empty())
+    {
+      xPicCommon* Unit = m_Buffer.back();
+      m_Buffer.pop_back();
+      m_Stats.NumReused++;
+      return Unit;
+    }
+    m_Stats.NumCreated++;
+  }
+  return xCreateNewUnit(); //pool miss - allocate outside of critical section
+}
+void xRentalCommon::xGiveback(xPicCommon* Unit)
+{
+  assert(Unit != nullptr);
+  Unit->setPOC      (NOT_VALID);
+  Unit->setTimestamp(NOT_VALID);
+
+  bool Destroy = false;
+  {
+    std::lock_guard<std::mutex> Lock(m_Mutex);
+    m_InUse--;
+    if     (!isCompatible(Unit)            ) { m_Stats.NumRejected++; m_Stats.NumDestroyed++; Destroy = true; }
+    else if(m_Buffer.size() >= m_SizeLimit ) {                        m_Stats.NumDestroyed++; Destroy = true; }
+    else                                     { m_Buffer.push_back(Unit); }
+  }
+  if(Destroy) { xDestroyUnit(Unit); }
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
@@ -39,6 +39,8 @@ THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "xCommonDefPMBB.h"
 #include "xVec.h"
+#include <vector>
+#include <mutex>
 
 namespace PMBB_NAMESPACE {
 
@@ -88,6 +90,7 @@ public:
   inline bool isSameBitDepth  (const xPicCommon* Pic) const { return isSameBitDepth(Pic->m_BitDepth); }
   inline bool isSameNumCmps   (const xPicCommon* Pic) const { return isSameNumCmps(Pic->m_NumCmps); }
   inline bool isCompatible    (const xPicCommon* Pic) const { return isSameSizeMargin(Pic) && isSameBitDepth(Pic) && isSameNumCmps(Pic); }
+  inline bool isCompatible    (int32V2 Size, int32 BitDepth, int32 Margin) const { return isSameSizeMargin(Size.getX(), Size.getY(), Margin) && isSameBitDepth(BitDepth); }
 
   //parameters
   inline int32V2 getSize    () const { return int32V2(m_Width, m_Height); }
@@ -97,6 +100,7 @@ public:
   inline int32   getMargin  () const { return m_Margin          ; }
   inline int32   getBitDepth() const { return m_BitDepth        ; }
   inline int32   getNumCmps () const { return m_NumCmps         ; }
+  inline int32   getBuffNumLines() const { return m_Height + (m_Margin << 1); } //number of buffer lines (including margin)
 
   //time
   inline void  setPOC      (int64 POC      )       { m_POC = POC; }
@@ -130,6 +134,7 @@ public:
   void   destroy();
 
   void   clear ();
+  void   clearLines(int32 FirstLine, int32 NumLines); //clears buffer lines (including margin) - allows first-touch placement of buffer pages by selected thread
   void   copy  (const xPicP* Src            );
   void   copy  (const xPicP* Src, eCmp CmpId) { assert(isCompatible(Src)); xMemcpyX(m_Buffer[(int32)CmpId], Src->m_Buffer[(int32)CmpId], m_BuffCmpNumPels); }
   void   set   (uint16 Value                );
@@ -182,6 +187,8 @@ public:
   void   create (const xPicI* Ref) { create(Ref->getSize(), Ref->getBitDepth(), Ref->getMargin()); }
   void   destroy();
 
+  void   clearLines(int32 FirstLine, int32 NumLines); //clears buffer lines (including margin) - allows first-touch placement of buffer pages by selected thread
+
   //convertion
   void rearrangeFromPlanar(const xPicP* Planar);
   void rearrangeToPlanar  (      xPicP* Planar);
@@ -201,6 +208,125 @@ public:
   inline const uint16V4* getBuffer(                ) const { return (uint16V4*)m_Buffer; }
 };
 
+//===============================================================================================================================================================================================================
+// xPicI8 - interleaved with native 8-bit storage (BitDepth<=8 only, half of xPicI footprint and bandwidth)
+//===============================================================================================================================================================================================================
+class xPicI8 : public xPicCommon
+{
+protected:
+  uint8* m_Buffer = nullptr;
+  uint8* m_Origin = nullptr;
+
+public:
+  //general functions
+  xPicI8 () { };
+  xPicI8 (int32V2 Size, int32 BitDepth, int32 Margin = c_DefMargin) { create(Size, BitDepth, Margin); }
+  ~xPicI8() { destroy(); }
+
+  void   create (int32V2 Size, int32 BitDepth, int32 Margin = c_DefMargin);
+  void   create (const xPicI8* Ref) { create(Ref->getSize(), Ref->getBitDepth(), Ref->getMargin()); }
+  void   destroy();
+
+  void   clearLines(int32 FirstLine, int32 NumLines); //clears buffer lines (including margin) - allows first-touch placement of buffer pages by selected thread
+
+  //convertion
+  void rearrangeFromPlanar(const xPicP* Planar);
+
+public:
+  //vector access
+  inline int32          getStride(                ) const { return m_Stride; }
+  inline int32          getPitch (                ) const { return 1; }
+  inline int32          getOffset(int32V2 Position) const { return (Position.getY() * m_Stride + Position.getX()); }
+  inline uint8V4*       getAddr  (                )       { return (uint8V4*)m_Origin; }
+  inline const uint8V4* getAddr  (                ) const { return (uint8V4*)m_Origin; }
+  inline uint8V4*       getBuffer(                )       { return (uint8V4*)m_Buffer; }
+  inline const uint8V4* getBuffer(                ) const { return (uint8V4*)m_Buffer; }
+};
+
+//===============================================================================================================================================================================================================
+// xRentalCommon - thread-safe pool of reusable pictures/planes with bounded capacity
+//===============================================================================================================================================================================================================
+class xRentalCommon
+{
+public:
+  struct xStats
+  {
+    int64 NumBorrows   = 0; //total number of borrow calls
+    int64 NumReused    = 0; //borrow served by unit already present in pool
+    int64 NumCreated   = 0; //total number of created units (preallocated + created on pool miss)
+    int64 NumDestroyed = 0; //units released while pool in use (pool full, incompatible unit or lowered size limit)
+    int64 NumRejected  = 0; //incompatible units returned to pool (i.e. after recreate with different parameters)
+    int64 PeakInUse    = 0; //maximum number of simultaneously borrowed units
+
+    flt64 getReuseRate() const { return NumBorrows > 0 ? (flt64)NumReused / (flt64)NumBorrows : 0.0; }
+  };
+
+protected:
+  //unit creation parameters
+  int32V2  m_Size     = { NOT_VALID, NOT_VALID };
+  int32    m_BitDepth = NOT_VALID;
+  int32    m_Margin   = NOT_VALID;
+
+  //pool state (guarded by m_Mutex)
+  std::vector<xPicCommon*> m_Buffer;
+  mutable std::mutex       m_Mutex;
+  uintSize                 m_SizeLimit = std::numeric_limits<uintSize>::max(); //max number of idle units kept in pool
+  int64                    m_InUse     = 0;
+  xStats                   m_Stats;
+
+public:
+  xRentalCommon() = default;
+  xRentalCommon(const xRentalCommon&) = delete;
+  xRentalCommon& operator=(const xRentalCommon&) = delete;
+  virtual ~xRentalCommon() { assert(m_Buffer.empty()); } //derived classes have to call xDestroy()
+
+  void     setSizeLimit(uintSize SizeLimit);
+  uintSize getLoad     () const; //number of idle units
+  int64    getInUse    () const; //number of borrowed units
+  xStats   getStats    () const;
+
+  inline int32V2 getSize    () const { return m_Size    ; }
+  inline int32   getBitDepth() const { return m_BitDepth; }
+  inline int32   getMargin  () const { return m_Margin  ; }
+  inline bool    isCompatible(const xPicCommon* Unit) const { assert(Unit != nullptr); return Unit->isCompatible(m_Size, m_BitDepth, m_Margin); }
+
+protected:
+  void        xCreate  (int32V2 Size, int32 BitDepth, int32 Margin, uintSize InitSize, uintSize SizeLimit);
+  void        xDestroy ();
+  xPicCommon* xBorrow  ();
+  void        xGiveback(xPicCommon* Unit);
+
+  virtual xPicCommon* xCreateNewUnit(                ) = 0;
+  virtual void        xDestroyUnit  (xPicCommon* Unit) = 0;
+};
+
+//===============================================================================================================================================================================================================
+// xPicRental - rental for any picture type constructible from (Size, BitDepth, Margin): xPicP, xPicI, xPicI8, xPlane<T>
+//===============================================================================================================================================================================================================
+template <class tPic> class xPicRental : public xRentalCommon
+{
+  static_assert(std::is_base_of_v<xPicCommon, tPic>);
+
+public:
+  xPicRental () = default;
+  xPicRental (int32V2 Size, int32 BitDepth, int32 Margin, uintSize InitSize = 0, uintSize SizeLimit = std::numeric_limits<uintSize>::max()) { create(Size, BitDepth, Margin, InitSize, SizeLimit); }
+  ~xPicRental() { destroy(); }
+
+  void  create  (int32V2 Size, int32 BitDepth, int32 Margin, uintSize InitSize = 0, uintSize SizeLimit = std::numeric_limits<uintSize>::max()) { xCreate(Size, BitDepth, Margin, InitSize, SizeLimit); }
+  void  destroy () { xDestroy(); }
+
+  tPic* borrow  (         ) { return (tPic*)xBorrow(); }
+  void  giveback(tPic* Pic) { xGiveback(Pic); }
+
+protected:
+  virtual xPicCommon* xCreateNewUnit(                ) final { return new tPic(m_Size, m_BitDepth, m_Margin); }
+  virtual void        xDestroyUnit  (xPicCommon* Unit) final { delete (tPic*)Unit; }
+};
+
+using xPicPRental  = xPicRental<xPicP >;
+using xPicIRental  = xPicRental<xPicI >;
+using xPicI8Rental = xPicRental<xPicI8>;
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
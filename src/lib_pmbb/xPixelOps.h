@@ -76,47 +76,79 @@ public:
   template <typename PelType> static inline void CopyPart(PelType* Dst, const PelType* Src, int32 DstStride, int32 SrcStride, int32V2 DstCoord, int32V2 SrcCoord, int32V2 Size);
 
 
-public:  
-  static inline void Copy         (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsSTD::Copy         (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
-  static inline void Downsample   (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSTD::Downsample   (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
-  static inline void CvtDownsample(uint8*  Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSTD::CvtDownsample(Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
-  static inline bool FindBroken   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth) { return xPixelOpsSTD::FindBroken(Src, SrcStride, Width, Height, BitDepth); }
-  static inline void ExtendMargin (uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSTD::ExtendMargin(Addr, Stride, Width, Height, Margin); }
-  static inline void ExtendMargin (flt32V2* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSTD::ExtendMargin(Addr, Stride, Width, Height, Margin); }
-
+public:
 #if   X_CAN_USE_AVX
   
+  static inline void  Copy         (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsAVX::Copy         (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
   static inline void  Cvt          (uint16* Dst, const uint8*  Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsAVX::Cvt          (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
   static inline void  Cvt          (uint8*  Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsAVX::Cvt          (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
   static inline void  Upsample     (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsAVX::Upsample     (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  Downsample   (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsAVX::Downsample   (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
   static inline void  CvtUpsample  (uint16* Dst, const uint8*  Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsAVX::CvtUpsample  (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  CvtDownsample(uint8*  Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsAVX::CvtDownsample(Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  CopyShr      (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   , int32 Shift) { xPixelOpsAVX::CopyShr(Dst, Src, DstStride, SrcStride, Width, Height, Shift); }
+  static inline void  UpsampleUV   (uint16* DstU, uint16* DstV, const uint16* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight, int32 Shift) { xPixelOpsAVX::UpsampleUV(DstU, DstV, SrcUV, DstStride, SrcStride, DstWidth, DstHeight, Shift); }
+  static inline void  CvtUpsampleUV(uint16* DstU, uint16* DstV, const uint8*  SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsAVX::CvtUpsampleUV(DstU, DstV, SrcUV, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  UnpackV210   (uint16* DstY, uint16* DstU, uint16* DstV, const uint32* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsAVX::UnpackV210(DstY, DstU, DstV, Src, DstStride, SrcStride, Width, Height); }
   
   static inline bool  CheckValues  (const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth) { return xPixelOpsAVX::CheckValues(Src, SrcStride, Width, Height, BitDepth); }
+  static inline bool  FindBroken   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth) { return xPixelOpsAVX::FindBroken(Src, SrcStride, Width, Height, BitDepth); }
+  static inline void  ExtendMargin (uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsAVX::ExtendMargin(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMargin (flt32V2* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsAVX::ExtendMargin(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMarginHor(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsAVX::ExtendMarginHor(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMarginVer(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsAVX::ExtendMarginVer(Addr, Stride, Width, Height, Margin); }
   static inline void  Interleave   (uint16* DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsAVX::Interleave(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
+  static inline void  CvtInterleave(uint8*  DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint8  ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsAVX::CvtInterleave(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
 
   static inline int32 CountNonZero (const uint16* Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsAVX::CountNonZero(Src, SrcStride, Width, Height); }
 
 #elif X_CAN_USE_SSE
 
+  static inline void  Copy         (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsSSE::Copy         (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
   static inline void  Cvt          (uint16* Dst, const uint8*  Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsSSE::Cvt          (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
   static inline void  Cvt          (uint8*  Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsSSE::Cvt          (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
   static inline void  Upsample     (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSSE::Upsample     (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  Downsample   (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSSE::Downsample   (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
   static inline void  CvtUpsample  (uint16* Dst, const uint8*  Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSSE::CvtUpsample  (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  CvtDownsample(uint8*  Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSSE::CvtDownsample(Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  CopyShr      (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   , int32 Shift) { xPixelOpsSSE::CopyShr(Dst, Src, DstStride, SrcStride, Width, Height, Shift); }
+  static inline void  UpsampleUV   (uint16* DstU, uint16* DstV, const uint16* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight, int32 Shift) { xPixelOpsSSE::UpsampleUV(DstU, DstV, SrcUV, DstStride, SrcStride, DstWidth, DstHeight, Shift); }
+  static inline void  CvtUpsampleUV(uint16* DstU, uint16* DstV, const uint8*  SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSSE::CvtUpsampleUV(DstU, DstV, SrcUV, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  UnpackV210   (uint16* DstY, uint16* DstU, uint16* DstV, const uint32* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSSE::UnpackV210(DstY, DstU, DstV, Src, DstStride, SrcStride, Width, Height); }
   
   static inline bool  CheckValues  (const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth) { return xPixelOpsSSE::CheckValues(Src, SrcStride, Width, Height, BitDepth); }
+  static inline bool  FindBroken   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth) { return xPixelOpsSSE::FindBroken(Src, SrcStride, Width, Height, BitDepth); }
+  static inline void  ExtendMargin (uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSSE::ExtendMargin(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMargin (flt32V2* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSSE::ExtendMargin(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMarginHor(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSSE::ExtendMarginHor(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMarginVer(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSSE::ExtendMarginVer(Addr, Stride, Width, Height, Margin); }
   static inline void  Interleave   (uint16* DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSSE::Interleave(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
+  static inline void  CvtInterleave(uint8*  DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint8  ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSSE::CvtInterleave(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
 
   static inline int32 CountNonZero (const uint16* Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsSSE::CountNonZero(Src, SrcStride, Width, Height); }
 
 #else //X_CAN_USE_???
 
+  static inline void  Copy         (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsSTD::Copy         (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
   static inline void  Cvt          (uint16* Dst, const uint8*  Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsSTD::Cvt          (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
   static inline void  Cvt          (uint8*  Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   ) { xPixelOpsSTD::Cvt          (Dst, Src, DstStride, SrcStride, Width   , Height   ); }
   static inline void  Upsample     (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSTD::Upsample     (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  Downsample   (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSTD::Downsample   (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
   static inline void  CvtUpsample  (uint16* Dst, const uint8*  Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSTD::CvtUpsample  (Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  CvtDownsample(uint8*  Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSTD::CvtDownsample(Dst, Src, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  CopyShr      (uint16* Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   , int32 Shift) { xPixelOpsSTD::CopyShr(Dst, Src, DstStride, SrcStride, Width, Height, Shift); }
+  static inline void  UpsampleUV   (uint16* DstU, uint16* DstV, const uint16* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight, int32 Shift) { xPixelOpsSTD::UpsampleUV(DstU, DstV, SrcUV, DstStride, SrcStride, DstWidth, DstHeight, Shift); }
+  static inline void  CvtUpsampleUV(uint16* DstU, uint16* DstV, const uint8*  SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight) { xPixelOpsSTD::CvtUpsampleUV(DstU, DstV, SrcUV, DstStride, SrcStride, DstWidth, DstHeight); }
+  static inline void  UnpackV210   (uint16* DstY, uint16* DstU, uint16* DstV, const uint32* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSTD::UnpackV210(DstY, DstU, DstV, Src, DstStride, SrcStride, Width, Height); }
   
   static inline bool  CheckValues  (const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth) { return xPixelOpsSTD::CheckValues(Src, SrcStride, Width, Height, BitDepth); }
+  static inline bool  FindBroken   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth) { return xPixelOpsSTD::FindBroken(Src, SrcStride, Width, Height, BitDepth); }
+  static inline void  ExtendMargin (uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSTD::ExtendMargin(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMargin (flt32V2* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSTD::ExtendMargin(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMarginHor(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSTD::ExtendMarginHor(Addr, Stride, Width, Height, Margin); }
+  static inline void  ExtendMarginVer(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin) { xPixelOpsSTD::ExtendMarginVer(Addr, Stride, Width, Height, Margin); }
   static inline void  Interleave   (uint16* DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSTD::Interleave(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
+  static inline void  CvtInterleave(uint8*  DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint8  ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height) { xPixelOpsSTD::CvtInterleave(DstABCD, SrcA, SrcB, SrcC, ValueD, DstStride, SrcStride, Width, Height); }
 
   static inline int32 CountNonZero (const uint16* Src, int32 SrcStride, int32 Width, int32 Height) { return xPixelOpsSTD::CountNonZero(Src, SrcStride, Width, Height); }
 
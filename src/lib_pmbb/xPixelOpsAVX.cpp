@@ -45,6 +45,56 @@ namespace PMBB_NAMESPACE {
 
 //===============================================================================================================================================================================================================
 
+void xPixelOpsAVX::Copy(uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
+{
+  if(((uint32)Width & c_RemainderMask32)==0) //Width%32==0
+  {
+    for(int32 y=0; y<Height; y++)
+    {
+      for(int32 x=0; x<Width; x+=32)
+      {
+        __m256i SrcV1 = _mm256_loadu_si256((__m256i*)&Src[x   ]);
+        __m256i SrcV2 = _mm256_loadu_si256((__m256i*)&Src[x+16]);
+        _mm256_storeu_si256((__m256i*)&Dst[x   ], SrcV1);
+        _mm256_storeu_si256((__m256i*)&Dst[x+16], SrcV2);
+      }
+      Src += SrcStride;
+      Dst += DstStride;
+    }
+  }
+  else
+  {
+    const int32 Width32 = (int32)((uint32)Width & c_MultipleMask32);
+    const int32 Width16 = (int32)((uint32)Width & c_MultipleMask16);
+    const int32 Width8  = (int32)((uint32)Width & c_MultipleMask8 );
+    for(int32 y=0; y<Height; y++)
+    {
+      for(int32 x=0; x<Width32; x+=32)
+      {
+        __m256i SrcV1 = _mm256_loadu_si256((__m256i*)&Src[x   ]);
+        __m256i SrcV2 = _mm256_loadu_si256((__m256i*)&Src[x+16]);
+        _mm256_storeu_si256((__m256i*)&Dst[x   ], SrcV1);
+        _mm256_storeu_si256((__m256i*)&Dst[x+16], SrcV2);
+      }
+      for(int32 x=Width32; x<Width16; x+=16)
+      {
+        __m256i SrcV = _mm256_loadu_si256((__m256i*)&Src[x]);
+        _mm256_storeu_si256((__m256i*)&Dst[x], SrcV);
+      }
+      for(int32 x=Width16; x<Width8; x+=8)
+      {
+        __m128i SrcV = _mm_loadu_si128((__m128i*)&Src[x]);
+        _mm_storeu_si128((__m128i*)&Dst[x], SrcV);
+      }
+      for(int32 x=Width8; x<Width; x++)
+      {
+        Dst[x] = Src[x];
+      }
+      Src += SrcStride;
+      Dst += DstStride;
+    }
+  }
+}
 void xPixelOpsAVX::Cvt(uint16* restrict Dst, const uint8* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
 {
   if(((uint32)Width & c_RemainderMask32)==0) //Width%32==0
@@ -233,6 +283,61 @@ void xPixelOpsAVX::Upsample(uint16* restrict Dst, const uint16* restrict Src, in
     }
   }
 }
+void xPixelOpsAVX::Downsample(uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight)
+{
+  const uint16* SrcL0 = Src;
+  const uint16* SrcL1 = Src + SrcStride;
+
+  const __m256i LowMaskV = _mm256_set1_epi32(0x0000FFFF);
+  const __m256i RoundV   = _mm256_set1_epi32(2);
+  //averages of 2x2 blocks for 8 destination pels starting at SrcX - sums are calculated with 32 bit precision (exact for full 16 bit range)
+  auto Avg8 = [&](int32 SrcX)
+  {
+    __m256i SrcV0 = _mm256_loadu_si256((__m256i*)&SrcL0[SrcX]);
+    __m256i SrcV1 = _mm256_loadu_si256((__m256i*)&SrcL1[SrcX]);
+    __m256i SumV0 = _mm256_add_epi32(_mm256_and_si256(SrcV0, LowMaskV), _mm256_srli_epi32(SrcV0, 16));
+    __m256i SumV1 = _mm256_add_epi32(_mm256_and_si256(SrcV1, LowMaskV), _mm256_srli_epi32(SrcV1, 16));
+    return _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(SumV0, SumV1), RoundV), 2);
+  };
+  const __m128i LowMaskH = _mm_set1_epi32(0x0000FFFF);
+  const __m128i RoundH   = _mm_set1_epi32(2);
+  auto Avg4 = [&](int32 SrcX)
+  {
+    __m128i SrcV0 = _mm_loadu_si128((__m128i*)&SrcL0[SrcX]);
+    __m128i SrcV1 = _mm_loadu_si128((__m128i*)&SrcL1[SrcX]);
+    __m128i SumV0 = _mm_add_epi32(_mm_and_si128(SrcV0, LowMaskH), _mm_srli_epi32(SrcV0, 16));
+    __m128i SumV1 = _mm_add_epi32(_mm_and_si128(SrcV1, LowMaskH), _mm_srli_epi32(SrcV1, 16));
+    return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(SumV0, SumV1), RoundH), 2);
+  };
+
+  const int32 Width16 = (int32)((uint32)DstWidth & c_MultipleMask16);
+  const int32 Width8  = (int32)((uint32)DstWidth & c_MultipleMask8 );
+  for(int32 y=0; y<DstHeight; y++)
+  {
+    for(int32 x=0; x<Width16; x+=16)
+    {
+      const int32 SrcX = x << 1;
+      __m256i DstVt = _mm256_packus_epi32(Avg8(SrcX), Avg8(SrcX + 16));
+      __m256i DstV  = _mm256_permute4x64_epi64(DstVt, 0xD8); //fix AVX per lane mess
+      _mm256_storeu_si256((__m256i*)&Dst[x], DstV);
+    }
+    for(int32 x=Width16; x<Width8; x+=8)
+    {
+      const int32 SrcX = x << 1;
+      __m128i DstV = _mm_packus_epi32(Avg4(SrcX), Avg4(SrcX + 8));
+      _mm_storeu_si128((__m128i*)&Dst[x], DstV);
+    }
+    for(int32 x=Width8; x<DstWidth; x++)
+    {
+      const int32 SrcX = x << 1;
+      int32 D = ((int32)SrcL0[SrcX] + (int32)SrcL0[SrcX + 1] + (int32)SrcL1[SrcX] + (int32)SrcL1[SrcX + 1] + 2) >> 2;
+      Dst[x] = (uint16)D;
+    }
+    Dst   += DstStride;
+    SrcL0 += (SrcStride << 1);
+    SrcL1 += (SrcStride << 1);
+  }
+}
 void xPixelOpsAVX::CvtUpsample(uint16* restrict Dst, const uint8* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight)
 {
   //TODO - reduce number of permutations
@@ -277,7 +382,7 @@ void xPixelOpsAVX::CvtUpsample(uint16* restrict Dst, const uint8* Src, int32 Dst
 
     for(int32 y=0; y<DstHeight; y+=2)
     {
-      for(int32 x=0; x<Width64; x+=32)
+      for(int32 x=0; x<Width64; x+=64)
       {
         __m256i SrcVt  = _mm256_loadu_si256      ((__m256i*)&Src[x>>1]);
         __m256i SrcV   = _mm256_permute4x64_epi64(SrcVt, 0xD8); //fix AVX per lane mess
@@ -316,7 +421,7 @@ void xPixelOpsAVX::CvtUpsample(uint16* restrict Dst, const uint8* Src, int32 Dst
         _mm_storeu_si128((__m128i*) & DstL1[x + 16], DstV3);
         _mm_storeu_si128((__m128i*) & DstL1[x + 24], DstV4);
       }
-      for(int32 x=Width32; x<Width16; x+=8)
+      for(int32 x=Width32; x<Width16; x+=16)
       {
         __m128i SrcVh = _mm_loadl_epi64((__m128i*)&Src[x>>1]);
         __m128i SrcV1 = _mm_unpacklo_epi8 (SrcVh, _mm_setzero_si128());
@@ -341,6 +446,217 @@ void xPixelOpsAVX::CvtUpsample(uint16* restrict Dst, const uint8* Src, int32 Dst
     }
   }
 }
+void xPixelOpsAVX::CvtDownsample(uint8* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight)
+{
+  const uint16* SrcL0 = Src;
+  const uint16* SrcL1 = Src + SrcStride;
+
+  const __m256i LowMaskV = _mm256_set1_epi32(0x0000FFFF);
+  const __m256i RoundV   = _mm256_set1_epi32(2);
+  const __m256i Max8bitV = _mm256_set1_epi16(255); //packus_epi16 saturates signed values
+  const __m256i PermuteV = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  //averages of 2x2 blocks for 8 destination pels starting at SrcX - sums are calculated with 32 bit precision (exact for full 16 bit range)
+  auto Avg8 = [&](int32 SrcX)
+  {
+    __m256i SrcV0 = _mm256_loadu_si256((__m256i*)&SrcL0[SrcX]);
+    __m256i SrcV1 = _mm256_loadu_si256((__m256i*)&SrcL1[SrcX]);
+    __m256i SumV0 = _mm256_add_epi32(_mm256_and_si256(SrcV0, LowMaskV), _mm256_srli_epi32(SrcV0, 16));
+    __m256i SumV1 = _mm256_add_epi32(_mm256_and_si256(SrcV1, LowMaskV), _mm256_srli_epi32(SrcV1, 16));
+    return _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(SumV0, SumV1), RoundV), 2);
+  };
+  const __m128i LowMaskH = _mm_set1_epi32(0x0000FFFF);
+  const __m128i RoundH   = _mm_set1_epi32(2);
+  const __m128i Max8bitH = _mm_set1_epi16(255);
+  auto Avg4 = [&](int32 SrcX)
+  {
+    __m128i SrcV0 = _mm_loadu_si128((__m128i*)&SrcL0[SrcX]);
+    __m128i SrcV1 = _mm_loadu_si128((__m128i*)&SrcL1[SrcX]);
+    __m128i SumV0 = _mm_add_epi32(_mm_and_si128(SrcV0, LowMaskH), _mm_srli_epi32(SrcV0, 16));
+    __m128i SumV1 = _mm_add_epi32(_mm_and_si128(SrcV1, LowMaskH), _mm_srli_epi32(SrcV1, 16));
+    return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(SumV0, SumV1), RoundH), 2);
+  };
+
+  const int32 Width32 = (int32)((uint32)DstWidth & c_MultipleMask32);
+  const int32 Width16 = (int32)((uint32)DstWidth & c_MultipleMask16);
+  const int32 Width8  = (int32)((uint32)DstWidth & c_MultipleMask8 );
+  for(int32 y=0; y<DstHeight; y++)
+  {
+    for(int32 x=0; x<Width32; x+=32)
+    {
+      const int32 SrcX = x << 1;
+      __m256i DstV1 = _mm256_min_epu16(_mm256_packus_epi32(Avg8(SrcX     ), Avg8(SrcX + 16)), Max8bitV);
+      __m256i DstV2 = _mm256_min_epu16(_mm256_packus_epi32(Avg8(SrcX + 32), Avg8(SrcX + 48)), Max8bitV);
+      __m256i DstVt = _mm256_packus_epi16(DstV1, DstV2); //values are already limited to 0-255
+      __m256i DstV  = _mm256_permutevar8x32_epi32(DstVt, PermuteV); //fix AVX per lane mess
+      _mm256_storeu_si256((__m256i*)&Dst[x], DstV);
+    }
+    for(int32 x=Width32; x<Width16; x+=16)
+    {
+      const int32 SrcX = x << 1;
+      __m128i DstV1 = _mm_min_epu16(_mm_packus_epi32(Avg4(SrcX     ), Avg4(SrcX +  8)), Max8bitH);
+      __m128i DstV2 = _mm_min_epu16(_mm_packus_epi32(Avg4(SrcX + 16), Avg4(SrcX + 24)), Max8bitH);
+      __m128i DstV  = _mm_packus_epi16(DstV1, DstV2); //values are already limited to 0-255
+      _mm_storeu_si128((__m128i*)&Dst[x], DstV);
+    }
+    for(int32 x=Width16; x<Width8; x+=8)
+    {
+      const int32 SrcX = x << 1;
+      __m128i DstV1 = _mm_min_epu16(_mm_packus_epi32(Avg4(SrcX), Avg4(SrcX + 8)), Max8bitH);
+      __m128i DstV  = _mm_packus_epi16(DstV1, DstV1); //values are already limited to 0-255
+      _mm_storel_epi64((__m128i*)&Dst[x], DstV);
+    }
+    for(int32 x=Width8; x<DstWidth; x++)
+    {
+      const int32 SrcX = x << 1;
+      int32 D = ((int32)SrcL0[SrcX] + (int32)SrcL0[SrcX + 1] + (int32)SrcL1[SrcX] + (int32)SrcL1[SrcX + 1] + 2) >> 2;
+      Dst[x] = (uint8)xClip<int32>(D, 0, 255);
+    }
+    Dst   += DstStride;
+    SrcL0 += (SrcStride << 1);
+    SrcL1 += (SrcStride << 1);
+  }
+}
+void xPixelOpsAVX::CopyShr(uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, int32 Shift)
+{
+  const __m128i ShiftV  = _mm_cvtsi32_si128(Shift);
+  const int32   Width32 = (int32)((uint32)Width & c_MultipleMask32);
+  const int32   Width16 = (int32)((uint32)Width & c_MultipleMask16);
+
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width32; x+=32)
+    {
+      __m256i SrcV1 = _mm256_loadu_si256((__m256i*)&Src[x   ]);
+      __m256i SrcV2 = _mm256_loadu_si256((__m256i*)&Src[x+16]);
+      _mm256_storeu_si256((__m256i*)&Dst[x   ], _mm256_srl_epi16(SrcV1, ShiftV));
+      _mm256_storeu_si256((__m256i*)&Dst[x+16], _mm256_srl_epi16(SrcV2, ShiftV));
+    }
+    for(int32 x=Width32; x<Width16; x+=16)
+    {
+      __m256i SrcV = _mm256_loadu_si256((__m256i*)&Src[x]);
+      _mm256_storeu_si256((__m256i*)&Dst[x], _mm256_srl_epi16(SrcV, ShiftV));
+    }
+    for(int32 x=Width16; x<Width; x++)
+    {
+      Dst[x] = (uint16)(Src[x] >> Shift);
+    }
+    Src += SrcStride;
+    Dst += DstStride;
+  }
+}
+void xPixelOpsAVX::UpsampleUV(uint16* restrict DstU, uint16* restrict DstV, const uint16* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight, int32 Shift)
+{
+  //CbCr pairs -> duplicated Cb and duplicated Cr (in lane shuffle - each lane holds 4 pairs = 8 destination pels)
+  const __m256i ShuffleU = _mm256_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5,  8,  9,  8,  9, 12, 13, 12, 13, 0, 1, 0, 1, 4, 5, 4, 5,  8,  9,  8,  9, 12, 13, 12, 13);
+  const __m256i ShuffleV = _mm256_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15, 2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15);
+  const __m128i ShiftV   = _mm_cvtsi32_si128(Shift);
+  const int32   Width16  = (int32)((uint32)DstWidth & c_MultipleMask16);
+
+  uint16* restrict DstU0 = DstU; uint16* restrict DstU1 = DstU + DstStride;
+  uint16* restrict DstV0 = DstV; uint16* restrict DstV1 = DstV + DstStride;
+
+  for(int32 y=0; y<DstHeight; y+=2)
+  {
+    for(int32 x=0; x<Width16; x+=16)
+    {
+      __m256i SrcV = _mm256_loadu_si256((__m256i*)&SrcUV[x]);
+      __m256i U    = _mm256_srl_epi16(_mm256_shuffle_epi8(SrcV, ShuffleU), ShiftV);
+      __m256i V    = _mm256_srl_epi16(_mm256_shuffle_epi8(SrcV, ShuffleV), ShiftV);
+      _mm256_storeu_si256((__m256i*)&DstU0[x], U);
+      _mm256_storeu_si256((__m256i*)&DstU1[x], U);
+      _mm256_storeu_si256((__m256i*)&DstV0[x], V);
+      _mm256_storeu_si256((__m256i*)&DstV1[x], V);
+    }
+    for(int32 x=Width16; x<DstWidth; x+=2)
+    {
+      const uint16 U = (uint16)(SrcUV[x  ] >> Shift);
+      const uint16 V = (uint16)(SrcUV[x+1] >> Shift);
+      DstU0[x] = U; DstU0[x+1] = U; DstU1[x] = U; DstU1[x+1] = U;
+      DstV0[x] = V; DstV0[x+1] = V; DstV1[x] = V; DstV1[x+1] = V;
+    }
+    SrcUV += SrcStride;
+    DstU0 += (DstStride << 1); DstU1 += (DstStride << 1);
+    DstV0 += (DstStride << 1); DstV1 += (DstStride << 1);
+  }
+}
+void xPixelOpsAVX::CvtUpsampleUV(uint16* restrict DstU, uint16* restrict DstV, const uint8* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight)
+{
+  //CbCr pairs zero extended to 16 bits -> duplicated Cb and duplicated Cr (in lane shuffle - each lane holds 4 pairs = 8 destination pels)
+  const __m256i ShuffleU = _mm256_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5,  8,  9,  8,  9, 12, 13, 12, 13, 0, 1, 0, 1, 4, 5, 4, 5,  8,  9,  8,  9, 12, 13, 12, 13);
+  const __m256i ShuffleV = _mm256_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15, 2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15);
+  const int32   Width16  = (int32)((uint32)DstWidth & c_MultipleMask16);
+
+  uint16* restrict DstU0 = DstU; uint16* restrict DstU1 = DstU + DstStride;
+  uint16* restrict DstV0 = DstV; uint16* restrict DstV1 = DstV + DstStride;
+
+  for(int32 y=0; y<DstHeight; y+=2)
+  {
+    for(int32 x=0; x<Width16; x+=16)
+    {
+      __m256i SrcV = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i*)&SrcUV[x]));
+      __m256i U    = _mm256_shuffle_epi8(SrcV, ShuffleU);
+      __m256i V    = _mm256_shuffle_epi8(SrcV, ShuffleV);
+      _mm256_storeu_si256((__m256i*)&DstU0[x], U);
+      _mm256_storeu_si256((__m256i*)&DstU1[x], U);
+      _mm256_storeu_si256((__m256i*)&DstV0[x], V);
+      _mm256_storeu_si256((__m256i*)&DstV1[x], V);
+    }
+    for(int32 x=Width16; x<DstWidth; x+=2)
+    {
+      const uint16 U = SrcUV[x  ];
+      const uint16 V = SrcUV[x+1];
+      DstU0[x] = U; DstU0[x+1] = U; DstU1[x] = U; DstU1[x+1] = U;
+      DstV0[x] = V; DstV0[x+1] = V; DstV1[x] = V; DstV1[x+1] = V;
+    }
+    SrcUV += SrcStride;
+    DstU0 += (DstStride << 1); DstU1 += (DstStride << 1);
+    DstV0 += (DstStride << 1); DstV1 += (DstStride << 1);
+  }
+}
+void xPixelOpsAVX::UnpackV210(uint16* restrict DstY, uint16* restrict DstU, uint16* restrict DstV, const uint32* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
+{
+  //2 groups of 6 pels = 8 words: Cb0 Y0 Cr0 | Y1 Cb1 Y2 | Cr1 Y3 Cb2 | Y4 Cr2 Y5 (x2)
+  //every output sample is gathered from its word by cross lane permute and extracted by variable shift
+  const __m256i MaskV   = _mm256_set1_epi32(0x3FF);
+  const __m256i IdxYA   = _mm256_setr_epi32( 0, 1,  1,  2, 3,  3,  4, 5); //Y0-Y7
+  const __m256i ShiftYA = _mm256_setr_epi32(10, 0, 20, 10, 0, 20, 10, 0);
+  const __m256i IdxYB   = _mm256_setr_epi32( 5,  6, 7,  7, 7, 7, 7, 7); //Y8-Y11
+  const __m256i ShiftYB = _mm256_setr_epi32(20, 10, 0, 20, 0, 0, 0, 0);
+  const __m256i IdxU    = _mm256_setr_epi32( 0,  1,  2, 4,  5,  6, 6, 6); //Cb0-Cb5
+  const __m256i ShiftU  = _mm256_setr_epi32( 0, 10, 20, 0, 10, 20, 0, 0);
+  const __m256i IdxV    = _mm256_setr_epi32( 0,  2,  3, 4,  6,  7, 7, 7); //Cr0-Cr5
+  const __m256i ShiftV  = _mm256_setr_epi32(20,  0, 10, 20, 0, 10, 0, 0);
+  auto Field = [](const uint32* Group, int32 FieldIdx) { return (uint16)((Group[FieldIdx / 3] >> (10 * (FieldIdx % 3))) & 0x3FF); };
+
+  for(int32 y=0; y<Height; y++)
+  {
+    int32 x = 0;
+    for(; x + 16 <= Width; x += 12) //16 pels stored, 12 valid
+    {
+      __m256i W  = _mm256_loadu_si256((__m256i*)&Src[(x / 6) * 4]);
+      __m256i YA = _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(W, IdxYA), ShiftYA), MaskV);
+      __m256i YB = _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(W, IdxYB), ShiftYB), MaskV);
+      __m256i U  = _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(W, IdxU ), ShiftU ), MaskV);
+      __m256i V  = _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(W, IdxV ), ShiftV ), MaskV);
+      __m256i Y  = _mm256_permute4x64_epi64(_mm256_packus_epi32(YA, YB), 0xD8); //fix AVX per lane mess
+      _mm256_storeu_si256((__m256i*)&DstY[x], Y);
+      _mm256_storeu_si256((__m256i*)&DstU[x], _mm256_or_si256(U, _mm256_slli_epi32(U, 16))); //each chroma sample covers 2 pels
+      _mm256_storeu_si256((__m256i*)&DstV[x], _mm256_or_si256(V, _mm256_slli_epi32(V, 16)));
+    }
+    for(; x < Width; x++)
+    {
+      const uint32* Group = Src + (x / 6) * 4;
+      const int32   Pos   = x % 6;
+      DstY[x] = Field(Group, (Pos << 1) + 1);
+      DstU[x] = Field(Group, (Pos >> 1) << 2);
+      DstV[x] = Field(Group, ((Pos >> 1) << 2) + 2);
+    }
+    Src  += SrcStride;
+    DstY += DstStride;
+    DstU += DstStride;
+    DstV += DstStride;
+  }
+}
 bool xPixelOpsAVX::CheckValues(const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth)
 {
   if(BitDepth == 16) { return true; }
@@ -356,11 +672,10 @@ bool xPixelOpsAVX::CheckValues(const uint16* Src, int32 SrcStride, int32 Width,
       {
         __m256i SrcV1  = _mm256_loadu_si256((__m256i*)&Src[x   ]);
         __m256i SrcV2  = _mm256_loadu_si256((__m256i*)&Src[x+16]);
-        __m256i MaskV1 = _mm256_cmpgt_epi16(SrcV1, MaxValueV); //0 - <=, 0xFFFF - >
-        __m256i MaskV2 = _mm256_cmpgt_epi16(SrcV2, MaxValueV); //0 - <=, 0xFFFF - >
-        __m256i Masks  = _mm256_packs_epi16(MaskV1, MaskV2);
-        uint32  Mask   = _mm256_movemask_epi8(Masks) & 0xFFFF;
-        if(Mask) { return false; }
+        __m256i OverV1 = _mm256_subs_epu16(SrcV1, MaxValueV); //0 - <=, >0 - > (unsigned saturation)
+        __m256i OverV2 = _mm256_subs_epu16(SrcV2, MaxValueV); //0 - <=, >0 - > (unsigned saturation)
+        __m256i OverV  = _mm256_or_si256(OverV1, OverV2);
+        if(!_mm256_testz_si256(OverV, OverV)) { return false; }
       }
       Src += SrcStride;
     } //y
@@ -370,15 +685,14 @@ bool xPixelOpsAVX::CheckValues(const uint16* Src, int32 SrcStride, int32 Width,
     const int32 Width32 = (int32)((uint32)Width & c_MultipleMask32);
     for(int32 y = 0; y < Height; y++)
     {
-      for(int32 x = 0; x < Width; x += 32)
+      for(int32 x = 0; x < Width32; x += 32)
       {
         __m256i SrcV1  = _mm256_loadu_si256((__m256i*)&Src[x   ]);
         __m256i SrcV2  = _mm256_loadu_si256((__m256i*)&Src[x+16]);
-        __m256i MaskV1 = _mm256_cmpgt_epi16(SrcV1, MaxValueV); //0 - <=, 0xFFFF - >
-        __m256i MaskV2 = _mm256_cmpgt_epi16(SrcV2, MaxValueV); //0 - <=, 0xFFFF - >
-        __m256i Masks  = _mm256_packs_epi16(MaskV1, MaskV2);
-        uint32  Mask   = _mm256_movemask_epi8(Masks) & 0xFFFF;
-        if(Mask) { return false; }
+        __m256i OverV1 = _mm256_subs_epu16(SrcV1, MaxValueV); //0 - <=, >0 - > (unsigned saturation)
+        __m256i OverV2 = _mm256_subs_epu16(SrcV2, MaxValueV); //0 - <=, >0 - > (unsigned saturation)
+        __m256i OverV  = _mm256_or_si256(OverV1, OverV2);
+        if(!_mm256_testz_si256(OverV, OverV)) { return false; }
       }
       for (int32 x = Width32; x < Width; x++)
       {
@@ -390,6 +704,95 @@ bool xPixelOpsAVX::CheckValues(const uint16* Src, int32 SrcStride, int32 Width,
 
   return true;
 }
+bool xPixelOpsAVX::FindBroken(const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth)
+{
+  if(BitDepth == 16) { return true; }
+
+  const int32   MaxValue  = xBitDepth2MaxValue(BitDepth);
+  const __m256i MaxValueV = _mm256_set1_epi16((int16)MaxValue);
+  const int32   Width16   = (int32)((uint32)Width & c_MultipleMask16);
+
+  bool Correct = true;
+  for(int32 y = 0; y < Height; y++)
+  {
+    __m256i OverV = _mm256_setzero_si256();
+    for(int32 x = 0; x < Width16; x += 16)
+    {
+      __m256i SrcV = _mm256_loadu_si256((__m256i*)&Src[x]);
+      OverV = _mm256_or_si256(OverV, _mm256_subs_epu16(SrcV, MaxValueV)); //0 - <=, >0 - > (unsigned saturation)
+    }
+    bool LineCorrect = _mm256_testz_si256(OverV, OverV);
+    for(int32 x = Width16; x < Width; x++) { if(Src[x] > MaxValue) { LineCorrect = false; } }
+    if(!LineCorrect) //rare case - report every broken sample of the line
+    {
+      for(int32 x = 0; x < Width; x++)
+      {
+        if(Src[x] > MaxValue) { fmt::printf("FILE BROKEN (y=%d, x=%d, VALUE=%d, Expected=[0-%d])\n", y, x, Src[x], MaxValue); }
+      }
+      Correct = false;
+    }
+    Src += SrcStride;
+  }
+  return Correct;
+}
+void xPixelOpsAVX::ExtendMargin(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  ExtendMarginHor(Addr, Stride, Width, Height, Margin);
+  ExtendMarginVer(Addr, Stride, Width, Height, Margin);
+}
+void xPixelOpsAVX::ExtendMargin(flt32V2* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  //left/right
+  for(int32 y = 0; y < Height; y++)
+  {
+    xFillLine(Addr - Margin, Addr[0        ], Margin);
+    xFillLine(Addr + Width , Addr[Width - 1], Margin);
+    Addr += Stride;
+  }
+  //below/above - lines are replicated as raw 16 bit words
+  constexpr int32 c_NumWords = sizeof(flt32V2) / sizeof(uint16);
+  const     int32 ExtWidth   = Width + (Margin << 1);
+  flt32V2* Below = Addr - Stride - Margin;
+  flt32V2* Above = Below - (Height - 1) * Stride;
+  xReplicateLine((uint16*)(Below + Stride), (const uint16*)Below,  Stride * c_NumWords, ExtWidth * c_NumWords, Margin);
+  xReplicateLine((uint16*)(Above - Stride), (const uint16*)Above, -Stride * c_NumWords, ExtWidth * c_NumWords, Margin);
+}
+void xPixelOpsAVX::ExtendMarginHor(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  if(Margin > 0 && Margin < 8 && Width + (Margin << 1) >= 8)
+  {
+    //margin narrower than vector - neighbouring picture samples are loaded and stored back unchanged (right side is loaded after left side is stored)
+    const __m128i IdxV       = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m128i LeftMaskV  = _mm_cmpgt_epi16(_mm_set1_epi16((int16)Margin), IdxV      ); //lanes [0, Margin)
+    const __m128i RightMaskV = _mm_cmpgt_epi16(IdxV, _mm_set1_epi16((int16)(7 - Margin))); //lanes [8-Margin, 8)
+    for(int32 y = 0; y < Height; y++)
+    {
+      uint16* Left  = Addr - Margin;
+      uint16* Right = Addr + Width + Margin - 8;
+      __m128i LeftV = _mm_blendv_epi8(_mm_loadu_si128((__m128i*)Left), _mm_set1_epi16((int16)Addr[0]), LeftMaskV);
+      _mm_storeu_si128((__m128i*)Left, LeftV);
+      __m128i RightV = _mm_blendv_epi8(_mm_loadu_si128((__m128i*)Right), _mm_set1_epi16((int16)Addr[Width - 1]), RightMaskV);
+      _mm_storeu_si128((__m128i*)Right, RightV);
+      Addr += Stride;
+    }
+    return;
+  }
+
+  for(int32 y = 0; y < Height; y++)
+  {
+    xFillLine(Addr - Margin, Addr[0        ], Margin);
+    xFillLine(Addr + Width , Addr[Width - 1], Margin);
+    Addr += Stride;
+  }
+}
+void xPixelOpsAVX::ExtendMarginVer(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  const int32 ExtWidth = Width + (Margin << 1);
+  uint16* Above = Addr - Margin;
+  uint16* Below = Addr - Margin + (Height - 1) * Stride;
+  xReplicateLine(Below + Stride, Below,  Stride, ExtWidth, Margin);
+  xReplicateLine(Above - Stride, Above, -Stride, ExtWidth, Margin);
+}
 void xPixelOpsAVX::Interleave(uint16* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, const uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
 {
   const __m256i d = _mm256_set1_epi16(ValueD);
@@ -524,6 +927,85 @@ void xPixelOpsAVX::Interleave(uint16* restrict DstABCD, const uint16* SrcA, cons
     }
   }
 }
+void xPixelOpsAVX::CvtInterleave(uint8* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint8 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
+{
+  const __m256i d = _mm256_set1_epi8((int8)ValueD);
+
+  const int32 Width32 = (int32)((uint32)Width & c_MultipleMask32);
+  const int32 Width16 = (int32)((uint32)Width & c_MultipleMask16);
+
+  for(int32 y = 0; y < Height; y++)
+  {
+    for(int32 x = 0; x < Width32; x += 32)
+    {
+      //load & convert
+      __m256i at = _mm256_packus_epi16(_mm256_loadu_si256((__m256i*) & SrcA[x]), _mm256_loadu_si256((__m256i*) & SrcA[x + 16]));
+      __m256i bt = _mm256_packus_epi16(_mm256_loadu_si256((__m256i*) & SrcB[x]), _mm256_loadu_si256((__m256i*) & SrcB[x + 16]));
+      __m256i ct = _mm256_packus_epi16(_mm256_loadu_si256((__m256i*) & SrcC[x]), _mm256_loadu_si256((__m256i*) & SrcC[x + 16]));
+
+      //fix AVX per lane mess
+      __m256i a = _mm256_permute4x64_epi64(at, 0xD8); //A0-A31
+      __m256i b = _mm256_permute4x64_epi64(bt, 0xD8); //B0-B31
+      __m256i c = _mm256_permute4x64_epi64(ct, 0xD8); //C0-C31
+
+      //transpose
+      __m256i ac_0    = _mm256_unpacklo_epi8(a   , c   );
+      __m256i ac_1    = _mm256_unpackhi_epi8(a   , c   );
+      __m256i bd_0    = _mm256_unpacklo_epi8(b   , d   );
+      __m256i bd_1    = _mm256_unpackhi_epi8(b   , d   );
+      __m256i abcd_0t = _mm256_unpacklo_epi8(ac_0, bd_0);
+      __m256i abcd_1t = _mm256_unpackhi_epi8(ac_0, bd_0);
+      __m256i abcd_2t = _mm256_unpacklo_epi8(ac_1, bd_1);
+      __m256i abcd_3t = _mm256_unpackhi_epi8(ac_1, bd_1);
+
+      //fix AVX per lane mess
+      __m256i abcd_0  = _mm256_permute2x128_si256(abcd_0t, abcd_1t, 0x20);
+      __m256i abcd_1  = _mm256_permute2x128_si256(abcd_2t, abcd_3t, 0x20);
+      __m256i abcd_2  = _mm256_permute2x128_si256(abcd_0t, abcd_1t, 0x31);
+      __m256i abcd_3  = _mm256_permute2x128_si256(abcd_2t, abcd_3t, 0x31);
+
+      //save
+      _mm256_storeu_si256((__m256i*) & DstABCD[(x << 2) +  0], abcd_0);
+      _mm256_storeu_si256((__m256i*) & DstABCD[(x << 2) + 32], abcd_1);
+      _mm256_storeu_si256((__m256i*) & DstABCD[(x << 2) + 64], abcd_2);
+      _mm256_storeu_si256((__m256i*) & DstABCD[(x << 2) + 96], abcd_3);
+    }
+    for(int32 x = Width32; x < Width16; x += 16)
+    {
+      //load & convert
+      __m128i a = _mm_packus_epi16(_mm_loadu_si128((__m128i*) & SrcA[x]), _mm_loadu_si128((__m128i*) & SrcA[x + 8])); //load A0-A15
+      __m128i b = _mm_packus_epi16(_mm_loadu_si128((__m128i*) & SrcB[x]), _mm_loadu_si128((__m128i*) & SrcB[x + 8])); //load B0-B15
+      __m128i c = _mm_packus_epi16(_mm_loadu_si128((__m128i*) & SrcC[x]), _mm_loadu_si128((__m128i*) & SrcC[x + 8])); //load C0-C15
+
+      //transpose
+      __m128i ac_0   = _mm_unpacklo_epi8(a   , c   );
+      __m128i ac_1   = _mm_unpackhi_epi8(a   , c   );
+      __m128i bd_0   = _mm_unpacklo_epi8(b   , _mm256_castsi256_si128(d));
+      __m128i bd_1   = _mm_unpackhi_epi8(b   , _mm256_castsi256_si128(d));
+      __m128i abcd_0 = _mm_unpacklo_epi8(ac_0, bd_0);
+      __m128i abcd_1 = _mm_unpackhi_epi8(ac_0, bd_0);
+      __m128i abcd_2 = _mm_unpacklo_epi8(ac_1, bd_1);
+      __m128i abcd_3 = _mm_unpackhi_epi8(ac_1, bd_1);
+
+      //save
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) +  0], abcd_0);
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) + 16], abcd_1);
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) + 32], abcd_2);
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) + 48], abcd_3);
+    }
+    for(int32 x = Width16; x < Width; x++)
+    {
+      DstABCD[(x << 2) + 0] = (uint8)xClipU8<uint16>(SrcA[x]);
+      DstABCD[(x << 2) + 1] = (uint8)xClipU8<uint16>(SrcB[x]);
+      DstABCD[(x << 2) + 2] = (uint8)xClipU8<uint16>(SrcC[x]);
+      DstABCD[(x << 2) + 3] = ValueD;
+    }
+    SrcA    += SrcStride;
+    SrcB    += SrcStride;
+    SrcC    += SrcStride;
+    DstABCD += DstStride;
+  }
+}
 int32 xPixelOpsAVX::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width, int32 Height)
 {
   const __m256i ZeroV = _mm256_setzero_si256();
@@ -537,7 +1019,7 @@ int32 xPixelOpsAVX::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width
       for(int32 x=0; x<Width; x+=32)
       {
         __m256i CoeffsA = _mm256_loadu_si256((__m256i*)&Src[x  ]);
-        __m256i CoeffsB = _mm256_loadu_si256((__m256i*)&Src[x+8]);
+        __m256i CoeffsB = _mm256_loadu_si256((__m256i*)&Src[x+16]);
         __m256i MasksA  = _mm256_cmpeq_epi16(CoeffsA, ZeroV);
         __m256i MasksB  = _mm256_cmpeq_epi16(CoeffsB, ZeroV);
         __m256i Masks   = _mm256_packs_epi16(MasksA, MasksB);
@@ -560,7 +1042,7 @@ int32 xPixelOpsAVX::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width
       for(int32 x=0; x<Width32; x+=32)
       {
         __m256i CoeffsA = _mm256_loadu_si256((__m256i*)&Src[x  ]);
-        __m256i CoeffsB = _mm256_loadu_si256((__m256i*)&Src[x+8]);
+        __m256i CoeffsB = _mm256_loadu_si256((__m256i*)&Src[x+16]);
         __m256i MasksA  = _mm256_cmpeq_epi16(CoeffsA, ZeroV);
         __m256i MasksB  = _mm256_cmpeq_epi16(CoeffsB, ZeroV);
         __m256i Masks   = _mm256_packs_epi16(MasksA, MasksB);
@@ -605,6 +1087,92 @@ int32 xPixelOpsAVX::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width
   return NumNonZero;
 }
 
+//===============================================================================================================================================================================================================
+// margin helpers - lines shorter than vector are handled by overlapping last store
+//===============================================================================================================================================================================================================
+void xPixelOpsAVX::xFillLine(uint16* Dst, uint16 Value, int32 Length)
+{
+  if(Length >= 16)
+  {
+    const __m256i ValueV = _mm256_set1_epi16((int16)Value);
+    for(int32 x = 0; x < Length - 16; x += 16) { _mm256_storeu_si256((__m256i*)&Dst[x], ValueV); }
+    _mm256_storeu_si256((__m256i*)&Dst[Length - 16], ValueV);
+  }
+  else if(Length >= 8)
+  {
+    const __m128i ValueV = _mm_set1_epi16((int16)Value);
+    _mm_storeu_si128((__m128i*)&Dst[0         ], ValueV);
+    _mm_storeu_si128((__m128i*)&Dst[Length - 8], ValueV);
+  }
+  else
+  {
+    for(int32 x = 0; x < Length; x++) { Dst[x] = Value; }
+  }
+}
+void xPixelOpsAVX::xFillLine(flt32V2* Dst, flt32V2 Value, int32 Length)
+{
+  const __m128i ValueH = _mm_loadl_epi64((__m128i*)&Value);
+  if(Length >= 4)
+  {
+    const __m256i ValueV = _mm256_broadcastq_epi64(ValueH);
+    for(int32 x = 0; x < Length - 4; x += 4) { _mm256_storeu_si256((__m256i*)&Dst[x], ValueV); }
+    _mm256_storeu_si256((__m256i*)&Dst[Length - 4], ValueV);
+  }
+  else if(Length >= 2)
+  {
+    const __m128i ValueV = _mm_unpacklo_epi64(ValueH, ValueH);
+    _mm_storeu_si128((__m128i*)&Dst[0         ], ValueV);
+    _mm_storeu_si128((__m128i*)&Dst[Length - 2], ValueV);
+  }
+  else if(Length == 1)
+  {
+    _mm_storel_epi64((__m128i*)Dst, ValueH);
+  }
+}
+void xPixelOpsAVX::xReplicateLine(uint16* Dst, const uint16* Src, int32 DstStride, int32 Length, int32 NumLines)
+{
+  if(Length >= 16)
+  {
+    const int32 Length64 = (int32)((uint32)(Length - 16) & c_MultipleMask64);
+    for(int32 y = 0; y < NumLines; y++)
+    {
+      for(int32 x = 0; x < Length64; x += 64)
+      {
+        __m256i SrcV1 = _mm256_loadu_si256((__m256i*)&Src[x     ]);
+        __m256i SrcV2 = _mm256_loadu_si256((__m256i*)&Src[x + 16]);
+        __m256i SrcV3 = _mm256_loadu_si256((__m256i*)&Src[x + 32]);
+        __m256i SrcV4 = _mm256_loadu_si256((__m256i*)&Src[x + 48]);
+        _mm256_storeu_si256((__m256i*)&Dst[x     ], SrcV1);
+        _mm256_storeu_si256((__m256i*)&Dst[x + 16], SrcV2);
+        _mm256_storeu_si256((__m256i*)&Dst[x + 32], SrcV3);
+        _mm256_storeu_si256((__m256i*)&Dst[x + 48], SrcV4);
+      }
+      for(int32 x = Length64; x < Length - 16; x += 16) { _mm256_storeu_si256((__m256i*)&Dst[x], _mm256_loadu_si256((__m256i*)&Src[x])); }
+      _mm256_storeu_si256((__m256i*)&Dst[Length - 16], _mm256_loadu_si256((__m256i*)&Src[Length - 16]));
+      Dst += DstStride;
+    }
+  }
+  else if(Length >= 8)
+  {
+    const __m128i SrcV1 = _mm_loadu_si128((__m128i*)&Src[0         ]);
+    const __m128i SrcV2 = _mm_loadu_si128((__m128i*)&Src[Length - 8]);
+    for(int32 y = 0; y < NumLines; y++)
+    {
+      _mm_storeu_si128((__m128i*)&Dst[0         ], SrcV1);
+      _mm_storeu_si128((__m128i*)&Dst[Length - 8], SrcV2);
+      Dst += DstStride;
+    }
+  }
+  else
+  {
+    for(int32 y = 0; y < NumLines; y++)
+    {
+      for(int32 x = 0; x < Length; x++) { Dst[x] = Src[x]; }
+      Dst += DstStride;
+    }
+  }
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
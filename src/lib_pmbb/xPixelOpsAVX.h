@@ -39,6 +39,7 @@ THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "xCommonDefPMBB.h"
+#include "xVec.h"
 
 #if X_USE_AVX && X_AVX_ALL
 
@@ -50,14 +51,32 @@ class xPixelOpsAVX
 {
 public:
   //Image
+  static void  Copy         (uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   );
   static void  Cvt          (uint16* restrict Dst, const uint8*  Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   );
   static void  Cvt          (uint8*  restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   );
   static void  Upsample     (uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight);
+  static void  Downsample   (uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight);
   static void  CvtUpsample  (uint16* restrict Dst, const uint8*  Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight);
+  static void  CvtDownsample(uint8*  restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight);
+  static void  CopyShr      (uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width   , int32 Height   , int32 Shift);
+  static void  UpsampleUV   (uint16* restrict DstU, uint16* restrict DstV, const uint16* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight, int32 Shift);
+  static void  CvtUpsampleUV(uint16* restrict DstU, uint16* restrict DstV, const uint8*  SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight);
+  static void  UnpackV210   (uint16* restrict DstY, uint16* restrict DstU, uint16* restrict DstV, const uint32* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height);
   static bool  CheckValues  (const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth);
+  static bool  FindBroken   (const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth);
+  static void  ExtendMargin (uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin);
+  static void  ExtendMargin (flt32V2* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin);
+  static void  ExtendMarginHor(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin);
+  static void  ExtendMarginVer(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin);
 
   static void  Interleave   (uint16* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height);
+  static void  CvtInterleave(uint8* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint8 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height); //interleave with U16-->U8 convertion
   static int32 CountNonZero (const uint16* Src, int32 SrcStride, int32 Width, int32 Height);
+
+protected:
+  static void  xFillLine     (uint16*  Dst, uint16  Value, int32 Length);
+  static void  xFillLine     (flt32V2* Dst, flt32V2 Value, int32 Length);
+  static void  xReplicateLine(uint16*  Dst, const uint16* Src, int32 DstStride, int32 Length, int32 NumLines); //copies Src line to NumLines lines starting at Dst
 };
 
 //===============================================================================================================================================================================================================
@@ -45,6 +45,50 @@ namespace PMBB_NAMESPACE {
 
 //===============================================================================================================================================================================================================
 
+void xPixelOpsSSE::Copy(uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
+{
+  if(((uint32)Width & c_RemainderMask16)==0) //Width%16==0
+  {
+    for(int32 y=0; y<Height; y++)
+    {
+      for(int32 x=0; x<Width; x+=16)
+      {
+        __m128i SrcV1 = _mm_loadu_si128((__m128i*)&Src[x  ]);
+        __m128i SrcV2 = _mm_loadu_si128((__m128i*)&Src[x+8]);
+        _mm_storeu_si128((__m128i*)&Dst[x  ], SrcV1);
+        _mm_storeu_si128((__m128i*)&Dst[x+8], SrcV2);
+      }
+      Src += SrcStride;
+      Dst += DstStride;
+    }
+  }
+  else
+  {
+    const int32 Width16 = (int32)((uint32)Width & c_MultipleMask16);
+    const int32 Width8  = (int32)((uint32)Width & c_MultipleMask8 );
+    for(int32 y=0; y<Height; y++)
+    {
+      for(int32 x=0; x<Width16; x+=16)
+      {
+        __m128i SrcV1 = _mm_loadu_si128((__m128i*)&Src[x  ]);
+        __m128i SrcV2 = _mm_loadu_si128((__m128i*)&Src[x+8]);
+        _mm_storeu_si128((__m128i*)&Dst[x  ], SrcV1);
+        _mm_storeu_si128((__m128i*)&Dst[x+8], SrcV2);
+      }
+      for(int32 x=Width16; x<Width8; x+=8)
+      {
+        __m128i SrcV = _mm_loadu_si128((__m128i*)&Src[x]);
+        _mm_storeu_si128((__m128i*)&Dst[x], SrcV);
+      }
+      for(int32 x=Width8; x<Width; x++)
+      {
+        Dst[x] = Src[x];
+      }
+      Src += SrcStride;
+      Dst += DstStride;
+    }
+  }
+}
 void xPixelOpsSSE::Cvt(uint16* restrict Dst, const uint8* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
 {
   if(((uint32)Width & c_RemainderMask16)==0) //Width%16==0
@@ -199,6 +243,43 @@ void xPixelOpsSSE::Upsample(uint16* restrict Dst, const uint16* restrict Src, in
     }
   }
 }
+void xPixelOpsSSE::Downsample(uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight)
+{
+  const uint16* SrcL0 = Src;
+  const uint16* SrcL1 = Src + SrcStride;
+
+  const __m128i LowMaskV = _mm_set1_epi32(0x0000FFFF);
+  const __m128i RoundV   = _mm_set1_epi32(2);
+  //averages of 2x2 blocks for 4 destination pels starting at SrcX - sums are calculated with 32 bit precision (exact for full 16 bit range)
+  auto Avg4 = [&](int32 SrcX)
+  {
+    __m128i SrcV0 = _mm_loadu_si128((__m128i*)&SrcL0[SrcX]);
+    __m128i SrcV1 = _mm_loadu_si128((__m128i*)&SrcL1[SrcX]);
+    __m128i SumV0 = _mm_add_epi32(_mm_and_si128(SrcV0, LowMaskV), _mm_srli_epi32(SrcV0, 16));
+    __m128i SumV1 = _mm_add_epi32(_mm_and_si128(SrcV1, LowMaskV), _mm_srli_epi32(SrcV1, 16));
+    return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(SumV0, SumV1), RoundV), 2);
+  };
+
+  const int32 Width8 = (int32)((uint32)DstWidth & c_MultipleMask8);
+  for(int32 y=0; y<DstHeight; y++)
+  {
+    for(int32 x=0; x<Width8; x+=8)
+    {
+      const int32 SrcX = x << 1;
+      __m128i DstV = _mm_packus_epi32(Avg4(SrcX), Avg4(SrcX + 8));
+      _mm_storeu_si128((__m128i*)&Dst[x], DstV);
+    }
+    for(int32 x=Width8; x<DstWidth; x++)
+    {
+      const int32 SrcX = x << 1;
+      int32 D = ((int32)SrcL0[SrcX] + (int32)SrcL0[SrcX + 1] + (int32)SrcL1[SrcX] + (int32)SrcL1[SrcX + 1] + 2) >> 2;
+      Dst[x] = (uint16)D;
+    }
+    Dst   += DstStride;
+    SrcL0 += (SrcStride << 1);
+    SrcL1 += (SrcStride << 1);
+  }
+}
 void xPixelOpsSSE::CvtUpsample(uint16* restrict Dst, const uint8* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight)
 {
   uint16 *restrict DstL0 = Dst;
@@ -281,6 +362,196 @@ void xPixelOpsSSE::CvtUpsample(uint16* restrict Dst, const uint8* Src, int32 Dst
     }
   }
 }
+void xPixelOpsSSE::CvtDownsample(uint8* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight)
+{
+  const uint16* SrcL0 = Src;
+  const uint16* SrcL1 = Src + SrcStride;
+
+  const __m128i LowMaskV = _mm_set1_epi32(0x0000FFFF);
+  const __m128i RoundV   = _mm_set1_epi32(2);
+  const __m128i Max8bitH = _mm_set1_epi16(255); //packus_epi16 saturates signed values
+  //averages of 2x2 blocks for 4 destination pels starting at SrcX - sums are calculated with 32 bit precision (exact for full 16 bit range)
+  auto Avg4 = [&](int32 SrcX)
+  {
+    __m128i SrcV0 = _mm_loadu_si128((__m128i*)&SrcL0[SrcX]);
+    __m128i SrcV1 = _mm_loadu_si128((__m128i*)&SrcL1[SrcX]);
+    __m128i SumV0 = _mm_add_epi32(_mm_and_si128(SrcV0, LowMaskV), _mm_srli_epi32(SrcV0, 16));
+    __m128i SumV1 = _mm_add_epi32(_mm_and_si128(SrcV1, LowMaskV), _mm_srli_epi32(SrcV1, 16));
+    return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(SumV0, SumV1), RoundV), 2);
+  };
+
+  const int32 Width16 = (int32)((uint32)DstWidth & c_MultipleMask16);
+  const int32 Width8  = (int32)((uint32)DstWidth & c_MultipleMask8 );
+  for(int32 y=0; y<DstHeight; y++)
+  {
+    for(int32 x=0; x<Width16; x+=16)
+    {
+      const int32 SrcX = x << 1;
+      __m128i DstV1 = _mm_min_epu16(_mm_packus_epi32(Avg4(SrcX     ), Avg4(SrcX +  8)), Max8bitH);
+      __m128i DstV2 = _mm_min_epu16(_mm_packus_epi32(Avg4(SrcX + 16), Avg4(SrcX + 24)), Max8bitH);
+      __m128i DstV  = _mm_packus_epi16(DstV1, DstV2); //values are already limited to 0-255
+      _mm_storeu_si128((__m128i*)&Dst[x], DstV);
+    }
+    for(int32 x=Width16; x<Width8; x+=8)
+    {
+      const int32 SrcX = x << 1;
+      __m128i DstV1 = _mm_min_epu16(_mm_packus_epi32(Avg4(SrcX), Avg4(SrcX + 8)), Max8bitH);
+      __m128i DstV  = _mm_packus_epi16(DstV1, DstV1); //values are already limited to 0-255
+      _mm_storel_epi64((__m128i*)&Dst[x], DstV);
+    }
+    for(int32 x=Width8; x<DstWidth; x++)
+    {
+      const int32 SrcX = x << 1;
+      int32 D = ((int32)SrcL0[SrcX] + (int32)SrcL0[SrcX + 1] + (int32)SrcL1[SrcX] + (int32)SrcL1[SrcX + 1] + 2) >> 2;
+      Dst[x] = (uint8)xClip<int32>(D, 0, 255);
+    }
+    Dst   += DstStride;
+    SrcL0 += (SrcStride << 1);
+    SrcL1 += (SrcStride << 1);
+  }
+}
+void xPixelOpsSSE::CopyShr(uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, int32 Shift)
+{
+  const __m128i ShiftV = _mm_cvtsi32_si128(Shift);
+  const int32   Width16 = (int32)((uint32)Width & c_MultipleMask16);
+  const int32   Width8  = (int32)((uint32)Width & c_MultipleMask8 );
+
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width16; x+=16)
+    {
+      __m128i SrcV1 = _mm_loadu_si128((__m128i*)&Src[x  ]);
+      __m128i SrcV2 = _mm_loadu_si128((__m128i*)&Src[x+8]);
+      _mm_storeu_si128((__m128i*)&Dst[x  ], _mm_srl_epi16(SrcV1, ShiftV));
+      _mm_storeu_si128((__m128i*)&Dst[x+8], _mm_srl_epi16(SrcV2, ShiftV));
+    }
+    for(int32 x=Width16; x<Width8; x+=8)
+    {
+      __m128i SrcV = _mm_loadu_si128((__m128i*)&Src[x]);
+      _mm_storeu_si128((__m128i*)&Dst[x], _mm_srl_epi16(SrcV, ShiftV));
+    }
+    for(int32 x=Width8; x<Width; x++)
+    {
+      Dst[x] = (uint16)(Src[x] >> Shift);
+    }
+    Src += SrcStride;
+    Dst += DstStride;
+  }
+}
+void xPixelOpsSSE::UpsampleUV(uint16* restrict DstU, uint16* restrict DstV, const uint16* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight, int32 Shift)
+{
+  //CbCr pairs -> duplicated Cb and duplicated Cr
+  const __m128i ShuffleU = _mm_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5,  8,  9,  8,  9, 12, 13, 12, 13);
+  const __m128i ShuffleV = _mm_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15);
+  const __m128i ShiftV   = _mm_cvtsi32_si128(Shift);
+  const int32   Width8   = (int32)((uint32)DstWidth & c_MultipleMask8);
+
+  uint16* restrict DstU0 = DstU; uint16* restrict DstU1 = DstU + DstStride;
+  uint16* restrict DstV0 = DstV; uint16* restrict DstV1 = DstV + DstStride;
+
+  for(int32 y=0; y<DstHeight; y+=2)
+  {
+    for(int32 x=0; x<Width8; x+=8)
+    {
+      __m128i SrcV = _mm_loadu_si128((__m128i*)&SrcUV[x]);
+      __m128i U    = _mm_srl_epi16(_mm_shuffle_epi8(SrcV, ShuffleU), ShiftV);
+      __m128i V    = _mm_srl_epi16(_mm_shuffle_epi8(SrcV, ShuffleV), ShiftV);
+      _mm_storeu_si128((__m128i*)&DstU0[x], U);
+      _mm_storeu_si128((__m128i*)&DstU1[x], U);
+      _mm_storeu_si128((__m128i*)&DstV0[x], V);
+      _mm_storeu_si128((__m128i*)&DstV1[x], V);
+    }
+    for(int32 x=Width8; x<DstWidth; x+=2)
+    {
+      const uint16 U = (uint16)(SrcUV[x  ] >> Shift);
+      const uint16 V = (uint16)(SrcUV[x+1] >> Shift);
+      DstU0[x] = U; DstU0[x+1] = U; DstU1[x] = U; DstU1[x+1] = U;
+      DstV0[x] = V; DstV0[x+1] = V; DstV1[x] = V; DstV1[x+1] = V;
+    }
+    SrcUV += SrcStride;
+    DstU0 += (DstStride << 1); DstU1 += (DstStride << 1);
+    DstV0 += (DstStride << 1); DstV1 += (DstStride << 1);
+  }
+}
+void xPixelOpsSSE::CvtUpsampleUV(uint16* restrict DstU, uint16* restrict DstV, const uint8* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight)
+{
+  //CbCr pairs -> duplicated Cb and duplicated Cr (zero extended)
+  const __m128i ShuffleU = _mm_setr_epi8(0, -1, 0, -1, 2, -1, 2, -1, 4, -1, 4, -1, 6, -1, 6, -1);
+  const __m128i ShuffleV = _mm_setr_epi8(1, -1, 1, -1, 3, -1, 3, -1, 5, -1, 5, -1, 7, -1, 7, -1);
+  const int32   Width16  = (int32)((uint32)DstWidth & c_MultipleMask16);
+
+  uint16* restrict DstU0 = DstU; uint16* restrict DstU1 = DstU + DstStride;
+  uint16* restrict DstV0 = DstV; uint16* restrict DstV1 = DstV + DstStride;
+
+  for(int32 y=0; y<DstHeight; y+=2)
+  {
+    for(int32 x=0; x<Width16; x+=16)
+    {
+      __m128i SrcV  = _mm_loadu_si128((__m128i*)&SrcUV[x]);
+      __m128i SrcVH = _mm_srli_si128(SrcV, 8);
+      __m128i U1    = _mm_shuffle_epi8(SrcV , ShuffleU);
+      __m128i U2    = _mm_shuffle_epi8(SrcVH, ShuffleU);
+      __m128i V1    = _mm_shuffle_epi8(SrcV , ShuffleV);
+      __m128i V2    = _mm_shuffle_epi8(SrcVH, ShuffleV);
+      _mm_storeu_si128((__m128i*)&DstU0[x  ], U1); _mm_storeu_si128((__m128i*)&DstU0[x+8], U2);
+      _mm_storeu_si128((__m128i*)&DstU1[x  ], U1); _mm_storeu_si128((__m128i*)&DstU1[x+8], U2);
+      _mm_storeu_si128((__m128i*)&DstV0[x  ], V1); _mm_storeu_si128((__m128i*)&DstV0[x+8], V2);
+      _mm_storeu_si128((__m128i*)&DstV1[x  ], V1); _mm_storeu_si128((__m128i*)&DstV1[x+8], V2);
+    }
+    for(int32 x=Width16; x<DstWidth; x+=2)
+    {
+      const uint16 U = SrcUV[x  ];
+      const uint16 V = SrcUV[x+1];
+      DstU0[x] = U; DstU0[x+1] = U; DstU1[x] = U; DstU1[x+1] = U;
+      DstV0[x] = V; DstV0[x+1] = V; DstV1[x] = V; DstV1[x+1] = V;
+    }
+    SrcUV += SrcStride;
+    DstU0 += (DstStride << 1); DstU1 += (DstStride << 1);
+    DstV0 += (DstStride << 1); DstV1 += (DstStride << 1);
+  }
+}
+void xPixelOpsSSE::UnpackV210(uint16* restrict DstY, uint16* restrict DstU, uint16* restrict DstV, const uint32* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
+{
+  //group of 6 pels = 4 words: Cb0 Y0 Cr0 | Y1 Cb1 Y2 | Cr1 Y3 Cb2 | Y4 Cr2 Y5
+  //fields 0/1/2 of all words: A = [Cb0 Y1 Cr1 Y4], B = [Y0 Cb1 Y3 Cr2], C = [Cr0 Y2 Cb2 Y5] -> AB = pack(A,B), CC = pack(C,C) -> byte shuffles
+  const __m128i MaskV     = _mm_set1_epi32(0x3FF);
+  const __m128i ShuffleYA = _mm_setr_epi8( 8,  9,  2,  3, -1, -1, 12, 13,  6,  7, -1, -1, -1, -1, -1, -1);
+  const __m128i ShuffleYC = _mm_setr_epi8(-1, -1, -1, -1,  2,  3, -1, -1, -1, -1,  6,  7, -1, -1, -1, -1);
+  const __m128i ShuffleUA = _mm_setr_epi8( 0,  1,  0,  1, 10, 11, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1);
+  const __m128i ShuffleUC = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,  4,  5,  4,  5, -1, -1, -1, -1);
+  const __m128i ShuffleVA = _mm_setr_epi8(-1, -1, -1, -1,  4,  5,  4,  5, 14, 15, 14, 15, -1, -1, -1, -1);
+  const __m128i ShuffleVC = _mm_setr_epi8( 0,  1,  0,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+  auto Field = [](const uint32* Group, int32 FieldIdx) { return (uint16)((Group[FieldIdx / 3] >> (10 * (FieldIdx % 3))) & 0x3FF); };
+
+  for(int32 y=0; y<Height; y++)
+  {
+    int32 x = 0;
+    for(; x + 8 <= Width; x += 6) //8 pels stored, 6 valid
+    {
+      __m128i W  = _mm_loadu_si128((__m128i*)&Src[(x / 6) * 4]);
+      __m128i A  = _mm_and_si128(W                    , MaskV);
+      __m128i B  = _mm_and_si128(_mm_srli_epi32(W, 10), MaskV);
+      __m128i C  = _mm_and_si128(_mm_srli_epi32(W, 20), MaskV);
+      __m128i AB = _mm_packus_epi32(A, B);
+      __m128i CC = _mm_packus_epi32(C, C);
+      _mm_storeu_si128((__m128i*)&DstY[x], _mm_or_si128(_mm_shuffle_epi8(AB, ShuffleYA), _mm_shuffle_epi8(CC, ShuffleYC)));
+      _mm_storeu_si128((__m128i*)&DstU[x], _mm_or_si128(_mm_shuffle_epi8(AB, ShuffleUA), _mm_shuffle_epi8(CC, ShuffleUC)));
+      _mm_storeu_si128((__m128i*)&DstV[x], _mm_or_si128(_mm_shuffle_epi8(AB, ShuffleVA), _mm_shuffle_epi8(CC, ShuffleVC)));
+    }
+    for(; x < Width; x++)
+    {
+      const uint32* Group = Src + (x / 6) * 4;
+      const int32   Pos   = x % 6;
+      DstY[x] = Field(Group, (Pos << 1) + 1);
+      DstU[x] = Field(Group, (Pos >> 1) << 2);
+      DstV[x] = Field(Group, ((Pos >> 1) << 2) + 2);
+    }
+    Src  += SrcStride;
+    DstY += DstStride;
+    DstU += DstStride;
+    DstV += DstStride;
+  }
+}
 bool xPixelOpsSSE::CheckValues(const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth)
 {
   if(BitDepth == 16) { return true; }
@@ -296,11 +567,10 @@ bool xPixelOpsSSE::CheckValues(const uint16* Src, int32 SrcStride, int32 Width,
       {
         __m128i SrcV1  = _mm_loadu_si128((__m128i*)&Src[x  ]);
         __m128i SrcV2  = _mm_loadu_si128((__m128i*)&Src[x+8]);
-        __m128i MaskV1 = _mm_cmpgt_epi16(SrcV1, MaxValueV); //0 - <=, 0xFFFF - >
-        __m128i MaskV2 = _mm_cmpgt_epi16(SrcV2, MaxValueV); //0 - <=, 0xFFFF - >
-        __m128i Masks  = _mm_packs_epi16(MaskV1, MaskV2);
-        uint32  Mask   = _mm_movemask_epi8(Masks) & 0xFFFF;
-        if(Mask) { return false; }
+        __m128i OverV1 = _mm_subs_epu16(SrcV1, MaxValueV); //0 - <=, >0 - > (unsigned saturation)
+        __m128i OverV2 = _mm_subs_epu16(SrcV2, MaxValueV); //0 - <=, >0 - > (unsigned saturation)
+        __m128i OverV  = _mm_or_si128(OverV1, OverV2);
+        if(!_mm_testz_si128(OverV, OverV)) { return false; }
       }
       Src += SrcStride;
     } //y
@@ -310,15 +580,14 @@ bool xPixelOpsSSE::CheckValues(const uint16* Src, int32 SrcStride, int32 Width,
     const int32 Width16 = (int32)((uint32)Width & c_MultipleMask16);
     for(int32 y = 0; y < Height; y++)
     {
-      for(int32 x = 0; x < Width; x += 16)
+      for(int32 x = 0; x < Width16; x += 16)
       {
         __m128i SrcV1  = _mm_loadu_si128((__m128i*)&Src[x  ]);
         __m128i SrcV2  = _mm_loadu_si128((__m128i*)&Src[x+8]);
-        __m128i MaskV1 = _mm_cmpgt_epi16(SrcV1, MaxValueV); //0 - <=, 0xFFFF - >
-        __m128i MaskV2 = _mm_cmpgt_epi16(SrcV2, MaxValueV); //0 - <=, 0xFFFF - >
-        __m128i Masks  = _mm_packs_epi16(MaskV1, MaskV2);
-        uint32  Mask   = _mm_movemask_epi8(Masks) & 0xFFFF;
-        if(Mask) { return false; }
+        __m128i OverV1 = _mm_subs_epu16(SrcV1, MaxValueV); //0 - <=, >0 - > (unsigned saturation)
+        __m128i OverV2 = _mm_subs_epu16(SrcV2, MaxValueV); //0 - <=, >0 - > (unsigned saturation)
+        __m128i OverV  = _mm_or_si128(OverV1, OverV2);
+        if(!_mm_testz_si128(OverV, OverV)) { return false; }
       }
       for (int32 x = Width16; x < Width; x++)
       {
@@ -330,6 +599,95 @@ bool xPixelOpsSSE::CheckValues(const uint16* Src, int32 SrcStride, int32 Width,
 
   return true;
 }
+bool xPixelOpsSSE::FindBroken(const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth)
+{
+  if(BitDepth == 16) { return true; }
+
+  const int32   MaxValue  = xBitDepth2MaxValue(BitDepth);
+  const __m128i MaxValueV = _mm_set1_epi16((int16)MaxValue);
+  const int32   Width8    = (int32)((uint32)Width & c_MultipleMask8);
+
+  bool Correct = true;
+  for(int32 y = 0; y < Height; y++)
+  {
+    __m128i OverV = _mm_setzero_si128();
+    for(int32 x = 0; x < Width8; x += 8)
+    {
+      __m128i SrcV = _mm_loadu_si128((__m128i*)&Src[x]);
+      OverV = _mm_or_si128(OverV, _mm_subs_epu16(SrcV, MaxValueV)); //0 - <=, >0 - > (unsigned saturation)
+    }
+    bool LineCorrect = _mm_testz_si128(OverV, OverV);
+    for(int32 x = Width8; x < Width; x++) { if(Src[x] > MaxValue) { LineCorrect = false; } }
+    if(!LineCorrect) //rare case - report every broken sample of the line
+    {
+      for(int32 x = 0; x < Width; x++)
+      {
+        if(Src[x] > MaxValue) { fmt::printf("FILE BROKEN (y=%d, x=%d, VALUE=%d, Expected=[0-%d])\n", y, x, Src[x], MaxValue); }
+      }
+      Correct = false;
+    }
+    Src += SrcStride;
+  }
+  return Correct;
+}
+void xPixelOpsSSE::ExtendMargin(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  ExtendMarginHor(Addr, Stride, Width, Height, Margin);
+  ExtendMarginVer(Addr, Stride, Width, Height, Margin);
+}
+void xPixelOpsSSE::ExtendMargin(flt32V2* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  //left/right
+  for(int32 y = 0; y < Height; y++)
+  {
+    xFillLine(Addr - Margin, Addr[0        ], Margin);
+    xFillLine(Addr + Width , Addr[Width - 1], Margin);
+    Addr += Stride;
+  }
+  //below/above - lines are replicated as raw 16 bit words
+  constexpr int32 c_NumWords = sizeof(flt32V2) / sizeof(uint16);
+  const     int32 ExtWidth   = Width + (Margin << 1);
+  flt32V2* Below = Addr - Stride - Margin;
+  flt32V2* Above = Below - (Height - 1) * Stride;
+  xReplicateLine((uint16*)(Below + Stride), (const uint16*)Below,  Stride * c_NumWords, ExtWidth * c_NumWords, Margin);
+  xReplicateLine((uint16*)(Above - Stride), (const uint16*)Above, -Stride * c_NumWords, ExtWidth * c_NumWords, Margin);
+}
+void xPixelOpsSSE::ExtendMarginHor(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  if(Margin > 0 && Margin < 8 && Width + (Margin << 1) >= 8)
+  {
+    //margin narrower than vector - neighbouring picture samples are loaded and stored back unchanged (right side is loaded after left side is stored)
+    const __m128i IdxV       = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m128i LeftMaskV  = _mm_cmpgt_epi16(_mm_set1_epi16((int16)Margin), IdxV      ); //lanes [0, Margin)
+    const __m128i RightMaskV = _mm_cmpgt_epi16(IdxV, _mm_set1_epi16((int16)(7 - Margin))); //lanes [8-Margin, 8)
+    for(int32 y = 0; y < Height; y++)
+    {
+      uint16* Left  = Addr - Margin;
+      uint16* Right = Addr + Width + Margin - 8;
+      __m128i LeftV = _mm_blendv_epi8(_mm_loadu_si128((__m128i*)Left), _mm_set1_epi16((int16)Addr[0]), LeftMaskV);
+      _mm_storeu_si128((__m128i*)Left, LeftV);
+      __m128i RightV = _mm_blendv_epi8(_mm_loadu_si128((__m128i*)Right), _mm_set1_epi16((int16)Addr[Width - 1]), RightMaskV);
+      _mm_storeu_si128((__m128i*)Right, RightV);
+      Addr += Stride;
+    }
+    return;
+  }
+
+  for(int32 y = 0; y < Height; y++)
+  {
+    xFillLine(Addr - Margin, Addr[0        ], Margin);
+    xFillLine(Addr + Width , Addr[Width - 1], Margin);
+    Addr += Stride;
+  }
+}
+void xPixelOpsSSE::ExtendMarginVer(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  const int32 ExtWidth = Width + (Margin << 1);
+  uint16* Above = Addr - Margin;
+  uint16* Below = Addr - Margin + (Height - 1) * Stride;
+  xReplicateLine(Below + Stride, Below,  Stride, ExtWidth, Margin);
+  xReplicateLine(Above - Stride, Above, -Stride, ExtWidth, Margin);
+}
 void xPixelOpsSSE::Interleave(uint16* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, const uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
 {
   const __m128i d = _mm_set1_epi16(ValueD);
@@ -429,6 +787,69 @@ void xPixelOpsSSE::Interleave(uint16* restrict DstABCD, const uint16* SrcA, cons
     }
   }
 }
+void xPixelOpsSSE::CvtInterleave(uint8* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint8 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
+{
+  const __m128i d = _mm_set1_epi8((int8)ValueD);
+  const __m128i z = _mm_setzero_si128();
+
+  const int32 Width16 = (int32)((uint32)Width & c_MultipleMask16);
+  const int32 Width8  = (int32)((uint32)Width & c_MultipleMask8 );
+
+  for(int32 y = 0; y < Height; y++)
+  {
+    for(int32 x = 0; x < Width16; x += 16)
+    {
+      //load & convert
+      __m128i a = _mm_packus_epi16(_mm_loadu_si128((__m128i*) & SrcA[x]), _mm_loadu_si128((__m128i*) & SrcA[x + 8])); //load A0-A15
+      __m128i b = _mm_packus_epi16(_mm_loadu_si128((__m128i*) & SrcB[x]), _mm_loadu_si128((__m128i*) & SrcB[x + 8])); //load B0-B15
+      __m128i c = _mm_packus_epi16(_mm_loadu_si128((__m128i*) & SrcC[x]), _mm_loadu_si128((__m128i*) & SrcC[x + 8])); //load C0-C15
+
+      //transpose
+      __m128i ac_0   = _mm_unpacklo_epi8(a   , c   );
+      __m128i ac_1   = _mm_unpackhi_epi8(a   , c   );
+      __m128i bd_0   = _mm_unpacklo_epi8(b   , d   );
+      __m128i bd_1   = _mm_unpackhi_epi8(b   , d   );
+      __m128i abcd_0 = _mm_unpacklo_epi8(ac_0, bd_0);
+      __m128i abcd_1 = _mm_unpackhi_epi8(ac_0, bd_0);
+      __m128i abcd_2 = _mm_unpacklo_epi8(ac_1, bd_1);
+      __m128i abcd_3 = _mm_unpackhi_epi8(ac_1, bd_1);
+
+      //save
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) +  0], abcd_0);
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) + 16], abcd_1);
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) + 32], abcd_2);
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) + 48], abcd_3);
+    }
+    for(int32 x = Width16; x < Width8; x += 8)
+    {
+      //load & convert
+      __m128i a = _mm_packus_epi16(_mm_loadu_si128((__m128i*) & SrcA[x]), z); //load A0-A7
+      __m128i b = _mm_packus_epi16(_mm_loadu_si128((__m128i*) & SrcB[x]), z); //load B0-B7
+      __m128i c = _mm_packus_epi16(_mm_loadu_si128((__m128i*) & SrcC[x]), z); //load C0-C7
+
+      //transpose
+      __m128i ac_0   = _mm_unpacklo_epi8(a   , c   );
+      __m128i bd_0   = _mm_unpacklo_epi8(b   , d   );
+      __m128i abcd_0 = _mm_unpacklo_epi8(ac_0, bd_0);
+      __m128i abcd_1 = _mm_unpackhi_epi8(ac_0, bd_0);
+
+      //save
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) +  0], abcd_0);
+      _mm_storeu_si128((__m128i*) & DstABCD[(x << 2) + 16], abcd_1);
+    }
+    for(int32 x = Width8; x < Width; x++)
+    {
+      DstABCD[(x << 2) + 0] = (uint8)xClipU8<uint16>(SrcA[x]);
+      DstABCD[(x << 2) + 1] = (uint8)xClipU8<uint16>(SrcB[x]);
+      DstABCD[(x << 2) + 2] = (uint8)xClipU8<uint16>(SrcC[x]);
+      DstABCD[(x << 2) + 3] = ValueD;
+    }
+    SrcA    += SrcStride;
+    SrcB    += SrcStride;
+    SrcC    += SrcStride;
+    DstABCD += DstStride;
+  }
+}
 int32 xPixelOpsSSE::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width, int32 Height)
 {
   
@@ -502,6 +923,69 @@ int32 xPixelOpsSSE::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width
   return NumNonZero;
 }
 
+//===============================================================================================================================================================================================================
+// margin helpers - lines shorter than vector are handled by overlapping last store
+//===============================================================================================================================================================================================================
+void xPixelOpsSSE::xFillLine(uint16* Dst, uint16 Value, int32 Length)
+{
+  if(Length >= 8)
+  {
+    const __m128i ValueV = _mm_set1_epi16((int16)Value);
+    for(int32 x = 0; x < Length - 8; x += 8) { _mm_storeu_si128((__m128i*)&Dst[x], ValueV); }
+    _mm_storeu_si128((__m128i*)&Dst[Length - 8], ValueV);
+  }
+  else
+  {
+    for(int32 x = 0; x < Length; x++) { Dst[x] = Value; }
+  }
+}
+void xPixelOpsSSE::xFillLine(flt32V2* Dst, flt32V2 Value, int32 Length)
+{
+  const __m128i ValueH = _mm_loadl_epi64((__m128i*)&Value);
+  if(Length >= 2)
+  {
+    const __m128i ValueV = _mm_unpacklo_epi64(ValueH, ValueH);
+    for(int32 x = 0; x < Length - 2; x += 2) { _mm_storeu_si128((__m128i*)&Dst[x], ValueV); }
+    _mm_storeu_si128((__m128i*)&Dst[Length - 2], ValueV);
+  }
+  else if(Length == 1)
+  {
+    _mm_storel_epi64((__m128i*)Dst, ValueH);
+  }
+}
+void xPixelOpsSSE::xReplicateLine(uint16* Dst, const uint16* Src, int32 DstStride, int32 Length, int32 NumLines)
+{
+  if(Length >= 8)
+  {
+    const int32 Length32 = (int32)((uint32)(Length - 8) & c_MultipleMask32);
+    for(int32 y = 0; y < NumLines; y++)
+    {
+      for(int32 x = 0; x < Length32; x += 32)
+      {
+        __m128i SrcV1 = _mm_loadu_si128((__m128i*)&Src[x     ]);
+        __m128i SrcV2 = _mm_loadu_si128((__m128i*)&Src[x +  8]);
+        __m128i SrcV3 = _mm_loadu_si128((__m128i*)&Src[x + 16]);
+        __m128i SrcV4 = _mm_loadu_si128((__m128i*)&Src[x + 24]);
+        _mm_storeu_si128((__m128i*)&Dst[x     ], SrcV1);
+        _mm_storeu_si128((__m128i*)&Dst[x +  8], SrcV2);
+        _mm_storeu_si128((__m128i*)&Dst[x + 16], SrcV3);
+        _mm_storeu_si128((__m128i*)&Dst[x + 24], SrcV4);
+      }
+      for(int32 x = Length32; x < Length - 8; x += 8) { _mm_storeu_si128((__m128i*)&Dst[x], _mm_loadu_si128((__m128i*)&Src[x])); }
+      _mm_storeu_si128((__m128i*)&Dst[Length - 8], _mm_loadu_si128((__m128i*)&Src[Length - 8]));
+      Dst += DstStride;
+    }
+  }
+  else
+  {
+    for(int32 y = 0; y < NumLines; y++)
+    {
+      for(int32 x = 0; x < Length; x++) { Dst[x] = Src[x]; }
+      Dst += DstStride;
+    }
+  }
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
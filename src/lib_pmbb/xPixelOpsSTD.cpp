@@ -148,6 +148,80 @@ void xPixelOpsSTD::CvtDownsample(uint8* restrict Dst, const uint16* Src, int32 D
     SrcL1 += SrcStrideMul2;
   }
 }
+void xPixelOpsSTD::CopyShr(uint16* restrict Dst, const uint16* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height, int32 Shift)
+{
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width; x++) { Dst[x] = (uint16)(Src[x] >> Shift); }
+    Src += SrcStride;
+    Dst += DstStride;
+  }
+}
+void xPixelOpsSTD::UpsampleUV(uint16* restrict DstU, uint16* restrict DstV, const uint16* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight, int32 Shift)
+{
+  for(int32 y=0; y<DstHeight; y+=2)
+  {
+    for(int32 x=0; x<DstWidth; x+=2)
+    {
+      const uint16 U = (uint16)(SrcUV[x  ] >> Shift); //CbCr pair of 2x2 block starts at x
+      const uint16 V = (uint16)(SrcUV[x+1] >> Shift);
+      DstU[x] = U; DstU[x+1] = U; DstU[DstStride+x] = U; DstU[DstStride+x+1] = U;
+      DstV[x] = V; DstV[x+1] = V; DstV[DstStride+x] = V; DstV[DstStride+x+1] = V;
+    }
+    SrcUV += SrcStride;
+    DstU  += (DstStride << 1);
+    DstV  += (DstStride << 1);
+  }
+}
+void xPixelOpsSTD::CvtUpsampleUV(uint16* restrict DstU, uint16* restrict DstV, const uint8* SrcUV, int32 DstStride, int32 SrcStride, int32 DstWidth, int32 DstHeight)
+{
+  for(int32 y=0; y<DstHeight; y+=2)
+  {
+    for(int32 x=0; x<DstWidth; x+=2)
+    {
+      const uint16 U = SrcUV[x  ]; //CbCr pair of 2x2 block starts at x
+      const uint16 V = SrcUV[x+1];
+      DstU[x] = U; DstU[x+1] = U; DstU[DstStride+x] = U; DstU[DstStride+x+1] = U;
+      DstV[x] = V; DstV[x+1] = V; DstV[DstStride+x] = V; DstV[DstStride+x+1] = V;
+    }
+    SrcUV += SrcStride;
+    DstU  += (DstStride << 1);
+    DstV  += (DstStride << 1);
+  }
+}
+void xPixelOpsSTD::UnpackV210(uint16* restrict DstY, uint16* restrict DstU, uint16* restrict DstV, const uint32* Src, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
+{
+  //group of 6 pels = 4 words = 12 fields (3 x 10 bits per word): Cb0 Y0 Cr0 | Y1 Cb1 Y2 | Cr1 Y3 Cb2 | Y4 Cr2 Y5
+  static constexpr int32 c_FieldY[6] = { 1, 3, 5, 7, 9, 11 };
+  static constexpr int32 c_FieldU[6] = { 0, 0, 4, 4, 8, 8 };
+  static constexpr int32 c_FieldV[6] = { 2, 2, 6, 6, 10, 10 };
+
+  for(int32 y=0; y<Height; y++)
+  {
+    const uint32* Group = Src;
+    for(int32 x=0; x<Width; x+=6, Group+=4)
+    {
+      uint16 Field[12];
+      for(int32 w=0; w<4; w++)
+      {
+        Field[3 * w + 0] = (uint16)( Group[w]        & 0x3FF);
+        Field[3 * w + 1] = (uint16)((Group[w] >> 10) & 0x3FF);
+        Field[3 * w + 2] = (uint16)((Group[w] >> 20) & 0x3FF);
+      }
+      const int32 Num = xMin(6, Width - x);
+      for(int32 p=0; p<Num; p++)
+      {
+        DstY[x + p] = Field[c_FieldY[p]];
+        DstU[x + p] = Field[c_FieldU[p]];
+        DstV[x + p] = Field[c_FieldV[p]];
+      }
+    }
+    Src  += SrcStride;
+    DstY += DstStride;
+    DstU += DstStride;
+    DstV += DstStride;
+  }
+}
 bool xPixelOpsSTD::CheckValues(const uint16* Src, int32 SrcStride, int32 Width, int32 Height, int32 BitDepth)
 {
   if(BitDepth == 16) { return true; }
@@ -228,6 +302,31 @@ void xPixelOpsSTD::ExtendMargin(flt32V2* Addr, int32 Stride, int32 Width, int32
         ::memcpy(Addr - (y + 1) * Stride, Addr, sizeof(flt32V2) * (Width + (Margin << 1)));
     }
 }
+void xPixelOpsSTD::ExtendMarginHor(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  for(int32 y = 0; y < Height; y++)
+  {
+    uint16 Left  = Addr[0];
+    uint16 Right = Addr[Width - 1];
+    for(int32 x = 0; x < Margin; x++)
+    {
+      Addr[x - Margin] = Left;
+      Addr[x + Width ] = Right;
+    }
+    Addr += Stride;
+  }
+}
+void xPixelOpsSTD::ExtendMarginVer(uint16* Addr, int32 Stride, int32 Width, int32 Height, int32 Margin)
+{
+  const int32 ExtWidth = Width + (Margin << 1);
+  uint16* Above = Addr - Margin;
+  uint16* Below = Addr - Margin + (Height - 1) * Stride;
+  for(int32 y = 0; y < Margin; y++)
+  {
+    ::memcpy(Below + (y + 1) * Stride, Below, sizeof(uint16) * ExtWidth);
+    ::memcpy(Above - (y + 1) * Stride, Above, sizeof(uint16) * ExtWidth);
+  }
+}
 void xPixelOpsSTD::Interleave(uint16* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint16 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
 {
   for(int32 y=0; y<Height; y++)
@@ -245,6 +344,23 @@ void xPixelOpsSTD::Interleave(uint16* restrict DstABCD, const uint16* SrcA, cons
     DstABCD += DstStride;
   }
 }
+void xPixelOpsSTD::CvtInterleave(uint8* restrict DstABCD, const uint16* SrcA, const uint16* SrcB, const uint16* SrcC, uint8 ValueD, int32 DstStride, int32 SrcStride, int32 Width, int32 Height)
+{
+  for(int32 y=0; y<Height; y++)
+  {
+    for(int32 x=0; x<Width; x++)
+    {
+      DstABCD[(x<<2)+0] = (uint8)xClipU8<uint16>(SrcA[x]);
+      DstABCD[(x<<2)+1] = (uint8)xClipU8<uint16>(SrcB[x]);
+      DstABCD[(x<<2)+2] = (uint8)xClipU8<uint16>(SrcC[x]);
+      DstABCD[(x<<2)+3] = ValueD;
+    }
+    SrcA    += SrcStride;
+    SrcB    += SrcStride;
+    SrcC    += SrcStride;
+    DstABCD += DstStride;
+  }
+}
 int32 xPixelOpsSTD::CountNonZero(const uint16* Src, int32 SrcStride, int32 Width, int32 Height)
 {
   int32 NumNonZero = 0;
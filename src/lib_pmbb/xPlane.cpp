@@ -5,6 +5,7 @@
 
 #include "xPlane.h"
 #include "xPixelOps.h"
+#include "xMemory.h"
 #include <typeinfo>
 
 namespace PMBB_NAMESPACE {
@@ -20,12 +21,12 @@ template <typename PelType> void xPlane<PelType>::create(int32V2 Size, int32 Bit
   if constexpr(std::is_integral_v<PelType>) { assert(BitDepth!=0); }
   xInit(Size, BitDepth, Margin, 1, sizeof(PelType));
   
-  m_Buffer = (PelType*)xAlignedMalloc(m_BuffCmpNumBytes, xc_AlignmentPel);
+  m_Buffer = (PelType*)xMemory::alignedMalloc(m_BuffCmpNumBytes, xc_AlignmentPel);
   m_Origin = m_Buffer + Margin*m_Stride + Margin;
 }
 template <typename PelType> void xPlane<PelType>::destroy()
 {
-  if(m_Buffer != nullptr) { xAlignedFree(m_Buffer); m_Buffer = nullptr; }
+  if(m_Buffer != nullptr) { xMemory::alignedFree(m_Buffer); m_Buffer = nullptr; }
   m_Origin = nullptr;
   xUnInit();
 }
@@ -68,7 +69,8 @@ template <typename PelType> bool xPlane<PelType>::check(const std::string& Name)
 }
 template <typename PelType> void xPlane<PelType>::extend()
 {
-  if constexpr(std::is_same_v<PelType, uint16>)
+  if(m_Margin == 0) { return; }
+  if constexpr(std::is_same_v<PelType, uint16> || std::is_same_v<PelType, flt32V2>)
   {
     xPixelOps::ExtendMargin(m_Origin, m_Stride, m_Width, m_Height, m_Margin);
   }
@@ -126,55 +128,7 @@ template class xPlane<uint64>;
 template class xPlane< int64>;
 template class xPlane< flt32>;
 template class xPlane< flt64>;
-
-//===============================================================================================================================================================================================================
-// xPlaneRental
-//===============================================================================================================================================================================================================
-/*template <typename PelType> void xPlaneRental<PelType>::create(int32V2 Size, int32 Margin, int32 BitDepth, uintSize InitSize, uintSize SizeLimit)
-{
-  m_Mutex.lock();
-  m_Size         = Size;
-  m_Margin       = Margin;
-  m_BitDepth     = BitDepth;
-  m_CreatedUnits = 0;
-  m_SizeLimit    = SizeLimit;
-
-  for(uintSize i=0; i<InitSize; i++) { xCreateNewUnit(); }
-  m_Mutex.unlock();
-}
-template <typename PelType> void xPlaneRental<PelType>::xCreateNewUnit()
-{
-  xPlane<PelType>* Tmp = new xPlane<PelType>;
-  Tmp->create(m_Size, m_Margin, m_BitDepth);
-  m_Buffer.push_back(Tmp);
-  m_CreatedUnits++;
-}
-template <typename PelType> void xPlaneRental<PelType>::xDestroyUnit()
-{
-  if(!m_Buffer.empty())
-  {
-    xPlane<PelType>* Tmp = (xPlane<PelType>*)m_Buffer.back();
-    m_Buffer.pop_back();
-    Tmp->destroy();
-    delete Tmp;
-  }
-}*/
-
-
-//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-// instantiation for base types
-//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-/*template class xPlaneRental<uint8 >;
-template class xPlaneRental< int8 >;
-template class xPlaneRental<uint16>;
-template class xPlaneRental< int16>;
-template class xPlaneRental<uint32>;
-template class xPlaneRental< int32>;
-template class xPlaneRental<uint64>;
-template class xPlaneRental< int64>;
-template class xPlaneRental< flt32>;
-template class xPlaneRental< flt64>;*/
+template class xPlane<flt32V2>;
 
 //===============================================================================================================================================================================================================
 
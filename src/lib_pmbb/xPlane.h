@@ -94,65 +94,23 @@ public:
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #ifndef PMBB_xPlane_IMPLEMENTATION
-template class xPlane<uint8 >;
-template class xPlane< int8 >;
-template class xPlane<uint16>;
-template class xPlane< int16>;
-template class xPlane<uint32>;
-template class xPlane< int32>;
-template class xPlane<uint64>;
-template class xPlane< int64>;
-template class xPlane< flt32>;
-template class xPlane< flt64>;
-template class xPlane<flt32V2>;
+extern template class xPlane<uint8 >;
+extern template class xPlane< int8 >;
+extern template class xPlane<uint16>;
+extern template class xPlane< int16>;
+extern template class xPlane<uint32>;
+extern template class xPlane< int32>;
+extern template class xPlane<uint64>;
+extern template class xPlane< int64>;
+extern template class xPlane< flt32>;
+extern template class xPlane< flt64>;
+extern template class xPlane<flt32V2>;
 #endif // !PMBB_xPlane_IMPLEMENTATION
 
 //===============================================================================================================================================================================================================
 // xPlaneRental
 //===============================================================================================================================================================================================================
-/*template <typename PelType> class xPlaneRental : public xRentalCommon
-{
-public:
-  typedef PelType T;
-  using tUnitPtrV = std::vector<xPlane<T>*>;
-
-protected:
-  //Unit creation parameters
-  int32V2    m_Size;
-  int32      m_Margin;
-  int32      m_BitDepth;
-
-public:
-  void       create         (int32V2 Size, int32 Margin, int32 BitDepth, uintSize InitSize = 0, uintSize SizeLimit = std::numeric_limits<uintSize>::max());
-  void       recreate       (int32V2 Size, int32 Margin, int32 BitDepth, uintSize InitSize = 0, uintSize SizeLimit = std::numeric_limits<uintSize>::max()) { destroy(); create(Size, Margin, BitDepth, InitSize, SizeLimit); }
-  void       destroy        () { while(!m_Buffer.empty()) { xDestroyUnit(); } }
-             
-  xPlane<T>* borrow  (                ) { return(xPlane<T>*)xBorrow(); }
-  void       giveback(xPlane<T>* Plane) { xGiveback((xPicCommon*)Plane); }
-
-  bool       isCompatible   (xPlane<T>* Plane) { assert(Plane != nullptr); return Plane->isCompatible(m_Size, m_Margin, m_BitDepth); }
-             
-protected:   
-  virtual void xCreateNewUnit () final;
-  virtual void xDestroyUnit   () final;
-};*/
-
-//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-// xPlaneRental - instantiation for base types
-//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-/*#ifndef PMBB_xPlane_IMPLEMENTATION
-extern template class xPlaneRental<uint8 >;
-extern template class xPlaneRental< int8 >;
-extern template class xPlaneRental<uint16>;
-extern template class xPlaneRental< int16>;
-extern template class xPlaneRental<uint32>;
-extern template class xPlaneRental< int32>;
-extern template class xPlaneRental<uint64>;
-extern template class xPlaneRental< int64>;
-extern template class xPlaneRental< flt32>;
-extern template class xPlaneRental< flt64>;
-#endif // !PMBB_xPlane_IMPLEMENTATION*/
+template <typename PelType> using xPlaneRental = xPicRental<xPlane<PelType>>;
 
 //===============================================================================================================================================================================================================
 
@@ -44,6 +44,8 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include <condition_variable>
 #include <chrono>
 #include <queue>
+#include <vector>
+#include <atomic>
 
 #ifdef max
 #undef max
@@ -241,6 +243,202 @@ template<class XXX> void xPriorityQueue<XXX>::DequeueWait(XXX& Data)
   //release lock - std::unique_lock destructor... 
 }
 
+//===============================================================================================================================================================================================================
+// xQueueLF - lock-free bounded MPMC ring buffer (FIFO) with xQueue compatible interface
+// Enqueue/Dequeue do not take any lock. Blocking variants spin (adaptively) before falling back to condition variable.
+// Capacity is rounded up to power of 2. setSize is allowed only when queue is not used concurrently.
+//===============================================================================================================================================================================================================
+template <class XXX> class xQueueLF
+{
+protected:
+  static constexpr int32 c_CacheLineSize = 64;
+  static constexpr int32 c_MinSpinLimit  = 16;
+  static constexpr int32 c_MaxSpinLimit  = 4096;
+
+  struct xCell
+  {
+    std::atomic<uintSize> Sequence;
+    XXX                   Data;
+  };
+
+protected:
+  std::vector<xCell> m_Cells;
+  uintSize           m_Mask;
+  uint32             m_QueueSize;
+
+  alignas(c_CacheLineSize) std::atomic<uintSize> m_EnqueuePos;
+  alignas(c_CacheLineSize) std::atomic<uintSize> m_DequeuePos;
+
+  //blocking utils
+  alignas(c_CacheLineSize) std::atomic<int32> m_NumEnqueueWaiters;
+  std::atomic<int32>      m_NumDequeueWaiters;
+  std::atomic<int32>      m_SpinLimit;
+  std::mutex              m_Mutex;
+  std::condition_variable m_EnqueueConditionVariable;
+  std::condition_variable m_DequeueConditionVariable;
+
+public:
+  xQueueLF(int32 QueueSize = 1) : m_NumEnqueueWaiters(0), m_NumDequeueWaiters(0), m_SpinLimit(std::thread::hardware_concurrency() > 1 ? c_MinSpinLimit : 0) { setSize(QueueSize); } //spinning on single core only delays the other side
+  xQueueLF(const xQueueLF&) = delete;
+  xQueueLF& operator=(const xQueueLF&) = delete;
+
+  int32    getSize  (          ) const { return m_QueueSize; }
+  void     setSize  (int32 Size);
+  bool     isEmpty  (          ) const { return getLoad() == 0; }
+  bool     isFull   (          ) const { return getLoad() >= (uintSize)m_Cells.size(); }
+  uintSize getLoad  (          ) const { uintSize E = m_EnqueuePos.load(std::memory_order_acquire); uintSize D = m_DequeuePos.load(std::memory_order_acquire); return E > D ? E - D : 0; }
+
+  bool EnqueueTry   (XXX  Data) { if(xEnqueueTry(Data)) { xNotifyEnqueue(); return true; } return false; }
+  bool DequeueTry   (XXX& Data) { if(xDequeueTry(Data)) { xNotifyDequeue(); return true; } return false; }
+
+  void EnqueueWait  (XXX  Data);
+  void DequeueWait  (XXX& Data);
+
+  template<class Rep, class Period> bool EnqueueWaitFor(XXX  Data, const std::chrono::duration<Rep, Period>& Duration);
+  template<class Rep, class Period> bool DequeueWaitFor(XXX& Data, const std::chrono::duration<Rep, Period>& Duration);
+
+protected:
+  bool xEnqueueTry(XXX  Data); //no wakeup of blocked consumers
+  bool xDequeueTry(XXX& Data); //no wakeup of blocked producers
+
+  static inline void xSpinPause() 
+  {
+#if X_SSE2
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+  }
+  template<class tTryFunc> bool xSpin(tTryFunc TryFunc);
+  void xNotifyEnqueue() { std::atomic_thread_fence(std::memory_order_seq_cst); if(m_NumDequeueWaiters.load(std::memory_order_relaxed) > 0) { std::lock_guard<std::mutex> LockManager(m_Mutex); m_DequeueConditionVariable.notify_one(); } }
+  void xNotifyDequeue() { std::atomic_thread_fence(std::memory_order_seq_cst); if(m_NumEnqueueWaiters.load(std::memory_order_relaxed) > 0) { std::lock_guard<std::mutex> LockManager(m_Mutex); m_EnqueueConditionVariable.notify_one(); } }
+};
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+template<class XXX> void xQueueLF<XXX>::setSize(int32 Size)
+{
+  assert(Size>0);
+  assert(isEmpty() && m_NumEnqueueWaiters == 0 && m_NumDequeueWaiters == 0);
+  uintSize Capacity = 1;
+  while(Capacity < (uintSize)Size) { Capacity <<= 1; }
+  m_Cells = std::vector<xCell>(Capacity);
+  for(uintSize i = 0; i < Capacity; i++) { m_Cells[i].Sequence.store(i, std::memory_order_relaxed); }
+  m_Mask      = Capacity - 1;
+  m_QueueSize = Size;
+  m_EnqueuePos.store(0, std::memory_order_relaxed);
+  m_DequeuePos.store(0, std::memory_order_relaxed);
+}
+template<class XXX> bool xQueueLF<XXX>::xEnqueueTry(XXX Data)
+{
+  uintSize Pos = m_EnqueuePos.load(std::memory_order_relaxed);
+  while(1)
+  {
+    xCell&   Cell = m_Cells[Pos & m_Mask];
+    uintSize Seq  = Cell.Sequence.load(std::memory_order_acquire);
+    intptr_t Diff = (intptr_t)Seq - (intptr_t)Pos;
+    if(Diff == 0)
+    {
+      if(m_EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+      {
+        Cell.Data = Data;
+        Cell.Sequence.store(Pos + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if(Diff < 0) { return false; } //full
+    else { Pos = m_EnqueuePos.load(std::memory_order_relaxed); }
+  }
+}
+template<class XXX> bool xQueueLF<XXX>::xDequeueTry(XXX& Data)
+{
+  uintSize Pos = m_DequeuePos.load(std::memory_order_relaxed);
+  while(1)
+  {
+    xCell&   Cell = m_Cells[Pos & m_Mask];
+    uintSize Seq  = Cell.Sequence.load(std::memory_order_acquire);
+    intptr_t Diff = (intptr_t)Seq - (intptr_t)(Pos + 1);
+    if(Diff == 0)
+    {
+      if(m_DequeuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+      {
+        Data = Cell.Data;
+        Cell.Sequence.store(Pos + m_Mask + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if(Diff < 0) { return false; } //empty
+    else { Pos = m_DequeuePos.load(std::memory_order_relaxed); }
+  }
+}
+template<class XXX> template<class tTryFunc> bool xQueueLF<XXX>::xSpin(tTryFunc TryFunc)
+{
+  //adaptive spinning - spin limit grows when spinning pays off and shrinks when it does not
+  const int32 SpinLimit = m_SpinLimit.load(std::memory_order_relaxed);
+  if(SpinLimit == 0) { return false; }
+  for(int32 i = 0; i < SpinLimit; i++)
+  {
+    if(TryFunc())
+    {
+      if(SpinLimit < c_MaxSpinLimit) { m_SpinLimit.store(xMin(SpinLimit << 1, c_MaxSpinLimit), std::memory_order_relaxed); }
+      return true;
+    }
+    xSpinPause();
+  }
+  if(SpinLimit > c_MinSpinLimit) { m_SpinLimit.store(xMax(SpinLimit >> 1, c_MinSpinLimit), std::memory_order_relaxed); }
+  return false;
+}
+template<class XXX> void xQueueLF<XXX>::EnqueueWait(XXX Data)
+{
+  if(EnqueueTry(Data)) { return; }
+  if(xSpin([&]{ return EnqueueTry(Data); })) { return; }
+  std::unique_lock<std::mutex> LockManager(m_Mutex);
+  m_NumEnqueueWaiters.fetch_add(1, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  m_EnqueueConditionVariable.wait(LockManager, [&]{ return xEnqueueTry(Data); });
+  m_NumEnqueueWaiters.fetch_sub(1, std::memory_order_relaxed);
+  LockManager.unlock();
+  xNotifyEnqueue();
+}
+template<class XXX> void xQueueLF<XXX>::DequeueWait(XXX& Data)
+{
+  if(DequeueTry(Data)) { return; }
+  if(xSpin([&]{ return DequeueTry(Data); })) { return; }
+  std::unique_lock<std::mutex> LockManager(m_Mutex);
+  m_NumDequeueWaiters.fetch_add(1, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  m_DequeueConditionVariable.wait(LockManager, [&]{ return xDequeueTry(Data); });
+  m_NumDequeueWaiters.fetch_sub(1, std::memory_order_relaxed);
+  LockManager.unlock();
+  xNotifyDequeue();
+}
+template<class XXX> template<class Rep, class Period> bool xQueueLF<XXX>::EnqueueWaitFor(XXX Data, const std::chrono::duration<Rep, Period>& Duration)
+{
+  if(Duration == std::chrono::duration<Rep, Period>::max()) { EnqueueWait(Data); return true; }
+  if(EnqueueTry(Data)) { return true; }
+  std::unique_lock<std::mutex> LockManager(m_Mutex);
+  m_NumEnqueueWaiters.fetch_add(1, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  bool Result = m_EnqueueConditionVariable.wait_for(LockManager, Duration, [&]{ return xEnqueueTry(Data); });
+  m_NumEnqueueWaiters.fetch_sub(1, std::memory_order_relaxed);
+  LockManager.unlock();
+  if(Result) { xNotifyEnqueue(); }
+  return Result;
+}
+template<class XXX> template<class Rep, class Period> bool xQueueLF<XXX>::DequeueWaitFor(XXX& Data, const std::chrono::duration<Rep, Period>& Duration)
+{
+  if(Duration == std::chrono::duration<Rep, Period>::max()) { DequeueWait(Data); return true; }
+  if(DequeueTry(Data)) { return true; }
+  std::unique_lock<std::mutex> LockManager(m_Mutex);
+  m_NumDequeueWaiters.fetch_add(1, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  bool Result = m_DequeueConditionVariable.wait_for(LockManager, Duration, [&]{ return xDequeueTry(Data); });
+  m_NumDequeueWaiters.fetch_sub(1, std::memory_order_relaxed);
+  LockManager.unlock();
+  if(Result) { xNotifyDequeue(); }
+  return Result;
+}
+
 //===============================================================================================================================================================================================================
 
 } //end of namespace PMBB
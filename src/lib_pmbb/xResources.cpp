@@ -0,0 +1,217 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+#include "xResources.h"
+#include "xTopology.h"
+#include "xString.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if X_SYSTEM_WINDOWS
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif X_SYSTEM_LINUX
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+namespace {
+
+#if X_SYSTEM_LINUX
+int64 xReadInt64(const std::string& FilePath) //returns NOT_VALID when file does not exist or value is not a number ("max" in cgroup v2)
+{
+  std::string Line = xTopology::readFirstLine(FilePath);
+  if(Line.empty() || !xString::xIsNumeric(Line[0])) { return NOT_VALID; }
+  try { return std::stoll(Line); } catch(...) { return NOT_VALID; }
+}
+std::string xFirstExisting(const std::string& Path0, const std::string& Path1, const std::string& FileName)
+{
+  std::ifstream File(Path0 + FileName);
+  return File.is_open() ? Path0 + FileName : Path1 + FileName;
+}
+#endif
+
+} //end of anonymous namespace
+
+//===============================================================================================================================================================================================================
+
+void xResources::detect()
+{
+  m_HardwareConcurrency = xMax((int32)std::thread::hardware_concurrency(), 1);
+
+#if X_SYSTEM_LINUX
+  cpu_set_t CpuSet;
+  CPU_ZERO(&CpuSet);
+  if(sched_getaffinity(0, sizeof(cpu_set_t), &CpuSet) == 0) { m_AffinityCpus = CPU_COUNT(&CpuSet); }
+
+  const int64 NumPages = sysconf(_SC_PHYS_PAGES);
+  const int64 PageSize = sysconf(_SC_PAGE_SIZE );
+  if(NumPages > 0 && PageSize > 0) { m_PhysicalMemory = NumPages * PageSize; }
+
+  //find own cgroups - "hierarchy-ID:controller-list:cgroup-path"
+  std::string V2Path, CpuPath, CpusetPath, MemoryPath;
+  bool        HasV1 = false, HasV2 = false;
+  std::ifstream CGroupFile("/proc/self/cgroup");
+  std::string   Line;
+  while(CGroupFile.is_open() && std::getline(CGroupFile, Line))
+  {
+    std::size_t Colon0 = Line.find(':');
+    std::size_t Colon1 = Colon0 != std::string::npos ? Line.find(':', Colon0 + 1) : std::string::npos;
+    if(Colon1 == std::string::npos) { continue; }
+    const std::string Controllers = Line.substr(Colon0 + 1, Colon1 - Colon0 - 1);
+    const std::string Path        = Line.substr(Colon1 + 1);
+    if(Line.compare(0, Colon0, "0") == 0 && Controllers.empty()) { V2Path = Path; HasV2 = true; continue; }
+    std::istringstream ControllerStream(Controllers);
+    std::string        Controller;
+    while(std::getline(ControllerStream, Controller, ','))
+    {
+      if     (Controller == "cpu"   ) { CpuPath    = Path; HasV1 = true; }
+      else if(Controller == "cpuset") { CpusetPath = Path; HasV1 = true; }
+      else if(Controller == "memory") { MemoryPath = Path; HasV1 = true; }
+    }
+  }
+
+  //hybrid hierarchy may report "0::/" next to v1 controllers - v2 limits are used only when v2 controllers are really mounted
+  if(HasV2 && std::ifstream("/sys/fs/cgroup/cgroup.controllers").is_open()) { xDetectCGroupV2(V2Path);                         }
+  else if(HasV1                                                           ) { xDetectCGroupV1(CpuPath, CpusetPath, MemoryPath); }
+#elif X_SYSTEM_WINDOWS
+  DWORD_PTR ProcessMask = 0, SystemMask = 0;
+  if(GetProcessAffinityMask(GetCurrentProcess(), &ProcessMask, &SystemMask))
+  {
+    int32 NumCpus = 0;
+    for(DWORD_PTR Mask = ProcessMask; Mask; Mask >>= 1) { NumCpus += (int32)(Mask & 1); }
+    m_AffinityCpus = NumCpus;
+  }
+  MEMORYSTATUSEX MemoryStatus;
+  MemoryStatus.dwLength = sizeof(MemoryStatus);
+  if(GlobalMemoryStatusEx(&MemoryStatus)) { m_PhysicalMemory = (int64)MemoryStatus.ullTotalPhys; }
+#endif
+}
+int32 xResources::getAvailableCpus() const
+{
+  int32 AvailableCpus = m_HardwareConcurrency > 0 ? m_HardwareConcurrency : 1;
+  if(m_AffinityCpus > 0) { AvailableCpus = xMin(AvailableCpus, m_AffinityCpus); }
+  if(m_CpusetCpus   > 0) { AvailableCpus = xMin(AvailableCpus, m_CpusetCpus  ); }
+  if(m_CpuQuota     > 0) { AvailableCpus = xMin(AvailableCpus, (int32)std::ceil(m_CpuQuota)); }
+  return xMax(AvailableCpus, 1);
+}
+int32 xResources::calcMaxBufferingDepth(int64 BytesPerFrame, int64 BytesFixed, int32 MaxDepth, flt64 MemoryFraction) const
+{
+  assert(BytesPerFrame > 0 && MaxDepth > 0);
+  const int64 AvailableMemory = getAvailableMemory();
+  if(AvailableMemory == c_Unlimited) { return MaxDepth; }
+  const int64 Budget = (int64)((flt64)AvailableMemory * MemoryFraction) - BytesFixed;
+  const int64 Depth  = Budget > 0 ? Budget / BytesPerFrame : 0;
+  return (int32)xClip<int64>(Depth, 1, MaxDepth);
+}
+int64 xResources::getPeakResidentMemory()
+{
+#if X_SYSTEM_WINDOWS
+  PROCESS_MEMORY_COUNTERS Counters;
+  if(!GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters))) { return NOT_VALID; }
+  return (int64)Counters.PeakWorkingSetSize;
+#elif X_SYSTEM_LINUX
+  struct rusage Usage;
+  if(getrusage(RUSAGE_SELF, &Usage) != 0) { return NOT_VALID; }
+  return (int64)Usage.ru_maxrss * 1024; //ru_maxrss is in kilobytes
+#else
+  return NOT_VALID;
+#endif
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void xResources::xDetectCGroupV2(const std::string& CGroupPath)
+{
+#if X_SYSTEM_LINUX
+  m_CGroupVersion = 2;
+  //inside cgroup namespace own cgroup is mounted at root, otherwise at relative path
+  const std::string Own  = "/sys/fs/cgroup" + (CGroupPath == "/" ? std::string("") : CGroupPath) + "/";
+  const std::string Root = "/sys/fs/cgroup/";
+
+  //cpu.max - "$MAX $PERIOD" or "max $PERIOD"
+  std::istringstream CpuMax(xTopology::readFirstLine(xFirstExisting(Own, Root, "cpu.max")));
+  std::string Quota, Period;
+  if(CpuMax >> Quota >> Period && Quota != "max")
+  {
+    try { m_CpuQuota = std::stod(Quota) / std::stod(Period); } catch(...) { m_CpuQuota = -1; }
+  }
+
+  std::vector<int32> Cpuset = xTopology::parseCpuList(xTopology::readFirstLine(xFirstExisting(Own, Root, "cpuset.cpus.effective")));
+  if(!Cpuset.empty()) { m_CpusetCpus = (int32)Cpuset.size(); }
+
+  const int64 MemoryMax = xReadInt64(xFirstExisting(Own, Root, "memory.max"));
+  if(MemoryMax > 0) { m_CGroupMemoryLimit = MemoryMax; }
+#else
+  (void)CGroupPath;
+#endif
+}
+void xResources::xDetectCGroupV1(const std::string& CpuPath, const std::string& CpusetPath, const std::string& MemoryPath)
+{
+#if X_SYSTEM_LINUX
+  m_CGroupVersion = 1;
+  auto Own = [](const std::string& Controller, const std::string& Path) { return "/sys/fs/cgroup/" + Controller + (Path == "/" ? std::string("") : Path) + "/"; };
+
+  const std::string CpuFile = std::ifstream("/sys/fs/cgroup/cpu/cpu.cfs_quota_us").is_open() ? "cpu" : "cpu,cpuacct";
+  const int64 QuotaUs  = xReadInt64(xFirstExisting(Own(CpuFile, CpuPath), "/sys/fs/cgroup/" + CpuFile + "/", "cpu.cfs_quota_us" ));
+  const int64 PeriodUs = xReadInt64(xFirstExisting(Own(CpuFile, CpuPath), "/sys/fs/cgroup/" + CpuFile + "/", "cpu.cfs_period_us"));
+  if(QuotaUs > 0 && PeriodUs > 0) { m_CpuQuota = (flt64)QuotaUs / (flt64)PeriodUs; }
+
+  std::string CpusetList = xTopology::readFirstLine(xFirstExisting(Own("cpuset", CpusetPath), "/sys/fs/cgroup/cpuset/", "cpuset.effective_cpus"));
+  if(CpusetList.empty()) { CpusetList = xTopology::readFirstLine(xFirstExisting(Own("cpuset", CpusetPath), "/sys/fs/cgroup/cpuset/", "cpuset.cpus")); }
+  std::vector<int32> Cpuset = xTopology::parseCpuList(CpusetList);
+  if(!Cpuset.empty()) { m_CpusetCpus = (int32)Cpuset.size(); }
+
+  //unlimited v1 memory cgroup reports huge value (i.e. 0x7FFFFFFFFFFFF000)
+  const int64 MemoryLimit = xReadInt64(xFirstExisting(Own("memory", MemoryPath), "/sys/fs/cgroup/memory/", "memory.limit_in_bytes"));
+  if(MemoryLimit > 0 && MemoryLimit < ((int64)1 << 60)) { m_CGroupMemoryLimit = MemoryLimit; }
+#else
+  (void)CpuPath; (void)CpusetPath; (void)MemoryPath;
+#endif
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
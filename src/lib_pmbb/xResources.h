@@ -0,0 +1,90 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include <string>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xResources - detection of CPU and memory resources available to process (hardware, affinity mask, cgroup v1/v2 limits)
+//===============================================================================================================================================================================================================
+class xResources
+{
+public:
+  static constexpr int64 c_Unlimited = int64_max;
+
+protected:
+  int32 m_HardwareConcurrency = NOT_VALID; //std::thread::hardware_concurrency
+  int32 m_AffinityCpus        = NOT_VALID; //number of cpus in process affinity mask
+  int32 m_CpusetCpus          = NOT_VALID; //number of cpus in cgroup cpuset
+  flt64 m_CpuQuota            = -1;        //cgroup cpu quota in number of cpus (quota/period), negative if unlimited
+  int64 m_PhysicalMemory      = c_Unlimited;
+  int64 m_CGroupMemoryLimit   = c_Unlimited;
+  int32 m_CGroupVersion       = 0;         //0 = cgroups not detected
+
+public:
+  void  detect();
+
+  int32 getHardwareConcurrency() const { return m_HardwareConcurrency; }
+  int32 getAffinityCpus       () const { return m_AffinityCpus       ; }
+  int32 getCpusetCpus         () const { return m_CpusetCpus         ; }
+  flt64 getCpuQuota           () const { return m_CpuQuota           ; }
+  int64 getPhysicalMemory     () const { return m_PhysicalMemory     ; }
+  int64 getCGroupMemoryLimit  () const { return m_CGroupMemoryLimit  ; }
+  int32 getCGroupVersion      () const { return m_CGroupVersion      ; }
+
+  int32 getAvailableCpus      () const; //min of all cpu limits (quota rounded up), at least 1
+  int64 getAvailableMemory    () const { return xMin(m_PhysicalMemory, m_CGroupMemoryLimit); }
+
+  //number of frames (sets of pictures) which can be buffered ahead in pipeline without exceeding MemoryFraction of available memory
+  int32 calcMaxBufferingDepth (int64 BytesPerFrame, int64 BytesFixed, int32 MaxDepth, flt64 MemoryFraction = 0.5) const;
+
+  //peak resident set size of the whole process (in bytes), NOT_VALID if unavailable
+  static int64 getPeakResidentMemory();
+
+protected:
+  void  xDetectCGroupV2(const std::string& CGroupPath);
+  void  xDetectCGroupV1(const std::string& CpuPath, const std::string& CpusetPath, const std::string& MemoryPath);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -40,42 +40,59 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include "xSeq.h"
 #include "xPixelOps.h"
 #include "xFile.h"
+#include "xStageTimer.h"
+#include "xTrace.h"
 #include <cassert>
 #include <cstring>
+#include <algorithm>
+#include <cctype>
+#include <type_traits>
 
 namespace PMBB_NAMESPACE {
 
 //===============================================================================================================================================================================================================
 
-void xSeq::create(int32V2 Size, int32 BitDepth, int32 ChromaFormat)
+static const xStageTimer::tStageId xc_StageSeqRead   = xStageTimer::registerStage("xSeq::Read"  );
+static const xStageTimer::tStageId xc_StageSeqUnpack = xStageTimer::registerStage("xSeq::Unpack");
+static const xStageTimer::tStageId xc_StageSeqRdAhd  = xStageTimer::registerStage("xSeq::ReadAhead");
+static const xStageTimer::tStageId xc_StageSeqFused  = xStageTimer::registerStage("xSeq::UnpackFused");
+
+//===============================================================================================================================================================================================================
+
+void xSeq::create(int32V2 Size, int32 BitDepth, int32 ChromaFormat, eLayout Layout)
 {
+  assert(Layout != eLayout::SemiPlanar || ChromaFormat == 420);
+  assert(Layout != eLayout::V210       || (ChromaFormat == 422 && BitDepth == 10));
+
   m_Width  = Size.getX();
   m_Height = Size.getY();
 
   m_BitsPerSample  = BitDepth;
   m_BytesPerSample = m_BitsPerSample <= 8 ? 1 : 2;
   m_ChromaFormat   = ChromaFormat;
+  m_Layout         = Layout;
 
   m_FileCmpNumPels  = m_Width * m_Height;
   m_FileCmpNumBytes = m_Width * m_Height * m_BytesPerSample;
+  m_FileImgNumBytes = calcFrameNumBytes(Size, BitDepth, ChromaFormat, Layout);
 
-  switch(m_ChromaFormat)
-  {
-    case 444: m_FileImgNumBytes = 3 * m_FileCmpNumBytes; break;
-    case 422: m_FileImgNumBytes = m_FileCmpNumBytes << 1; break;
-    case 420: m_FileImgNumBytes = m_FileCmpNumBytes + (m_FileCmpNumBytes >> 1); break;
-    case 400: m_FileImgNumBytes = m_FileCmpNumBytes; break;
-    default: assert(0);
-  }
-
-  m_FileBuffer = (uint8*)xAlignedMalloc(m_FileImgNumBytes, xc_AlignmentPel);
+  m_FileBuffer = xAllocFrameBuffer();
 }
 void xSeq::destroy()
 {
+  stopReadAhead();
   m_FileName.clear();
   m_FileMode = eMode::Unknown;
+  m_ReadMode = eRead::Stdio;
   m_FileSize = NOT_VALID;
+  m_Streaming   = false;
+  m_EndOfStream = false;
+  m_Format      = eFormat::Raw;
+  m_Layout      = eLayout::Planar;
+  m_Y4M         = xY4MInfo();
+  m_StreamPrefix.clear();
   m_File.close();
+  m_FileMap.close();
 
   m_Width  = NOT_VALID;
   m_Height = NOT_VALID;
@@ -87,12 +104,64 @@ void xSeq::destroy()
   m_FileCmpNumPels  = NOT_VALID;
   m_FileCmpNumBytes = NOT_VALID;
 
-  if(m_FileBuffer) { xAlignedFree(m_FileBuffer); m_FileBuffer = nullptr; }
+  if(m_FileBuffer  ) { xFreeFrameBuffer(m_FileBuffer); m_FileBuffer = nullptr; }
+  if(m_StripeBuffer) { xAlignedFree(m_StripeBuffer); m_StripeBuffer = nullptr; }
+  m_StripeStride = NOT_VALID;
 }
-xSeq::tResult xSeq::openFile(const std::string& FileName, eMode FileMode)
+xSeq::tResult xSeq::openFile(const std::string& FileName, eMode FileMode, eRead ReadMode)
 {
   m_FileName   = FileName;
   m_FileMode   = FileMode;
+  m_ReadMode   = eRead::Stdio;
+  m_Streaming   = false;
+  m_EndOfStream = false;
+  m_Format      = eFormat::Raw;
+  m_Y4M         = xY4MInfo();
+  m_StreamPrefix.clear();
+
+  //stream - not seekable and not mappable, frames are read sequentially until EOF
+  if(FileMode == eMode::Read && xFile::isStream(m_FileName))
+  {
+    if(m_FileName == xFile::c_StdStreamName) { m_File.openStdin(); }
+    else                                     { m_File.open(m_FileName, "rb"); } //FIFO - blocks until writer opens it
+    if(!m_File.valid()) { return eRetv::Error; }
+    m_Streaming    = true;
+    m_FileSize     = NOT_VALID;
+    m_NumOfFrames  = NOT_VALID;
+    m_CurrFrameIdx = 0;
+    return xOpenY4MStream();
+  }
+
+  //container - Y4M header of existing file is parsed once, frames are addressed as fixed length records (FRAME header + samples)
+  if(FileMode == eMode::Read || (FileMode == eMode::Append && isY4MFileName(m_FileName) && xFile::filesize(m_FileName) > 0))
+  {
+    xY4MInfo Info;
+    if(probeFormat(m_FileName, Info) == eFormat::Y4M)
+    {
+      if(!Info.isValid()) { return eRetv::Error; }
+      m_Format = eFormat::Y4M;
+      m_Y4M    = Info;
+      eRetv CheckResult = xCheckY4MParams();
+      if(CheckResult != eRetv::Success) { return CheckResult; }
+      if(FileMode == eMode::Append && m_Y4M.FrameHdrLength != (int32)c_Y4MFrameTag.size() + 1) { return eRetv::WrongArg; } //written frames would have different record length
+    }
+  }
+  else if(isY4MFileName(m_FileName))
+  {
+    m_Format = eFormat::Y4M;
+    m_Y4M    = { { m_Width, m_Height }, m_BitsPerSample, m_ChromaFormat, (int32)formatY4MHeader({ m_Width, m_Height }, m_BitsPerSample, m_ChromaFormat).size(), (int32)c_Y4MFrameTag.size() + 1, 0 };
+  }
+
+  if(FileMode == eMode::Read && ReadMode == eRead::MemMap && m_FileMap.open(m_FileName))
+  {
+    m_ReadMode     = eRead::MemMap;
+    m_FileSize     = m_FileMap.getSize();
+    m_NumOfFrames  = xCalcNumFrames(m_FileSize);
+    m_CurrFrameIdx = 0;
+    m_FileMap.advise(0, m_FileSize, xFileMap::eAdvice::Sequential);
+    return eRetv::Success;
+  }
+
   switch(FileMode)
   {
     case eMode::Read  : m_File.open(m_FileName, "rb"); break;
@@ -101,11 +170,18 @@ xSeq::tResult xSeq::openFile(const std::string& FileName, eMode FileMode)
     default: return eRetv::WrongArg;
   }
 
+  //new Y4M file starts with stream header
+  if(m_File.valid() && m_Format == eFormat::Y4M && FileMode != eMode::Read && m_File.size() == 0)
+  {
+    m_File.write(formatY4MHeader({ m_Width, m_Height }, m_BitsPerSample, m_ChromaFormat));
+  }
+
   if(m_File.valid())
   {
     m_FileSize     = m_File.size();
-    m_NumOfFrames  = calcNumFramesInFile({ m_Width, m_Height }, m_BitsPerSample, m_ChromaFormat, m_FileSize);
+    m_NumOfFrames  = xCalcNumFrames(m_FileSize);
     m_CurrFrameIdx = 0;
+    if(m_Format == eFormat::Y4M && FileMode == eMode::Read) { m_File.seek(m_Y4M.HeaderLength, xFile::seek_mode::beg); }
   }
   else
   {
@@ -119,10 +195,18 @@ xSeq::tResult xSeq::openFile(const std::string& FileName, eMode FileMode)
 }
 xSeq::tResult xSeq::closeFile()
 {
+  stopReadAhead();
   m_File.close();
+  m_FileMap.close();
   m_FileName.clear();
   m_FileMode = eMode::Unknown;
+  m_ReadMode = eRead::Stdio;
   m_FileSize = NOT_VALID;
+  m_Streaming   = false;
+  m_EndOfStream = false;
+  m_Format      = eFormat::Raw;
+  m_Y4M         = xY4MInfo();
+  m_StreamPrefix.clear();
 
   m_NumOfFrames  = NOT_VALID;
   m_CurrFrameIdx = NOT_VALID;
@@ -130,31 +214,124 @@ xSeq::tResult xSeq::closeFile()
 }
 xSeq::tResult xSeq::seekFrame(int32 FrameNumber)
 {
-  if(m_FileMode == eMode::Read && FrameNumber >= m_NumOfFrames) { return eRetv::WrongArg; }
+  if(m_FileMode == eMode::Read && m_NumOfFrames != NOT_VALID && FrameNumber >= m_NumOfFrames) { return eRetv::WrongArg; }
   if(m_FileMode != eMode::Read) { return eRetv::Error; }
 
-  //seek frame
-  uintSize Offset = (uintSize)m_FileImgNumBytes * (uintSize)FrameNumber;
-  bool SeekResult = m_File.seek(Offset, xFile::seek_mode::beg);
-  if(!SeekResult) { return eRetv::Error; }
+  //stream cannot be rewound - preceding frames are read and dropped (read-ahead keeps running)
+  if(m_Streaming)
+  {
+    if(FrameNumber < m_CurrFrameIdx) { return eRetv::WrongArg; }
+    while(m_CurrFrameIdx < FrameNumber)
+    {
+      const uint8* FileData = xReadFrameData();
+      if(FileData == nullptr) { return xReadFailure(); }
+      xReleaseFrameData();
+      m_CurrFrameIdx += 1;
+    }
+    return eRetv::Success;
+  }
+
+  //frames already loaded by I/O thread are discarded
+  const int32 ReadAheadDepth = m_ReadAheadDepth;
+  stopReadAhead();
+
+  //seek frame (mapped file is addressed by m_CurrFrameIdx)
+  if(m_ReadMode == eRead::Stdio)
+  {
+    bool SeekResult = m_File.seek(xGetRecordOffset(FrameNumber), xFile::seek_mode::beg);
+    if(!SeekResult) { return eRetv::Error; }
+  }
 
   //update state
-  m_CurrFrameIdx += FrameNumber;
+  m_CurrFrameIdx = FrameNumber;
 
+  if(ReadAheadDepth > 0) { return startReadAhead(ReadAheadDepth); }
   return eRetv::Success;
 }
 xSeq::tResult xSeq::readFrame(xPicP* Pic)
 {
-  if(m_FileMode == eMode::Read && m_CurrFrameIdx >= m_NumOfFrames) { return eRetv::EndOfFile; }
+  if(xIsPastLastFrame()) { return eRetv::EndOfFile; }
   if(m_FileMode != eMode::Read) { return eRetv::Error; }
 
   //read frame
-  uintSize Read = m_File.read(m_FileBuffer, m_FileImgNumBytes);
-  if(Read != (uintSize)m_FileImgNumBytes) { return eRetv::Error; }
+  const uint8* FileData = nullptr;
+  {
+    xStageTimer::xScope Scope(xc_StageSeqRead, (int64)m_Width * m_Height);
+    FileData = xReadFrameData();
+    if(FileData == nullptr) { return xReadFailure(); }
+  }
 
   //unpack frame
-  bool Unpacked = xUnpackFrame(Pic);
-  if(!Unpacked) { return eRetv::Error; }
+  {
+    xStageTimer::xScope Scope(xc_StageSeqUnpack, (int64)m_Width * m_Height);
+    bool Unpacked = xUnpackFrame(Pic, FileData);
+    xReleaseFrameData();
+    if(!Unpacked) { return eRetv::Error; }
+  }
+
+  //update state
+  m_CurrFrameIdx += 1;
+
+  return eRetv::Success;
+}
+xSeq::tResult xSeq::unpackFrame(xPicP* Pic, const uint8* FileData)
+{
+  if(xIsPastLastFrame()) { return eRetv::EndOfFile; }
+  if(m_FileMode != eMode::Read || FileData == nullptr) { return eRetv::Error; }
+
+  //unpack frame
+  {
+    xStageTimer::xScope Scope(xc_StageSeqUnpack, (int64)m_Width * m_Height);
+    bool Unpacked = xUnpackFrame(Pic, FileData);
+    if(!Unpacked) { return eRetv::Error; }
+  }
+
+  //update state
+  m_CurrFrameIdx += 1;
+
+  return eRetv::Success;
+}
+xSeq::tResult xSeq::readFrame  (xPicP* Pic, xPicI*  PicI,                        boolV4& Correct) { return xReadFrameI  (Pic, PicI,           Correct); }
+xSeq::tResult xSeq::unpackFrame(xPicP* Pic, xPicI*  PicI, const uint8* FileData, boolV4& Correct) { return xUnpackFrameI(Pic, PicI, FileData, Correct); }
+xSeq::tResult xSeq::readFrame  (xPicP* Pic, xPicI8* PicI,                        boolV4& Correct) { return xReadFrameI  (Pic, PicI,           Correct); }
+xSeq::tResult xSeq::unpackFrame(xPicP* Pic, xPicI8* PicI, const uint8* FileData, boolV4& Correct) { return xUnpackFrameI(Pic, PicI, FileData, Correct); }
+template <class tPicI> xSeq::tResult xSeq::xReadFrameI(xPicP* Pic, tPicI* PicI, boolV4& Correct)
+{
+  if(xIsPastLastFrame()) { return eRetv::EndOfFile; }
+  if(m_FileMode != eMode::Read) { return eRetv::Error; }
+
+  //read frame
+  const uint8* FileData = nullptr;
+  {
+    xStageTimer::xScope Scope(xc_StageSeqRead, (int64)m_Width * m_Height);
+    FileData = xReadFrameData();
+    if(FileData == nullptr) { return xReadFailure(); }
+  }
+
+  //unpack, check, extend and interleave frame
+  {
+    xStageTimer::xScope Scope(xc_StageSeqFused, (int64)m_Width * m_Height);
+    bool Unpacked = xUnpackFrameFused(Pic, PicI, FileData, Correct);
+    xReleaseFrameData();
+    if(!Unpacked) { return eRetv::Error; }
+  }
+
+  //update state
+  m_CurrFrameIdx += 1;
+
+  return eRetv::Success;
+}
+template <class tPicI> xSeq::tResult xSeq::xUnpackFrameI(xPicP* Pic, tPicI* PicI, const uint8* FileData, boolV4& Correct)
+{
+  if(xIsPastLastFrame()) { return eRetv::EndOfFile; }
+  if(m_FileMode != eMode::Read || FileData == nullptr) { return eRetv::Error; }
+
+  //unpack, check, extend and interleave frame
+  {
+    xStageTimer::xScope Scope(xc_StageSeqFused, (int64)m_Width * m_Height);
+    bool Unpacked = xUnpackFrameFused(Pic, PicI, FileData, Correct);
+    if(!Unpacked) { return eRetv::Error; }
+  }
 
   //update state
   m_CurrFrameIdx += 1;
@@ -168,13 +345,8 @@ xSeq::tResult xSeq::writeFrame(const xPicP* Pic)
   if(!Packed) { return eRetv::Error; }
 
   //write frame
-  uintSize Written = m_File.write(m_FileBuffer, m_FileImgNumBytes);
-  if(Written != (uintSize)m_FileImgNumBytes) { return eRetv::Error; }
-  m_File.flush();
-
-  //update state
-  m_FileSize     += m_FileImgNumBytes;
-  m_NumOfFrames  += 1;
+  bool Written = xWriteFrameData();
+  if(!Written) { return eRetv::Error; }
   m_CurrFrameIdx += 1;
 
   return eRetv::Success;
@@ -182,15 +354,16 @@ xSeq::tResult xSeq::writeFrame(const xPicP* Pic)
 #if HAS_XPLANE
 xSeq::tResult xSeq::readFrame(xPlane<uint16>* Plane)
 {
-  if(m_FileMode == eMode::Read && m_CurrFrameIdx >= m_NumOfFrames) { return eRetv::EndOfFile; }
+  if(xIsPastLastFrame()) { return eRetv::EndOfFile; }
   if(m_FileMode != eMode::Read) { return eRetv::Error; }
 
   //read frame
-  uintSize Read = m_File.read(m_FileBuffer, m_FileImgNumBytes);
-  if(Read != (uintSize)m_FileImgNumBytes) { return eRetv::Error; }
+  const uint8* FileData = xReadFrameData();
+  if(FileData == nullptr) { return xReadFailure(); }
 
   //unpack frame
-  bool Unpacked = xUnpackFrame(Plane);
+  bool Unpacked = xUnpackFrame(Plane, FileData);
+  xReleaseFrameData();
   if(!Unpacked) { return eRetv::Error; }
 
   //update state
@@ -205,13 +378,8 @@ xSeq::tResult xSeq::writeFrame(const xPlane<uint16>* Plane)
   if(!Packed) { return eRetv::Error; }
 
   //write frame
-  uintSize Written = m_File.write(m_FileBuffer, m_FileImgNumBytes);
-  if(Written != (uintSize)m_FileImgNumBytes) { return eRetv::Error; }
-  m_File.flush();
-
-  //update state
-  m_FileSize     += m_FileImgNumBytes;
-  m_NumOfFrames  += 1;
+  bool Written = xWriteFrameData();
+  if(!Written) { return eRetv::Error; }
   m_CurrFrameIdx += 1;
 
   return eRetv::Success;
@@ -220,21 +388,176 @@ xSeq::tResult xSeq::writeFrame(const xPlane<uint16>* Plane)
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-bool xSeq::xUnpackFrame(xPicP* Pic)
+const uint8* xSeq::xReadFrameData()
+{
+  if(!isReadAhead()) { return xLoadFrameData(m_CurrFrameIdx, m_FileBuffer, m_EndOfStream); }
+
+  xReadAheadSlot* Slot = nullptr;
+  if(m_LoadedSlots.DequeueTry(Slot)) { m_ReadAheadStats.NumHits++; }
+  else
+  {
+    tTimePoint WaitBeg = tClock::now();
+    m_LoadedSlots.DequeueWait(Slot);
+    m_ReadAheadStats.NumMisses++;
+    m_ReadAheadStats.WaitTime += std::chrono::duration_cast<tDurationS>(tClock::now() - WaitBeg).count();
+  }
+  assert(Slot != nullptr && Slot->FrameIdx == m_CurrFrameIdx);
+  m_CurrSlot    = Slot;
+  m_EndOfStream = Slot->EndOfStream;
+  if(Slot->Data == nullptr) { xReleaseFrameData(); return nullptr; }
+  return Slot->Data;
+}
+void xSeq::xReleaseFrameData()
+{
+  //unpacked frame is dropped from process mapping (not from page cache) - resident memory does not grow with file size
+  if(m_ReadMode == eRead::MemMap) { m_FileMap.advise(xGetRecordOffset(m_CurrFrameIdx), xGetFrameHdrLength() + m_FileImgNumBytes, xFileMap::eAdvice::DontNeed); }
+  //buffer goes back to I/O thread
+  if(m_CurrSlot != nullptr) { m_FreeSlots.EnqueueWait(m_CurrSlot); m_CurrSlot = nullptr; }
+}
+const uint8* xSeq::xLoadFrameData(int32 FrameIdx, uint8* Buffer, bool& EndOfStream)
+{
+  EndOfStream = false;
+  //record = Y4M FRAME header (if any) + frame samples
+  const int32 HdrLength   = xGetFrameHdrLength();
+  const int32 RecNumBytes = HdrLength + m_FileImgNumBytes;
+
+  if(m_ReadMode == eRead::MemMap)
+  {
+    const int64 Offset = xGetRecordOffset(FrameIdx);
+    if(Offset + RecNumBytes > m_FileSize) { return nullptr; }
+    if(isReadAhead()) { m_FileMap.prefault(Offset, RecNumBytes); } //I/O thread takes page faults, unpack finds frame resident
+    else              { m_FileMap.advise(Offset + RecNumBytes, RecNumBytes, xFileMap::eAdvice::WillNeed); } //next frame is fetched while current one is unpacked
+    if(HdrLength && !xCheckFrameHeader(m_FileMap.getData() + Offset, FrameIdx)) { return nullptr; }
+    return m_FileMap.getData() + Offset + HdrLength;
+  }
+
+  //FRAME header is read by the same call into space in front of buffer
+  uint8*   Record = Buffer - HdrLength;
+  uintSize Read   = 0;
+  if(!m_StreamPrefix.empty())
+  {
+    Read = xMin((uintSize)m_StreamPrefix.size(), (uintSize)RecNumBytes);
+    std::memcpy(Record, m_StreamPrefix.data(), Read);
+    m_StreamPrefix.erase(m_StreamPrefix.begin(), m_StreamPrefix.begin() + Read);
+  }
+  Read += m_File.read(Record + Read, (uint32)(RecNumBytes - Read));
+  if(Read == (uintSize)RecNumBytes) { return !HdrLength || xCheckFrameHeader(Record, FrameIdx) ? Buffer : nullptr; }
+  EndOfStream = m_Streaming && m_File.valid(); //incomplete trailing frame is ignored (as for regular files)
+  return nullptr;
+}
+uint8* xSeq::xAllocFrameBuffer() const
+{
+  uint8* Memory = (uint8*)xAlignedMalloc(c_FrameHdrSpace + m_FileImgNumBytes, xc_AlignmentPel);
+  return Memory + c_FrameHdrSpace;
+}
+void xSeq::xFreeFrameBuffer(uint8* Buffer) const
+{
+  xAlignedFree(Buffer - c_FrameHdrSpace);
+}
+bool xSeq::xWriteFrameData()
+{
+  //FRAME header is placed in front of packed frame and written together with it
+  const int32 HdrLength = xGetFrameHdrLength();
+  if(HdrLength) { std::memcpy(m_FileBuffer - HdrLength, c_Y4MFrameTag.data(), c_Y4MFrameTag.size()); m_FileBuffer[-1] = '\n'; }
+  const int32 RecNumBytes = HdrLength + m_FileImgNumBytes;
+  uintSize Written = m_File.write(m_FileBuffer - HdrLength, RecNumBytes);
+  if(Written != (uintSize)RecNumBytes) { return false; }
+  m_File.flush();
+
+  m_FileSize    += RecNumBytes;
+  m_NumOfFrames += 1;
+  return true;
+}
+bool xSeq::xCheckFrameHeader(const uint8* Record, int32 FrameIdx) const
+{
+  const int32 HdrLength = m_Y4M.FrameHdrLength;
+  if(std::memcmp(Record, c_Y4MFrameTag.data(), c_Y4MFrameTag.size()) == 0 && Record[HdrLength - 1] == '\n') { return true; }
+  fmt::printf("xSeq: invalid Y4M FRAME header of frame %d in %s (all FRAME headers are required to have the same length)\n", FrameIdx, m_FileName);
+  return false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+xSeq::tResult xSeq::startReadAhead(int32 Depth)
+{
+  if(m_FileMode != eMode::Read || Depth <= 0) { return eRetv::WrongArg; }
+  stopReadAhead();
+
+  m_ReadAheadDepth = Depth;
+  m_ReadAheadIdx   = m_CurrFrameIdx;
+  m_ReadAheadStats = xReadAheadStats();
+  m_ReadAheadSlots.resize(Depth);
+  m_FreeSlots  .setSize(Depth + 1); //+1 for stop request
+  m_LoadedSlots.setSize(Depth    );
+  for(xReadAheadSlot& Slot : m_ReadAheadSlots)
+  {
+    if(m_ReadMode == eRead::Stdio) { Slot.Buffer = xAllocFrameBuffer(); }
+    m_FreeSlots.EnqueueWait(&Slot);
+  }
+  m_ReadAheadThread = std::thread(&xSeq::xReadAheadFunc, this);
+  return eRetv::Success;
+}
+void xSeq::stopReadAhead()
+{
+  if(!isReadAhead()) { return; }
+
+  m_FreeSlots.EnqueueResize(nullptr); //wakes I/O thread waiting for free slot
+  if(m_ReadAheadThread.joinable()) { m_ReadAheadThread.join(); }
+
+  xReadAheadSlot* Slot = nullptr;
+  while(m_FreeSlots  .DequeueTry(Slot)) {}
+  while(m_LoadedSlots.DequeueTry(Slot)) {}
+  for(xReadAheadSlot& S : m_ReadAheadSlots) { if(S.Buffer) { xFreeFrameBuffer(S.Buffer); } }
+  m_ReadAheadSlots.clear();
+  m_CurrSlot       = nullptr;
+  m_ReadAheadDepth = 0;
+  m_ReadAheadIdx   = NOT_VALID;
+
+  //I/O thread has advanced file position past frames which were not consumed (streams cannot be rewound - consumed frames are lost)
+  if(m_ReadMode == eRead::Stdio && !m_Streaming && m_File.valid() && m_CurrFrameIdx != NOT_VALID) { m_File.seek(xGetRecordOffset(m_CurrFrameIdx), xFile::seek_mode::beg); }
+}
+void xSeq::xReadAheadFunc()
+{
+  if(xTrace::isEnabled()) { xTrace::setThreadName("SeqIO " + m_FileName); }
+
+  while(m_NumOfFrames == NOT_VALID || m_ReadAheadIdx < m_NumOfFrames)
+  {
+    xReadAheadSlot* Slot = nullptr;
+    m_FreeSlots.DequeueWait(Slot);
+    if(Slot == nullptr) { return; } //stop request
+    {
+      xStageTimer::xScope Scope(xc_StageSeqRdAhd, (int64)m_Width * m_Height);
+      Slot->Data = xLoadFrameData(m_ReadAheadIdx, Slot->Buffer, Slot->EndOfStream);
+    }
+    Slot->FrameIdx = m_ReadAheadIdx++;
+    m_LoadedSlots.EnqueueWait(Slot);
+    if(Slot->Data == nullptr) { return; } //read error or end of stream is reported by readFrame
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+bool xSeq::xUnpackFrame(xPicP* Pic, const uint8* FileData)
 {
   uint16* PtrLm      = Pic->getAddr  (eCmp::LM);
   uint16* PtrCb      = Pic->getAddr  (eCmp::CB);
   uint16* PtrCr      = Pic->getAddr  (eCmp::CR);
   const int32 Stride = Pic->getStride();
 
+  if(m_Layout != eLayout::Planar)
+  {
+    uint16* const Dst[3] = { PtrLm, PtrCb, PtrCr };
+    return xUnpackPackedLines(Dst, Stride, FileData, 0, m_Height);
+  }
+
   //process luma
-  if(m_BytesPerSample == 1) { xPixelOps::Cvt (PtrLm, m_FileBuffer           , Stride, m_Width, m_Width, m_Height); }
-  else                      { xPixelOps::Copy(PtrLm, (uint16*)(m_FileBuffer), Stride, m_Width, m_Width, m_Height); }
+  if(m_BytesPerSample == 1) { xPixelOps::Cvt (PtrLm, FileData           , Stride, m_Width, m_Width, m_Height); }
+  else                      { xPixelOps::Copy(PtrLm, (uint16*)(FileData), Stride, m_Width, m_Width, m_Height); }
 
   //process chroma (if there is any chroma)
   if(m_ChromaFormat > 400)
   {
-    const uint8* ChromaPtr = m_FileBuffer + m_FileCmpNumBytes;
+    const uint8* ChromaPtr = FileData + m_FileCmpNumBytes;
 
     if(m_ChromaFormat == 420)
     {
@@ -272,8 +595,156 @@ bool xSeq::xUnpackFrame(xPicP* Pic)
   }
   return true;
 }
+template <class tPicI> bool xSeq::xUnpackFrameFused(xPicP* Pic, tPicI* PicI, const uint8* FileData, boolV4& Correct)
+{
+  assert(Pic != nullptr || PicI != nullptr);
+  assert(Pic == nullptr || PicI == nullptr || PicI->isCompatible(Pic));
+  if(m_Layout == eLayout::Planar && m_ChromaFormat != 400 && m_ChromaFormat != 420 && m_ChromaFormat != 444) { return false; }
+
+  const xPicCommon* PicC = Pic != nullptr ? (const xPicCommon*)Pic : (const xPicCommon*)PicI;
+  const int32 Margin      = PicC->getMargin();
+  const int32 NumCmps     = PicC->getNumCmps();
+  const int32 BitDepth    = PicC->getBitDepth();
+  const int32 ExtWidth    = m_Width + (Margin << 1);
+  const int32 StrideI     = PicI != nullptr ? PicI->getStride() * xPicCommon::c_MaxNumCmps : 0; //in samples
+  const int32 NumFileCmps = m_ChromaFormat == 400 ? 1 : 3;
+
+  //planar lines - picture buffer or reused stripe buffer (direct-to-interleaved mode)
+  if(Pic == nullptr && m_StripeBuffer == nullptr)
+  {
+    m_StripeStride = xRoundUpToNearestMultiple(ExtWidth, xc_Log2MemSizeCacheLine - 1); //lines start at cache line boundary (uint16 samples)
+    const int32 StripeNumBytes = NumCmps * c_FusedStripHeight * m_StripeStride * (int32)sizeof(uint16);
+    m_StripeBuffer = (uint16*)xAlignedMalloc(xRoundUpToNearestMultiple(StripeNumBytes, xc_Log2MemSizePage), xc_AlignmentPel);
+    ::memset(m_StripeBuffer, 0, StripeNumBytes); //chroma lines of 4:0:0 input are never written
+  }
+  assert(Pic != nullptr || m_StripeStride >= ExtWidth);
+  const int32 Stride = Pic != nullptr ? Pic->getStride() : m_StripeStride;
+  auto GetLineAddr = [&](int32 CmpIdx, int32 y) -> uint16*
+  {
+    if(Pic != nullptr) { return Pic->getAddr((eCmp)CmpIdx) + y * Stride; }
+    return m_StripeBuffer + CmpIdx * c_FusedStripHeight * m_StripeStride + Margin;
+  };
+
+  //file component planes (4:2:0 chroma planes have quarter size and half width)
+  const int32  ChromaFileCmpNumBytes = m_ChromaFormat == 420 ? m_FileCmpNumBytes >> 2 : m_FileCmpNumBytes;
+  const int32  ChromaFileStride      = m_ChromaFormat == 420 ? m_Width >> 1           : m_Width;
+  const uint8* FileCmp[3] = { FileData, FileData + m_FileCmpNumBytes, FileData + m_FileCmpNumBytes + ChromaFileCmpNumBytes };
+
+  auto InterleaveLines = [&](uint16* const* Src, int32 FirstBuffLine, int32 NumLines)
+  {
+    if constexpr(std::is_same_v<tPicI, xPicI8>) { xPixelOps::CvtInterleave((uint8* )PicI->getBuffer() + FirstBuffLine * StrideI, Src[0], Src[1], Src[2], 0, StrideI, Stride, ExtWidth, NumLines); }
+    else                                        { xPixelOps::Interleave   ((uint16*)PicI->getBuffer() + FirstBuffLine * StrideI, Src[0], Src[1], Src[2], 0, StrideI, Stride, ExtWidth, NumLines); }
+  };
+
+  Correct = xMakeVec4(true);
+
+  //stripes - every sample is written once to planar and once to interleaved buffer while stripe is still in cache
+  for(int32 y = 0; y < m_Height; y += c_FusedStripHeight)
+  {
+    const int32 StripHeight = xMin(c_FusedStripHeight, m_Height - y);
+
+    //unpack
+    if(m_Layout != eLayout::Planar)
+    {
+      uint16* const Dst[3] = { GetLineAddr(0, y), GetLineAddr(1, y), GetLineAddr(2, y) };
+      xUnpackPackedLines(Dst, Stride, FileData, y, StripHeight);
+    }
+    else
+    {
+      for(int32 CmpIdx = 0; CmpIdx < NumFileCmps; CmpIdx++)
+      {
+        uint16* Dst = GetLineAddr(CmpIdx, y);
+        if(CmpIdx == 0 || m_ChromaFormat == 444)
+        {
+          const int32 SrcOffset = y * m_Width;
+          if(m_BytesPerSample == 1) { xPixelOps::Cvt (Dst,           FileCmp[CmpIdx]  + SrcOffset, Stride, m_Width, m_Width, StripHeight); }
+          else                      { xPixelOps::Copy(Dst, (uint16*)(FileCmp[CmpIdx]) + SrcOffset, Stride, m_Width, m_Width, StripHeight); }
+        }
+        else
+        {
+          const int32 SrcOffset = (y >> 1) * ChromaFileStride;
+          if(m_BytesPerSample == 1) { xPixelOps::CvtUpsample(Dst,           FileCmp[CmpIdx]  + SrcOffset, Stride, ChromaFileStride, m_Width, StripHeight); }
+          else                      { xPixelOps::Upsample   (Dst, (uint16*)(FileCmp[CmpIdx]) + SrcOffset, Stride, ChromaFileStride, m_Width, StripHeight); }
+        }
+      }
+    }
+
+    //check and extend left/right
+    uint16* LineBeg[xPicCommon::c_MaxNumCmps] = { nullptr, nullptr, nullptr, nullptr };
+    for(int32 CmpIdx = 0; CmpIdx < NumCmps; CmpIdx++)
+    {
+      uint16* Addr = GetLineAddr(CmpIdx, y);
+      if(Correct[CmpIdx]) { Correct[CmpIdx] = xPixelOps::CheckValues(Addr, Stride, m_Width, StripHeight, BitDepth); }
+      if(Margin > 0) { xPixelOps::ExtendMarginHor(Addr, Stride, m_Width, StripHeight, Margin); }
+      LineBeg[CmpIdx] = Addr - Margin;
+    }
+
+    //interleave (including left/right margin)
+    if(PicI != nullptr) { InterleaveLines(LineBeg, y + Margin, StripHeight); }
+  }
+
+  //extend above/below
+  if(Margin == 0) { return true; }
+  if(Pic != nullptr)
+  {
+    for(int32 CmpIdx = 0; CmpIdx < NumCmps; CmpIdx++) { xPixelOps::ExtendMarginVer(Pic->getAddr((eCmp)CmpIdx), Stride, m_Width, m_Height, Margin); }
+    if(PicI != nullptr)
+    {
+      uint16* BuffBeg[xPicCommon::c_MaxNumCmps] = { Pic->getBuffer(eCmp::C0), Pic->getBuffer(eCmp::C1), Pic->getBuffer(eCmp::C2), nullptr };
+      uint16* BuffEnd[xPicCommon::c_MaxNumCmps] = { BuffBeg[0] + (m_Height + Margin) * Stride, BuffBeg[1] + (m_Height + Margin) * Stride, BuffBeg[2] + (m_Height + Margin) * Stride, nullptr };
+      InterleaveLines(BuffBeg, 0                , Margin);
+      InterleaveLines(BuffEnd, m_Height + Margin, Margin);
+    }
+  }
+  else
+  {
+    //whole interleaved lines (including left/right margin) are replicated
+    const int32 StrideV = PicI->getStride();
+    auto* FirstLine = PicI->getBuffer() + Margin * StrideV;
+    auto* LastLine  = FirstLine + (m_Height - 1) * StrideV;
+    for(int32 y = 1; y <= Margin; y++)
+    {
+      ::memcpy(FirstLine - y * StrideV, FirstLine, sizeof(*FirstLine) * ExtWidth);
+      ::memcpy(LastLine  + y * StrideV, LastLine , sizeof(*LastLine ) * ExtWidth);
+    }
+  }
+
+  return true;
+}
+bool xSeq::xUnpackPackedLines(uint16* const* Dst, int32 DstStride, const uint8* FileData, int32 FirstLine, int32 NumLines) const
+{
+  switch(m_Layout)
+  {
+    case eLayout::SemiPlanar:
+    {
+      //luma plane followed by half height plane of CbCr pairs (line of pairs has luma width), FirstLine and NumLines are even
+      const uint8* ChromaData = FileData + m_FileCmpNumBytes + (FirstLine >> 1) * m_Width * m_BytesPerSample;
+      if(m_BytesPerSample == 1)
+      {
+        xPixelOps::Cvt          (Dst[0], FileData + FirstLine * m_Width, DstStride, m_Width, m_Width, NumLines);
+        xPixelOps::CvtUpsampleUV(Dst[1], Dst[2], ChromaData, DstStride, m_Width, m_Width, NumLines);
+      }
+      else
+      {
+        const int32 Shift = 16 - m_BitsPerSample; //samples are MSB aligned
+        xPixelOps::CopyShr   (Dst[0], (const uint16*)FileData + FirstLine * m_Width, DstStride, m_Width, m_Width, NumLines, Shift);
+        xPixelOps::UpsampleUV(Dst[1], Dst[2], (const uint16*)ChromaData, DstStride, m_Width, m_Width, NumLines, Shift);
+      }
+      return true;
+    }
+    case eLayout::V210:
+    {
+      const int32 LineNumWords = calcV210LineNumBytes(m_Width) >> 2;
+      xPixelOps::UnpackV210(Dst[0], Dst[1], Dst[2], (const uint32*)FileData + FirstLine * LineNumWords, DstStride, LineNumWords, m_Width, NumLines);
+      return true;
+    }
+    default: return false;
+  }
+}
 bool xSeq::xPackFrame(const xPicP* Pic)
 {
+  if(m_Layout != eLayout::Planar) { return false; } //packed layouts are read only
+
   const uint16* PtrLm  = Pic->getAddr  (eCmp::LM);
   const uint16* PtrCb  = Pic->getAddr  (eCmp::CB);
   const uint16* PtrCr  = Pic->getAddr  (eCmp::CR);
@@ -325,19 +796,23 @@ bool xSeq::xPackFrame(const xPicP* Pic)
 }
 
 #if HAS_XPLANE
-bool xSeq::xUnpackFrame(xPlane<uint16>* Pic)
+bool xSeq::xUnpackFrame(xPlane<uint16>* Pic, const uint8* FileData)
 {
+  if(m_Layout != eLayout::Planar) { return false; }
+
   uint16* PtrLm      = Pic->getAddr  ();
   const int32 Stride = Pic->getStride();
 
   //process luma
-  if(m_BytesPerSample == 1) { xPixelOps::Cvt (PtrLm, m_FileBuffer           , Stride, m_Width, m_Width, m_Height); }
-  else                      { xPixelOps::Copy(PtrLm, (uint16*)(m_FileBuffer), Stride, m_Width, m_Width, m_Height); }
+  if(m_BytesPerSample == 1) { xPixelOps::Cvt (PtrLm, FileData           , Stride, m_Width, m_Width, m_Height); }
+  else                      { xPixelOps::Copy(PtrLm, (uint16*)(FileData), Stride, m_Width, m_Width, m_Height); }
 
   return true;
 }
 bool xSeq::xPackFrame(const xPlane<uint16>* Pic)
 {
+  if(m_Layout != eLayout::Planar) { return false; }
+
   const uint16* PtrLm  = Pic->getAddr  ();
   const int32   Stride = Pic->getStride();
 
@@ -369,8 +844,45 @@ bool xSeq::xPackFrame(const xPlane<uint16>* Pic)
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-int32 xSeq::calcNumFramesInFile(int32V2 Size, int32 BitDepth, int32 ChromaFormat, int64 FileSize)
+int32 xSeq::xCalcNumFrames(int64 FileSize) const
+{
+  if(m_Format == eFormat::Raw) { return calcNumFramesInFile({ m_Width, m_Height }, m_BitsPerSample, m_ChromaFormat, FileSize, m_Layout); }
+  return (int32)(xMax(FileSize - m_Y4M.HeaderLength, (int64)0) / (m_Y4M.FrameHdrLength + m_FileImgNumBytes));
+}
+xSeq::eRetv xSeq::xOpenY4MStream()
+{
+  //container is recognized by signature - bytes consumed from raw stream are kept and prepended to first frame
+  std::string Header(c_Y4MSignature.size(), '\0');
+  const uintSize Read = m_File.read(Header.data(), (uint32)Header.size());
+  if(Read != Header.size() || Header != c_Y4MSignature) { m_StreamPrefix.assign(Header.begin(), Header.begin() + Read); return eRetv::Success; }
+
+  //header is read byte by byte from stdio buffer (no additional syscalls)
+  for(char c = 0; Header.size() < (uintSize)c_Y4MMaxHeaderLength; Header.push_back(c))
+  {
+    if(m_File.read(&c, 1) != 1) { return eRetv::Error; }
+    if(c == '\n') { break; }
+  }
+  xY4MInfo Info;
+  if(!parseY4MHeader(Header, Info)) { return eRetv::Error; }
+  Info.HeaderLength   = (int32)Header.size() + 1;
+  Info.FrameHdrLength = (int32)c_Y4MFrameTag.size() + 1; //plain "FRAME\n" - frame parameters cannot be detected without consuming the stream (checked for each frame)
+  m_Format = eFormat::Y4M;
+  m_Y4M    = Info;
+  return xCheckY4MParams();
+}
+xSeq::eRetv xSeq::xCheckY4MParams() const
+{
+  if(m_Width == NOT_VALID) { return eRetv::Success; } //stream opened before create() - parameters are taken from header by caller
+  const bool Match = m_Y4M.Size == int32V2(m_Width, m_Height) && m_Y4M.BitDepth == m_BitsPerSample && m_Y4M.ChromaFormat == m_ChromaFormat && m_Layout == eLayout::Planar;
+  return Match ? eRetv::Success : eRetv::WrongArg;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int32 xSeq::calcFrameNumBytes(int32V2 Size, int32 BitDepth, int32 ChromaFormat, eLayout Layout)
 {
+  if(Layout == eLayout::V210) { return calcV210LineNumBytes(Size.getX()) * Size.getY(); } //SemiPlanar has the same size as planar 4:2:0
+
   int32 BytesPerSample  = BitDepth <= 8 ? 1 : 2;
   int32 FileCmpNumPels  = Size.getMul();
   int32 FileCmpNumBytes = FileCmpNumPels * BytesPerSample;
@@ -384,8 +896,93 @@ int32 xSeq::calcNumFramesInFile(int32V2 Size, int32 BitDepth, int32 ChromaFormat
     case 400: FileImgNumBytes = FileCmpNumBytes; break;
     default: assert(0);
   }
+  return FileImgNumBytes;
+}
+int32 xSeq::calcNumFramesInFile(int32V2 Size, int32 BitDepth, int32 ChromaFormat, int64 FileSize, eLayout Layout)
+{
+  return (int32)(FileSize / calcFrameNumBytes(Size, BitDepth, ChromaFormat, Layout));
+}
+xSeq::eFormat xSeq::probeFormat(const std::string& FileName, xY4MInfo& Info)
+{
+  Info = xY4MInfo();
+  if(xFile::isStream(FileName) || !xFile::exist(FileName)) { return eFormat::Raw; }
+
+  //stream header and first FRAME header
+  std::vector<char> Buffer(c_Y4MMaxHeaderLength + c_Y4MMaxFrameHdrLen);
+  xFile File(FileName, "rb");
+  if(!File.valid()) { return eFormat::Raw; }
+  const int32 Read     = (int32)File.read(Buffer.data(), (uint32)Buffer.size());
+  const int64 FileSize = File.size();
+  File.close();
+  if(Read < (int32)c_Y4MSignature.size() || std::string_view(Buffer.data(), c_Y4MSignature.size()) != c_Y4MSignature) { return eFormat::Raw; }
+
+  const char* HeaderEnd = (const char*)std::memchr(Buffer.data(), '\n', Read);
+  if(HeaderEnd == nullptr || !parseY4MHeader(std::string_view(Buffer.data(), HeaderEnd - Buffer.data()), Info)) { Info = xY4MInfo(); return eFormat::Y4M; }
+  Info.HeaderLength = (int32)(HeaderEnd - Buffer.data()) + 1;
+
+  //all frames are assumed to have FRAME header of the same length as the first one (checked when frame is read)
+  const int32 Remaining = Read - Info.HeaderLength;
+  if(Remaining == 0) { Info.FrameHdrLength = (int32)c_Y4MFrameTag.size() + 1; }
+  else
+  {
+    const char* FrameBeg = HeaderEnd + 1;
+    const char* FrameEnd = (const char*)std::memchr(FrameBeg, '\n', xMin(Remaining, c_Y4MMaxFrameHdrLen));
+    if(FrameEnd == nullptr || std::string_view(FrameBeg, xMin(Remaining, (int32)c_Y4MFrameTag.size())) != c_Y4MFrameTag) { Info = xY4MInfo(); return eFormat::Y4M; }
+    Info.FrameHdrLength = (int32)(FrameEnd - FrameBeg) + 1;
+  }
+  Info.NumFrames = (int32)((FileSize - Info.HeaderLength) / (Info.FrameHdrLength + calcFrameNumBytes(Info.Size, Info.BitDepth, Info.ChromaFormat)));
+  return eFormat::Y4M;
+}
+bool xSeq::parseY4MHeader(std::string_view Header, xY4MInfo& Info)
+{
+  //YUV4MPEG2 W<width> H<height> [C<colorspace>] [F, I, A, X - ignored]
+  Info.Size         = { NOT_VALID, NOT_VALID };
+  Info.BitDepth     = 8;
+  Info.ChromaFormat = 420; //default colorspace is 420jpeg
 
-  return (int32)(FileSize / FileImgNumBytes);
+  auto ParseInt = [](std::string_view Str, int32 Default) { int32 Value = 0; if(Str.empty()) { return Default; } for(char c : Str) { if(c < '0' || c > '9') { return (int32)NOT_VALID; } Value = Value * 10 + (c - '0'); } return Value; };
+
+  uintSize Pos = 0;
+  for(int32 TokenIdx = 0; Pos < Header.size(); TokenIdx++)
+  {
+    uintSize End = Header.find(' ', Pos);
+    if(End == std::string_view::npos) { End = Header.size(); }
+    const std::string_view Token = Header.substr(Pos, End - Pos);
+    Pos = End + 1;
+    if(TokenIdx == 0) { if(Token != c_Y4MSignature) { return false; } continue; }
+    if(Token.empty()) { continue; }
+
+    const std::string_view Value = Token.substr(1);
+    switch(Token[0])
+    {
+      case 'W': Info.Size.setX(ParseInt(Value, NOT_VALID)); break;
+      case 'H': Info.Size.setY(ParseInt(Value, NOT_VALID)); break;
+      case 'C':
+        if(Value.substr(0, 4) == "mono") { Info.ChromaFormat = 400; Info.BitDepth = ParseInt(Value.substr(4), 8); break; } //mono, mono10, mono16
+        Info.ChromaFormat = ParseInt(Value.substr(0, 3), NOT_VALID);
+        if(Info.ChromaFormat != 420 && Info.ChromaFormat != 422 && Info.ChromaFormat != 444) { return false; } //411, 444alpha, ... - unsupported
+        if     (Value.size() > 4 && Value[3] == 'p') { Info.BitDepth = ParseInt(Value.substr(4), NOT_VALID); } //420p10, 444p12, ...
+        else if(Value.size() > 3 && Value.substr(3) != "jpeg" && Value.substr(3) != "paldv" && Value.substr(3) != "mpeg2") { return false; }
+        break;
+      default: break;
+    }
+  }
+  return Info.Size.getX() > 0 && Info.Size.getY() > 0 && Info.BitDepth >= 8 && Info.BitDepth <= 16;
+}
+std::string xSeq::formatY4MHeader(int32V2 Size, int32 BitDepth, int32 ChromaFormat)
+{
+  //frame rate is not known to xSeq - 25 fps is written as in most tools
+  std::string Colorspace = ChromaFormat == 400 ? std::string("mono") : fmt::sprintf("%d", ChromaFormat);
+  if     (BitDepth > 8     ) { Colorspace += fmt::sprintf(ChromaFormat == 400 ? "%d" : "p%d", BitDepth); }
+  else if(ChromaFormat == 420) { Colorspace += "jpeg"; }
+  return fmt::sprintf("%s W%d H%d F25:1 Ip A1:1 C%s\n", c_Y4MSignature, Size.getX(), Size.getY(), Colorspace);
+}
+bool xSeq::isY4MFileName(const std::string& FileName)
+{
+  if(FileName.size() < 4) { return false; }
+  std::string Extension = FileName.substr(FileName.size() - 4);
+  std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](char c) { return (char)std::tolower(c); });
+  return Extension == ".y4m";
 }
 xSeq::tResult xSeq::dumpFrame(const xPicP* Pic, const std::string& FileName, int32 ChromaFormat, bool Append)
 {
@@ -40,7 +40,12 @@ THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "xCommonDefPMBB.h"
 #include "xFile.h"
+#include "xFileMap.h"
 #include "xPic.h"
+#include "xQueue.h"
+#include <thread>
+#include <vector>
+#include <string_view>
 
 #if __has_include("xPlane.h")
 #include "xPlane.h"
@@ -58,6 +63,9 @@ class xSeq
 public:
   enum class eMode : int32 { Unknown, Read, Write, Append };
   enum class eRetv : int32 { Success, EndOfFile, Error, WrongArg };
+  enum class eRead : int32 { Stdio, MemMap }; //MemMap - frames are unpacked directly from file mapping (falls back to Stdio if mapping fails)
+  enum class eFormat : int32 { Raw, Y4M }; //Y4M - YUV4MPEG2 container, picture parameters are stored in stream header
+  enum class eLayout : int32 { Planar = 0, SemiPlanar = 1, V210 = 2 }; //SemiPlanar - 4:2:0 with interleaved CbCr plane (NV12 for 8 bit, MSB aligned P010/P016 otherwise), V210 - packed 10 bit 4:2:2 (read only)
 
   static std::string_view ResultToString(eRetv Result)
   {
@@ -81,6 +89,7 @@ public:
     tResult(eRetv Result, const std::string Message = std::string()) : m_Result(Result), m_Message(Message) {}
 
     explicit operator bool() const { return CheckResult(m_Result); }
+    inline eRetv getResult() const { return m_Result; } //no error printout (i.e. EndOfFile is expected for streams)
 
     static inline bool CheckResult(eRetv Result)
     {
@@ -93,11 +102,59 @@ public:
     inline bool operator!= (const eRetv Res) const { return m_Result != Res; }
   };
 
+  struct xY4MInfo
+  {
+    int32V2 Size           = { NOT_VALID, NOT_VALID };
+    int32   BitDepth       = NOT_VALID;
+    int32   ChromaFormat   = NOT_VALID;
+    int32   HeaderLength   = NOT_VALID; //stream header length (including '\n')
+    int32   FrameHdrLength = NOT_VALID; //FRAME header length (including '\n') - has to be the same for all frames
+    int32   NumFrames      = NOT_VALID; //NOT_VALID for streams
+
+    bool isValid() const { return Size.getX() > 0 && Size.getY() > 0 && BitDepth > 0 && ChromaFormat != NOT_VALID && HeaderLength > 0 && FrameHdrLength > 0; }
+  };
+
+  struct xReadAheadStats
+  {
+    int64 NumHits   = 0; //frame was already loaded when requested
+    int64 NumMisses = 0; //readFrame had to wait for I/O thread
+    flt64 WaitTime  = 0; //total readFrame wait time [s]
+
+    flt64 getHitRate() const { return NumHits + NumMisses > 0 ? (flt64)NumHits / (flt64)(NumHits + NumMisses) : 0.0; }
+  };
+
+protected:
+  static constexpr int32 c_FusedStripHeight = 2; //number of lines processed by fused frame preparation at once (even - 4:2:0 chroma lines are upsampled in pairs)
+
+  static constexpr std::string_view c_Y4MSignature       = "YUV4MPEG2";
+  static constexpr std::string_view c_Y4MFrameTag        = "FRAME";
+  static constexpr int32            c_Y4MMaxHeaderLength = 4096;
+  static constexpr int32            c_Y4MMaxFrameHdrLen  = 256;
+  static constexpr int32            c_FrameHdrSpace      = xc_AlignmentPel; //space in front of frame buffers - Y4M FRAME header is read (or written) together with frame data by single call, data stays aligned
+  static_assert(c_Y4MMaxFrameHdrLen <= c_FrameHdrSpace);
+
+protected:
+  struct xReadAheadSlot
+  {
+    uint8*       Buffer   = nullptr;   //owned frame buffer (unused in MemMap mode)
+    const uint8* Data     = nullptr;   //loaded frame data (Buffer or file mapping), nullptr on read error or end of stream
+    int32        FrameIdx = NOT_VALID;
+    bool         EndOfStream = false;
+  };
+
 protected:
   std::string m_FileName;
   eMode       m_FileMode = eMode::Unknown;
+  eRead       m_ReadMode = eRead::Stdio;
   int64       m_FileSize = NOT_VALID;
+  bool        m_Streaming   = false; //pipe, FIFO or stdin - read sequentially until EOF, number of frames is unknown (NOT_VALID)
+  bool        m_EndOfStream = false; //last failed frame load hit end of stream (not read error)
+  eFormat     m_Format      = eFormat::Raw;
+  eLayout     m_Layout      = eLayout::Planar;
+  xY4MInfo    m_Y4M;
+  std::vector<uint8> m_StreamPrefix; //bytes consumed by container detection of raw stream - prepended to first frame
   xFile       m_File;
+  xFileMap    m_FileMap;
 
   int32   m_Width           = NOT_VALID;
   int32   m_Height          = NOT_VALID;
@@ -114,47 +171,124 @@ protected:
   int32   m_CurrFrameIdx    = NOT_VALID;
 
   uint8*  m_FileBuffer      = nullptr;
+  uint16* m_StripeBuffer    = nullptr; //planar stripe for direct-to-interleaved unpack
+  int32   m_StripeStride    = NOT_VALID;
+
+  //asynchronous read-ahead
+  int32                       m_ReadAheadDepth = 0;
+  int32                       m_ReadAheadIdx   = NOT_VALID; //next frame to be loaded by I/O thread
+  std::vector<xReadAheadSlot> m_ReadAheadSlots;
+  xQueue<xReadAheadSlot*>     m_FreeSlots;
+  xQueue<xReadAheadSlot*>     m_LoadedSlots;
+  xReadAheadSlot*             m_CurrSlot = nullptr;
+  std::thread                 m_ReadAheadThread;
+  xReadAheadStats             m_ReadAheadStats;
 
 public:
   xSeq() { m_FileBuffer = nullptr; };
-  xSeq(int32V2 Size, int32 BitDepth, int32 ChromaFormat) { create(Size, BitDepth, ChromaFormat); }
+  xSeq(int32V2 Size, int32 BitDepth, int32 ChromaFormat, eLayout Layout = eLayout::Planar) { create(Size, BitDepth, ChromaFormat, Layout); }
   ~xSeq() { destroy(); }
 
-  void    create    (int32V2 Size, int32 BitDepth, int32 ChromaFormat);
+  void    create    (int32V2 Size, int32 BitDepth, int32 ChromaFormat, eLayout Layout = eLayout::Planar);
   void    destroy   ();
-  tResult openFile  (const std::string& FileName, eMode FileMode);
+  tResult openFile  (const std::string& FileName, eMode FileMode, eRead ReadMode = eRead::Stdio);
   tResult closeFile ();
   tResult seekFrame (int32 FrameNumber);
   tResult readFrame (xPicP*       Pic);
   tResult writeFrame(const xPicP* Pic);
+  tResult unpackFrame(xPicP* Pic, const uint8* FileData); //unpacks current frame loaded outside of xSeq (i.e. by xSeqBatchReader)
+
+  //fused frame preparation - unpack, sample range check, margin extension and interleave (optional PicI) done stripe by stripe while data stays in cache
+  //Pic can be nullptr if only interleaved picture is needed - stripes are unpacked into small internal buffer and planar picture is not written at all
+  tResult readFrame  (xPicP* Pic, xPicI* PicI, boolV4& Correct);
+  tResult unpackFrame(xPicP* Pic, xPicI* PicI, const uint8* FileData, boolV4& Correct);
+  tResult readFrame  (xPicP* Pic, xPicI8* PicI, boolV4& Correct); //as above, interleaved picture with native 8-bit storage (BitDepth<=8)
+  tResult unpackFrame(xPicP* Pic, xPicI8* PicI, const uint8* FileData, boolV4& Correct);
 #if HAS_XPLANE
   tResult readFrame (xPlane<uint16>*       Plane);
   tResult writeFrame(const xPlane<uint16>* Plane);
 #endif //HAS_XPLANE
 
+  //dedicated I/O thread loads up to Depth frames ahead of readFrame into pooled buffers (Read mode only)
+  tResult startReadAhead(int32 Depth);
+  void    stopReadAhead ();
+  inline bool                   isReadAhead      () const { return m_ReadAheadDepth > 0; }
+  inline const xReadAheadStats& getReadAheadStats() const { return m_ReadAheadStats; }
+
 public:
   inline int32 getWidth   () const { return m_Width           ; }
   inline int32 getHeight  () const { return m_Height          ; }
   inline int32 getArea    () const { return m_Width * m_Height; }
   inline int32 getBitDepth() const { return m_BitsPerSample   ; }
+  inline int32 getFrameNumBytes() const { return m_FileImgNumBytes; }
+  inline eLayout getLayout() const { return m_Layout; }
 
   inline std::string getFileName() const { return m_FileName; }
   inline eMode       getFileMode() const { return m_FileMode; }
+  inline eRead       getReadMode() const { return m_ReadMode; }
   inline int64       getFileSize() const { return m_FileSize; }
 
-  inline int32       getNumOfFrames () const { return m_NumOfFrames ; }
+  inline bool        isStreaming    () const { return m_Streaming   ; }
+  inline eFormat     getFormat      () const { return m_Format      ; }
+  inline const xY4MInfo& getY4MInfo () const { return m_Y4M         ; }
+  inline int64       getFrameDataOffset(int32 FrameIdx) const { return xGetRecordOffset(FrameIdx) + xGetFrameHdrLength(); } //position of frame samples in file
+  inline int32       getNumOfFrames () const { return m_NumOfFrames ; } //NOT_VALID for streams
   inline int32       getCurrFrameIdx() const { return m_CurrFrameIdx; }
 
 protected:
-  bool xUnpackFrame(      xPicP* Pic);
+  const uint8* xReadFrameData   ();
+  void         xReleaseFrameData();
+  const uint8* xLoadFrameData   (int32 FrameIdx, uint8* Buffer, bool& EndOfStream);
+  uint8*       xAllocFrameBuffer() const;
+  void         xFreeFrameBuffer (uint8* Buffer) const;
+  bool         xWriteFrameData  ();
+
+  inline int32 xGetFrameHdrLength() const { return m_Format == eFormat::Y4M ? m_Y4M.FrameHdrLength : 0; }
+  inline int64 xGetRecordOffset  (int32 FrameIdx) const { return (m_Format == eFormat::Y4M ? m_Y4M.HeaderLength : 0) + (int64)(xGetFrameHdrLength() + m_FileImgNumBytes) * FrameIdx; }
+  int32        xCalcNumFrames    (int64 FileSize) const;
+  eRetv        xOpenY4MStream    ();
+  eRetv        xCheckY4MParams   () const;
+  bool         xCheckFrameHeader (const uint8* Record, int32 FrameIdx) const;
+
+  inline bool  xIsPastLastFrame () const { return m_FileMode == eMode::Read && m_NumOfFrames != NOT_VALID && m_CurrFrameIdx >= m_NumOfFrames; }
+  inline eRetv xReadFailure     () const { return m_EndOfStream ? eRetv::EndOfFile : eRetv::Error; }
+  void         xReadAheadFunc   ();
+
+  bool xUnpackFrame(      xPicP* Pic, const uint8* FileData);
   bool xPackFrame  (const xPicP* Pic);
+  template <class tPicI> tResult xReadFrameI      (xPicP* Pic, tPicI* PicI, boolV4& Correct);
+  template <class tPicI> tResult xUnpackFrameI    (xPicP* Pic, tPicI* PicI, const uint8* FileData, boolV4& Correct);
+  template <class tPicI> bool    xUnpackFrameFused(xPicP* Pic, tPicI* PicI, const uint8* FileData, boolV4& Correct);
+  bool xUnpackPackedLines(uint16* const* Dst, int32 DstStride, const uint8* FileData, int32 FirstLine, int32 NumLines) const; //SemiPlanar and V210 layouts, Dst points to FirstLine of each component
 #if HAS_XPLANE
-  bool xUnpackFrame(      xPlane<uint16>* Pic);
+  bool xUnpackFrame(      xPlane<uint16>* Pic, const uint8* FileData);
   bool xPackFrame  (const xPlane<uint16>* Pic);
 #endif //HAS_XPLANE
 
 public:
-  static int32 calcNumFramesInFile(int32V2 Size, int32 BitDepth, int32 ChromaFormat, int64 FileSize);
+  static int32 calcFrameNumBytes  (int32V2 Size, int32 BitDepth, int32 ChromaFormat, eLayout Layout = eLayout::Planar);
+  static int32 calcNumFramesInFile(int32V2 Size, int32 BitDepth, int32 ChromaFormat, int64 FileSize, eLayout Layout = eLayout::Planar);
+  static int32 calcV210LineNumBytes(int32 Width) { return ((Width + 47) / 48) * 128; } //lines are padded to 48 pels (128 bytes)
+
+  //Y4M - probeFormat reads regular file header only (streams are recognized by openFile, their header can be read only once), invalid header gives Y4M with !Info.isValid()
+  static eFormat     probeFormat    (const std::string& FileName, xY4MInfo& Info);
+  static bool        parseY4MHeader (std::string_view Header, xY4MInfo& Info); //Header without trailing '\n'
+  static std::string formatY4MHeader(int32V2 Size, int32 BitDepth, int32 ChromaFormat);
+  static bool        isY4MFileName  (const std::string& FileName);
+
+  static std::string_view FormatToString(eFormat Format) { return Format == eFormat::Y4M ? "Y4M" : "Raw"; }
+  static std::string_view LayoutToString(eLayout Layout)
+  {
+    switch(Layout)
+    {
+      case eLayout::Planar    : return "Planar"    ; break;
+      case eLayout::SemiPlanar: return "SemiPlanar"; break;
+      case eLayout::V210      : return "V210"      ; break;
+      default:                  return "INVALID"   ; break;
+    }
+  }
+
+  static std::string_view ReadModeToString(eRead ReadMode) { return ReadMode == eRead::MemMap ? "MemMap" : "Stdio"; }
 
   static tResult dumpFrame(const xPicP* Pic, const std::string& FileName, int32 ChromaFormat, bool Append); //slow stateless write for debug purposes
 };
@@ -0,0 +1,217 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xSeqBatchReader.h"
+#include "xStageTimer.h"
+
+#if X_SYSTEM_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+static const xStageTimer::tStageId xc_StageBatchWait = xStageTimer::registerStage("xSeqBatch::Wait");
+
+//===============================================================================================================================================================================================================
+
+bool xSeqBatchReader::create(const std::vector<xSeq*>& Seqs, bool DirectIO, bool UseIOUring)
+{
+#if X_SYSTEM_LINUX
+  destroy();
+  if(Seqs.empty()) { return false; }
+
+  int32 MaxFrameNumBytes = 0;
+  for(const xSeq* Seq : Seqs)
+  {
+    if(Seq->getFileMode() != xSeq::eMode::Read || Seq->isStreaming()) { return false; } //streams cannot be read at explicit offsets
+    MaxFrameNumBytes = xMax(MaxFrameNumBytes, Seq->getFrameNumBytes());
+  }
+
+  //unaligned frame is covered by aligned read, so buffer has to hold up to two additional blocks
+  m_BufferSize = (int32)xRoundUpToNearestMultiple(MaxFrameNumBytes + 2 * c_DirectAlignment, c_DirectAlignLog2);
+
+  m_Slots.resize(Seqs.size());
+  for(uintSize s = 0; s < Seqs.size(); s++)
+  {
+    xSeqSlot& Slot = m_Slots[s];
+    Slot.Seq       = Seqs[s];
+    Slot.NextFrame = Seqs[s]->getCurrFrameIdx();
+    Slot.DirectIO  = false;
+    if(DirectIO) { Slot.FileDesc = open(Slot.Seq->getFileName().c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT); Slot.DirectIO = Slot.FileDesc >= 0; }
+    if(Slot.FileDesc < 0) { Slot.FileDesc = open(Slot.Seq->getFileName().c_str(), O_RDONLY | O_CLOEXEC); } //i.e. tmpfs does not support O_DIRECT
+    if(Slot.FileDesc < 0) { destroy(); return false; }
+    posix_fadvise(Slot.FileDesc, 0, 0, POSIX_FADV_SEQUENTIAL);
+    for(int32 b = 0; b < c_NumBufferSets; b++) { Slot.Buffer[b] = (uint8*)xAlignedMalloc(m_BufferSize, c_DirectAlignment); }
+  }
+
+  m_Backend = eBackend::PRead;
+  if(UseIOUring && m_Ring.init((uint32)xRoundUpToNearestMultiple((int32)m_Slots.size() * c_NumBufferSets, 3)))
+  {
+    m_Backend = eBackend::IOUring;
+    std::vector<xIOUring::xBuffer> Buffers;
+    for(xSeqSlot& Slot : m_Slots) { for(int32 b = 0; b < c_NumBufferSets; b++) { Buffers.push_back({ Slot.Buffer[b], (uintSize)m_BufferSize }); } }
+    m_Ring.registerBuffers(Buffers); //without registration plain reads are used
+  }
+
+  m_NextSet  = 0;
+  m_CurrSet  = NOT_VALID;
+  m_InFlight = false;
+  return true;
+#else
+  (void)Seqs; (void)DirectIO; (void)UseIOUring;
+  return false;
+#endif
+}
+void xSeqBatchReader::destroy()
+{
+#if X_SYSTEM_LINUX
+  if(m_InFlight) { xWaitBatch(m_NextSet); } //kernel may still write into buffers
+  m_Ring.uninit();
+  for(xSeqSlot& Slot : m_Slots)
+  {
+    if(Slot.FileDesc >= 0) { close(Slot.FileDesc); }
+    for(int32 b = 0; b < c_NumBufferSets; b++) { if(Slot.Buffer[b]) { xAlignedFree(Slot.Buffer[b]); } }
+  }
+#endif
+  m_Slots.clear();
+  m_Backend  = eBackend::None;
+  m_InFlight = false;
+  m_CurrSet  = NOT_VALID;
+}
+bool xSeqBatchReader::loadFrames()
+{
+  if(m_Backend == eBackend::None) { return false; }
+  for(const xSeqSlot& Slot : m_Slots) { if(Slot.NextFrame >= Slot.Seq->getNumOfFrames()) { return false; } }
+
+  if(!m_InFlight && !xSubmitBatch(m_NextSet)) { return false; }
+  m_InFlight = false;
+  {
+    xStageTimer::xScope Scope(xc_StageBatchWait);
+    if(!xWaitBatch(m_NextSet)) { return false; }
+  }
+  m_CurrSet = m_NextSet;
+  m_NextSet = (m_NextSet + 1) % c_NumBufferSets;
+  for(xSeqSlot& Slot : m_Slots) { Slot.NextFrame++; }
+
+  //next frame is read while current one is processed
+  bool NextExists = true;
+  for(const xSeqSlot& Slot : m_Slots) { if(Slot.NextFrame >= Slot.Seq->getNumOfFrames()) { NextExists = false; } }
+  if(m_Backend == eBackend::IOUring && NextExists) { m_InFlight = xSubmitBatch(m_NextSet); }
+  return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+bool xSeqBatchReader::xSubmitBatch(int32 Set)
+{
+  for(xSeqSlot& Slot : m_Slots)
+  {
+    const int32 FrameNumBytes = Slot.Seq->getFrameNumBytes();
+    const int64 Offset        = Slot.Seq->getFrameDataOffset(Slot.NextFrame); //Y4M FRAME headers are skipped
+    const int64 ReadOffset    = Slot.DirectIO ? Offset & ~(int64)(c_DirectAlignment - 1) : Offset;
+    const int32 Skip          = (int32)(Offset - ReadOffset);
+    Slot.ReadOffset[Set] = ReadOffset;
+    Slot.ReadLength[Set] = Slot.DirectIO ? (int32)xRoundUpToNearestMultiple(Skip + FrameNumBytes, c_DirectAlignLog2) : FrameNumBytes;
+    Slot.Data      [Set] = Slot.Buffer[Set] + Skip;
+  }
+
+  if(m_Backend == eBackend::PRead)
+  {
+    for(xSeqSlot& Slot : m_Slots) { if(!xReadSync(Slot, Set, 0)) { return false; } }
+    return true;
+  }
+
+  for(uintSize s = 0; s < m_Slots.size(); s++)
+  {
+    xSeqSlot& Slot = m_Slots[s];
+    bool Queued = m_Ring.queueRead(Slot.FileDesc, Slot.Buffer[Set], Slot.ReadLength[Set], Slot.ReadOffset[Set], (int32)s * c_NumBufferSets + Set, s);
+    if(!Queued) { return false; }
+  }
+  return m_Ring.submit(0) >= 0;
+}
+bool xSeqBatchReader::xWaitBatch(int32 Set)
+{
+  if(m_Backend != eBackend::IOUring) { return true; }
+
+  int32 NumRemaining = (int32)m_Slots.size();
+  bool  Success      = true;
+  while(NumRemaining > 0)
+  {
+    uint64 UserData = 0;
+    int32  Result   = 0;
+    while(NumRemaining > 0 && m_Ring.peekCompletion(UserData, Result))
+    {
+      NumRemaining--;
+      xSeqSlot& Slot = m_Slots[(uintSize)UserData];
+      const int32 Required = (int32)(Slot.Data[Set] - Slot.Buffer[Set]) + Slot.Seq->getFrameNumBytes();
+      if(Result < 0) { Success = false; }
+      else if(Result < Required) { Success &= xReadSync(Slot, Set, Result); } //short read - remaining part is read synchronously
+    }
+    if(NumRemaining > 0 && m_Ring.submit(NumRemaining) < 0) { return false; }
+  }
+  return Success;
+}
+bool xSeqBatchReader::xReadSync(xSeqSlot& Slot, int32 Set, int32 Done)
+{
+#if X_SYSTEM_LINUX
+  const int32 Required = (int32)(Slot.Data[Set] - Slot.Buffer[Set]) + Slot.Seq->getFrameNumBytes();
+  while(Done < Required)
+  {
+    //O_DIRECT requires aligned file offset, buffer address and length - partially read block is read again
+    if(Slot.DirectIO) { Done &= ~(c_DirectAlignment - 1); }
+    const ssize_t Result = pread(Slot.FileDesc, Slot.Buffer[Set] + Done, (size_t)(Slot.ReadLength[Set] - Done), Slot.ReadOffset[Set] + Done);
+    if(Result < 0 && errno == EINTR) { continue; }
+    if(Result <= 0) { return false; } //error or unexpected end of file
+    Done += (int32)Result;
+    if(Slot.DirectIO && (Result & (c_DirectAlignment - 1)) != 0 && Done < Required) { return false; } //unaligned O_DIRECT read ends at end of file
+  }
+  return true;
+#else
+  (void)Slot; (void)Set; (void)Done;
+  return false;
+#endif
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
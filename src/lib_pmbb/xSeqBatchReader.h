@@ -0,0 +1,120 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include "xSeq.h"
+#include "xIOUring.h"
+#include <vector>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xSeqBatchReader - loads current frame of many sequences with single batched submission (io_uring, falls back to pread)
+// - frame data of all sequences is read into own (registered, O_DIRECT compatible) buffers, unpacking is done by xSeq::unpackFrame
+// - with io_uring the next frame of all sequences is submitted right after current one completes (double buffering, no I/O threads)
+// - Linux only, create() returns false on other platforms (xSeq::readFrame has to be used)
+//===============================================================================================================================================================================================================
+class xSeqBatchReader
+{
+public:
+  enum class eBackend : int32 { None, IOUring, PRead };
+
+  static constexpr int32 c_DirectAlignLog2 = 12; //4096 - covers logical block size of all common devices
+  static constexpr int32 c_DirectAlignment = 1 << c_DirectAlignLog2;
+  static constexpr int32 c_NumBufferSets   = 2;
+
+  static std::string_view BackendToString(eBackend Backend)
+  {
+    switch(Backend)
+    {
+      case eBackend::IOUring: return "io_uring"; break;
+      case eBackend::PRead  : return "pread"   ; break;
+      default:                return "none"    ; break;
+    }
+  }
+
+protected:
+  struct xSeqSlot
+  {
+    xSeq*        Seq       = nullptr;
+    int32        FileDesc  = NOT_VALID;
+    bool         DirectIO  = false;
+    int32        NextFrame = NOT_VALID;
+    uint8*       Buffer    [c_NumBufferSets] = { nullptr };
+    int32        ReadLength[c_NumBufferSets] = { 0 };
+    int64        ReadOffset[c_NumBufferSets] = { 0 };
+    const uint8* Data      [c_NumBufferSets] = { nullptr };
+  };
+
+  eBackend              m_Backend    = eBackend::None;
+  std::vector<xSeqSlot> m_Slots;
+  int32                 m_BufferSize = 0;
+  int32                 m_NextSet    = 0;
+  int32                 m_CurrSet    = NOT_VALID;
+  bool                  m_InFlight   = false; //next batch was already submitted
+  xIOUring              m_Ring;
+
+public:
+  xSeqBatchReader() {}
+  xSeqBatchReader(const xSeqBatchReader&) = delete;
+  xSeqBatchReader& operator=(const xSeqBatchReader&) = delete;
+  ~xSeqBatchReader() { destroy(); }
+
+  //sequences have to be opened in Read mode (and positioned at first frame), reading starts from their current frame
+  bool  create (const std::vector<xSeq*>& Seqs, bool DirectIO, bool UseIOUring = true);
+  void  destroy();
+
+  //loads current frame of all sequences, data stays valid until next call
+  bool  loadFrames();
+  const uint8* getFrameData(int32 SeqIdx) const { return m_Slots[SeqIdx].Data[m_CurrSet]; }
+
+  inline eBackend getBackend () const { return m_Backend; }
+  inline bool     isDirectIO () const { for(const xSeqSlot& S : m_Slots) { if(!S.DirectIO) { return false; } } return !m_Slots.empty(); }
+  inline bool     hasRegisteredBuffers() const { return m_Ring.hasRegisteredBuffers(); }
+
+protected:
+  bool  xSubmitBatch(int32 Set);
+  bool  xWaitBatch  (int32 Set);
+  bool  xReadSync   (xSeqSlot& Slot, int32 Set, int32 Done);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
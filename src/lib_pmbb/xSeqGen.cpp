@@ -0,0 +1,234 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+#include "xSeqGen.h"
+#include "xStageTimer.h"
+#include <cassert>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+static const xStageTimer::tStageId xc_StageSeqGen = xStageTimer::registerStage("xSeqGen::Gen");
+
+//===============================================================================================================================================================================================================
+
+std::string_view xSeqGen::SeqToString(eSeq Seq)
+{
+  switch(Seq)
+  {
+    case eSeq::Ref: return "Ref"; break;
+    case eSeq::Tst: return "Tst"; break;
+    case eSeq::Msk: return "Msk"; break;
+    default:        return "Unknown"; break;
+  }
+}
+void xSeqGen::create(const xParams& Params)
+{
+  assert(Params.Size.getX() > 0 && Params.Size.getY() > 0);
+  assert(Params.ChromaFormat == 400 || Params.ChromaFormat == 420 || Params.ChromaFormat == 444);
+
+  m_Params = Params;
+  if(m_Params.NoiseAmp == NOT_VALID) { m_Params.NoiseAmp = getDefNoiseAmp(m_Params.BitDepth); }
+  m_ChromaShift = m_Params.ChromaFormat == 420 ? 1 : 0;
+
+  for(int32 CmpIdx = 0; CmpIdx < xPicCommon::c_DefNumCmps; CmpIdx++)
+  {
+    const int32 Shift  = CmpIdx == 0 ? 0 : m_ChromaShift;
+    const int32 Width  = m_Params.Size.getX() >> Shift;
+    const int32 Height = m_Params.Size.getY() >> Shift;
+    m_CmpSize[CmpIdx]  = { Width, Height };
+
+    //coarse grid of random values
+    const int32 GridW = Width  / c_TextureCell + 2;
+    const int32 GridH = Height / c_TextureCell + 2;
+    std::vector<int32> Grid(GridW * GridH);
+    for(int32 i = 0; i < GridW * GridH; i++) { Grid[i] = (int32)(xHash(m_Params.Seed, CmpIdx, i) & 0xFFFF); }
+
+    //bilinear interpolation of grid + fine detail
+    constexpr int32 Cell = c_TextureCell;
+    m_Texture[CmpIdx].resize((uintSize)Width * Height);
+    uint16* Texture = m_Texture[CmpIdx].data();
+    for(int32 y = 0; y < Height; y++)
+    {
+      const int32  FY = y % Cell;
+      const int32* G0 = Grid.data() + (y / Cell) * GridW;
+      const int32* G1 = G0 + GridW;
+      for(int32 x = 0; x < Width; x++)
+      {
+        const int32 GX     = x / Cell;
+        const int32 FX     = x % Cell;
+        const int32 Top    = G0[GX] * (Cell - FX) + G0[GX + 1] * FX;
+        const int32 Bot    = G1[GX] * (Cell - FX) + G1[GX + 1] * FX;
+        const int32 Smooth = (Top * (Cell - FY) + Bot * FY) / (Cell * Cell);
+        const int32 Detail = (int32)(xHash(~m_Params.Seed, CmpIdx, y * Width + x) & 0x0FFF) - 0x0800;
+        Texture[(uintSize)y * Width + x] = (uint16)xClip<int32>(Smooth + Detail, 0, 0xFFFF);
+      }
+    }
+  }
+}
+void xSeqGen::destroy()
+{
+  for(int32 CmpIdx = 0; CmpIdx < xPicCommon::c_DefNumCmps; CmpIdx++) { m_Texture[CmpIdx].clear(); m_Texture[CmpIdx].shrink_to_fit(); }
+}
+void xSeqGen::genFrame(xPicP* Pic, eSeq Seq, int32 FrameIdx) const
+{
+  assert(Pic != nullptr && Pic->isSameSize(m_Params.Size.getX(), m_Params.Size.getY()));
+  xStageTimer::xScope Scope(xc_StageSeqGen, (int64)m_Params.Size.getX() * m_Params.Size.getY());
+
+  switch(Seq)
+  {
+    case eSeq::Ref: xGenRef(Pic, FrameIdx); break;
+    case eSeq::Tst: xGenTst(Pic, FrameIdx); break;
+    case eSeq::Msk: xGenMsk(Pic, FrameIdx); break;
+    default: assert(0); break;
+  }
+}
+xSeq::tResult xSeqGen::writeSequence(const std::string& FileName, eSeq Seq, int32 FirstFrame, int32 NumFrames, int32 BitDepth, int32 ChromaFormat) const
+{
+  xSeq  Sequence(m_Params.Size, BitDepth, ChromaFormat);
+  xPicP Picture (m_Params.Size, BitDepth, 0);
+
+  xSeq::tResult OpenResult = Sequence.openFile(FileName, xSeq::eMode::Write);
+  if(OpenResult != xSeq::eRetv::Success) { return OpenResult; }
+
+  for(int32 f = 0; f < NumFrames; f++)
+  {
+    genFrame(&Picture, Seq, FirstFrame + f);
+    xSeq::tResult WriteResult = Sequence.writeFrame(&Picture);
+    if(WriteResult != xSeq::eRetv::Success) { Sequence.closeFile(); return WriteResult; }
+  }
+  return Sequence.closeFile();
+}
+
+//===============================================================================================================================================================================================================
+// xSeqGen - generators
+//===============================================================================================================================================================================================================
+void xSeqGen::xGenRef(xPicP* Pic, int32 FrameIdx) const
+{
+  const int32 DownShift = 16 - Pic->getBitDepth();
+  const int32 Stride    = Pic->getStride();
+
+  for(int32 CmpIdx = 0; CmpIdx < xPicCommon::c_DefNumCmps; CmpIdx++)
+  {
+    const int32   Shift   = CmpIdx == 0 ? 0 : m_ChromaShift;
+    const int32   Width   = m_CmpSize[CmpIdx].getX();
+    const int32   Height  = m_CmpSize[CmpIdx].getY();
+    const int32   OffsetX = xWrap((FrameIdx * m_Params.Motion.getX()) >> Shift, Width );
+    const int32   OffsetY = xWrap((FrameIdx * m_Params.Motion.getY()) >> Shift, Height);
+    const uint16* Texture = m_Texture[CmpIdx].data();
+    uint16*       Dst     = Pic->getAddr((eCmp)CmpIdx);
+
+    for(int32 y = 0; y < Height; y++)
+    {
+      const uint16* TexRow = Texture + (uintSize)xWrap(y + OffsetY, Height) * Width;
+      uint16*       DstRow = Dst + (y << Shift) * Stride;
+      int32         TX     = OffsetX;
+      for(int32 x = 0; x < Width; x++)
+      {
+        xPutSample(DstRow + (x << Shift), Stride, Shift, (uint16)(TexRow[TX] >> DownShift));
+        if(++TX == Width) { TX = 0; }
+      }
+    }
+  }
+}
+void xSeqGen::xGenTst(xPicP* Pic, int32 FrameIdx) const
+{
+  const int32 DownShift = 16 - Pic->getBitDepth();
+  const int32 MaxValue  = xBitDepth2MaxValue(Pic->getBitDepth());
+  const int32 Stride    = Pic->getStride();
+  const int32 NoiseAmp  = m_Params.NoiseAmp;
+  const int32 NoiseSpan = 2 * NoiseAmp + 1;
+
+  for(int32 CmpIdx = 0; CmpIdx < xPicCommon::c_DefNumCmps; CmpIdx++)
+  {
+    const int32   Shift     = CmpIdx == 0 ? 0 : m_ChromaShift;
+    const int32   Width     = m_CmpSize[CmpIdx].getX();
+    const int32   Height    = m_CmpSize[CmpIdx].getY();
+    const int32   OffsetX   = xWrap(((FrameIdx * m_Params.Motion.getX()) >> Shift) - (m_Params.Shift.getX() >> Shift), Width );
+    const int32   OffsetY   = xWrap(((FrameIdx * m_Params.Motion.getY()) >> Shift) - (m_Params.Shift.getY() >> Shift), Height);
+    const int32   ColorOff  = m_Params.ColorOffset[CmpIdx];
+    const uint32  FrameSeed = xHash(m_Params.Seed, (uint32)FrameIdx, (uint32)CmpIdx + 1);
+    const uint16* Texture   = m_Texture[CmpIdx].data();
+    uint16*       Dst       = Pic->getAddr((eCmp)CmpIdx);
+
+    for(int32 y = 0; y < Height; y++)
+    {
+      const uint16* TexRow = Texture + (uintSize)xWrap(y + OffsetY, Height) * Width;
+      uint16*       DstRow = Dst + (y << Shift) * Stride;
+      int32         TX     = OffsetX;
+      for(int32 x = 0; x < Width; x++)
+      {
+        int32 Value = (TexRow[TX] >> DownShift) + ColorOff;
+        if(NoiseAmp > 0) { Value += (int32)(xHash(FrameSeed, (uint32)x, (uint32)y) % (uint32)NoiseSpan) - NoiseAmp; }
+        xPutSample(DstRow + (x << Shift), Stride, Shift, (uint16)xClip<int32>(Value, 0, MaxValue));
+        if(++TX == Width) { TX = 0; }
+      }
+    }
+  }
+}
+void xSeqGen::xGenMsk(xPicP* Pic, int32 FrameIdx) const
+{
+  const uint16 MaxValue = Pic->getMaxPelValue();
+  const int32  Stride   = Pic->getStride();
+  const int32  MotionX  = FrameIdx * m_Params.Motion.getX();
+  const int32  MotionY  = FrameIdx * m_Params.Motion.getY();
+
+  for(int32 CmpIdx = 0; CmpIdx < xPicCommon::c_DefNumCmps; CmpIdx++)
+  {
+    const int32 Shift  = CmpIdx == 0 ? 0 : m_ChromaShift;
+    const int32 Width  = m_CmpSize[CmpIdx].getX();
+    const int32 Height = m_CmpSize[CmpIdx].getY();
+    uint16*     Dst    = Pic->getAddr((eCmp)CmpIdx);
+
+    for(int32 y = 0; y < Height; y++)
+    {
+      const int32 BlockY = xFloorDiv((y << Shift) + MotionY, c_MaskBlock);
+      uint16*     DstRow = Dst + (y << Shift) * Stride;
+      for(int32 x = 0; x < Width; x++)
+      {
+        const int32 BlockX = xFloorDiv((x << Shift) + MotionX, c_MaskBlock);
+        xPutSample(DstRow + (x << Shift), Stride, Shift, ((BlockX + BlockY) & 1) ? MaxValue : 0);
+      }
+    }
+  }
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,124 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include "xPic.h"
+#include "xSeq.h"
+#include <vector>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xSeqGen - deterministic synthetic sequence generator
+//   Ref - smooth random texture moving with constant velocity (wraps around picture borders)
+//   Tst - Ref displaced by Shift, with per component ColorOffset and uniform noise in [-NoiseAmp, NoiseAmp]
+//   Msk - moving checkerboard of 0 / MaxValue blocks
+// Every sample depends only on (Seed, FrameIdx, position) - frames can be generated in any order and from any thread.
+// For 420 each chroma 2x2 block is constant, so generated pictures are identical to pictures written and read back by xSeq.
+//===============================================================================================================================================================================================================
+class xSeqGen
+{
+public:
+  enum class eSeq : int32 { Ref, Tst, Msk };
+
+  static constexpr uint32 c_DefSeed     = 0x5E96E17;
+  static constexpr int32  c_TextureCell = 16; //coarse texture grid cell size (in component samples)
+  static constexpr int32  c_MaskBlock   = 64; //mask checkerboard block size (in luma samples)
+
+  struct xParams
+  {
+    int32V2 Size         = { NOT_VALID, NOT_VALID };
+    int32   BitDepth     = 8;
+    int32   ChromaFormat = 420;
+    uint32  Seed         = c_DefSeed;
+    int32   NoiseAmp     = NOT_VALID;      //NOT_VALID = getDefNoiseAmp(BitDepth)
+    int32V2 Shift        = { 0, 0 };       //Tst displacement (in luma samples)
+    int32V4 ColorOffset  = { 0, 0, 0, 0 }; //Tst per component offset
+    int32V2 Motion       = { 2, 2 };       //Ref and Msk velocity (in luma samples per frame, even values keep 420 chroma aligned)
+  };
+
+protected:
+  xParams             m_Params;
+  int32               m_ChromaShift = 0;
+  int32V2             m_CmpSize [xPicCommon::c_DefNumCmps];
+  std::vector<uint16> m_Texture [xPicCommon::c_DefNumCmps]; //16 bit texture, component resolution
+
+public:
+  xSeqGen() {}
+  xSeqGen(const xParams& Params) { create(Params); }
+  ~xSeqGen() { destroy(); }
+
+  void create (const xParams& Params);
+  void destroy();
+
+  void          genFrame     (xPicP* Pic, eSeq Seq, int32 FrameIdx) const; //output bit depth is taken from Pic
+  xSeq::tResult writeSequence(const std::string& FileName, eSeq Seq, int32 FirstFrame, int32 NumFrames, int32 BitDepth, int32 ChromaFormat) const;
+
+  const xParams& getParams() const { return m_Params; }
+
+  static int32 getDefNoiseAmp(int32 BitDepth) { return xMax(1, xBitDepth2MaxValue(BitDepth) >> 6); }
+  static std::string_view SeqToString(eSeq Seq);
+
+protected:
+  void xGenRef(xPicP* Pic, int32 FrameIdx) const;
+  void xGenTst(xPicP* Pic, int32 FrameIdx) const;
+  void xGenMsk(xPicP* Pic, int32 FrameIdx) const;
+
+  //writes component value computed for component sample grid position into all covered picture samples
+  static inline void xPutSample(uint16* Addr, int32 Stride, int32 Shift, uint16 Value)
+  {
+    if(Shift == 0) { Addr[0] = Value; return; }
+    Addr[0] = Value; Addr[1] = Value; Addr[Stride] = Value; Addr[Stride + 1] = Value;
+  }
+  static inline int32 xWrap    (int32 Value, int32 Size) { const int32 R = Value % Size; return R < 0 ? R + Size : R; }
+  static inline int32 xFloorDiv(int32 Value, int32 Size) { return (Value - xWrap(Value, Size)) / Size; }
+  static inline uint32 xHash(uint32 A, uint32 B, uint32 C)
+  {
+    uint32 H = A ^ (B * 0x9E3779B1u) ^ (C * 0x85EBCA77u);
+    H ^= H >> 16; H *= 0x7FEB352Du;
+    H ^= H >> 15; H *= 0x846CA68Bu;
+    H ^= H >> 16;
+    return H;
+  }
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,215 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+#include "xStageTimer.h"
+#include <mutex>
+#include <fstream>
+#include <algorithm>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+namespace {
+
+struct alignas(64) xStage
+{
+  std::string          Name;
+  std::atomic<int64>   FrameNs     = 0; //current frame accumulators
+  std::atomic<int64>   FrameCalls  = 0;
+  std::atomic<int64>   FramePixels = 0;
+  int64                TotalCalls  = 0;
+  int64                TotalPixels = 0;
+  std::vector<int64>   FrameSamples;    //per frame time [ns]
+};
+
+struct xRegistry
+{
+  std::mutex         Mutex;
+  std::atomic<int32> NumStages = 0;
+  xStage             Stages[xStageTimer::c_MaxNumStages];
+};
+
+xRegistry& xGetRegistry() { static xRegistry Registry; return Registry; }
+
+std::string xEscapeJSON(const std::string& Src)
+{
+  std::string Dst;
+  for(char C : Src)
+  {
+    if     (C == '"' ) { Dst += "\\\""; }
+    else if(C == '\\') { Dst += "\\\\"; }
+    else if((uint8)C < 0x20) { Dst += fmt::sprintf("\\u%04x", (int32)C); }
+    else               { Dst += C; }
+  }
+  return Dst;
+}
+
+} //end of anonymous namespace
+
+//===============================================================================================================================================================================================================
+
+xStageTimer::tStageId xStageTimer::registerStage(const std::string& Name)
+{
+  xRegistry& Registry = xGetRegistry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  const int32 NumStages = Registry.NumStages.load(std::memory_order_relaxed);
+  for(int32 s = 0; s < NumStages; s++) { if(Registry.Stages[s].Name == Name) { return s; } }
+  if(NumStages >= c_MaxNumStages) { assert(0); return NOT_VALID; }
+  Registry.Stages[NumStages].Name = Name;
+  Registry.NumStages.store(NumStages + 1, std::memory_order_release);
+  return NumStages;
+}
+void xStageTimer::addSample(tStageId StageId, tDuration Duration, int64 NumPixels)
+{
+  if(StageId < 0 || StageId >= c_MaxNumStages) { return; }
+  xStage& Stage = xGetRegistry().Stages[StageId];
+  Stage.FrameNs    .fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(Duration).count(), std::memory_order_relaxed);
+  Stage.FrameCalls .fetch_add(1        , std::memory_order_relaxed);
+  Stage.FramePixels.fetch_add(NumPixels, std::memory_order_relaxed);
+}
+void xStageTimer::reserveFrames(int32 NumFrames)
+{
+  xRegistry& Registry = xGetRegistry();
+  for(int32 s = 0; s < c_MaxNumStages; s++) { Registry.Stages[s].FrameSamples.reserve(NumFrames); }
+}
+void xStageTimer::finishFrame()
+{
+  xRegistry& Registry = xGetRegistry();
+  const int32 NumStages = Registry.NumStages.load(std::memory_order_acquire);
+  for(int32 s = 0; s < NumStages; s++)
+  {
+    xStage& Stage = Registry.Stages[s];
+    const int64 FrameCalls = Stage.FrameCalls.exchange(0, std::memory_order_relaxed);
+    const int64 FrameNs    = Stage.FrameNs   .exchange(0, std::memory_order_relaxed);
+    const int64 FramePels  = Stage.FramePixels.exchange(0, std::memory_order_relaxed);
+    if(FrameCalls == 0) { continue; }
+    Stage.TotalCalls  += FrameCalls;
+    Stage.TotalPixels += FramePels;
+    Stage.FrameSamples.push_back(FrameNs);
+  }
+}
+void xStageTimer::reset()
+{
+  xRegistry& Registry = xGetRegistry();
+  for(int32 s = 0; s < c_MaxNumStages; s++)
+  {
+    xStage& Stage = Registry.Stages[s];
+    Stage.FrameNs    .store(0, std::memory_order_relaxed);
+    Stage.FrameCalls .store(0, std::memory_order_relaxed);
+    Stage.FramePixels.store(0, std::memory_order_relaxed);
+    Stage.TotalCalls  = 0;
+    Stage.TotalPixels = 0;
+    Stage.FrameSamples.clear();
+  }
+}
+int32 xStageTimer::getNumStages()
+{
+  return xGetRegistry().NumStages.load(std::memory_order_acquire);
+}
+const char* xStageTimer::getStageName(tStageId StageId)
+{
+  if(StageId < 0 || StageId >= c_MaxNumStages) { return "INVALID"; }
+  return xGetRegistry().Stages[StageId].Name.c_str();
+}
+xStageTimer::xSummary xStageTimer::getSummary(tStageId StageId)
+{
+  xSummary Summary;
+  if(StageId < 0 || StageId >= getNumStages()) { return Summary; }
+  const xStage& Stage = xGetRegistry().Stages[StageId];
+
+  Summary.Name      = Stage.Name;
+  Summary.NumFrames = (int32)Stage.FrameSamples.size();
+  Summary.NumCalls  = Stage.TotalCalls;
+  Summary.NumPixels = Stage.TotalPixels;
+  if(Summary.NumFrames == 0) { return Summary; }
+
+  std::vector<int64> Sorted = Stage.FrameSamples;
+  std::sort(Sorted.begin(), Sorted.end());
+  int64 TotalNs = 0;
+  for(int64 Ns : Sorted) { TotalNs += Ns; }
+
+  auto Ms = [](int64 Ns) { return (flt64)Ns / 1e6; };
+  const int32 N     = Summary.NumFrames;
+  Summary.TotalMs   = Ms(TotalNs);
+  Summary.AvgMs     = Summary.TotalMs / N;
+  Summary.MinMs     = Ms(Sorted.front());
+  Summary.MedianMs  = (N & 1) ? Ms(Sorted[N >> 1]) : (Ms(Sorted[(N >> 1) - 1]) + Ms(Sorted[N >> 1])) / 2;
+  Summary.P99Ms     = Ms(Sorted[xMin(N - 1, (int32)std::ceil(0.99 * N) - 1)]);
+  Summary.MaxMs     = Ms(Sorted.back());
+  Summary.MPixPerS  = TotalNs > 0 ? (flt64)Summary.NumPixels / ((flt64)TotalNs / 1e3) : 0;
+
+  const int64 MaxUs = xMax(Sorted.back() / 1000, (int64)1);
+  Summary.Histogram.assign(xFastLog2((uint64)MaxUs) + 1, 0);
+  for(int64 Ns : Sorted) { Summary.Histogram[Ns >= 2000 ? xFastLog2((uint64)(Ns / 1000)) : 0]++; }
+
+  return Summary;
+}
+std::vector<xStageTimer::xSummary> xStageTimer::getSummary()
+{
+  std::vector<xSummary> Summaries;
+  const int32 NumStages = getNumStages();
+  for(int32 s = 0; s < NumStages; s++) { Summaries.push_back(getSummary(s)); }
+  return Summaries;
+}
+std::string xStageTimer::formatJSON()
+{
+  std::vector<xSummary> Summaries = getSummary();
+  std::string Result = "{\n  \"Stages\": [\n";
+  for(int32 s = 0; s < (int32)Summaries.size(); s++)
+  {
+    const xSummary& S = Summaries[s];
+    std::string Histogram;
+    for(int32 b = 0; b < (int32)S.Histogram.size(); b++) { Histogram += fmt::sprintf(b ? ", %d" : "%d", S.Histogram[b]); }
+    Result += fmt::sprintf("    {\"Name\": \"%s\", \"Frames\": %d, \"Calls\": %d, \"Pixels\": %d, \"TotalMs\": %.4f, \"AvgMs\": %.4f, \"MinMs\": %.4f, \"MedianMs\": %.4f, \"P99Ms\": %.4f, \"MaxMs\": %.4f, \"MPixPerS\": %.2f, \"HistogramLog2Us\": [%s]}%s\n",
+      xEscapeJSON(S.Name), S.NumFrames, S.NumCalls, S.NumPixels, S.TotalMs, S.AvgMs, S.MinMs, S.MedianMs, S.P99Ms, S.MaxMs, S.MPixPerS, Histogram, s + 1 < (int32)Summaries.size() ? "," : "");
+  }
+  Result += "  ]\n}\n";
+  return Result;
+}
+bool xStageTimer::writeJSON(const std::string& FilePath)
+{
+  std::ofstream File(FilePath, std::ios::out | std::ios::trunc);
+  if(!File.is_open()) { return false; }
+  File << formatJSON();
+  return File.good();
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,123 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include "xTrace.h"
+#include <vector>
+#include <atomic>
+#include <string>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xStageTimer - process wide registry of named processing stages with scoped timers
+// - stages are registered once (usually as static const in translation unit which uses them)
+// - time of all scopes of given stage is accumulated over a frame (from any thread) and becomes single per-frame sample on finishFrame()
+//   (for stages executed concurrently by several threads the sample is a sum of thread times, not a wall time)
+// - scopes are also recorded as timeline events when xTrace is enabled
+// - when disabled, scope costs two relaxed atomic loads
+//===============================================================================================================================================================================================================
+class xStageTimer
+{
+public:
+  using tStageId = int32;
+  static constexpr int32 c_MaxNumStages = 64;
+
+  class xScope
+  {
+  protected:
+    tStageId   m_StageId;
+    int64      m_NumPixels;
+    tTimePoint m_Beg;
+
+  public:
+    xScope(tStageId StageId, int64 NumPixels = 0) { m_StageId = (isEnabled() || xTrace::isEnabled()) ? StageId : NOT_VALID; m_NumPixels = NumPixels; if(m_StageId != NOT_VALID) { m_Beg = tClock::now(); } }
+    ~xScope()
+    {
+      if(m_StageId == NOT_VALID) { return; }
+      const tTimePoint End = tClock::now();
+      if(isEnabled()        ) { addSample(m_StageId, End - m_Beg, m_NumPixels); }
+      if(xTrace::isEnabled()) { xTrace::addComplete(getStageName(m_StageId), "stage", m_Beg, End); }
+    }
+
+    xScope(const xScope&) = delete;
+    xScope& operator=(const xScope&) = delete;
+  };
+
+  class xSummary
+  {
+  public:
+    std::string Name;
+    int32  NumFrames = 0; //number of frames in which stage was executed
+    int64  NumCalls  = 0;
+    int64  NumPixels = 0;
+    flt64  TotalMs   = 0;
+    flt64  AvgMs     = 0; //per frame values
+    flt64  MinMs     = 0;
+    flt64  MedianMs  = 0;
+    flt64  P99Ms     = 0;
+    flt64  MaxMs     = 0;
+    flt64  MPixPerS  = 0; //throughput (pixels passed to scopes / total time)
+    std::vector<int64> Histogram; //log2(us) histogram of per-frame times - bin b counts frames in [2^b, 2^(b+1)) us
+  };
+
+protected:
+  static inline std::atomic<bool> m_Enabled = false;
+
+public:
+  static tStageId registerStage(const std::string& Name); //returns id of already registered stage with same name
+  static void     setEnabled   (bool Enabled) { m_Enabled.store(Enabled, std::memory_order_relaxed); }
+  static bool     isEnabled    (            ) { return m_Enabled.load(std::memory_order_relaxed); }
+  static void     addSample    (tStageId StageId, tDuration Duration, int64 NumPixels);
+  static void     reserveFrames(int32 NumFrames);
+  static void     finishFrame  (); //must not overlap with any active scope
+  static void     reset        ();
+
+  static int32                 getNumStages();
+  static const char*           getStageName(tStageId StageId); //pointer is valid until program exit
+  static xSummary              getSummary  (tStageId StageId);
+  static std::vector<xSummary> getSummary  ();
+  static std::string           formatJSON  ();
+  static bool                  writeJSON   (const std::string& FilePath);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -37,6 +37,7 @@ THE POSSIBILITY OF SUCH DAMAGE.
 ############################################################################ */
 
 #include "xThreadPool.h"
+#include "xPerfCounters.h"
 
 using namespace std::chrono_literals;
 
@@ -44,7 +45,7 @@ namespace PMBB_NAMESPACE {
 
 //===============================================================================================================================================================================================================
 
-void xThreadPool::create(int32 NumThreads, int32 WaitingQueueSize)
+void xThreadPool::create(int32 NumThreads, int32 WaitingQueueSize, eAffinity Affinity)
 {
   assert(NumThreads      >0);
   assert(WaitingQueueSize>0);
@@ -52,11 +53,42 @@ void xThreadPool::create(int32 NumThreads, int32 WaitingQueueSize)
   m_NumThreads = NumThreads;
   m_WaitingTasks.setSize(WaitingQueueSize);
 
+  //workers are split into contiguous groups - one group per NUMA node with cpus allowed by process affinity mask
+  m_Affinity     = Affinity;
+  m_NumPinFailed = 0;
+  m_NodeCpus.clear();
+  m_PoolNode.assign(xTopology::getNumNodes(), NOT_VALID);
+  if(m_Affinity != eAffinity::None)
+  {
+    for(int32 n = 0; n < xTopology::getNumNodes() && (int32)m_NodeCpus.size() < m_NumThreads; n++)
+    {
+      std::vector<int32> NodeCpus = xTopology::getAllowedNodeCpus(n);
+      if(NodeCpus.empty()) { continue; } //node without allowed cpus
+      m_PoolNode[n] = (int32)m_NodeCpus.size();
+      m_NodeCpus.push_back(std::move(NodeCpus));
+    }
+  }
+  m_NumNodes = xMax((int32)m_NodeCpus.size(), 1);
+  m_ThreadNode.resize(m_NumThreads);
+  for(int32 i=0; i<m_NumThreads; i++) { m_ThreadNode[i] = (int32)(((int64)i * m_NumNodes) / m_NumThreads); }
+
+  if(m_StatsEnabled) { m_WorkerStats = std::vector<xThreadPoolStats::xAccumulator>(m_NumThreads); m_StatsBeg = tClock::now(); }
+
   for(int32 i=0; i<m_NumThreads; i++)
   {
     std::packaged_task<uint32(xThreadPool*)> PackagedTask(xThreadStarter);
     m_Future.push_back(PackagedTask.get_future());
     std::thread Thread = std::thread(std::move(PackagedTask), this);
+    if(m_Affinity != eAffinity::None) //workers are blocked on m_Event until all affinities are set
+    {
+      std::vector<int32> NodeCpus = m_ThreadNode[i] < (int32)m_NodeCpus.size() ? m_NodeCpus[m_ThreadNode[i]] : std::vector<int32>();
+      if(m_Affinity == eAffinity::Core && !NodeCpus.empty())
+      {
+        const int32 FirstInNode = (int32)std::distance(m_ThreadNode.begin(), std::find(m_ThreadNode.begin(), m_ThreadNode.end(), m_ThreadNode[i]));
+        NodeCpus = { NodeCpus[(i - FirstInNode) % (int32)NodeCpus.size()] };
+      }
+      if(!xTopology::setThreadAffinity(Thread, NodeCpus)) { m_NumPinFailed++; }
+    }
     m_ThreadId.push_back(Thread.get_id());
     m_Thread  .push_back(std::move(Thread));      
   } 
@@ -92,9 +124,9 @@ void xThreadPool::destroy()
     }
   }
 
-  for(std::pair<const uintPtr, xQueue<xWorkerTask*>>& Pair : m_CompletedTasks)
+  for(std::pair<const uintPtr, xQueueLF<xWorkerTask*>>& Pair : m_CompletedTasks)
   {
-    xQueue<xWorkerTask*>& CompletedTaskQueue = Pair.second;
+    xQueueLF<xWorkerTask*>& CompletedTaskQueue = Pair.second;
     int32 NumCompleted = (int32)CompletedTaskQueue.getLoad();
     for(int32 i=0; i<NumCompleted; i++)
     {
@@ -109,13 +141,18 @@ bool xThreadPool::registerClient(uintPtr ClientId, int32 CompletedQueueSize)
   if(m_CompletedTasks.find(ClientId) != m_CompletedTasks.end()) { return false; }
 
   m_CompletedTasks.emplace(ClientId, CompletedQueueSize);
+  if(m_StatsEnabled && m_ClientStats.find(ClientId) == m_ClientStats.end()) //statistics of unregistered clients are retained until pool is destroyed
+  {
+    m_ClientStats.emplace(std::piecewise_construct, std::forward_as_tuple(ClientId), std::forward_as_tuple());
+    m_ClientOrder.emplace(ClientId, (int32)m_ClientOrder.size());
+  }
   return true;
 }
 bool xThreadPool::unregisterClient(uintPtr ClientId)
 {
   if(m_CompletedTasks.find(ClientId) == m_CompletedTasks.end()) { return false; }
 
-  xQueue<xWorkerTask*>& CompletedTaskQueue = m_CompletedTasks.at(ClientId);
+  xQueueLF<xWorkerTask*>& CompletedTaskQueue = m_CompletedTasks.at(ClientId);
   int32 NumCompleted = (int32)CompletedTaskQueue.getLoad();
   for(int32 i=0; i<NumCompleted; i++)
   {
@@ -132,6 +169,9 @@ uint32 xThreadPool::xThreadFunc()
   m_Event.wait();
   std::thread::id ThreadId = std::this_thread::get_id();
   int32 ThreadIdx = (int32)(std::find(m_ThreadId.begin(), m_ThreadId.end(), ThreadId) - m_ThreadId.begin());
+  if(xTrace::isEnabled()) { xTrace::setThreadName(fmt::sprintf("Worker%d", ThreadIdx)); }
+  if(xPerfCounters::isEnabled()) { xPerfCounters::registerThread(); }
+  tTimePoint IdleBeg = m_StatsEnabled ? tClock::now() : tTimePoint::min();
   while(1)
   {    
     xWorkerTask* Task;
@@ -140,12 +180,52 @@ uint32 xThreadPool::xThreadFunc()
     {
       delete Task; break;
     }
-    xWorkerTask::StarterFunction(Task, ThreadIdx);
-    m_CompletedTasks.at(Task->getClientId()).EnqueueWait(Task);
+    const bool TraceEnabled = xTrace::isEnabled();
+    if(m_StatsEnabled || TraceEnabled)
+    {
+      tTimePoint TaskBeg = tClock::now();
+      xWorkerTask::StarterFunction(Task, ThreadIdx);
+      tTimePoint TaskEnd = tClock::now();
+      if(TraceEnabled) { xTrace::addComplete(Task->getTraceName(), "pool", TaskBeg, TaskEnd); }
+      if(m_StatsEnabled)
+      {
+        const int64 QueueNs = std::chrono::duration_cast<std::chrono::nanoseconds>(TaskBeg - Task->getEnqueueTime()).count();
+        const int64 TaskNs  = std::chrono::duration_cast<std::chrono::nanoseconds>(TaskEnd - TaskBeg               ).count();
+        m_WorkerStats[ThreadIdx].addIdle(std::chrono::duration_cast<std::chrono::nanoseconds>(TaskBeg - IdleBeg).count());
+        m_WorkerStats[ThreadIdx].addTask(QueueNs, TaskNs);
+        m_ClientStats.at(Task->getClientId()).addTask(QueueNs, TaskNs); //recorded before completion is signalled - snapshot taken after wait includes this task
+      }
+      IdleBeg = TaskEnd;
+    }
+    else
+    {
+      xWorkerTask::StarterFunction(Task, ThreadIdx);
+    }
+    xLatch* Latch = Task->getLatch();
+    if(Latch != nullptr) { Latch->countDown(); } //task owned by client - must not be touched after countDown
+    else                 { m_CompletedTasks.at(Task->getClientId()).EnqueueWait(Task); }
   }
   return EXIT_SUCCESS;
 }
 
+xThreadPoolStats::xSnapshot xThreadPool::getStatistics()
+{
+  xThreadPoolStats::xSnapshot Snapshot;
+  if(!m_StatsEnabled) { return Snapshot; }
+  Snapshot.NumThreads = m_NumThreads;
+  Snapshot.WallNs     = std::chrono::duration_cast<std::chrono::nanoseconds>(tClock::now() - m_StatsBeg).count();
+  for(const xThreadPoolStats::xAccumulator& Worker : m_WorkerStats) { Snapshot.Workers.push_back(Worker.get()); }
+  for(const std::pair<const uintPtr, xThreadPoolStats::xAccumulator>& Pair : m_ClientStats) { Snapshot.Clients.emplace(m_ClientOrder.at(Pair.first), Pair.second.get()); }
+  return Snapshot;
+}
+void xThreadPool::resetStatistics()
+{
+  if(!m_StatsEnabled) { return; }
+  for(xThreadPoolStats::xAccumulator& Worker : m_WorkerStats) { Worker.reset(); }
+  for(std::pair<const uintPtr, xThreadPoolStats::xAccumulator>& Pair : m_ClientStats) { Pair.second.reset(); }
+  m_StatsBeg = tClock::now();
+}
+
 //===============================================================================================================================================================================================================
 
 void xThreadPool::xWorkerTask::StarterFunction(xWorkerTask* WorkerTask, int32 ThreadIdx)
@@ -163,12 +243,23 @@ void xThreadPoolInterface::init(xThreadPool* ThreadPool, int32 CompletedQueueSiz
   m_ThreadPool = ThreadPool;
   m_ThreadPool->registerClient(getClientId(), CompletedQueueSize);
   m_NumChunks  = m_ThreadPool->getNumThreads();
+
+  m_ParallelForSegments = std::vector<xParallelForSegment>(m_ThreadPool->getNumNodes());
+  m_ParallelForTasks.clear();
+  m_ParallelForTasks.reserve(m_ThreadPool->getNumThreads());
+  for(int32 i = 0; i < m_ThreadPool->getNumThreads(); i++)
+  {
+    m_ParallelForTasks.emplace_back(this);
+    m_ParallelForTasks.back().setClientId(getClientId());
+    m_ParallelForTasks.back().setLatch   (&m_ParallelForLatch);
+  }
 }
 void xThreadPoolInterface::uininit()
 {
   if(m_ThreadPool == nullptr) { return; }
   m_ThreadPool->unregisterClient(getClientId());
   m_ThreadPool = nullptr;
+  m_ParallelForTasks.clear();
 }
 void xThreadPoolInterface::addWaitingTask(xThreadPool::xWorkerTask* Task)
 { 
@@ -194,6 +285,57 @@ void xThreadPoolInterface::executeTask(std::function<void(int32)> Function)
   addWaitingTask(Function);
   waitUntilTasksFinished(1);
 }
+void xThreadPoolInterface::xParallelFor(int32 Range, int32 Grain, const void* Body, fRangeFunc Func)
+{
+  if(Range <= 0) { return; }
+
+  const int32 NumThreads = isActive() ? (int32)m_ParallelForTasks.size() : 0;
+  if(Grain <= 0) { Grain = xMax(1, Range / xMax(1, NumThreads * 4)); }
+  const int32 NumChunks  = (Range + Grain - 1) / Grain;
+  const int32 NumHelpers = xMin(NumThreads, NumChunks - 1); //calling thread takes one share
+
+  if(NumHelpers <= 0) { Func(Body, 0, Range); return; }
+
+  m_ParallelForGrain = Grain;
+  m_ParallelForBody  = Body;
+  m_ParallelForFunc  = Func;
+  const int32 NumSegments = (int32)m_ParallelForSegments.size();
+  for(int32 s = 0; s < NumSegments; s++)
+  {
+    m_ParallelForSegments[s].Next.store((int32)(((int64)Range *  s     ) / NumSegments), std::memory_order_relaxed);
+    m_ParallelForSegments[s].End =      (int32)(((int64)Range * (s + 1)) / NumSegments);
+  }
+  m_ParallelForLatch.reset(NumHelpers);
+
+  for(int32 i = 0; i < NumHelpers; i++)
+  {
+    xWorkerTaskParallelFor& Task = m_ParallelForTasks[i];
+    Task.setPriority(m_Priority);
+    Task.setStatus  (xThreadPool::eTaskStatus::Waiting);
+    m_ThreadPool->addWaitingTask(&Task);
+  }
+
+  xParallelForWorker(NOT_VALID);
+  m_ParallelForLatch.wait();
+}
+void xThreadPoolInterface::xParallelForWorker(int32 ThreadIdx)
+{
+  const int32 Grain       = m_ParallelForGrain;
+  const int32 NumSegments = (int32)m_ParallelForSegments.size();
+  const int32 HomeSegment = NumSegments > 1 ? m_ThreadPool->getThreadNode(ThreadIdx) : 0;
+  for(int32 s = 0; s < NumSegments; s++)
+  {
+    xParallelForSegment& Segment = m_ParallelForSegments[(HomeSegment + s) % NumSegments];
+    const int32 End = Segment.End;
+    while(1)
+    {
+      const int32 Beg = Segment.Next.fetch_add(Grain, std::memory_order_relaxed);
+      if(Beg >= End) { break; }
+      xTrace::xScope Scope("Chunk", "parallelFor", Beg);
+      m_ParallelForFunc(m_ParallelForBody, Beg, xMin(Beg + Grain, End));
+    }
+  }
+}
 
 //===============================================================================================================================================================================================================
 
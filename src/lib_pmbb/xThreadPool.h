@@ -41,9 +41,13 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include "xCommonDefPMBB.h"
 #include "xQueue.h"
 #include "xEvent.h"
+#include "xTopology.h"
+#include "xThreadPoolStats.h"
+#include "xTrace.h"
 #include <vector>
 #include <map>
 #include <future>
+#include <atomic>
 
 namespace PMBB_NAMESPACE {
 
@@ -62,6 +66,8 @@ public:
     Terminate,
   };
 
+  using eAffinity = xTopology::eAffinity;
+
 public:
   class xWorkerTask
   {
@@ -72,13 +78,15 @@ public:
     uintPtr     m_ClientId;
     int8        m_Priority;
     eTaskStatus m_Status;
+    xLatch*     m_Latch; //if set, task is owned by client and completion is signalled by latch instead of completed queue
+    tTimePoint  m_EnqueueTime; //used only if statistics are enabled
 
   protected:
     virtual void WorkingFunction(int32 ThreadIdx) = 0;
 
   public:
-             xWorkerTask(                               ) { m_ClientId = (uintPtr)nullptr;  m_Priority = c_DefaultPriority; m_Status = eTaskStatus::UNKNOWN; }
-             xWorkerTask(uintPtr ClientId, int8 Priority) { m_ClientId = ClientId;          m_Priority = Priority;          m_Status = eTaskStatus::UNKNOWN; }
+             xWorkerTask(                               ) { m_ClientId = (uintPtr)nullptr;  m_Priority = c_DefaultPriority; m_Status = eTaskStatus::UNKNOWN; m_Latch = nullptr; }
+             xWorkerTask(uintPtr ClientId, int8 Priority) { m_ClientId = ClientId;          m_Priority = Priority;          m_Status = eTaskStatus::UNKNOWN; m_Latch = nullptr; }
     virtual ~xWorkerTask(                               ) { }
 
     static  void StarterFunction(xWorkerTask* WorkerTask, int32 ThreadIdx);
@@ -89,6 +97,12 @@ public:
     int8         getPriority (                     ){ return m_Priority; }
     void         setStatus   (eTaskStatus Status   ){ m_Status = Status; }
     eTaskStatus  getStatus   (                     ){ return m_Status; }
+    void         setLatch    (xLatch*     Latch    ){ m_Latch = Latch; }
+    xLatch*      getLatch    (                     ){ return m_Latch; }
+    void         setEnqueueTime(tTimePoint Time    ){ m_EnqueueTime = Time; }
+    tTimePoint   getEnqueueTime(                   ){ return m_EnqueueTime; }
+
+    virtual const char* getTraceName() const { return "Task"; } //name presented in timeline trace
 
   public:
     class Comparator
@@ -108,6 +122,8 @@ public:
 
   protected:
     void WorkingFunction(int32 ThreadIdx) final { m_Function(ThreadIdx); }
+  public:
+    const char* getTraceName() const final { return "TaskFunction"; }
   };
 
 protected:
@@ -127,11 +143,26 @@ protected:
   std::vector<std::thread>         m_Thread;
   std::vector<std::thread::id>     m_ThreadId;
 
+  //affinity & NUMA
+  eAffinity                        m_Affinity;
+  int32                            m_NumNodes;   //number of NUMA nodes occupied by workers
+  std::vector<int32>               m_ThreadNode; //NUMA node of each worker (index of occupied node)
+  std::vector<std::vector<int32>>  m_NodeCpus;   //allowed cpus of each occupied node
+  std::vector<int32>               m_PoolNode;   //topology node -> occupied node index (NOT_VALID if not occupied)
+  int32                            m_NumPinFailed;
+
+  //statistics (optional, enabled before create)
+  bool                                        m_StatsEnabled;
+  tTimePoint                                  m_StatsBeg;
+  std::vector<xThreadPoolStats::xAccumulator> m_WorkerStats;
+  std::map<uintPtr, xThreadPoolStats::xAccumulator> m_ClientStats;
+  std::map<uintPtr, int32>                    m_ClientOrder; //client registration order - used as client index in statistics
+
   //input queque
   xPriorityQueue<xWorkerTask*> m_WaitingTasks;
 
   //output
-  std::map<uintPtr, xQueue<xWorkerTask*>> m_CompletedTasks;
+  std::map<uintPtr, xQueueLF<xWorkerTask*>> m_CompletedTasks; //lock-free - completed tasks are handed off without kernel transitions
 
 
 protected:  
@@ -139,21 +170,33 @@ protected:
   static uint32 xThreadStarter(xThreadPool* ThreadPool) { return ThreadPool->xThreadFunc(); }
 
 public:
-  xThreadPool() : m_Event(true, false) { m_NumThreads = 0; }
+  xThreadPool() : m_Event(true, false) { m_NumThreads = 0; m_Affinity = eAffinity::None; m_NumNodes = 1; m_NumPinFailed = 0; m_StatsEnabled = false; }
 
-  void         create   (int32 NumThreads, int32 WaitingQueueSize);
+  void         create   (int32 NumThreads, int32 WaitingQueueSize, eAffinity Affinity = eAffinity::None);
   void         destroy  ();
                
   bool         registerClient  (uintPtr ClientId, int32 CompletedQueueSize);
   bool         unregisterClient(uintPtr ClientId);
 
-  void         addWaitingTask       (xWorkerTask* Task) { m_WaitingTasks.EnqueueWait(Task); }
+  void         addWaitingTask       (xWorkerTask* Task) { if(m_StatsEnabled) { Task->setEnqueueTime(tClock::now()); } m_WaitingTasks.EnqueueWait(Task); }
   xWorkerTask* receiveCompletedTask (uintPtr ClientId ) { xWorkerTask* Task; m_CompletedTasks.at(ClientId).DequeueWait(Task); return Task; }  
   int32        getWaitingQueueSize  (                 ) { return m_WaitingTasks.getSize(); }
   bool         isWaitingQueueEmpty  (                 ) { return m_WaitingTasks.isEmpty(); }
   int32        getCompletedQueueSize(uintPtr ClientId ) { return m_CompletedTasks.at(ClientId).getSize(); }
   bool         isCompletedQueueEmpty(uintPtr ClientId ) { return m_CompletedTasks.at(ClientId).isEmpty(); }
   int32        getNumThreads        (                 ) { return m_NumThreads; }
+  eAffinity    getAffinity          (                 ) { return m_Affinity; }
+  int32        getNumNodes          (                 ) { return m_NumNodes; }
+  int32        getThreadNode        (int32 ThreadIdx  ) { return (ThreadIdx >= 0 && ThreadIdx < m_NumThreads) ? m_ThreadNode[ThreadIdx] : getCallerNode(); }
+  int32        getCallerNode        (                 ) { if(m_NumNodes <= 1) { return 0; } int32 Node = xTopology::getCurrentNode(); return (Node >= 0 && Node < (int32)m_PoolNode.size() && m_PoolNode[Node] != NOT_VALID) ? m_PoolNode[Node] : 0; }
+  int32        getNumPinFailed      (                 ) { return m_NumPinFailed; } //number of workers which could not be pinned
+
+  //statistics - low overhead counters (two clock reads per task), sampling is allowed while pool is running
+  void         setStatsEnabled      (bool Enabled     ) { assert(m_NumThreads == 0); m_StatsEnabled = Enabled; } //must be called before create
+  bool         getStatsEnabled      (                 ) { return m_StatsEnabled; }
+  int32        getClientIndex       (uintPtr ClientId ) { return m_ClientOrder.count(ClientId) ? m_ClientOrder.at(ClientId) : NOT_VALID; }
+  xThreadPoolStats::xSnapshot getStatistics  ();
+  void                        resetStatistics();
 };
 
 //===============================================================================================================================================================================================================
@@ -162,14 +205,44 @@ class xThreadPoolInterface
 {
 public:
   using xWorkerTask = xThreadPool::xWorkerTask;
+  using fRangeFunc  = void(*)(const void* Body, int32 Beg, int32 End); //type erased [Beg, End) loop over Body
+
+protected:
+  //parallel for - helper task pulling chunks of iterations from shared atomic counter
+  class xWorkerTaskParallelFor : public xWorkerTask
+  {
+  protected:
+    xThreadPoolInterface* m_Owner;
+  public:
+    xWorkerTaskParallelFor(xThreadPoolInterface* Owner) { m_Owner = Owner; }
+  protected:
+    void WorkingFunction(int32 ThreadIdx) final { m_Owner->xParallelForWorker(ThreadIdx); }
+  public:
+    const char* getTraceName() const final { return "ParallelFor"; }
+  };
+
+  //parallel for - range is split into one segment per NUMA node, workers drain segment of own node first and then help others
+  struct alignas(64) xParallelForSegment
+  {
+    std::atomic<int32> Next;
+    int32              End;
+  };
 
 protected:
   xThreadPool* m_ThreadPool;
   int8         m_Priority;
   int32        m_NumChunks;
 
+  //parallel for - helper tasks are allocated once (in init) and reused by every parallelFor call
+  std::vector<xWorkerTaskParallelFor> m_ParallelForTasks;
+  xLatch                              m_ParallelForLatch;
+  std::vector<xParallelForSegment>    m_ParallelForSegments;
+  int32                               m_ParallelForGrain;
+  const void*                         m_ParallelForBody;
+  fRangeFunc                          m_ParallelForFunc;
+
 public:
-  xThreadPoolInterface() { m_ThreadPool = nullptr; m_Priority = xThreadPool::xWorkerTask::c_DefaultPriority; m_NumChunks = NOT_VALID; }
+  xThreadPoolInterface() { m_ThreadPool = nullptr; m_Priority = xThreadPool::xWorkerTask::c_DefaultPriority; m_NumChunks = NOT_VALID; m_ParallelForGrain = 1; m_ParallelForBody = nullptr; m_ParallelForFunc = nullptr; }
 
   void init   (xThreadPool* ThreadPool, int32 CompletedQueueSize);
   void uininit();
@@ -181,11 +254,20 @@ public:
   void         waitUntilTasksFinished(int32 NumTasksToWaitFor);
   void         executeTask           (std::function<void(int32)> Function);
 
+  //calls Body(Idx) for every Idx in [0, Range), iterations are distributed in chunks of Grain (Grain<=0 --> auto)
+  //no heap allocation, calling thread participates in processing, not reentrant for single interface
+  template<class tBody> void parallelFor(int32 Range, int32 Grain, const tBody& Body)
+  {
+    fRangeFunc Func = [](const void* BodyPtr, int32 Beg, int32 End) { const tBody& B = *(const tBody*)BodyPtr; for(int32 Idx = Beg; Idx < End; Idx++) { B(Idx); } };
+    xParallelFor(Range, Grain, (const void*)&Body, Func);
+  }
+
   int32  getWaitingQueueSize  () { return m_ThreadPool->getWaitingQueueSize(); }
   bool   isWaitingQueueEmpty  () { return m_ThreadPool->isWaitingQueueEmpty(); }
   int32  getCompletedQueueSize() { return m_ThreadPool->getCompletedQueueSize(getClientId()); }
   bool   isCompletedQueueEmpty() { return m_ThreadPool->isCompletedQueueEmpty(getClientId()); }
   int32  getNumThreads        () { return m_ThreadPool != nullptr ? m_ThreadPool->getNumThreads() : 0; }
+  int32  getClientIndex       () { return m_ThreadPool != nullptr ? m_ThreadPool->getClientIndex(getClientId()) : NOT_VALID; }
 
   void   setPriority  (int8  Priority ){ m_Priority = Priority; }
   int8   getPriority  (               ){ return m_Priority; }
@@ -194,6 +276,9 @@ public:
 
 protected:
   uintPtr getClientId() { return (uintPtr)this; }
+
+  void    xParallelFor      (int32 Range, int32 Grain, const void* Body, fRangeFunc Func);
+  void    xParallelForWorker(int32 ThreadIdx);
 };
 
 //===============================================================================================================================================================================================================
@@ -0,0 +1,179 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+#include "xThreadPoolStats.h"
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xThreadPoolStats::xHistogram
+//===============================================================================================================================================================================================================
+int64 xThreadPoolStats::xHistogram::getPercentile(flt64 Percentile) const
+{
+  const uint64 Count = getCount();
+  if(Count == 0) { return 0; }
+  const uint64 Rank = xMax((uint64)1, (uint64)std::ceil(Percentile * (flt64)Count));
+  uint64 Accumulated = 0;
+  for(int32 b = 0; b < c_NumBins; b++)
+  {
+    Accumulated += m_Bins[b];
+    if(Accumulated >= Rank) { return (int64)1 << (b + 1); }
+  }
+  return (int64)1 << c_NumBins;
+}
+
+//===============================================================================================================================================================================================================
+// xThreadPoolStats::xCounters
+//===============================================================================================================================================================================================================
+xThreadPoolStats::xCounters& xThreadPoolStats::xCounters::operator+=(const xCounters& Other)
+{
+  NumTasks  += Other.NumTasks;
+  BusyNs    += Other.BusyNs;
+  IdleNs    += Other.IdleNs;
+  QueueNs   += Other.QueueNs;
+  QueueHist += Other.QueueHist;
+  TaskHist  += Other.TaskHist;
+  return *this;
+}
+xThreadPoolStats::xCounters& xThreadPoolStats::xCounters::operator-=(const xCounters& Other)
+{
+  NumTasks  -= Other.NumTasks;
+  BusyNs    -= Other.BusyNs;
+  IdleNs    -= Other.IdleNs;
+  QueueNs   -= Other.QueueNs;
+  QueueHist -= Other.QueueHist;
+  TaskHist  -= Other.TaskHist;
+  return *this;
+}
+
+//===============================================================================================================================================================================================================
+// xThreadPoolStats::xSnapshot
+//===============================================================================================================================================================================================================
+xThreadPoolStats::xCounters xThreadPoolStats::xSnapshot::getTotal() const
+{
+  xCounters Total;
+  for(const xCounters& Worker : Workers) { Total += Worker; }
+  return Total;
+}
+flt64 xThreadPoolStats::xSnapshot::getUtilization() const
+{
+  if(WallNs <= 0 || NumThreads <= 0) { return 0; }
+  return (flt64)getTotal().BusyNs / ((flt64)WallNs * NumThreads);
+}
+xThreadPoolStats::xSnapshot xThreadPoolStats::xSnapshot::operator-(const xSnapshot& Prev) const
+{
+  xSnapshot Delta = *this;
+  Delta.WallNs -= Prev.WallNs;
+  for(int32 i = 0; i < xMin((int32)Delta.Workers.size(), (int32)Prev.Workers.size()); i++) { Delta.Workers[i] -= Prev.Workers[i]; }
+  for(std::pair<const int32, xCounters>& Pair : Delta.Clients)
+  {
+    std::map<int32, xCounters>::const_iterator PrevIter = Prev.Clients.find(Pair.first);
+    if(PrevIter != Prev.Clients.end()) { Pair.second -= PrevIter->second; }
+  }
+  return Delta;
+}
+std::string xThreadPoolStats::xSnapshot::format(const std::string& Prefix) const
+{
+  auto Ms  = [](int64 Ns) { return (flt64)Ns / 1e6; };
+  auto Us  = [](int64 Ns) { return (flt64)Ns / 1e3; };
+  auto Avg = [](int64 Ns, uint64 Count) { return Count > 0 ? (flt64)Ns / 1e3 / (flt64)Count : 0.0; };
+  auto Pct = [this](int64 Ns) { return WallNs > 0 ? 100.0 * (flt64)Ns / (flt64)WallNs : 0.0; };
+
+  std::string Result;
+  const xCounters Total = getTotal();
+  Result += fmt::sprintf("%sWallTime %9.2f ms   Threads %d   Utilization %5.1f%%   Tasks %d\n", Prefix, Ms(WallNs), NumThreads, 100.0 * getUtilization(), Total.NumTasks);
+  for(int32 i = 0; i < (int32)Workers.size(); i++)
+  {
+    const xCounters& W = Workers[i];
+    Result += fmt::sprintf("%sWorker%-3d Tasks %8d   Busy %9.2f ms (%5.1f%%)   Idle %9.2f ms (%5.1f%%)   QueueWait avg %8.1f us  p50 <%8.1f us  p99 <%8.1f us   Task avg %8.1f us  p99 <%8.1f us\n",
+      Prefix, i, W.NumTasks, Ms(W.BusyNs), Pct(W.BusyNs), Ms(W.IdleNs), Pct(W.IdleNs),
+      Avg(W.QueueNs, W.NumTasks), Us(W.QueueHist.getPercentile(0.50)), Us(W.QueueHist.getPercentile(0.99)),
+      Avg(W.BusyNs , W.NumTasks), Us(W.TaskHist .getPercentile(0.99)));
+  }
+  for(const std::pair<const int32, xCounters>& Pair : Clients)
+  {
+    const xCounters& C = Pair.second;
+    Result += fmt::sprintf("%sClient%-3d Tasks %8d   Busy %9.2f ms            QueueWait avg %8.1f us  p50 <%8.1f us  p99 <%8.1f us   Task avg %8.1f us  p99 <%8.1f us\n",
+      Prefix, Pair.first, C.NumTasks, Ms(C.BusyNs),
+      Avg(C.QueueNs, C.NumTasks), Us(C.QueueHist.getPercentile(0.50)), Us(C.QueueHist.getPercentile(0.99)),
+      Avg(C.BusyNs , C.NumTasks), Us(C.TaskHist .getPercentile(0.99)));
+  }
+  return Result;
+}
+
+//===============================================================================================================================================================================================================
+// xThreadPoolStats::xAccumulator
+//===============================================================================================================================================================================================================
+void xThreadPoolStats::xAccumulator::reset()
+{
+  m_NumTasks.store(0, std::memory_order_relaxed);
+  m_BusyNs  .store(0, std::memory_order_relaxed);
+  m_IdleNs  .store(0, std::memory_order_relaxed);
+  m_QueueNs .store(0, std::memory_order_relaxed);
+  for(int32 b = 0; b < c_NumBins; b++)
+  {
+    m_QueueHist[b].store(0, std::memory_order_relaxed);
+    m_TaskHist [b].store(0, std::memory_order_relaxed);
+  }
+}
+void xThreadPoolStats::xAccumulator::addTask(int64 QueueNs, int64 TaskNs)
+{
+  m_NumTasks.fetch_add(1      , std::memory_order_relaxed);
+  m_BusyNs  .fetch_add(TaskNs , std::memory_order_relaxed);
+  m_QueueNs .fetch_add(QueueNs, std::memory_order_relaxed);
+  m_QueueHist[xHistogram::calcBin(QueueNs)].fetch_add(1, std::memory_order_relaxed);
+  m_TaskHist [xHistogram::calcBin(TaskNs )].fetch_add(1, std::memory_order_relaxed);
+}
+xThreadPoolStats::xCounters xThreadPoolStats::xAccumulator::get() const
+{
+  xCounters Counters;
+  Counters.NumTasks = m_NumTasks.load(std::memory_order_relaxed);
+  Counters.BusyNs   = m_BusyNs  .load(std::memory_order_relaxed);
+  Counters.IdleNs   = m_IdleNs  .load(std::memory_order_relaxed);
+  Counters.QueueNs  = m_QueueNs .load(std::memory_order_relaxed);
+  for(int32 b = 0; b < c_NumBins; b++)
+  {
+    Counters.QueueHist.m_Bins[b] = m_QueueHist[b].load(std::memory_order_relaxed);
+    Counters.TaskHist .m_Bins[b] = m_TaskHist [b].load(std::memory_order_relaxed);
+  }
+  return Counters;
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,131 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include <vector>
+#include <map>
+#include <atomic>
+#include <string>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xThreadPoolStats - thread pool instrumentation (queue wait, task runtime, worker idle time, per client totals)
+//===============================================================================================================================================================================================================
+class xThreadPoolStats
+{
+public:
+  static constexpr int32 c_NumBins = 40; //log2 histogram - bin b counts durations in [2^b, 2^(b+1)) ns, last bin is open ended
+
+  //plain log2(ns) histogram
+  class xHistogram
+  {
+  public:
+    uint64 m_Bins[c_NumBins];
+
+  public:
+    xHistogram() { clear(); }
+
+    void   clear        () { for(int32 b = 0; b < c_NumBins; b++) { m_Bins[b] = 0; } }
+    uint64 getCount     () const { uint64 Count = 0; for(int32 b = 0; b < c_NumBins; b++) { Count += m_Bins[b]; } return Count; }
+    int64  getPercentile(flt64 Percentile) const; //upper bound of bin containing given percentile [ns]
+
+    xHistogram& operator+=(const xHistogram& Other) { for(int32 b = 0; b < c_NumBins; b++) { m_Bins[b] += Other.m_Bins[b]; } return *this; }
+    xHistogram& operator-=(const xHistogram& Other) { for(int32 b = 0; b < c_NumBins; b++) { m_Bins[b] -= Other.m_Bins[b]; } return *this; }
+
+    static int32 calcBin(int64 Ns) { return Ns <= 1 ? 0 : xMin((int32)xFastLog2((uint64)Ns), c_NumBins - 1); }
+  };
+
+  //plain counters of single worker or single client
+  class xCounters
+  {
+  public:
+    uint64     NumTasks  = 0;
+    int64      BusyNs    = 0; //sum of task execution time
+    int64      IdleNs    = 0; //time spent waiting for tasks (workers only)
+    int64      QueueNs   = 0; //sum of enqueue-to-start latency
+    xHistogram QueueHist;
+    xHistogram TaskHist;
+
+  public:
+    xCounters& operator+=(const xCounters& Other);
+    xCounters& operator-=(const xCounters& Other);
+  };
+
+  //point-in-time copy of all counters, two snapshots can be subtracted to get statistics of given interval
+  class xSnapshot
+  {
+  public:
+    int32                       NumThreads = 0;
+    int64                       WallNs     = 0; //time since statistics start
+    std::vector<xCounters>      Workers;
+    std::map<int32, xCounters>  Clients;        //indexed by client registration order
+
+  public:
+    xCounters   getTotal         () const;
+    flt64       getUtilization   () const; //busy time / (wall time * num threads)
+    xSnapshot   operator-        (const xSnapshot& Prev) const;
+    std::string format           (const std::string& Prefix) const;
+  };
+
+  //live counters - updated concurrently by workers (relaxed atomics), cacheline aligned to avoid false sharing between workers
+  class alignas(64) xAccumulator
+  {
+  protected:
+    std::atomic<uint64> m_NumTasks;
+    std::atomic<int64 > m_BusyNs;
+    std::atomic<int64 > m_IdleNs;
+    std::atomic<int64 > m_QueueNs;
+    std::atomic<uint64> m_QueueHist[c_NumBins];
+    std::atomic<uint64> m_TaskHist [c_NumBins];
+
+  public:
+    xAccumulator() { reset(); }
+
+    void      reset  ();
+    void      addTask(int64 QueueNs, int64 TaskNs);
+    void      addIdle(int64 IdleNs) { m_IdleNs.fetch_add(IdleNs, std::memory_order_relaxed); }
+    xCounters get    () const;
+  };
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,246 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+#include "xTopology.h"
+#include "xString.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iterator>
+
+#if X_SYSTEM_WINDOWS
+#define NOMINMAX
+#include <windows.h>
+#elif X_SYSTEM_LINUX
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+namespace {
+
+struct xTopologyInfo
+{
+  int32                           NumCpus = 0;
+  std::vector<std::vector<int32>> NodeCpus;
+  std::vector<int32>              CpuNode;
+};
+
+xTopologyInfo xDetectTopology()
+{
+  xTopologyInfo Info;
+  Info.NumCpus = xMax((int32)std::thread::hardware_concurrency(), 1);
+
+#if X_SYSTEM_LINUX
+  std::vector<int32> OnlineCpus = xTopology::parseCpuList(xTopology::readFirstLine("/sys/devices/system/cpu/online"));
+  if(!OnlineCpus.empty()) { Info.NumCpus = xMax(Info.NumCpus, OnlineCpus.back() + 1); }
+
+  std::vector<int32> OnlineNodes = xTopology::parseCpuList(xTopology::readFirstLine("/sys/devices/system/node/online"));
+  for(int32 NodeId : OnlineNodes)
+  {
+    std::vector<int32> Cpus = xTopology::parseCpuList(xTopology::readFirstLine(fmt::sprintf("/sys/devices/system/node/node%d/cpulist", NodeId)));
+    if(!Cpus.empty()) { Info.NodeCpus.push_back(Cpus); } //memory-only nodes are skipped
+  }
+#elif X_SYSTEM_WINDOWS
+  ULONG HighestNodeNumber = 0;
+  if(GetNumaHighestNodeNumber(&HighestNodeNumber))
+  {
+    for(ULONG NodeId = 0; NodeId <= HighestNodeNumber; NodeId++)
+    {
+      ULONGLONG Mask = 0;
+      if(!GetNumaNodeProcessorMask((UCHAR)NodeId, &Mask) || Mask == 0) { continue; }
+      std::vector<int32> Cpus;
+      for(int32 CpuIdx = 0; CpuIdx < 64; CpuIdx++) { if(Mask & (1ull << CpuIdx)) { Cpus.push_back(CpuIdx); } }
+      Info.NodeCpus.push_back(Cpus);
+    }
+  }
+#endif
+
+  if(Info.NodeCpus.empty()) //no NUMA information - single node with all cpus
+  {
+    std::vector<int32> Cpus(Info.NumCpus);
+    for(int32 CpuIdx = 0; CpuIdx < Info.NumCpus; CpuIdx++) { Cpus[CpuIdx] = CpuIdx; }
+    Info.NodeCpus.push_back(Cpus);
+  }
+
+  for(int32 NodeIdx = 0; NodeIdx < (int32)Info.NodeCpus.size(); NodeIdx++)
+  {
+    for(int32 CpuIdx : Info.NodeCpus[NodeIdx])
+    {
+      if(CpuIdx >= (int32)Info.CpuNode.size()) { Info.CpuNode.resize(CpuIdx + 1, 0); }
+      Info.CpuNode[CpuIdx] = NodeIdx;
+    }
+  }
+
+  return Info;
+}
+
+const xTopologyInfo& xGetTopology()
+{
+  static const xTopologyInfo Info = xDetectTopology();
+  return Info;
+}
+
+} //end of anonymous namespace
+
+//===============================================================================================================================================================================================================
+
+int32 xTopology::getNumCpus()
+{
+  return xGetTopology().NumCpus;
+}
+int32 xTopology::getNumNodes()
+{
+  return (int32)xGetTopology().NodeCpus.size();
+}
+std::vector<int32> xTopology::getNodeCpus(int32 NodeIdx)
+{
+  const xTopologyInfo& Info = xGetTopology();
+  if(NodeIdx < 0 || NodeIdx >= (int32)Info.NodeCpus.size()) { return std::vector<int32>(); }
+  return Info.NodeCpus[NodeIdx];
+}
+int32 xTopology::getCpuNode(int32 CpuIdx)
+{
+  const xTopologyInfo& Info = xGetTopology();
+  if(CpuIdx < 0 || CpuIdx >= (int32)Info.CpuNode.size()) { return 0; }
+  return Info.CpuNode[CpuIdx];
+}
+int32 xTopology::getCurrentCpu()
+{
+#if X_SYSTEM_LINUX
+  int32 CpuIdx = sched_getcpu();
+  return CpuIdx >= 0 ? CpuIdx : NOT_VALID;
+#elif X_SYSTEM_WINDOWS
+  return (int32)GetCurrentProcessorNumber();
+#else
+  return NOT_VALID;
+#endif
+}
+std::vector<int32> xTopology::getAllowedCpus()
+{
+  std::vector<int32> Cpus;
+#if X_SYSTEM_LINUX
+  cpu_set_t CpuSet;
+  CPU_ZERO(&CpuSet);
+  if(sched_getaffinity(0, sizeof(cpu_set_t), &CpuSet) == 0)
+  {
+    for(int32 CpuIdx = 0; CpuIdx < CPU_SETSIZE; CpuIdx++) { if(CPU_ISSET(CpuIdx, &CpuSet)) { Cpus.push_back(CpuIdx); } }
+  }
+#elif X_SYSTEM_WINDOWS
+  DWORD_PTR ProcessMask = 0, SystemMask = 0;
+  if(GetProcessAffinityMask(GetCurrentProcess(), &ProcessMask, &SystemMask))
+  {
+    for(int32 CpuIdx = 0; CpuIdx < (int32)(sizeof(DWORD_PTR) * 8); CpuIdx++) { if(ProcessMask & ((DWORD_PTR)1 << CpuIdx)) { Cpus.push_back(CpuIdx); } }
+  }
+#endif
+  return Cpus;
+}
+std::vector<int32> xTopology::getAllowedNodeCpus(int32 NodeIdx)
+{
+  std::vector<int32> NodeCpus    = getNodeCpus(NodeIdx);
+  std::vector<int32> AllowedCpus = getAllowedCpus();
+  if(AllowedCpus.empty()) { return NodeCpus; } //affinity mask unavailable - assume whole node is allowed
+  std::vector<int32> Cpus;
+  std::set_intersection(NodeCpus.begin(), NodeCpus.end(), AllowedCpus.begin(), AllowedCpus.end(), std::back_inserter(Cpus));
+  return Cpus;
+}
+bool xTopology::setThreadAffinity(std::thread& Thread, const std::vector<int32>& Cpus)
+{
+  if(Cpus.empty()) { return false; }
+#if X_SYSTEM_LINUX
+  cpu_set_t CpuSet;
+  CPU_ZERO(&CpuSet);
+  for(int32 CpuIdx : Cpus) { if(CpuIdx < CPU_SETSIZE) { CPU_SET(CpuIdx, &CpuSet); } }
+  return pthread_setaffinity_np(Thread.native_handle(), sizeof(cpu_set_t), &CpuSet) == 0;
+#elif X_SYSTEM_WINDOWS
+  DWORD_PTR Mask = 0;
+  for(int32 CpuIdx : Cpus) { if(CpuIdx < (int32)(sizeof(DWORD_PTR) * 8)) { Mask |= ((DWORD_PTR)1 << CpuIdx); } }
+  return Mask != 0 && SetThreadAffinityMask((HANDLE)Thread.native_handle(), Mask) != 0;
+#else
+  (void)Thread;
+  return false;
+#endif
+}
+std::string xTopology::readFirstLine(const std::string& FilePath)
+{
+  std::ifstream File(FilePath);
+  std::string   Line;
+  if(File.is_open()) { std::getline(File, Line); xString::trimR(Line); }
+  return Line;
+}
+std::vector<int32> xTopology::parseCpuList(const std::string& CpuList)
+{
+  std::vector<int32> Cpus;
+  std::istringstream Stream(CpuList);
+  std::string        Range;
+  while(std::getline(Stream, Range, ','))
+  {
+    xString::trimL(Range); xString::trimR(Range);
+    if(Range.empty()) { continue; }
+    std::size_t Dash = Range.find('-');
+    int32 First = NOT_VALID, Last = NOT_VALID;
+    try
+    {
+      if(Dash == std::string::npos) { First = Last = std::stoi(Range); }
+      else                          { First = std::stoi(Range.substr(0, Dash)); Last = std::stoi(Range.substr(Dash + 1)); }
+    }
+    catch(...) { return std::vector<int32>(); }
+    for(int32 CpuIdx = First; CpuIdx <= Last; CpuIdx++) { Cpus.push_back(CpuIdx); }
+  }
+  return Cpus;
+}
+std::string xTopology::formatCpuList(const std::vector<int32>& Cpus)
+{
+  std::string Result;
+  for(std::size_t i = 0; i < Cpus.size(); )
+  {
+    std::size_t j = i;
+    while(j + 1 < Cpus.size() && Cpus[j + 1] == Cpus[j] + 1) { j++; }
+    if(!Result.empty()) { Result += ","; }
+    Result += j == i ? fmt::sprintf("%d", Cpus[i]) : fmt::sprintf("%d-%d", Cpus[i], Cpus[j]);
+    i = j + 1;
+  }
+  return Result;
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
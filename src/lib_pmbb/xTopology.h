@@ -0,0 +1,93 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include <vector>
+#include <thread>
+#include <string_view>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xTopology - CPU/NUMA topology detection and thread affinity
+//===============================================================================================================================================================================================================
+class xTopology
+{
+public:
+  enum class eAffinity : int32
+  {
+    INVALID = NOT_VALID,
+    None    = 0, //no affinity - threads scheduled by OS
+    Node    = 1, //workers grouped by NUMA node - each thread bound to all cpus of its node
+    Core    = 2, //each thread pinned to single cpu (cpus of node are used in order)
+  };
+
+  static std::string_view AffinityToString(eAffinity Affinity)
+  {
+    switch(Affinity)
+    {
+      case eAffinity::None: return "None"; break;
+      case eAffinity::Node: return "Node"; break;
+      case eAffinity::Core: return "Core"; break;
+      default: return "INVALID"; break;
+    }
+  }
+
+public:
+  static int32              getNumCpus       ();
+  static int32              getNumNodes      ();
+  static std::vector<int32> getNodeCpus      (int32 NodeIdx);
+  static int32              getCpuNode       (int32 CpuIdx );
+  static int32              getCurrentCpu    ();
+  static int32              getCurrentNode   () { int32 CpuIdx = getCurrentCpu(); return CpuIdx != NOT_VALID ? getCpuNode(CpuIdx) : 0; }
+
+  static std::vector<int32> getAllowedCpus    ();              //cpus in process affinity mask (empty if unknown)
+  static std::vector<int32> getAllowedNodeCpus(int32 NodeIdx); //node cpus restricted to process affinity mask
+
+  static bool               setThreadAffinity(std::thread& Thread, const std::vector<int32>& Cpus);
+
+  static std::string        readFirstLine    (const std::string& FilePath); //first line of small text file (sysfs, procfs, cgroupfs), empty if file does not exist
+  static std::vector<int32> parseCpuList     (const std::string& CpuList); //Linux cpulist format i.e. "0-3,8-11"
+  static std::string        formatCpuList    (const std::vector<int32>& Cpus);
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
@@ -0,0 +1,197 @@
+﻿/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+#include "xTrace.h"
+
+#if USE_TRACE
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <fstream>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+
+namespace {
+
+struct xEvent
+{
+  const char* Name;
+  const char* Category;
+  int64       BegNs;
+  int64       DurNs;
+  int64       Arg;
+};
+
+struct xThreadBuffer
+{
+  int32                     ThreadIdx = 0;
+  std::string               ThreadName;
+  int32                     Capacity  = 0;
+  std::unique_ptr<xEvent[]> Events; //default initialized - pages are touched only when used
+  std::atomic<int32>        NumEvents  = 0;
+  std::atomic<int64>        NumDropped = 0;
+};
+
+struct xRegistry
+{
+  std::mutex                                  Mutex;
+  std::vector<std::unique_ptr<xThreadBuffer>> Buffers; //buffers outlive threads - events are written at exit
+  int32                                       MaxEventsPerThread = xTrace::c_DefMaxEventsPerThread;
+  tTimePoint                                  Origin             = tClock::now();
+};
+
+xRegistry& xGetRegistry() { static xRegistry Registry; return Registry; }
+
+thread_local xThreadBuffer* t_Buffer = nullptr;
+
+xThreadBuffer* xGetThreadBuffer()
+{
+  if(t_Buffer != nullptr) { return t_Buffer; }
+  xRegistry& Registry = xGetRegistry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  std::unique_ptr<xThreadBuffer> Buffer = std::make_unique<xThreadBuffer>();
+  Buffer->ThreadIdx = (int32)Registry.Buffers.size();
+  Buffer->Capacity  = Registry.MaxEventsPerThread;
+  Buffer->Events    = std::unique_ptr<xEvent[]>(new xEvent[Buffer->Capacity]);
+  t_Buffer = Buffer.get();
+  Registry.Buffers.push_back(std::move(Buffer));
+  return t_Buffer;
+}
+
+std::string xEscapeJSON(const std::string& Src)
+{
+  std::string Dst;
+  for(char C : Src)
+  {
+    if     (C == '"' ) { Dst += "\\\""; }
+    else if(C == '\\') { Dst += "\\\\"; }
+    else if((uint8)C < 0x20) { Dst += fmt::sprintf("\\u%04x", (int32)C); }
+    else               { Dst += C; }
+  }
+  return Dst;
+}
+
+} //end of anonymous namespace
+
+//===============================================================================================================================================================================================================
+
+void xTrace::start(int32 MaxEventsPerThread)
+{
+  xRegistry& Registry = xGetRegistry();
+  {
+    std::lock_guard<std::mutex> Lock(Registry.Mutex);
+    Registry.MaxEventsPerThread = xMax(MaxEventsPerThread, 1);
+    Registry.Origin             = tClock::now();
+  }
+  m_Enabled.store(true, std::memory_order_relaxed);
+}
+void xTrace::setThreadName(const std::string& Name)
+{
+  xThreadBuffer* Buffer = xGetThreadBuffer();
+  std::lock_guard<std::mutex> Lock(xGetRegistry().Mutex);
+  Buffer->ThreadName = Name;
+}
+void xTrace::addComplete(const char* Name, const char* Category, tTimePoint Beg, tTimePoint End, int64 Arg)
+{
+  xThreadBuffer* Buffer = xGetThreadBuffer();
+  const int32 EventIdx = Buffer->NumEvents.load(std::memory_order_relaxed);
+  if(EventIdx >= Buffer->Capacity) { Buffer->NumDropped.fetch_add(1, std::memory_order_relaxed); return; }
+  xEvent& Event  = Buffer->Events[EventIdx];
+  Event.Name     = Name;
+  Event.Category = Category;
+  Event.BegNs    = std::chrono::duration_cast<std::chrono::nanoseconds>(Beg - xGetRegistry().Origin).count();
+  Event.DurNs    = std::chrono::duration_cast<std::chrono::nanoseconds>(End - Beg).count();
+  Event.Arg      = Arg;
+  Buffer->NumEvents.store(EventIdx + 1, std::memory_order_release);
+}
+int64 xTrace::getNumEvents()
+{
+  xRegistry& Registry = xGetRegistry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  int64 NumEvents = 0;
+  for(const std::unique_ptr<xThreadBuffer>& Buffer : Registry.Buffers) { NumEvents += Buffer->NumEvents.load(std::memory_order_acquire); }
+  return NumEvents;
+}
+int64 xTrace::getNumDropped()
+{
+  xRegistry& Registry = xGetRegistry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  int64 NumDropped = 0;
+  for(const std::unique_ptr<xThreadBuffer>& Buffer : Registry.Buffers) { NumDropped += Buffer->NumDropped.load(std::memory_order_relaxed); }
+  return NumDropped;
+}
+bool xTrace::writeJSON(const std::string& FilePath)
+{
+  std::ofstream File(FilePath, std::ios::out | std::ios::trunc);
+  if(!File.is_open()) { return false; }
+
+  xRegistry& Registry = xGetRegistry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+
+  File << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+  bool First = true;
+  for(const std::unique_ptr<xThreadBuffer>& Buffer : Registry.Buffers)
+  {
+    const std::string ThreadName = Buffer->ThreadName.empty() ? fmt::sprintf("Thread%d", Buffer->ThreadIdx) : Buffer->ThreadName;
+    File << fmt::sprintf("%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}}", First ? "" : ",\n", Buffer->ThreadIdx, xEscapeJSON(ThreadName));
+    File << fmt::sprintf(",\n{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"sort_index\": %d}}", Buffer->ThreadIdx, Buffer->ThreadIdx);
+    First = false;
+
+    const int32 NumEvents = Buffer->NumEvents.load(std::memory_order_acquire);
+    std::string Chunk;
+    for(int32 i = 0; i < NumEvents; i++)
+    {
+      const xEvent& E = Buffer->Events[i];
+      Chunk += fmt::sprintf(",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f", xEscapeJSON(E.Name), xEscapeJSON(E.Category), Buffer->ThreadIdx, (flt64)E.BegNs / 1e3, (flt64)E.DurNs / 1e3);
+      Chunk += E.Arg != NOT_VALID ? fmt::sprintf(", \"args\": {\"arg\": %d}}", E.Arg) : std::string("}");
+      if(Chunk.size() >= (1 << 20)) { File << Chunk; Chunk.clear(); }
+    }
+    File << Chunk;
+  }
+  File << "\n]}\n";
+  return File.good();
+}
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB
+
+#endif //USE_TRACE
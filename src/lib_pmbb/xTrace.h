@@ -0,0 +1,103 @@
+﻿#pragma once
+/* ############################################################################
+The copyright in this software is being made available under the 3-clause BSD
+License, included below. This software may be subject to other third party
+and contributor rights, including patent rights, and no such rights are
+granted under this license.
+
+Author(s):
+  * Jakub Stankowski, jakub.stankowski@put.poznan.pl,
+    Poznan University of Technology, Poznań, Poland
+
+
+Copyright (c) 2010-2021, Poznan University of Technology. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+############################################################################ */
+
+
+#include "xCommonDefPMBB.h"
+#include <atomic>
+#include <string>
+
+namespace PMBB_NAMESPACE {
+
+//===============================================================================================================================================================================================================
+// xTrace - timeline recorder producing Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev)
+// - every thread records into own preallocated buffer (single producer, no locks after first event of given thread)
+// - Name and Category have to point to strings with static storage duration (string literals, registered stage names)
+// - when buffer of given thread is full, further events of this thread are dropped (and counted)
+// - with USE_TRACE=0 isEnabled() is constexpr false and all trace points are removed by compiler
+//===============================================================================================================================================================================================================
+class xTrace
+{
+public:
+  static constexpr int32 c_DefMaxEventsPerThread = 1 << 20;
+
+  class xScope
+  {
+  protected:
+    const char* m_Name;
+    const char* m_Category;
+    int64       m_Arg;
+    tTimePoint  m_Beg;
+
+  public:
+    xScope(const char* Name, const char* Category, int64 Arg = NOT_VALID) { m_Name = isEnabled() ? Name : nullptr; m_Category = Category; m_Arg = Arg; if(m_Name != nullptr) { m_Beg = tClock::now(); } }
+    ~xScope() { if(m_Name != nullptr) { addComplete(m_Name, m_Category, m_Beg, tClock::now(), m_Arg); } }
+
+    xScope(const xScope&) = delete;
+    xScope& operator=(const xScope&) = delete;
+  };
+
+#if USE_TRACE
+protected:
+  static inline std::atomic<bool> m_Enabled = false;
+
+public:
+  static void  start        (int32 MaxEventsPerThread = c_DefMaxEventsPerThread); //enables recording and sets time origin
+  static void  stop         () { m_Enabled.store(false, std::memory_order_relaxed); }
+  static bool  isEnabled    () { return m_Enabled.load(std::memory_order_relaxed); }
+  static void  setThreadName(const std::string& Name); //name of calling thread presented in timeline
+  static void  addComplete  (const char* Name, const char* Category, tTimePoint Beg, tTimePoint End, int64 Arg = NOT_VALID);
+  static int64 getNumEvents ();
+  static int64 getNumDropped();
+  static bool  writeJSON    (const std::string& FilePath); //all recording threads have to be quiescent
+#else
+public:
+  static void            start        (int32 /*MaxEventsPerThread*/ = c_DefMaxEventsPerThread) {}
+  static void            stop         () {}
+  static constexpr bool  isEnabled    () { return false; }
+  static void            setThreadName(const std::string& /*Name*/) {}
+  static void            addComplete  (const char* /*Name*/, const char* /*Category*/, tTimePoint /*Beg*/, tTimePoint /*End*/, int64 /*Arg*/ = NOT_VALID) {}
+  static int64           getNumEvents () { return 0; }
+  static int64           getNumDropped() { return 0; }
+  static bool            writeJSON    (const std::string& /*FilePath*/) { return false; }
+#endif //USE_TRACE
+};
+
+//===============================================================================================================================================================================================================
+
+} //end of namespace PMBB